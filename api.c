@@ -26,12 +26,20 @@ SOFTWARE.
  * @file api.c
  * @brief Networking + JSON parsing for Binance endpoints.
  *
- * This module provides two high-level calls:
+ * This module provides the high-level calls:
  * - fetch_ticker_data(): latest price + 24h change for a symbol
+ * - fetch_book_tickers(): best bid/ask of every pair in one request
+ * - fetch_agg_trades(): pages of aggregated trades for trade-flow analysis
  * - fetch_historical_data(): OHLC candles for charting
+ * - fetch_historical_range(): paged OHLC candles for backfills
+ *
+ * Every request passes through a process-wide request-weight limiter so the
+ * UI fetch thread, chart reloads and bulk commands share one budget.
  *
  * Ownership:
  * - fetch_ticker_data() fills a caller-provided ::TickerData.
+ * - fetch_book_tickers() allocates @p *quotes; caller must free(@p *quotes).
+ * - fetch_agg_trades() allocates @p *trades; caller must free(@p *trades).
  * - fetch_historical_data() allocates @p *points; caller must free(@p *points).
  */
 
@@ -41,11 +49,42 @@ SOFTWARE.
 #include <curl/curl.h>
 #include <jansson.h>
 #include <time.h>
+#include <pthread.h>
 #include "cticker.h"
+#include "probes.h"
+#include "trace.h"
 
 #define BINANCE_API_BASE "https://api.binance.com"
 #define BINANCE_TICKER_URL BINANCE_API_BASE "/api/v3/ticker/24hr?symbol=%s"
+#define BINANCE_BOOK_TICKER_URL BINANCE_API_BASE "/api/v3/ticker/bookTicker"
+#define BINANCE_AGG_TRADES_URL BINANCE_API_BASE "/api/v3/aggTrades?symbol=%s&limit=1000"
 #define BINANCE_KLINES_URL BINANCE_API_BASE "/api/v3/klines?symbol=%s&interval=%s&limit=%d"
+#define BINANCE_KLINES_RANGE_URL BINANCE_KLINES_URL "&startTime=%llu"
+#define BINANCE_KLINES_RANGE_END "&endTime=%llu"
+
+/*
+ * Request weights (see Binance "LIMITS" docs). The IP budget is 6000/min;
+ * we stay well below it so other tools on the same IP keep working.
+ */
+#define API_WEIGHT_PER_MINUTE 3000.0
+#define API_WEIGHT_TICKER 2
+#define API_WEIGHT_KLINES 2
+// bookTicker without a symbol parameter covers every pair.
+#define API_WEIGHT_BOOK_TICKER_ALL 4
+#define API_WEIGHT_AGG_TRADES 4
+// Cool-down used when a 429/418 arrives without a Retry-After header.
+#define API_DEFAULT_BACKOFF_SECONDS 30
+
+/**
+ * @brief Token bucket shared by every request in the process.
+ */
+static struct {
+    pthread_mutex_t mutex;
+    double tokens;
+    struct timespec last_refill;
+    bool initialized;
+    time_t blocked_until;
+} rate_limiter = {.mutex = PTHREAD_MUTEX_INITIALIZER};
 
 /**
  * @brief In-memory buffer for the HTTP response body.
@@ -78,6 +117,122 @@ static size_t write_callback(void *contents, size_t size, size_t nmemb, void *us
     return realsize;
 }
 
+// Monotonic clock difference in seconds.
+static double elapsed_seconds(const struct timespec *from, const struct timespec *to) {
+    return (double)(to->tv_sec - from->tv_sec) + (double)(to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+/**
+ * @brief Block until @p weight request units are available.
+ *
+ * Sleeps in short slices outside the limiter mutex so concurrent callers
+ * queue up fairly instead of spinning.
+ */
+static void rate_limit_acquire(int weight) {
+    for (;;) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        pthread_mutex_lock(&rate_limiter.mutex);
+        if (!rate_limiter.initialized) {
+            rate_limiter.tokens = API_WEIGHT_PER_MINUTE;
+            rate_limiter.last_refill = now;
+            rate_limiter.initialized = true;
+        }
+        double refill = elapsed_seconds(&rate_limiter.last_refill, &now) *
+                        (API_WEIGHT_PER_MINUTE / 60.0);
+        rate_limiter.tokens += refill;
+        if (rate_limiter.tokens > API_WEIGHT_PER_MINUTE) {
+            rate_limiter.tokens = API_WEIGHT_PER_MINUTE;
+        }
+        rate_limiter.last_refill = now;
+
+        double wait = 0.0;
+        time_t wall_now = time(NULL);
+        if (rate_limiter.blocked_until > wall_now) {
+            wait = (double)(rate_limiter.blocked_until - wall_now);
+        } else if (rate_limiter.tokens >= weight) {
+            rate_limiter.tokens -= weight;
+            pthread_mutex_unlock(&rate_limiter.mutex);
+            return;
+        } else {
+            wait = (weight - rate_limiter.tokens) * 60.0 / API_WEIGHT_PER_MINUTE;
+        }
+        pthread_mutex_unlock(&rate_limiter.mutex);
+
+        if (wait > 0.25) {
+            wait = 0.25;
+        }
+        struct timespec pause = {
+            .tv_sec = 0,
+            .tv_nsec = (long)(wait * 1e9) + 1000000L,
+        };
+        nanosleep(&pause, NULL);
+    }
+}
+
+// Honor a 429/418 response by pausing every caller.
+static void rate_limit_backoff(long retry_after) {
+    if (retry_after <= 0) {
+        retry_after = API_DEFAULT_BACKOFF_SECONDS;
+    }
+    pthread_mutex_lock(&rate_limiter.mutex);
+    time_t until = time(NULL) + retry_after;
+    if (until > rate_limiter.blocked_until) {
+        rate_limiter.blocked_until = until;
+    }
+    pthread_mutex_unlock(&rate_limiter.mutex);
+}
+
+/**
+ * @brief Perform a rate-limited GET and collect the body.
+ *
+ * On success the caller owns @p response->data and must free it. @p symbol
+ * only labels the request probes ("*" for all-pairs endpoints).
+ *
+ * @return 0 on HTTP 200, -1 otherwise (the body is released on failure).
+ */
+static int http_get(const char *symbol, const char *url, int weight,
+                    ResponseBuffer *response) {
+    rate_limit_acquire(weight);
+
+    CURL *curl = curl_easy_init();
+    if (!curl) {
+        return -1;
+    }
+    uint64_t span = trace_begin();
+    CTICKER_PROBE2(request__start, symbol, url);
+
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)response);
+    /* Keep UI responsive even on slow networks. */
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
+
+    CURLcode res = curl_easy_perform(curl);
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    if (status == 429 || status == 418) {
+        curl_off_t retry_after = 0;
+        curl_easy_getinfo(curl, CURLINFO_RETRY_AFTER, &retry_after);
+        rate_limit_backoff((long)retry_after);
+    }
+    curl_easy_cleanup(curl);
+    // The last path segment names the endpoint and its query.
+    const char *endpoint = strrchr(url, '/');
+    trace_end("fetch", span, endpoint ? endpoint + 1 : url);
+
+    if (res != CURLE_OK || status != 200 || !response->data) {
+        free(response->data);
+        response->data = NULL;
+        response->size = 0;
+        CTICKER_PROBE3(request__end, symbol, (size_t)0, status);
+        return -1;
+    }
+    CTICKER_PROBE3(request__end, symbol, response->size, status);
+    return 0;
+}
+
 /**
  * @brief Fetch latest ticker data from Binance.
  *
@@ -86,38 +241,24 @@ static size_t write_callback(void *contents, size_t size, size_t nmemb, void *us
  * - priceChangePercent
  */
 int fetch_ticker_data(const char *symbol, TickerData *data) {
-    CURL *curl;
-    CURLcode res;
     char url[512];
     ResponseBuffer response = {0};
     
     snprintf(url, sizeof(url), BINANCE_TICKER_URL, symbol);
     
-    curl = curl_easy_init();
-    if (!curl) {
-        return -1;
-    }
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
-    /* Keep UI responsive even on slow networks. */
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-    
-    res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK) {
-        free(response.data);
+    if (http_get(symbol, url, API_WEIGHT_TICKER, &response) != 0) {
         return -1;
     }
     
     /* Parse JSON response (expected to be an object). */
+    uint64_t span = trace_begin();
     json_error_t error;
     json_t *root = json_loads(response.data, 0, &error);
     free(response.data);
     
     if (!root) {
+        trace_end("parse", span, symbol);
+        CTICKER_PROBE2(parse__done, symbol, -1);
         return -1;
     }
     
@@ -201,6 +342,141 @@ int fetch_ticker_data(const char *symbol, TickerData *data) {
     data->timestamp = time(NULL);
     
     json_decref(root);
+    trace_end("parse", span, symbol);
+    CTICKER_PROBE2(parse__done, symbol, 1);
+    return 0;
+}
+
+/**
+ * @brief Fetch the best bid/ask of every pair.
+ *
+ * Endpoint returns a JSON array of objects with fields like:
+ * - symbol
+ * - bidPrice / askPrice
+ */
+int fetch_book_tickers(BookQuote **quotes, int *count) {
+    ResponseBuffer response = {0};
+    *quotes = NULL;
+    *count = 0;
+
+    if (http_get("*", BINANCE_BOOK_TICKER_URL, API_WEIGHT_BOOK_TICKER_ALL, &response) != 0) {
+        return -1;
+    }
+
+    uint64_t span = trace_begin();
+    json_error_t error;
+    json_t *root = json_loads(response.data, 0, &error);
+    free(response.data);
+    if (!root || !json_is_array(root)) {
+        json_decref(root);
+        trace_end("parse", span, "bookTicker");
+        CTICKER_PROBE2(parse__done, "*", -1);
+        return -1;
+    }
+
+    size_t size = json_array_size(root);
+    BookQuote *out = calloc(size > 0 ? size : 1, sizeof(BookQuote));
+    if (!out) {
+        json_decref(root);
+        trace_end("parse", span, "bookTicker");
+        CTICKER_PROBE2(parse__done, "*", -1);
+        return -1;
+    }
+
+    int valid = 0;
+    for (size_t i = 0; i < size; i++) {
+        json_t *item = json_array_get(root, i);
+        json_t *symbol_json = json_object_get(item, "symbol");
+        json_t *bid_json = json_object_get(item, "bidPrice");
+        json_t *ask_json = json_object_get(item, "askPrice");
+        if (!json_is_string(symbol_json) || !json_is_string(bid_json) ||
+            !json_is_string(ask_json) ||
+            strlen(json_string_value(symbol_json)) >= MAX_SYMBOL_LEN) {
+            continue;
+        }
+        snprintf(out[valid].symbol, sizeof(out[valid].symbol), "%s",
+                 json_string_value(symbol_json));
+        out[valid].bid = atof(json_string_value(bid_json));
+        out[valid].ask = atof(json_string_value(ask_json));
+        valid++;
+    }
+
+    json_decref(root);
+    *quotes = out;
+    *count = valid;
+    trace_end("parse", span, "bookTicker");
+    CTICKER_PROBE2(parse__done, "*", valid);
+    return 0;
+}
+
+/**
+ * @brief Fetch a page of aggregated trades.
+ *
+ * Endpoint returns a JSON array of objects with fields like:
+ * - a: aggregate trade id
+ * - p / q: price and quantity (strings)
+ * - T: trade time (ms)
+ * - m: buyer is the maker
+ */
+int fetch_agg_trades(const char *symbol, uint64_t from_id, TradeSample **trades, int *count) {
+    char url[512];
+    ResponseBuffer response = {0};
+    *trades = NULL;
+    *count = 0;
+
+    int len = snprintf(url, sizeof(url), BINANCE_AGG_TRADES_URL, symbol);
+    if (from_id > 0 && len > 0 && (size_t)len < sizeof(url)) {
+        snprintf(url + len, sizeof(url) - (size_t)len, "&fromId=%llu",
+                 (unsigned long long)from_id);
+    }
+    if (http_get(symbol, url, API_WEIGHT_AGG_TRADES, &response) != 0) {
+        return -1;
+    }
+
+    uint64_t span = trace_begin();
+    json_error_t error;
+    json_t *root = json_loads(response.data, 0, &error);
+    free(response.data);
+    if (!root || !json_is_array(root)) {
+        json_decref(root);
+        trace_end("parse", span, "aggTrades");
+        CTICKER_PROBE2(parse__done, symbol, -1);
+        return -1;
+    }
+
+    size_t size = json_array_size(root);
+    TradeSample *out = calloc(size > 0 ? size : 1, sizeof(TradeSample));
+    if (!out) {
+        json_decref(root);
+        trace_end("parse", span, "aggTrades");
+        CTICKER_PROBE2(parse__done, symbol, -1);
+        return -1;
+    }
+
+    int valid = 0;
+    for (size_t i = 0; i < size; i++) {
+        json_t *item = json_array_get(root, i);
+        json_t *id_json = json_object_get(item, "a");
+        json_t *price_json = json_object_get(item, "p");
+        json_t *qty_json = json_object_get(item, "q");
+        json_t *time_json = json_object_get(item, "T");
+        if (!json_is_integer(id_json) || !json_is_string(price_json) ||
+            !json_is_string(qty_json) || !json_is_integer(time_json)) {
+            continue;
+        }
+        out[valid].id = (uint64_t)json_integer_value(id_json);
+        out[valid].time_ms = (uint64_t)json_integer_value(time_json);
+        out[valid].price = atof(json_string_value(price_json));
+        out[valid].quantity = atof(json_string_value(qty_json));
+        out[valid].buyer_maker = json_is_true(json_object_get(item, "m"));
+        valid++;
+    }
+
+    json_decref(root);
+    *trades = out;
+    *count = valid;
+    trace_end("parse", span, "aggTrades");
+    CTICKER_PROBE2(parse__done, symbol, valid);
     return 0;
 }
 
@@ -211,41 +487,35 @@ int fetch_ticker_data(const char *symbol, TickerData *data) {
  * responses (also keeps rendering and parsing fast).
  */
 static void get_interval_params(Period period, const char **interval, int *limit) {
+    *interval = period_interval_code(period);
     switch (period) {
         case PERIOD_1MIN:
-            *interval = "1m";
             *limit = 240;  // 4 hours of 1-minute candles
             break;
         case PERIOD_15MIN:
-            *interval = "15m";
             *limit = 192;  // 2 days of 15-minute candles
             break;
         case PERIOD_1HOUR:
-            *interval = "1h";
             *limit = 168;  // 1 week of hourly candles
             break;
         case PERIOD_4HOUR:
-            *interval = "4h";
             *limit = 180;  // ~30 days of 4-hour candles
             break;
         case PERIOD_1DAY:
-            *interval = "1d";
             *limit = 120;  // ~4 months of daily candles
             break;
         case PERIOD_1WEEK:
-            *interval = "1w";
             *limit = 104;  // 2 years of weekly candles
             break;
         case PERIOD_1MONTH:
         default:
-            *interval = "1M";
             *limit = 120;  // 10 years of monthly candles
             break;
     }
 }
 
 /**
- * @brief Fetch historical kline data from Binance.
+ * @brief Download and parse a Binance klines response.
  *
  * The response is a JSON array of arrays. For each kline we read:
  * - [0] open time (ms)
@@ -260,43 +530,23 @@ static void get_interval_params(Period period, const char **interval, int *limit
  * - [9] taker buy base asset volume
  * - [10] taker buy quote asset volume
  */
-int fetch_historical_data(const char *symbol, Period period,
-                          PricePoint **points, int *count) {
-    CURL *curl;
-    CURLcode res;
-    char url[512];
+static int fetch_klines(const char *symbol, const char *url, PricePoint **points,
+                        int *count) {
     ResponseBuffer response = {0};
-    const char *interval = "15m";
-    int limit = 96;
-    
-    get_interval_params(period, &interval, &limit);
-    snprintf(url, sizeof(url), BINANCE_KLINES_URL, symbol, interval, limit);
-    
-    curl = curl_easy_init();
-    if (!curl) {
-        return -1;
-    }
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&response);
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 10L);
-    
-    res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK) {
-        free(response.data);
+    if (http_get(symbol, url, API_WEIGHT_KLINES, &response) != 0) {
         return -1;
     }
     
     /* Parse JSON response (expected to be an array). */
+    uint64_t span = trace_begin();
     json_error_t error;
     json_t *root = json_loads(response.data, 0, &error);
     free(response.data);
     
     if (!root || !json_is_array(root)) {
         if (root) json_decref(root);
+        trace_end("parse", span, "klines");
+        CTICKER_PROBE2(parse__done, symbol, -1);
         return -1;
     }
     
@@ -308,6 +558,8 @@ int fetch_historical_data(const char *symbol, Period period,
     *points = malloc(sizeof(PricePoint) * array_size);
     if (!*points) {
         json_decref(root);
+        trace_end("parse", span, "klines");
+        CTICKER_PROBE2(parse__done, symbol, -1);
         return -1;
     }
     
@@ -356,5 +608,41 @@ int fetch_historical_data(const char *symbol, Period period,
     }
     
     json_decref(root);
+    trace_end("parse", span, "klines");
+    CTICKER_PROBE2(parse__done, symbol, *count);
     return 0;
 }
+
+int fetch_historical_data(const char *symbol, Period period,
+                          PricePoint **points, int *count) {
+    char url[512];
+    const char *interval = "15m";
+    int limit = 96;
+    
+    get_interval_params(period, &interval, &limit);
+    snprintf(url, sizeof(url), BINANCE_KLINES_URL, symbol, interval, limit);
+    return fetch_klines(symbol, url, points, count);
+}
+
+/**
+ * @brief Fetch candles whose open time lies in [start_time, end_time].
+ *
+ * Binance returns at most @p limit (<= 1000) candles from @p start_time
+ * onwards; callers page by advancing @p start_time past the last result.
+ */
+int fetch_historical_range(const char *symbol, Period period,
+                           uint64_t start_time, uint64_t end_time, int limit,
+                           PricePoint **points, int *count) {
+    char url[640];
+    if (limit <= 0 || limit > 1000) {
+        limit = 1000;
+    }
+    int written = snprintf(url, sizeof(url), BINANCE_KLINES_RANGE_URL, symbol,
+                           period_interval_code(period), limit,
+                           (unsigned long long)start_time * 1000ULL);
+    if (end_time > 0 && written > 0 && (size_t)written < sizeof(url)) {
+        snprintf(url + written, sizeof(url) - (size_t)written, BINANCE_KLINES_RANGE_END,
+                 (unsigned long long)end_time * 1000ULL + 999ULL);
+    }
+    return fetch_klines(symbol, url, points, count);
+}
@@ -0,0 +1,504 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file arbitrage.c
+ * @brief Triangular arbitrage detection on the all-pair bid/ask graph.
+ *
+ * Assets are nodes and pairs are edges. Every triangle is enumerated once
+ * when the graph is built (merging the sorted neighbour lists of each
+ * edge's endpoints) and indexed by the edges it uses. A poll of the book
+ * ticker then touches only the pairs whose bid/ask moved, and each of
+ * those only re-evaluates the cycles through it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "arbitrage.h"
+#include "portfolio.h"
+
+/**
+ * @brief Neighbour entry of the adjacency lists.
+ */
+typedef struct {
+    int asset;
+    int edge;
+} ArbNeighbour;
+
+// qsort/bsearch comparators for asset names, edges and neighbour entries.
+static int compare_names(const void *a, const void *b) {
+    return strcmp((const char *)a, (const char *)b);
+}
+
+static int compare_edges(const void *a, const void *b) {
+    return strcmp(((const ArbEdge *)a)->symbol, ((const ArbEdge *)b)->symbol);
+}
+
+static int compare_neighbours(const void *a, const void *b) {
+    const ArbNeighbour *x = a;
+    const ArbNeighbour *y = b;
+    return x->asset != y->asset ? (x->asset < y->asset ? -1 : 1) : (x->edge - y->edge);
+}
+
+// Asset id of @p name (assets are sorted), or -1.
+static int find_asset(const ArbGraph *graph, const char *name) {
+    const char (*found)[MAX_SYMBOL_LEN] = bsearch(name, graph->assets, (size_t)graph->asset_count,
+                                                  MAX_SYMBOL_LEN, compare_names);
+    return found ? (int)(found - graph->assets) : -1;
+}
+
+// Conversion rate of one leg; 0 when the side it needs has no quote.
+static double leg_rate(const ArbEdge *edge, bool sell) {
+    if (sell) {
+        return edge->bid > 0.0 ? edge->bid : 0.0;
+    }
+    return edge->ask > 0.0 ? 1.0 / edge->ask : 0.0;
+}
+
+// Recompute one cycle and move it in or out of the flagged set.
+static void evaluate_cycle(ArbGraph *graph, int id) {
+    ArbCycle *cycle = &graph->cycles[id];
+    double rate = graph->fee_factor;
+    for (int k = 0; k < 3; k++) {
+        rate *= leg_rate(&graph->edges[cycle->edges[k]], (cycle->sells >> k) & 1u);
+    }
+    cycle->rate = rate;
+
+    int slot = graph->flagged_slot[id];
+    bool flagged = rate > graph->min_rate;
+    if (flagged && slot < 0) {
+        graph->flagged_slot[id] = graph->flagged_count;
+        graph->flagged[graph->flagged_count++] = id;
+    } else if (!flagged && slot >= 0) {
+        int last = graph->flagged[--graph->flagged_count];
+        graph->flagged[slot] = last;
+        graph->flagged_slot[last] = slot;
+        graph->flagged_slot[id] = -1;
+    }
+    graph->evaluations++;
+}
+
+// Append the cycle a -> b -> c -> a over edges ab, bc, ca.
+static int add_cycle(ArbGraph *graph, int *capacity, const int assets[3], const int edges[3]) {
+    if (graph->cycle_count == *capacity) {
+        int grown_capacity = *capacity ? *capacity * 2 : 256;
+        ArbCycle *grown = realloc(graph->cycles, (size_t)grown_capacity * sizeof(ArbCycle));
+        if (!grown) {
+            return -1;
+        }
+        graph->cycles = grown;
+        *capacity = grown_capacity;
+    }
+    ArbCycle *cycle = &graph->cycles[graph->cycle_count++];
+    memset(cycle, 0, sizeof(*cycle));
+    for (int k = 0; k < 3; k++) {
+        cycle->assets[k] = assets[k];
+        cycle->edges[k] = edges[k];
+        if (graph->edges[edges[k]].base == assets[k]) {
+            cycle->sells |= 1u << k;
+        }
+    }
+    return 0;
+}
+
+// Intern the base/quote assets of every recognised pair.
+static int build_assets(ArbGraph *graph, const BookQuote *quotes, int count) {
+    graph->assets = malloc((size_t)(2 * count + 1) * MAX_SYMBOL_LEN);
+    graph->edges = malloc((size_t)(count + 1) * sizeof(ArbEdge));
+    if (!graph->assets || !graph->edges) {
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        char base[MAX_SYMBOL_LEN];
+        char quote[MAX_SYMBOL_LEN];
+        if (portfolio_split_symbol(quotes[i].symbol, base, sizeof(base), quote,
+                                   sizeof(quote)) != 0) {
+            continue;
+        }
+        ArbEdge *edge = &graph->edges[graph->edge_count++];
+        memset(edge, 0, sizeof(*edge));
+        snprintf(edge->symbol, sizeof(edge->symbol), "%s", quotes[i].symbol);
+        edge->bid = quotes[i].bid;
+        edge->ask = quotes[i].ask;
+        memcpy(graph->assets[graph->asset_count++], base, MAX_SYMBOL_LEN);
+        memcpy(graph->assets[graph->asset_count++], quote, MAX_SYMBOL_LEN);
+    }
+
+    qsort(graph->assets, (size_t)graph->asset_count, MAX_SYMBOL_LEN, compare_names);
+    int unique = 0;
+    for (int i = 0; i < graph->asset_count; i++) {
+        if (unique == 0 || strcmp(graph->assets[i], graph->assets[unique - 1]) != 0) {
+            memmove(graph->assets[unique++], graph->assets[i], MAX_SYMBOL_LEN);
+        }
+    }
+    graph->asset_count = unique;
+
+    qsort(graph->edges, (size_t)graph->edge_count, sizeof(ArbEdge), compare_edges);
+    for (int e = 0; e < graph->edge_count; e++) {
+        char base[MAX_SYMBOL_LEN];
+        char quote[MAX_SYMBOL_LEN];
+        portfolio_split_symbol(graph->edges[e].symbol, base, sizeof(base), quote, sizeof(quote));
+        graph->edges[e].base = find_asset(graph, base);
+        graph->edges[e].quote = find_asset(graph, quote);
+    }
+    return 0;
+}
+
+/*
+ * Enumerate each triangle once: for every edge (a, b) with a < b, the
+ * common neighbours w > b of a and b close a triangle, which yields the
+ * two cycles a -> b -> w and a -> w -> b.
+ */
+static int build_cycles(ArbGraph *graph) {
+    int n = graph->asset_count;
+    int *start = calloc((size_t)n + 1, sizeof(int));
+    ArbNeighbour *adjacent = malloc((size_t)(2 * graph->edge_count + 1) * sizeof(ArbNeighbour));
+    int *fill = calloc((size_t)n + 1, sizeof(int));
+    int status = -1;
+    int capacity = 0;
+    if (!start || !adjacent || !fill) {
+        goto done;
+    }
+    for (int e = 0; e < graph->edge_count; e++) {
+        start[graph->edges[e].base + 1]++;
+        start[graph->edges[e].quote + 1]++;
+    }
+    for (int a = 0; a < n; a++) {
+        start[a + 1] += start[a];
+    }
+    for (int e = 0; e < graph->edge_count; e++) {
+        const ArbEdge *edge = &graph->edges[e];
+        adjacent[start[edge->base] + fill[edge->base]++] = (ArbNeighbour){edge->quote, e};
+        adjacent[start[edge->quote] + fill[edge->quote]++] = (ArbNeighbour){edge->base, e};
+    }
+    for (int a = 0; a < n; a++) {
+        qsort(adjacent + start[a], (size_t)(start[a + 1] - start[a]), sizeof(ArbNeighbour),
+              compare_neighbours);
+    }
+
+    for (int e = 0; e < graph->edge_count; e++) {
+        int a = graph->edges[e].base;
+        int b = graph->edges[e].quote;
+        if (a > b) {
+            int tmp = a;
+            a = b;
+            b = tmp;
+        }
+        int i = start[a];
+        int j = start[b];
+        while (i < start[a + 1] && j < start[b + 1]) {
+            int wa = adjacent[i].asset;
+            int wb = adjacent[j].asset;
+            if (wa <= b || wa < wb) {
+                i++;
+            } else if (wb < wa) {
+                j++;
+            } else {
+                /* Pairs listed twice between the same assets give one triangle each. */
+                int i_end = i;
+                int j_end = j;
+                while (i_end < start[a + 1] && adjacent[i_end].asset == wa) {
+                    i_end++;
+                }
+                while (j_end < start[b + 1] && adjacent[j_end].asset == wa) {
+                    j_end++;
+                }
+                for (int x = i; x < i_end; x++) {
+                    for (int y = j; y < j_end; y++) {
+                        int forward_assets[3] = {a, b, wa};
+                        int forward_edges[3] = {e, adjacent[y].edge, adjacent[x].edge};
+                        int reverse_assets[3] = {a, wa, b};
+                        int reverse_edges[3] = {adjacent[x].edge, adjacent[y].edge, e};
+                        if (add_cycle(graph, &capacity, forward_assets, forward_edges) != 0 ||
+                            add_cycle(graph, &capacity, reverse_assets, reverse_edges) != 0) {
+                            goto done;
+                        }
+                    }
+                }
+                i = i_end;
+                j = j_end;
+            }
+        }
+    }
+    status = 0;
+
+done:
+    free(start);
+    free(adjacent);
+    free(fill);
+    return status;
+}
+
+// Invert the cycle -> edges relation into per-edge cycle lists.
+static int build_index(ArbGraph *graph) {
+    size_t cycles = (size_t)graph->cycle_count;
+    graph->edge_cycle_start = calloc((size_t)graph->edge_count + 1, sizeof(int));
+    graph->edge_cycles = malloc((3 * cycles + 1) * sizeof(int));
+    graph->flagged = malloc((cycles + 1) * sizeof(int));
+    graph->flagged_slot = malloc((cycles + 1) * sizeof(int));
+    int *fill = calloc((size_t)graph->edge_count + 1, sizeof(int));
+    if (!graph->edge_cycle_start || !graph->edge_cycles || !graph->flagged ||
+        !graph->flagged_slot || !fill) {
+        free(fill);
+        return -1;
+    }
+    for (int c = 0; c < graph->cycle_count; c++) {
+        for (int k = 0; k < 3; k++) {
+            graph->edge_cycle_start[graph->cycles[c].edges[k] + 1]++;
+        }
+        graph->flagged_slot[c] = -1;
+    }
+    for (int e = 0; e < graph->edge_count; e++) {
+        graph->edge_cycle_start[e + 1] += graph->edge_cycle_start[e];
+    }
+    for (int c = 0; c < graph->cycle_count; c++) {
+        for (int k = 0; k < 3; k++) {
+            int e = graph->cycles[c].edges[k];
+            graph->edge_cycles[graph->edge_cycle_start[e] + fill[e]++] = c;
+        }
+    }
+    free(fill);
+    return 0;
+}
+
+// Build assets, edges, cycles and the edge -> cycle index, then rate every cycle.
+int arb_graph_build(ArbGraph *graph, const BookQuote *quotes, int count, double fee,
+                    double threshold) {
+    memset(graph, 0, sizeof(*graph));
+    double keep = 1.0 - fee;
+    graph->fee_factor = keep * keep * keep;
+    graph->min_rate = 1.0 + threshold;
+    if (build_assets(graph, quotes, count) != 0 || build_cycles(graph) != 0 ||
+        build_index(graph) != 0) {
+        arb_graph_free(graph);
+        return -1;
+    }
+    for (int c = 0; c < graph->cycle_count; c++) {
+        evaluate_cycle(graph, c);
+    }
+    return 0;
+}
+
+// Release the graph arrays.
+void arb_graph_free(ArbGraph *graph) {
+    free(graph->assets);
+    free(graph->edges);
+    free(graph->cycles);
+    free(graph->edge_cycle_start);
+    free(graph->edge_cycles);
+    free(graph->flagged);
+    free(graph->flagged_slot);
+    memset(graph, 0, sizeof(*graph));
+}
+
+// Binary search over the symbol-sorted edges.
+int arb_graph_find(const ArbGraph *graph, const char *symbol) {
+    ArbEdge key;
+    snprintf(key.symbol, sizeof(key.symbol), "%s", symbol);
+    const ArbEdge *found = bsearch(&key, graph->edges, (size_t)graph->edge_count,
+                                   sizeof(ArbEdge), compare_edges);
+    return found ? (int)(found - graph->edges) : -1;
+}
+
+// Store the new quote and re-rate only the cycles indexed under @p edge.
+int arb_graph_update(ArbGraph *graph, int edge, double bid, double ask) {
+    graph->edges[edge].bid = bid;
+    graph->edges[edge].ask = ask;
+    int first = graph->edge_cycle_start[edge];
+    int last = graph->edge_cycle_start[edge + 1];
+    for (int i = first; i < last; i++) {
+        evaluate_cycle(graph, graph->edge_cycles[i]);
+    }
+    return last - first;
+}
+
+// Best flagged cycles by rate.
+int arb_graph_top(const ArbGraph *graph, int *cycles, int max) {
+    /* Insertion into a short sorted list; the flagged set is small. */
+    int count = 0;
+    for (int i = 0; i < graph->flagged_count; i++) {
+        int id = graph->flagged[i];
+        double rate = graph->cycles[id].rate;
+        int pos = count < max ? count : max;
+        while (pos > 0 && graph->cycles[cycles[pos - 1]].rate < rate) {
+            if (pos < max) {
+                cycles[pos] = cycles[pos - 1];
+            }
+            pos--;
+        }
+        if (pos < max) {
+            cycles[pos] = id;
+            if (count < max) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+/* ---- Background detector ---- */
+
+// Apply one poll; the first one builds the graph.
+static int apply_quotes(ArbitrageDetector *detector, const BookQuote *quotes, int count,
+                        int *changed, int *evaluated) {
+    ArbGraph *graph = &detector->graph;
+    *changed = 0;
+    *evaluated = 0;
+    if (!graph->edges) {
+        if (arb_graph_build(graph, quotes, count, detector->fee, detector->threshold) != 0) {
+            return -1;
+        }
+        *changed = graph->edge_count;
+        *evaluated = graph->cycle_count;
+    }
+
+    if (count > detector->quote_edge_count) {
+        int *grown = realloc(detector->quote_edges, (size_t)count * sizeof(int));
+        if (!grown) {
+            return -1;
+        }
+        for (int i = detector->quote_edge_count; i < count; i++) {
+            grown[i] = -1;
+        }
+        detector->quote_edges = grown;
+        detector->quote_edge_count = count;
+    }
+    for (int i = 0; i < count; i++) {
+        /* The exchange lists pairs in a stable order, so the cached edge usually matches. */
+        int edge = detector->quote_edges[i];
+        if (edge < 0 || strcmp(graph->edges[edge].symbol, quotes[i].symbol) != 0) {
+            edge = arb_graph_find(graph, quotes[i].symbol);
+            detector->quote_edges[i] = edge;
+        }
+        if (edge < 0) {
+            continue;
+        }
+        const ArbEdge *current = &graph->edges[edge];
+        if (current->bid != quotes[i].bid || current->ask != quotes[i].ask) {
+            *evaluated += arb_graph_update(graph, edge, quotes[i].bid, quotes[i].ask);
+            (*changed)++;
+        }
+    }
+    return 0;
+}
+
+// Copy the best flagged cycles into the published state (mutex held).
+static void publish(ArbitrageDetector *detector, int changed, int evaluated) {
+    const ArbGraph *graph = &detector->graph;
+    ArbitrageSnapshot *out = &detector->published;
+    int top[ARBITRAGE_MAX_SHOWN];
+    out->shown_count = arb_graph_top(graph, top, ARBITRAGE_MAX_SHOWN);
+    for (int i = 0; i < out->shown_count; i++) {
+        const ArbCycle *cycle = &graph->cycles[top[i]];
+        ArbOpportunity *opportunity = &out->shown[i];
+        for (int k = 0; k < 3; k++) {
+            snprintf(opportunity->assets[k], MAX_SYMBOL_LEN, "%s",
+                     graph->assets[cycle->assets[k]]);
+            snprintf(opportunity->symbols[k], MAX_SYMBOL_LEN, "%s",
+                     graph->edges[cycle->edges[k]].symbol);
+            opportunity->sells[k] = (cycle->sells >> k) & 1u;
+        }
+        opportunity->profit = cycle->rate - 1.0;
+    }
+    out->status = ARBITRAGE_READY;
+    out->stale = false;
+    out->pair_count = graph->edge_count;
+    out->asset_count = graph->asset_count;
+    out->cycle_count = graph->cycle_count;
+    out->flagged_count = graph->flagged_count;
+    out->changed_pairs = changed;
+    out->evaluated_cycles = evaluated;
+    out->updated = (uint64_t)time(NULL);
+}
+
+// Worker loop: poll, apply the changed quotes, publish, sleep.
+static void *arbitrage_worker(void *arg) {
+    ArbitrageDetector *detector = arg;
+    while (!atomic_load(&detector->stop)) {
+        BookQuote *quotes = NULL;
+        int count = 0;
+        int changed = 0;
+        int evaluated = 0;
+        bool ok = fetch_book_tickers(&quotes, &count) == 0 &&
+                  apply_quotes(detector, quotes, count, &changed, &evaluated) == 0;
+        free(quotes);
+
+        pthread_mutex_lock(&detector->mutex);
+        if (ok) {
+            publish(detector, changed, evaluated);
+        } else if (detector->published.status == ARBITRAGE_READY) {
+            detector->published.stale = true;
+        } else {
+            detector->published.status = ARBITRAGE_FAILED;
+        }
+        pthread_mutex_unlock(&detector->mutex);
+
+        for (int i = 0; i < ARBITRAGE_REFRESH_SECONDS && !atomic_load(&detector->stop); i++) {
+            sleep(1);
+        }
+    }
+    return NULL;
+}
+
+// Reset the detector and start its worker.
+int arbitrage_start(ArbitrageDetector *detector, const Config *config) {
+    memset(detector, 0, sizeof(*detector));
+    pthread_mutex_init(&detector->mutex, NULL);
+    atomic_init(&detector->stop, false);
+    detector->fee = config->arbitrage_fee / 100.0;
+    detector->threshold = config->arbitrage_threshold / 100.0;
+    detector->published.status = ARBITRAGE_LOADING;
+    detector->published.fee_pct = config->arbitrage_fee;
+    detector->published.threshold_pct = config->arbitrage_threshold;
+    if (pthread_create(&detector->thread, NULL, arbitrage_worker, detector) != 0) {
+        detector->published.status = ARBITRAGE_FAILED;
+        return -1;
+    }
+    detector->thread_started = true;
+    return 0;
+}
+
+// Join the worker and free what it owned.
+void arbitrage_stop(ArbitrageDetector *detector) {
+    if (detector->thread_started) {
+        atomic_store(&detector->stop, true);
+        pthread_join(detector->thread, NULL);
+        detector->thread_started = false;
+    }
+    arb_graph_free(&detector->graph);
+    free(detector->quote_edges);
+    detector->quote_edges = NULL;
+    detector->quote_edge_count = 0;
+    pthread_mutex_destroy(&detector->mutex);
+}
+
+// Copy the published state for rendering.
+void arbitrage_snapshot(ArbitrageDetector *detector, ArbitrageSnapshot *snapshot) {
+    pthread_mutex_lock(&detector->mutex);
+    *snapshot = detector->published;
+    pthread_mutex_unlock(&detector->mutex);
+}
@@ -0,0 +1,191 @@
+#ifndef CTICKER_ARBITRAGE_H
+#define CTICKER_ARBITRAGE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/** Seconds between book ticker polls. */
+#define ARBITRAGE_REFRESH_SECONDS 5
+/** Flagged cycles published to the UI, most profitable first. */
+#define ARBITRAGE_MAX_SHOWN 64
+
+/**
+ * @brief A pair as an edge between its base and quote asset.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    int base;
+    int quote;
+    double bid;
+    double ask;
+} ArbEdge;
+
+/**
+ * @brief One direction around a triangle of assets.
+ *
+ * Leg k converts assets[k] into assets[(k + 1) % 3] over edges[k]: it
+ * sells at the bid when assets[k] is the edge's base and buys at the ask
+ * otherwise.
+ */
+typedef struct {
+    int assets[3];
+    int edges[3];
+    /** Bit k set when leg k sells (base -> quote). */
+    unsigned sells;
+    /** Units of assets[0] returned per unit put in, after fees (0 when a quote is missing). */
+    double rate;
+} ArbCycle;
+
+/**
+ * @brief Currency graph with every triangle precomputed.
+ *
+ * Each edge keeps the list of cycles running through it, so a bid/ask
+ * change re-evaluates only those cycles (a handful per pair) instead of
+ * the whole graph. Flagged cycles are kept in an unordered set with O(1)
+ * insertion and removal.
+ */
+typedef struct {
+    /** Asset names, sorted. */
+    char (*assets)[MAX_SYMBOL_LEN];
+    int asset_count;
+    /** Edges sorted by symbol. */
+    ArbEdge *edges;
+    int edge_count;
+    ArbCycle *cycles;
+    int cycle_count;
+    /** Cycles through edge e: edge_cycles[edge_cycle_start[e] .. edge_cycle_start[e + 1]). */
+    int *edge_cycle_start;
+    int *edge_cycles;
+    /** Fee multiplier of a full cycle, (1 - fee)^3. */
+    double fee_factor;
+    /** Rate a cycle must exceed to be flagged (1 + threshold). */
+    double min_rate;
+    /** Flagged cycle ids, and each cycle's slot there (-1 when not flagged). */
+    int *flagged;
+    int *flagged_slot;
+    int flagged_count;
+    /** Cycle evaluations since the graph was built. */
+    uint64_t evaluations;
+} ArbGraph;
+
+/**
+ * @brief Build the graph from the pairs in @p quotes and evaluate every cycle.
+ *
+ * Pairs whose quote asset is not recognised are skipped.
+ *
+ * @param[in] fee Fee per leg as a fraction (0.001 = 0.1%).
+ * @param[in] threshold Net profit a cycle must exceed, as a fraction.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int arb_graph_build(ArbGraph *graph, const BookQuote *quotes, int count, double fee,
+                    double threshold);
+
+/**
+ * @brief Release memory owned by @p graph.
+ */
+void arb_graph_free(ArbGraph *graph);
+
+/**
+ * @brief Edge index of @p symbol, or -1 when it is not in the graph.
+ */
+int arb_graph_find(const ArbGraph *graph, const char *symbol);
+
+/**
+ * @brief Apply a new bid/ask to @p edge and re-evaluate the cycles through it.
+ * @return Number of cycles re-evaluated.
+ */
+int arb_graph_update(ArbGraph *graph, int edge, double bid, double ask);
+
+/**
+ * @brief Write up to @p max flagged cycle ids, most profitable first.
+ * @return Number of ids written.
+ */
+int arb_graph_top(const ArbGraph *graph, int *cycles, int max);
+
+/** Detector progress shown by the UI. */
+typedef enum {
+    ARBITRAGE_LOADING,
+    ARBITRAGE_READY,
+    ARBITRAGE_FAILED
+} ArbitrageStatus;
+
+/**
+ * @brief A flagged cycle, self-contained for rendering.
+ */
+typedef struct {
+    char assets[3][MAX_SYMBOL_LEN];
+    char symbols[3][MAX_SYMBOL_LEN];
+    bool sells[3];
+    /** Net profit after fees as a fraction. */
+    double profit;
+} ArbOpportunity;
+
+/**
+ * @brief State published by the detector after every poll.
+ */
+typedef struct {
+    ArbitrageStatus status;
+    /** The last poll failed; figures are from the one before. */
+    bool stale;
+    int pair_count;
+    int asset_count;
+    int cycle_count;
+    /** Flagged cycles (may exceed the ones listed). */
+    int flagged_count;
+    ArbOpportunity shown[ARBITRAGE_MAX_SHOWN];
+    int shown_count;
+    /** Pairs whose bid/ask changed, and cycles re-evaluated, in the last poll. */
+    int changed_pairs;
+    int evaluated_cycles;
+    /** Fee per leg and threshold, in percent. */
+    double fee_pct;
+    double threshold_pct;
+    /** Time of the last successful poll. */
+    uint64_t updated;
+} ArbitrageSnapshot;
+
+/**
+ * @brief Background worker polling the all-pair book ticker.
+ *
+ * The graph is owned by the worker thread; results are published into
+ * ::ArbitrageDetector::published under the mutex.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_t thread;
+    bool thread_started;
+    atomic_bool stop;
+    double fee;
+    double threshold;
+    ArbGraph graph;
+    /** Position in the previous poll -> edge, to skip lookups while the order holds. */
+    int *quote_edges;
+    int quote_edge_count;
+    ArbitrageSnapshot published;
+} ArbitrageDetector;
+
+/**
+ * @brief Start polling with @p config's fee and threshold.
+ * @return 0 on success, -1 if the thread could not be created.
+ */
+int arbitrage_start(ArbitrageDetector *detector, const Config *config);
+
+/**
+ * @brief Stop and join the worker and release the graph.
+ */
+void arbitrage_stop(ArbitrageDetector *detector);
+
+/**
+ * @brief Copy the published state (takes the detector mutex).
+ */
+void arbitrage_snapshot(ArbitrageDetector *detector, ArbitrageSnapshot *snapshot);
+
+/**
+ * @brief Render the opportunity list with @p selected highlighted.
+ */
+void draw_arbitrage_screen(const ArbitrageSnapshot *snapshot, int selected);
+
+#endif
@@ -0,0 +1,455 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file backfill.c
+ * @brief `cticker backfill`: page historical klines into the candle store.
+ *
+ * Each symbol is handled by one worker thread which walks forward from the
+ * requested start (or the last stored candle, whichever is newer) in pages
+ * of up to 1000 candles and merges every page into the store as soon as it
+ * arrives. An interrupted run therefore resumes where it stopped. Holes
+ * inside the already stored range (outages, partial imports) are detected
+ * from candle continuity and fetched first, one small request per gap, as
+ * is any history between the requested start and the first stored candle
+ * (left by a shorter earlier run or an import). All
+ * workers share the api.c request limiter, so adding jobs only helps until
+ * the request budget becomes the bottleneck.
+ *
+ * Example:
+ *   cticker backfill --interval 1m --days 30 --jobs 4
+ */
+
+#include <curl/curl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "candle_gaps.h"
+#include "candle_store.h"
+#include "commands.h"
+
+// Candles per REST request (Binance maximum).
+#define BACKFILL_PAGE_LIMIT 1000
+#define BACKFILL_DEFAULT_DAYS 30
+#define BACKFILL_DEFAULT_JOBS 4
+#define BACKFILL_MAX_JOBS 16
+// Attempts per page before a symbol is reported as failed.
+#define BACKFILL_MAX_RETRIES 3
+// Gaps (the leading range included) repaired per symbol and run.
+#define BACKFILL_MAX_GAPS 256
+
+/**
+ * @brief Work item and result for one symbol.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    /** First open time to fetch (after resuming). */
+    uint64_t start;
+    /** Estimated candles between start and now (for progress only). */
+    uint64_t expected;
+    /** Candles received so far. */
+    atomic_ulong fetched;
+    /** Candles that were new to the store. */
+    long added;
+    /** Candles already stored before this run. */
+    uint64_t existing;
+    /** Gaps found before and inside the stored range. */
+    size_t gaps;
+    /** 0 on success, -1 on failure. */
+    int status;
+    atomic_bool done;
+} BackfillJob;
+
+/**
+ * @brief Shared state of one backfill run.
+ */
+typedef struct {
+    BackfillJob *jobs;
+    int job_count;
+    atomic_int next;
+    Period period;
+    uint64_t from;
+    uint64_t now;
+} BackfillQueue;
+
+static volatile sig_atomic_t backfill_stop = 0;
+
+// SIGINT/SIGTERM: finish the current page, then stop.
+static void backfill_signal_handler(int signo) {
+    (void)signo;
+    backfill_stop = 1;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Round down to the period grid (weeks/months are left as-is; Binance snaps).
+static uint64_t align_start(uint64_t timestamp, Period period) {
+    uint64_t spacing = period_seconds(period);
+    if (spacing == 0 || spacing >= 7 * 24 * 60 * 60) {
+        return timestamp;
+    }
+    return timestamp - timestamp % spacing;
+}
+
+/**
+ * @brief Fetch the range before the first stored candle and the holes
+ *        inside the stored range, and merge them at once.
+ */
+static int backfill_gaps(BackfillQueue *queue, BackfillJob *job, CandleStore *store) {
+    CandleGap gaps[BACKFILL_MAX_GAPS];
+    job->gaps = 0;
+    if (store->records[0].timestamp > queue->from) {
+        gaps[0].start = queue->from;
+        gaps[0].end = store->records[0].timestamp - 1;
+        job->gaps = 1;
+    }
+
+    size_t first = candle_store_lower_bound(store, queue->from);
+    if (first > 0) {
+        first--;
+    }
+    size_t lead = job->gaps;
+    size_t found = candle_gaps_find_records(store->records + first,
+                                            (size_t)store->count - first,
+                                            gaps + lead, BACKFILL_MAX_GAPS - lead);
+    for (size_t g = lead; g < lead + found; g++) {
+        if (gaps[g].end >= queue->from) {
+            gaps[job->gaps++] = gaps[g];
+        }
+    }
+
+    CandleRecord *records = NULL;
+    size_t count = 0;
+    int status = 0;
+    for (size_t g = 0; g < job->gaps && !backfill_stop; g++) {
+        PricePoint *points = NULL;
+        int n = 0;
+        if (candle_gaps_fetch(job->symbol, queue->period, &gaps[g], &points, &n, NULL) != 0) {
+            status = -1;
+            break;
+        }
+        CandleRecord *grown = n > 0 ? realloc(records, sizeof(CandleRecord) * (count + (size_t)n))
+                                    : records;
+        if (!grown) {
+            free(points);
+            status = -1;
+            break;
+        }
+        records = grown;
+        for (int i = 0; i < n; i++) {
+            candle_record_from_point(&records[count++], &points[i]);
+        }
+        free(points);
+    }
+
+    /* The leading range and the gaps are disjoint and ascending, so the
+     * batch is already sorted. */
+    if (count > 0) {
+        long added = candle_store_merge(store, records, count);
+        if (added < 0) {
+            status = -1;
+        } else {
+            job->added += added;
+            atomic_fetch_add(&job->fetched, (unsigned long)count);
+        }
+    }
+    free(records);
+    return status;
+}
+
+/**
+ * @brief Fetch and store every page for one symbol.
+ */
+static int backfill_symbol(BackfillQueue *queue, BackfillJob *job) {
+    job->start = queue->from;
+    CandleStore store;
+    if (candle_store_open(&store, job->symbol, queue->period, true) != 0) {
+        fprintf(stderr, "%s: cannot open candle store\n", job->symbol);
+        return -1;
+    }
+
+    job->existing = store.count;
+    if (store.count > 0 && backfill_gaps(queue, job, &store) != 0) {
+        fprintf(stderr, "%s: failed to fill gaps; rerun to retry\n", job->symbol);
+    }
+
+    /* Resume from the last stored candle; it may have been incomplete. */
+    if (store.count > 0 && store.records[store.count - 1].timestamp > job->start) {
+        job->start = store.records[store.count - 1].timestamp;
+    }
+    uint64_t spacing = period_seconds(queue->period);
+    uint64_t span = queue->now > job->start ? queue->now - job->start : 0;
+    job->expected = (spacing ? span / spacing : span / (28 * 24 * 60 * 60)) + 1;
+
+    CandleRecord *records = malloc(sizeof(CandleRecord) * BACKFILL_PAGE_LIMIT);
+    if (!records) {
+        candle_store_close(&store);
+        return -1;
+    }
+
+    int status = 0;
+    uint64_t cursor = job->start;
+    while (!backfill_stop && cursor <= queue->now) {
+        PricePoint *points = NULL;
+        int count = 0;
+        int attempt = 0;
+        while (fetch_historical_range(job->symbol, queue->period, cursor, 0,
+                                      BACKFILL_PAGE_LIMIT, &points, &count) != 0) {
+            if (++attempt >= BACKFILL_MAX_RETRIES || backfill_stop) {
+                status = -1;
+                break;
+            }
+            sleep((unsigned int)attempt);
+        }
+        if (status != 0) {
+            char at[32];
+            cli_format_time(at, sizeof(at), cursor);
+            fprintf(stderr, "%s: request failed at %s; rerun to resume\n", job->symbol, at);
+            break;
+        }
+        if (count > BACKFILL_PAGE_LIMIT) {
+            count = BACKFILL_PAGE_LIMIT;
+        }
+        for (int i = 0; i < count; i++) {
+            candle_record_from_point(&records[i], &points[i]);
+        }
+        free(points);
+        if (count == 0) {
+            break;
+        }
+
+        long added = candle_store_merge(&store, records, (size_t)count);
+        if (added < 0) {
+            fprintf(stderr, "%s: failed to write candle store\n", job->symbol);
+            status = -1;
+            break;
+        }
+        job->added += added;
+        atomic_fetch_add(&job->fetched, (unsigned long)count);
+
+        const CandleRecord *last = &records[count - 1];
+        uint64_t next = spacing ? last->timestamp + spacing : last->close_time + 1;
+        if (count < BACKFILL_PAGE_LIMIT || next <= cursor) {
+            break;
+        }
+        cursor = next;
+    }
+
+    free(records);
+    candle_store_close(&store);
+    return status;
+}
+
+static void *backfill_worker(void *arg) {
+    BackfillQueue *queue = arg;
+    for (;;) {
+        int index = atomic_fetch_add(&queue->next, 1);
+        if (index >= queue->job_count) {
+            break;
+        }
+        BackfillJob *job = &queue->jobs[index];
+        job->status = backfill_symbol(queue, job);
+        atomic_store(&job->done, true);
+    }
+    return NULL;
+}
+
+// Print one progress line (overwritten in place on a terminal).
+static void report_progress(const BackfillQueue *queue, double elapsed, bool final) {
+    unsigned long fetched = 0;
+    uint64_t expected = 0;
+    int done = 0;
+    for (int i = 0; i < queue->job_count; i++) {
+        BackfillJob *job = &queue->jobs[i];
+        fetched += atomic_load(&job->fetched);
+        expected += job->expected;
+        done += atomic_load(&job->done) ? 1 : 0;
+    }
+    double percent = expected ? 100.0 * (double)fetched / (double)expected : 0.0;
+    if (percent > 100.0) {
+        percent = 100.0;
+    }
+    fprintf(stderr, "\r%d/%d symbols, %lu candles (%.1f%%), %.0f candles/s%s", done,
+            queue->job_count, fetched, percent,
+            elapsed > 0.0 ? (double)fetched / elapsed : 0.0, final ? "\n" : "   ");
+    fflush(stderr);
+}
+
+static void print_backfill_usage(void) {
+    fprintf(stderr,
+            "Usage: cticker backfill [--interval INTERVAL] [--days N] [--jobs N] [SYMBOL...]\n"
+            "Defaults: --interval 1m --days 30, symbols from ~/.cticker.conf\n");
+}
+
+// Append @p symbol unless it is already queued.
+static void add_job(BackfillJob *jobs, int *job_count, const char *symbol) {
+    for (int i = 0; i < *job_count; i++) {
+        if (strcmp(jobs[i].symbol, symbol) == 0) {
+            return;
+        }
+    }
+    BackfillJob *job = &jobs[(*job_count)++];
+    snprintf(job->symbol, sizeof(job->symbol), "%s", symbol);
+    atomic_init(&job->fetched, 0);
+    atomic_init(&job->done, false);
+}
+
+int command_backfill(int argc, char *argv[]) {
+    Period period = PERIOD_1MIN;
+    long days = BACKFILL_DEFAULT_DAYS;
+    int jobs_wanted = BACKFILL_DEFAULT_JOBS;
+
+    int capacity = (argc > MAX_SYMBOLS ? argc : MAX_SYMBOLS);
+    BackfillJob *jobs = calloc((size_t)capacity, sizeof(BackfillJob));
+    if (!jobs) {
+        return 1;
+    }
+    int job_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (strcmp(arg, "--interval") == 0 && has_value) {
+            if (cli_parse_period(argv[++i], &period) != 0) {
+                free(jobs);
+                return 2;
+            }
+        } else if (strcmp(arg, "--days") == 0 && has_value) {
+            days = atol(argv[++i]);
+        } else if (strcmp(arg, "--jobs") == 0 && has_value) {
+            jobs_wanted = atoi(argv[++i]);
+        } else if (arg[0] == '-') {
+            print_backfill_usage();
+            free(jobs);
+            return 2;
+        } else {
+            add_job(jobs, &job_count, arg);
+        }
+    }
+
+    if (job_count == 0) {
+        Config config;
+        if (load_config(&config) != 0) {
+            fprintf(stderr, "Failed to load configuration\n");
+            free(jobs);
+            return 1;
+        }
+        for (int i = 0; i < config.symbol_count; i++) {
+            add_job(jobs, &job_count, config.symbols[i]);
+        }
+    }
+    if (job_count == 0 || days <= 0) {
+        print_backfill_usage();
+        free(jobs);
+        return 2;
+    }
+    if (jobs_wanted < 1) {
+        jobs_wanted = 1;
+    }
+    if (jobs_wanted > BACKFILL_MAX_JOBS) {
+        jobs_wanted = BACKFILL_MAX_JOBS;
+    }
+    if (jobs_wanted > job_count) {
+        jobs_wanted = job_count;
+    }
+
+    uint64_t now = (uint64_t)time(NULL);
+    uint64_t span = (uint64_t)days * 24 * 60 * 60;
+    BackfillQueue queue = {
+        .jobs = jobs,
+        .job_count = job_count,
+        .period = period,
+        .from = align_start(now > span ? now - span : 0, period),
+        .now = now,
+    };
+    atomic_init(&queue.next, 0);
+
+    /* curl's global state must be set up before threads use it. */
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    signal(SIGINT, backfill_signal_handler);
+    signal(SIGTERM, backfill_signal_handler);
+
+    double started = wall_seconds();
+    pthread_t threads[BACKFILL_MAX_JOBS];
+    int spawned = 0;
+    for (int i = 0; i < jobs_wanted; i++) {
+        if (pthread_create(&threads[spawned], NULL, backfill_worker, &queue) == 0) {
+            spawned++;
+        }
+    }
+    if (spawned == 0) {
+        backfill_worker(&queue);
+    }
+
+    bool tty = isatty(STDERR_FILENO);
+    for (;;) {
+        int done = 0;
+        for (int i = 0; i < job_count; i++) {
+            done += atomic_load(&jobs[i].done) ? 1 : 0;
+        }
+        if (done == job_count) {
+            break;
+        }
+        if (tty) {
+            report_progress(&queue, wall_seconds() - started, false);
+        }
+        struct timespec pause = {.tv_sec = 0, .tv_nsec = 250000000L};
+        nanosleep(&pause, NULL);
+    }
+    for (int i = 0; i < spawned; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = wall_seconds() - started;
+    report_progress(&queue, elapsed, true);
+    curl_global_cleanup();
+
+    int failures = 0;
+    long added = 0;
+    for (int i = 0; i < job_count; i++) {
+        BackfillJob *job = &jobs[i];
+        char from_text[32];
+        cli_format_time(from_text, sizeof(from_text), job->start);
+        fprintf(stderr, "%s %s: from %s, %zu gap(s), %lu fetched, %ld new, %llu stored%s\n",
+                job->symbol, period_interval_code(period), from_text, job->gaps,
+                atomic_load(&job->fetched), job->added,
+                (unsigned long long)(job->existing + (uint64_t)job->added),
+                job->status ? " (incomplete)" : "");
+        failures += job->status ? 1 : 0;
+        added += job->added;
+    }
+    fprintf(stderr, "Backfilled %ld new candles for %d symbol(s) in %.1f s%s\n", added,
+            job_count, elapsed, backfill_stop ? " (interrupted; rerun to resume)" : "");
+
+    free(jobs);
+    return (failures || backfill_stop) ? 1 : 0;
+}
@@ -0,0 +1,928 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file backtest.c
+ * @brief `cticker backtest`: parameter sweeps of simple strategies over the
+ *        local candle store.
+ *
+ * Each symbol's range is gathered from the memory-mapped store into
+ * high/low/close columns once. Indicators shared by many runs (rolling
+ * extremes per window length, RSI per period, close prefix sums) are also
+ * computed once per symbol. A run then fills its signal column with
+ * branch-free loops the compiler vectorises, and settles positions, fees,
+ * equity and drawdown in a single scalar pass. Symbols are prepared, and
+ * runs executed, on a pool of worker threads.
+ *
+ * Examples:
+ *   cticker backtest BTCUSDT ETHUSDT --strategy ma --fast 5:50:5 --slow 20:400:20
+ *   cticker backtest BTCUSDT --strategy breakout --entry 20:200:20 --exit 10:100:10
+ *   cticker backtest BTCUSDT --strategy rsi --period 7:21:7 --lower 20:35:5 --upper 60:80:5 --csv
+ */
+
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "backtest.h"
+#include "commands.h"
+
+#define BACKTEST_DEFAULT_JOBS 4
+#define BACKTEST_MAX_JOBS 64
+#define BACKTEST_DEFAULT_FEE 0.001
+#define BACKTEST_DEFAULT_TOP 5
+// Upper bound on grid points, to keep result tables bounded.
+#define BACKTEST_MAX_RUNS 100000
+// Runs a worker claims at a time.
+#define BACKTEST_RUN_CHUNK 8
+
+/* ---- Indicator kernels ---- */
+
+/*
+ * Element-wise kernels are unrolled by four by hand: under GCC's cheap -O2
+ * cost model only such straight-line blocks of single selects are packed
+ * into SIMD instructions.
+ */
+
+// out[i] = max(out[i], suffix[i]).
+static void combine_max(double *restrict out, const double *restrict suffix, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        out[i] = suffix[i] > out[i] ? suffix[i] : out[i];
+        out[i + 1] = suffix[i + 1] > out[i + 1] ? suffix[i + 1] : out[i + 1];
+        out[i + 2] = suffix[i + 2] > out[i + 2] ? suffix[i + 2] : out[i + 2];
+        out[i + 3] = suffix[i + 3] > out[i + 3] ? suffix[i + 3] : out[i + 3];
+    }
+    for (; i < count; i++) {
+        out[i] = suffix[i] > out[i] ? suffix[i] : out[i];
+    }
+}
+
+// out[i] = min(out[i], suffix[i]).
+static void combine_min(double *restrict out, const double *restrict suffix, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        out[i] = suffix[i] < out[i] ? suffix[i] : out[i];
+        out[i + 1] = suffix[i + 1] < out[i + 1] ? suffix[i + 1] : out[i + 1];
+        out[i + 2] = suffix[i + 2] < out[i + 2] ? suffix[i + 2] : out[i + 2];
+        out[i + 3] = suffix[i + 3] < out[i + 3] ? suffix[i + 3] : out[i + 3];
+    }
+    for (; i < count; i++) {
+        out[i] = suffix[i] < out[i] ? suffix[i] : out[i];
+    }
+}
+
+/*
+ * Extreme of the @p window values ending at each index (van Herk /
+ * Gil-Werman): running extremes from the start and from the end of each
+ * window-sized block, then one combine per index, so the cost does not
+ * depend on the window length.
+ */
+static int rolling_extreme(const double *in, size_t n, int window, bool want_max, double *out) {
+    size_t w = (size_t)window;
+    double *suffix = malloc((n > 0 ? n : 1) * sizeof(double));
+    if (!suffix) {
+        return -1;
+    }
+    for (size_t start = 0; start < n; start += w) {
+        size_t end = start + w < n ? start + w : n;
+        out[start] = in[start];
+        for (size_t i = start + 1; i < end; i++) {
+            out[i] = want_max ? fmax(out[i - 1], in[i]) : fmin(out[i - 1], in[i]);
+        }
+        suffix[end - 1] = in[end - 1];
+        for (size_t i = end - 1; i > start; i--) {
+            suffix[i - 1] = want_max ? fmax(suffix[i], in[i - 1]) : fmin(suffix[i], in[i - 1]);
+        }
+    }
+    // Indices below window - 1 only see the (partial) first block.
+    if (n >= w) {
+        if (want_max) {
+            combine_max(out + w - 1, suffix, n - w + 1);
+        } else {
+            combine_min(out + w - 1, suffix, n - w + 1);
+        }
+    }
+    free(suffix);
+    return 0;
+}
+
+// Wilder RSI; NAN until @p period changes have been seen.
+static void wilder_rsi(const double *close, size_t n, int period, double *out) {
+    double gain = 0.0;
+    double loss = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = NAN;
+        if (i == 0) {
+            continue;
+        }
+        double change = close[i] - close[i - 1];
+        double up = change > 0.0 ? change : 0.0;
+        double down = change < 0.0 ? -change : 0.0;
+        if (i <= (size_t)period) {
+            gain += up / period;
+            loss += down / period;
+            if (i < (size_t)period) {
+                continue;
+            }
+        } else {
+            gain = (gain * (period - 1) + up) / period;
+            loss = (loss * (period - 1) + down) / period;
+        }
+        out[i] = loss > 0.0 ? 100.0 - 100.0 / (1.0 + gain / loss) : 100.0;
+    }
+}
+
+/* ---- Signal kernels ---- */
+
+/*
+ * 1.0 while SMA(fast) > SMA(slow). Window sums come from the prefix sums
+ * and are compared cross-multiplied, so there is no division; unrolled by
+ * four so GCC's cheap -O2 cost model still vectorises it.
+ */
+static void ma_cross_signal(const double *restrict prefix, size_t n, int fast, int slow,
+                            double *restrict signal) {
+    size_t start = (size_t)slow - 1;
+    if (start > n) {
+        start = n;
+    }
+    memset(signal, 0, start * sizeof(double));
+    const double f_scale = slow;
+    const double s_scale = fast;
+    size_t i = start;
+    for (; i + 4 <= n; i += 4) {
+        for (size_t k = 0; k < 4; k++) {
+            double f = prefix[i + k + 1] - prefix[i + k + 1 - fast];
+            double s = prefix[i + k + 1] - prefix[i + k + 1 - slow];
+            signal[i + k] = f * f_scale > s * s_scale ? 1.0 : 0.0;
+        }
+    }
+    for (; i < n; i++) {
+        double f = prefix[i + 1] - prefix[i + 1 - fast];
+        double s = prefix[i + 1] - prefix[i + 1 - slow];
+        signal[i] = f * f_scale > s * s_scale ? 1.0 : 0.0;
+    }
+}
+
+// mask[i] = 1.0 where a[i] > b[i] (NAN compares false).
+static void greater_mask(const double *restrict a, const double *restrict b, size_t count,
+                         double *restrict mask) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        mask[i] = a[i] > b[i] ? 1.0 : 0.0;
+        mask[i + 1] = a[i + 1] > b[i + 1] ? 1.0 : 0.0;
+        mask[i + 2] = a[i + 2] > b[i + 2] ? 1.0 : 0.0;
+        mask[i + 3] = a[i + 3] > b[i + 3] ? 1.0 : 0.0;
+    }
+    for (; i < count; i++) {
+        mask[i] = a[i] > b[i] ? 1.0 : 0.0;
+    }
+}
+
+// mask[i] = 1.0 where sign * a[i] > limit; sign -1 turns "above" into "below".
+static void threshold_mask(const double *restrict a, double sign, double limit, size_t count,
+                           double *restrict mask) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        mask[i] = sign * a[i] > limit ? 1.0 : 0.0;
+        mask[i + 1] = sign * a[i + 1] > limit ? 1.0 : 0.0;
+        mask[i + 2] = sign * a[i + 2] > limit ? 1.0 : 0.0;
+        mask[i + 3] = sign * a[i + 3] > limit ? 1.0 : 0.0;
+    }
+    for (; i < count; i++) {
+        mask[i] = sign * a[i] > limit ? 1.0 : 0.0;
+    }
+}
+
+/*
+ * Entry where the close clears the previous candle's entry-channel top,
+ * exit where it breaks the previous exit-channel bottom.
+ */
+static void breakout_masks(const double *close, const double *top, const double *bottom,
+                           size_t n, size_t warmup, double *entry, double *exit) {
+    if (warmup < 1) {
+        warmup = 1;
+    }
+    if (warmup > n) {
+        warmup = n;
+    }
+    memset(entry, 0, warmup * sizeof(double));
+    memset(exit, 0, warmup * sizeof(double));
+    greater_mask(close + warmup, top + warmup - 1, n - warmup, entry + warmup);
+    greater_mask(bottom + warmup - 1, close + warmup, n - warmup, exit + warmup);
+}
+
+/*
+ * Settle positions, fees, equity and drawdown in one pass. Without @p exit,
+ * @p entry is the target position; with it, the two are the set/reset
+ * flags of a position latch. A decision on candle i earns the return of
+ * candle i + 1.
+ */
+static void settle(const double *log_return, const double *entry, const double *exit,
+                   size_t n, double fee_log, BacktestStats *stats) {
+    double position = 0.0;
+    double equity = 0.0;
+    double peak = 0.0;
+    double worst = 0.0;
+    double held = 0.0;
+    int trades = 0;
+    for (size_t i = 0; i < n; i++) {
+        equity += position * log_return[i];
+        held += position;
+        double target = entry[i];
+        if (exit) {
+            target = entry[i] > 0.0 ? 1.0 : (exit[i] > 0.0 ? 0.0 : position);
+        }
+        if (target != position) {
+            trades++;
+            equity -= fee_log;
+            position = target;
+        }
+        if (equity > peak) {
+            peak = equity;
+        } else if (peak - equity > worst) {
+            worst = peak - equity;
+        }
+    }
+    stats->total_return = expm1(equity);
+    stats->max_drawdown = -expm1(-worst);
+    stats->trades = trades;
+    stats->exposure = n > 0 ? held / (double)n : 0.0;
+}
+
+/* ---- Series preparation ---- */
+
+// Indicator for @p window, or NULL when the grid did not ask for it.
+static const double *find_indicator(const BacktestIndicator *list, int count, int window) {
+    for (int i = 0; i < count; i++) {
+        if (list[i].window == window) {
+            return list[i].values;
+        }
+    }
+    return NULL;
+}
+
+// Compute one indicator per distinct value of grid slot @p slot.
+static int build_indicators(const BacktestSeries *series, const BacktestParams *grid,
+                            size_t runs, int slot, int kind, BacktestIndicator **out,
+                            int *out_count) {
+    *out = NULL;
+    *out_count = 0;
+    BacktestIndicator *list = NULL;
+    int count = 0;
+    for (size_t r = 0; r < runs; r++) {
+        int window = grid[r].values[slot];
+        if (window < 1 || find_indicator(list, count, window)) {
+            continue;
+        }
+        BacktestIndicator *grown = realloc(list, (size_t)(count + 1) * sizeof(*list));
+        if (!grown) {
+            goto fail;
+        }
+        list = grown;
+        list[count].window = window;
+        list[count].values = malloc((series->count > 0 ? series->count : 1) * sizeof(double));
+        if (!list[count].values) {
+            goto fail;
+        }
+        count++;
+        int rc = 0;
+        if (kind == 0) {
+            rc = rolling_extreme(series->high, series->count, window, true, list[count - 1].values);
+        } else if (kind == 1) {
+            rc = rolling_extreme(series->low, series->count, window, false, list[count - 1].values);
+        } else {
+            wilder_rsi(series->close, series->count, window, list[count - 1].values);
+        }
+        if (rc != 0) {
+            goto fail;
+        }
+    }
+    *out = list;
+    *out_count = count;
+    return 0;
+
+fail:
+    for (int i = 0; i < count; i++) {
+        free(list[i].values);
+    }
+    free(list);
+    return -1;
+}
+
+// Gather the columns and build the shared indicators.
+int backtest_series_init(BacktestSeries *series, const CandleRecord *records, size_t count,
+                         BacktestStrategy strategy, const BacktestParams *grid, size_t runs) {
+    memset(series, 0, sizeof(*series));
+    size_t n = count > 0 ? count : 1;
+    series->count = count;
+    series->high = malloc(n * sizeof(double));
+    series->low = malloc(n * sizeof(double));
+    series->close = malloc(n * sizeof(double));
+    series->log_return = malloc(n * sizeof(double));
+    series->close_prefix = malloc((n + 1) * sizeof(double));
+    if (!series->high || !series->low || !series->close || !series->log_return ||
+        !series->close_prefix) {
+        backtest_series_free(series);
+        return -1;
+    }
+    series->close_prefix[0] = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        series->high[i] = records[i].high;
+        series->low[i] = records[i].low;
+        series->close[i] = records[i].close;
+        series->close_prefix[i + 1] = series->close_prefix[i] + records[i].close;
+    }
+    for (size_t i = 0; i < count; i++) {
+        double prev = i > 0 ? series->close[i - 1] : 0.0;
+        series->log_return[i] = (prev > 0.0 && series->close[i] > 0.0)
+            ? log(series->close[i] / prev) : 0.0;
+    }
+
+    int rc = 0;
+    if (strategy == BACKTEST_BREAKOUT) {
+        rc = build_indicators(series, grid, runs, 0, 0, &series->rolling_high,
+                              &series->rolling_high_count);
+        if (rc == 0) {
+            rc = build_indicators(series, grid, runs, 1, 1, &series->rolling_low,
+                                  &series->rolling_low_count);
+        }
+    } else if (strategy == BACKTEST_RSI) {
+        rc = build_indicators(series, grid, runs, 0, 2, &series->rsi, &series->rsi_count);
+    }
+    if (rc != 0) {
+        backtest_series_free(series);
+        return -1;
+    }
+    return 0;
+}
+
+// Free one indicator list.
+static void free_indicators(BacktestIndicator *list, int count) {
+    for (int i = 0; i < count; i++) {
+        free(list[i].values);
+    }
+    free(list);
+}
+
+// Release the columns and indicators.
+void backtest_series_free(BacktestSeries *series) {
+    free(series->high);
+    free(series->low);
+    free(series->close);
+    free(series->log_return);
+    free(series->close_prefix);
+    free_indicators(series->rolling_high, series->rolling_high_count);
+    free_indicators(series->rolling_low, series->rolling_low_count);
+    free_indicators(series->rsi, series->rsi_count);
+    memset(series, 0, sizeof(*series));
+}
+
+// Build the signal column for one parameter set and settle it.
+void backtest_run(const BacktestSeries *series, BacktestStrategy strategy,
+                  const BacktestParams *params, double fee, double *scratch,
+                  BacktestStats *stats) {
+    const int *p = params->values;
+    size_t n = series->count;
+    double fee_log = -log1p(-fee);
+    memset(stats, 0, sizeof(*stats));
+
+    double *entry = scratch;
+    double *exit = scratch + n;
+    switch (strategy) {
+        case BACKTEST_MA_CROSS:
+            if (p[0] < 1 || p[1] <= p[0]) {
+                return;
+            }
+            ma_cross_signal(series->close_prefix, n, p[0], p[1], entry);
+            settle(series->log_return, entry, NULL, n, fee_log, stats);
+            break;
+        case BACKTEST_BREAKOUT: {
+            const double *top = find_indicator(series->rolling_high,
+                                               series->rolling_high_count, p[0]);
+            const double *bottom = find_indicator(series->rolling_low,
+                                                  series->rolling_low_count, p[1]);
+            if (!top || !bottom) {
+                return;
+            }
+            size_t warmup = (size_t)(p[0] > p[1] ? p[0] : p[1]);
+            breakout_masks(series->close, top, bottom, n, warmup, entry, exit);
+            settle(series->log_return, entry, exit, n, fee_log, stats);
+            break;
+        }
+        case BACKTEST_RSI: {
+            const double *rsi = find_indicator(series->rsi, series->rsi_count, p[0]);
+            if (!rsi || p[1] >= p[2]) {
+                return;
+            }
+            // Enter below the lower threshold, exit above the upper one.
+            threshold_mask(rsi, -1.0, -p[1], n, entry);
+            threshold_mask(rsi, 1.0, p[2], n, exit);
+            settle(series->log_return, entry, exit, n, fee_log, stats);
+            break;
+        }
+    }
+}
+
+/* ---- Command ---- */
+
+/**
+ * @brief One swept parameter: an inclusive range walked in steps.
+ */
+typedef struct {
+    const char *name;
+    int first;
+    int last;
+    int step;
+} BacktestRange;
+
+/**
+ * @brief Per-symbol input and result.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    BacktestSeries series;
+    /** Results for every grid point, in grid order. */
+    BacktestStats *stats;
+    int status;
+} BacktestJob;
+
+/**
+ * @brief Shared settings and work queues of one sweep.
+ */
+typedef struct {
+    BacktestJob *jobs;
+    int job_count;
+    BacktestStrategy strategy;
+    const BacktestParams *grid;
+    size_t run_count;
+    Period period;
+    uint64_t from;
+    uint64_t to;
+    double fee;
+    /** Largest series, to size the per-thread scratch. */
+    size_t max_count;
+    /** Next symbol to load (phase 1). */
+    atomic_int next_job;
+    /** Next symbol * run_count + run to execute (phase 2). */
+    atomic_size_t next_task;
+} BacktestQueue;
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Parse `N` or `FIRST:LAST[:STEP]`.
+static int parse_range(const char *text, BacktestRange *range) {
+    int first = 0;
+    int last = 0;
+    int step = 1;
+    int fields = sscanf(text, "%d:%d:%d", &first, &last, &step);
+    if (fields == 1) {
+        last = first;
+    } else if (fields < 2) {
+        return -1;
+    }
+    if (first < 1 || last < first || step < 1) {
+        return -1;
+    }
+    range->first = first;
+    range->last = last;
+    range->step = step;
+    return 0;
+}
+
+// Parameter combinations the strategy can actually run.
+static bool params_valid(BacktestStrategy strategy, const BacktestParams *params) {
+    const int *p = params->values;
+    switch (strategy) {
+        case BACKTEST_MA_CROSS:
+            return p[0] < p[1];
+        case BACKTEST_BREAKOUT:
+            return true;
+        case BACKTEST_RSI:
+            return p[1] < p[2] && p[2] <= 100;
+    }
+    return false;
+}
+
+// Cartesian product of the ranges; NULL when it is empty or too large.
+static BacktestParams *build_grid(BacktestStrategy strategy, const BacktestRange *ranges,
+                                  int range_count, size_t *out_count) {
+    size_t total = 1;
+    for (int i = 0; i < range_count; i++) {
+        total *= (size_t)((ranges[i].last - ranges[i].first) / ranges[i].step + 1);
+        if (total > BACKTEST_MAX_RUNS) {
+            fprintf(stderr, "Parameter grid exceeds %d runs\n", BACKTEST_MAX_RUNS);
+            return NULL;
+        }
+    }
+    BacktestParams *grid = calloc(total, sizeof(*grid));
+    if (!grid) {
+        return NULL;
+    }
+    size_t count = 0;
+    for (size_t index = 0; index < total; index++) {
+        BacktestParams params = {{0}};
+        size_t rest = index;
+        for (int i = range_count - 1; i >= 0; i--) {
+            size_t steps = (size_t)((ranges[i].last - ranges[i].first) / ranges[i].step + 1);
+            params.values[i] = ranges[i].first + (int)(rest % steps) * ranges[i].step;
+            rest /= steps;
+        }
+        if (params_valid(strategy, &params)) {
+            grid[count++] = params;
+        }
+    }
+    if (count == 0) {
+        fprintf(stderr, "Parameter grid is empty\n");
+        free(grid);
+        return NULL;
+    }
+    *out_count = count;
+    return grid;
+}
+
+// Load one symbol's range from the store and prepare its columns.
+static int load_symbol(BacktestQueue *queue, BacktestJob *job) {
+    CandleStore store;
+    if (candle_store_open(&store, job->symbol, queue->period, false) != 0) {
+        fprintf(stderr, "%s: no local %s candles\n", job->symbol,
+                period_interval_code(queue->period));
+        return -1;
+    }
+    size_t begin = candle_store_lower_bound(&store, queue->from);
+    size_t end = candle_store_lower_bound(&store, queue->to);
+    size_t count = end > begin ? end - begin : 0;
+    int status = 0;
+    if (count < 2) {
+        fprintf(stderr, "%s: not enough candles in range\n", job->symbol);
+        status = -1;
+    } else if (backtest_series_init(&job->series, store.records + begin, count,
+                                    queue->strategy, queue->grid, queue->run_count) != 0 ||
+               !(job->stats = calloc(queue->run_count, sizeof(BacktestStats)))) {
+        fprintf(stderr, "%s: out of memory\n", job->symbol);
+        status = -1;
+    }
+    candle_store_close(&store);
+    return status;
+}
+
+static void *load_worker(void *arg) {
+    BacktestQueue *queue = arg;
+    for (;;) {
+        int index = atomic_fetch_add(&queue->next_job, 1);
+        if (index >= queue->job_count) {
+            break;
+        }
+        queue->jobs[index].status = load_symbol(queue, &queue->jobs[index]);
+    }
+    return NULL;
+}
+
+/*
+ * Runs are claimed in small chunks across all symbols, so a symbol with a
+ * long history does not leave the other threads idle at the end.
+ */
+static void *run_worker(void *arg) {
+    BacktestQueue *queue = arg;
+    double *scratch = malloc(2 * queue->max_count * sizeof(double));
+    if (!scratch) {
+        return NULL;
+    }
+    size_t total = (size_t)queue->job_count * queue->run_count;
+    for (;;) {
+        size_t task = atomic_fetch_add(&queue->next_task, BACKTEST_RUN_CHUNK);
+        if (task >= total) {
+            break;
+        }
+        size_t end = task + BACKTEST_RUN_CHUNK < total ? task + BACKTEST_RUN_CHUNK : total;
+        for (; task < end; task++) {
+            BacktestJob *job = &queue->jobs[task / queue->run_count];
+            size_t run = task % queue->run_count;
+            if (job->status == 0) {
+                backtest_run(&job->series, queue->strategy, &queue->grid[run], queue->fee,
+                             scratch, &job->stats[run]);
+            }
+        }
+    }
+    free(scratch);
+    return NULL;
+}
+
+// Run @p worker on @p threads threads, the calling one included.
+static int run_pool(void *(*worker)(void *), BacktestQueue *queue, int threads) {
+    pthread_t spawned_threads[BACKTEST_MAX_JOBS];
+    int spawned = 0;
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&spawned_threads[spawned], NULL, worker, queue) == 0) {
+            spawned++;
+        }
+    }
+    worker(queue);
+    for (int i = 0; i < spawned; i++) {
+        pthread_join(spawned_threads[i], NULL);
+    }
+    return spawned + 1;
+}
+
+// Parameter columns, e.g. "fast=5 slow=40".
+static void format_params(char *buf, size_t size, const BacktestRange *ranges, int range_count,
+                          const BacktestParams *params) {
+    size_t len = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < range_count && len < size; i++) {
+        len += (size_t)snprintf(buf + len, size - len, "%s%s=%d", i ? " " : "",
+                                ranges[i].name, params->values[i]);
+    }
+}
+
+// Print the best @p top runs of one symbol next to buy and hold.
+static void print_top(const BacktestQueue *queue, const BacktestJob *job,
+                      const BacktestRange *ranges, int range_count, int top) {
+    size_t *order = malloc(queue->run_count * sizeof(size_t));
+    if (!order) {
+        return;
+    }
+    size_t shown = 0;
+    /* Partial selection sort: top is small. */
+    for (size_t r = 0; r < queue->run_count; r++) {
+        order[r] = r;
+    }
+    for (; shown < (size_t)top && shown < queue->run_count; shown++) {
+        size_t best = shown;
+        for (size_t r = shown + 1; r < queue->run_count; r++) {
+            if (job->stats[order[r]].total_return > job->stats[order[best]].total_return) {
+                best = r;
+            }
+        }
+        size_t tmp = order[shown];
+        order[shown] = order[best];
+        order[best] = tmp;
+    }
+
+    const BacktestSeries *series = &job->series;
+    double hold = series->close[series->count - 1] / series->close[0] - 1.0;
+    printf("%s  %zu candles, %zu runs, buy & hold %+.2f%%\n", job->symbol, series->count,
+           queue->run_count, hold * 100.0);
+    printf("  %-28s %10s %9s %7s %8s\n", "PARAMS", "RETURN", "MAX DD", "TRADES", "EXPOSURE");
+    for (size_t i = 0; i < shown; i++) {
+        const BacktestStats *stats = &job->stats[order[i]];
+        char params[64];
+        format_params(params, sizeof(params), ranges, range_count, &queue->grid[order[i]]);
+        printf("  %-28s %+9.2f%% %8.2f%% %7d %7.1f%%\n", params, stats->total_return * 100.0,
+               stats->max_drawdown * 100.0, stats->trades, stats->exposure * 100.0);
+    }
+    free(order);
+}
+
+// Every run as CSV, one row per symbol and grid point.
+static void print_csv(const BacktestQueue *queue, const BacktestRange *ranges, int range_count) {
+    printf("symbol");
+    for (int i = 0; i < range_count; i++) {
+        printf(",%s", ranges[i].name);
+    }
+    printf(",return,max_drawdown,trades,exposure\n");
+    for (int j = 0; j < queue->job_count; j++) {
+        const BacktestJob *job = &queue->jobs[j];
+        if (job->status != 0) {
+            continue;
+        }
+        for (size_t r = 0; r < queue->run_count; r++) {
+            const BacktestStats *stats = &job->stats[r];
+            printf("%s", job->symbol);
+            for (int i = 0; i < range_count; i++) {
+                printf(",%d", queue->grid[r].values[i]);
+            }
+            printf(",%.6f,%.6f,%d,%.4f\n", stats->total_return, stats->max_drawdown,
+                   stats->trades, stats->exposure);
+        }
+    }
+}
+
+static void print_backtest_usage(void) {
+    fprintf(stderr,
+            "Usage: cticker backtest SYMBOL... [--strategy ma|breakout|rsi]\n"
+            "                        [--interval INTERVAL] [--from TIME] [--to TIME]\n"
+            "                        [--fee PCT] [--jobs N] [--top N] [--csv]\n"
+            "                        [PARAMETER RANGE]...\n"
+            "Ranges are N or FIRST:LAST[:STEP]; every combination is run.\n"
+            "  ma:       --fast (5:50:5)  --slow (20:200:20)\n"
+            "  breakout: --entry (20:200:20)  --exit (10:100:10)\n"
+            "  rsi:      --period (14)  --lower (20:40:5)  --upper (60:80:5)\n"
+            "Fees default to 0.1%% per position change; data comes from the\n"
+            "local candle store (see `cticker backfill`).\n");
+}
+
+int command_backtest(int argc, char *argv[]) {
+    static const BacktestRange defaults[][BACKTEST_MAX_PARAMS] = {
+        [BACKTEST_MA_CROSS] = {{"fast", 5, 50, 5}, {"slow", 20, 200, 20}},
+        [BACKTEST_BREAKOUT] = {{"entry", 20, 200, 20}, {"exit", 10, 100, 10}},
+        [BACKTEST_RSI] = {{"period", 14, 14, 1}, {"lower", 20, 40, 5}, {"upper", 60, 80, 5}},
+    };
+    static const int range_counts[] = {
+        [BACKTEST_MA_CROSS] = 2,
+        [BACKTEST_BREAKOUT] = 2,
+        [BACKTEST_RSI] = 3,
+    };
+    const char *interval_arg = "1m";
+    const char *from_arg = NULL;
+    const char *to_arg = NULL;
+    const char *range_args[BACKTEST_MAX_PARAMS] = {NULL};
+    const char *range_names[BACKTEST_MAX_PARAMS] = {NULL};
+    int range_arg_count = 0;
+    BacktestStrategy strategy = BACKTEST_MA_CROSS;
+    double fee_pct = BACKTEST_DEFAULT_FEE * 100.0;
+    int jobs_wanted = BACKTEST_DEFAULT_JOBS;
+    int top = BACKTEST_DEFAULT_TOP;
+    bool csv = false;
+
+    BacktestJob *jobs = calloc((size_t)(argc > 1 ? argc : 1), sizeof(BacktestJob));
+    if (!jobs) {
+        return 1;
+    }
+    int job_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (strcmp(arg, "--strategy") == 0 && has_value) {
+            const char *name = argv[++i];
+            if (strcmp(name, "ma") == 0) {
+                strategy = BACKTEST_MA_CROSS;
+            } else if (strcmp(name, "breakout") == 0) {
+                strategy = BACKTEST_BREAKOUT;
+            } else if (strcmp(name, "rsi") == 0) {
+                strategy = BACKTEST_RSI;
+            } else {
+                print_backtest_usage();
+                free(jobs);
+                return 2;
+            }
+        } else if (strcmp(arg, "--interval") == 0 && has_value) {
+            interval_arg = argv[++i];
+        } else if (strcmp(arg, "--from") == 0 && has_value) {
+            from_arg = argv[++i];
+        } else if (strcmp(arg, "--to") == 0 && has_value) {
+            to_arg = argv[++i];
+        } else if (strcmp(arg, "--fee") == 0 && has_value) {
+            fee_pct = atof(argv[++i]);
+        } else if (strcmp(arg, "--jobs") == 0 && has_value) {
+            jobs_wanted = atoi(argv[++i]);
+        } else if (strcmp(arg, "--top") == 0 && has_value) {
+            top = atoi(argv[++i]);
+        } else if (strcmp(arg, "--csv") == 0) {
+            csv = true;
+        } else if (strncmp(arg, "--", 2) == 0 && has_value &&
+                   range_arg_count < BACKTEST_MAX_PARAMS) {
+            /* Matched against the strategy's parameter names below. */
+            range_names[range_arg_count] = arg + 2;
+            range_args[range_arg_count++] = argv[++i];
+        } else if (arg[0] == '-') {
+            print_backtest_usage();
+            free(jobs);
+            return 2;
+        } else {
+            snprintf(jobs[job_count++].symbol, sizeof(jobs[0].symbol), "%s", arg);
+        }
+    }
+
+    int range_count = range_counts[strategy];
+    BacktestRange ranges[BACKTEST_MAX_PARAMS];
+    memcpy(ranges, defaults[strategy], sizeof(ranges));
+    for (int a = 0; a < range_arg_count; a++) {
+        int slot = -1;
+        for (int i = 0; i < range_count; i++) {
+            if (strcmp(range_names[a], ranges[i].name) == 0) {
+                slot = i;
+            }
+        }
+        if (slot < 0 || parse_range(range_args[a], &ranges[slot]) != 0) {
+            fprintf(stderr, "Invalid parameter --%s %s\n", range_names[a], range_args[a]);
+            print_backtest_usage();
+            free(jobs);
+            return 2;
+        }
+    }
+    if (job_count == 0 || fee_pct < 0.0 || fee_pct >= 100.0 || top < 1) {
+        print_backtest_usage();
+        free(jobs);
+        return 2;
+    }
+
+    Period period = PERIOD_1MIN;
+    if (cli_parse_period(interval_arg, &period) != 0) {
+        free(jobs);
+        return 2;
+    }
+    uint64_t now = (uint64_t)time(NULL);
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    if ((from_arg && cli_parse_time(from_arg, now, &from) != 0) ||
+        (to_arg && cli_parse_time(to_arg, now, &to) != 0)) {
+        fprintf(stderr, "Invalid --from/--to time\n");
+        free(jobs);
+        return 2;
+    }
+
+    size_t run_count = 0;
+    BacktestParams *grid = build_grid(strategy, ranges, range_count, &run_count);
+    if (!grid) {
+        free(jobs);
+        return 2;
+    }
+
+    if (jobs_wanted < 1) {
+        jobs_wanted = 1;
+    }
+    if (jobs_wanted > BACKTEST_MAX_JOBS) {
+        jobs_wanted = BACKTEST_MAX_JOBS;
+    }
+
+    BacktestQueue queue = {
+        .jobs = jobs,
+        .job_count = job_count,
+        .strategy = strategy,
+        .grid = grid,
+        .run_count = run_count,
+        .period = period,
+        .from = from,
+        .to = to,
+        .fee = fee_pct / 100.0,
+    };
+    atomic_init(&queue.next_job, 0);
+    atomic_init(&queue.next_task, 0);
+
+    double started = wall_seconds();
+    run_pool(load_worker, &queue, jobs_wanted < job_count ? jobs_wanted : job_count);
+    double loaded = wall_seconds();
+    size_t candles = 0;
+    int failures = 0;
+    for (int i = 0; i < job_count; i++) {
+        if (jobs[i].status != 0) {
+            failures++;
+            continue;
+        }
+        candles += jobs[i].series.count;
+        if (jobs[i].series.count > queue.max_count) {
+            queue.max_count = jobs[i].series.count;
+        }
+    }
+    int threads = 0;
+    if (failures < job_count) {
+        threads = run_pool(run_worker, &queue, jobs_wanted);
+    }
+    double finished = wall_seconds();
+
+    if (csv) {
+        print_csv(&queue, ranges, range_count);
+    } else {
+        for (int i = 0; i < job_count; i++) {
+            if (jobs[i].status == 0) {
+                print_top(&queue, &jobs[i], ranges, range_count, top);
+            }
+        }
+    }
+    size_t runs = run_count * (size_t)(job_count - failures);
+    double elapsed = finished - loaded;
+    fprintf(stderr,
+            "Backtested %zu runs over %zu candles in %.3f s (load %.3f s), "
+            "%.1f M candle-runs/s on %d thread(s)\n",
+            runs, candles, elapsed, loaded - started,
+            elapsed > 0.0 ? (double)candles * (double)run_count / elapsed / 1e6 : 0.0, threads);
+
+    for (int i = 0; i < job_count; i++) {
+        backtest_series_free(&jobs[i].series);
+        free(jobs[i].stats);
+    }
+    free(grid);
+    free(jobs);
+    return failures ? 1 : 0;
+}
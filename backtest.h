@@ -0,0 +1,102 @@
+#ifndef CTICKER_BACKTEST_H
+#define CTICKER_BACKTEST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "candle_store.h"
+
+/** Parameters per strategy (unused slots are 0). */
+#define BACKTEST_MAX_PARAMS 3
+
+/**
+ * @brief Rule-based long/flat strategies.
+ *
+ * Decisions are taken on a candle's close and earn the next candle's return.
+ */
+typedef enum {
+    /** Long while SMA(fast) > SMA(slow); params {fast, slow}. */
+    BACKTEST_MA_CROSS,
+    /** Enter above the highest high of `entry` candles, exit below the lowest
+     *  low of `exit` candles; params {entry, exit}. */
+    BACKTEST_BREAKOUT,
+    /** Enter when RSI(period) < lower, exit when it rises above upper;
+     *  params {period, lower, upper}. */
+    BACKTEST_RSI
+} BacktestStrategy;
+
+/**
+ * @brief One point of a parameter grid.
+ */
+typedef struct {
+    int values[BACKTEST_MAX_PARAMS];
+} BacktestParams;
+
+/**
+ * @brief Outcome of one run.
+ */
+typedef struct {
+    /** Compounded return after fees (0.12 = +12%). */
+    double total_return;
+    /** Largest peak-to-trough equity decline (0.08 = -8%). */
+    double max_drawdown;
+    /** Position changes (entries plus exits). */
+    int trades;
+    /** Fraction of candles spent in the market. */
+    double exposure;
+} BacktestStats;
+
+/**
+ * @brief Indicator values for one window length, aligned with the candles.
+ */
+typedef struct {
+    int window;
+    double *values;
+} BacktestIndicator;
+
+/**
+ * @brief Column-oriented candles of one symbol plus every indicator the
+ *        grid needs, computed once and shared read-only by all runs.
+ */
+typedef struct {
+    size_t count;
+    double *high;
+    double *low;
+    double *close;
+    /** ln(close[i] / close[i - 1]); 0 for the first candle. */
+    double *log_return;
+    /** close_prefix[i] = sum of close[0 .. i - 1] (count + 1 entries). */
+    double *close_prefix;
+    /** Highest high / lowest low of the trailing window, per window length. */
+    BacktestIndicator *rolling_high;
+    int rolling_high_count;
+    BacktestIndicator *rolling_low;
+    int rolling_low_count;
+    /** Wilder RSI per period. */
+    BacktestIndicator *rsi;
+    int rsi_count;
+} BacktestSeries;
+
+/**
+ * @brief Copy the high/low/close columns of @p count records and build the
+ *        indicators @p grid needs for @p strategy.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int backtest_series_init(BacktestSeries *series, const CandleRecord *records, size_t count,
+                         BacktestStrategy strategy, const BacktestParams *grid, size_t runs);
+
+/**
+ * @brief Release memory owned by @p series.
+ */
+void backtest_series_free(BacktestSeries *series);
+
+/**
+ * @brief Run one parameter set.
+ *
+ * @param[in] fee Fraction charged on every position change (0.001 = 0.1%).
+ * @param scratch Caller buffer of at least 2 * series->count doubles.
+ */
+void backtest_run(const BacktestSeries *series, BacktestStrategy strategy,
+                  const BacktestParams *params, double fee, double *scratch,
+                  BacktestStats *stats);
+
+#endif
@@ -0,0 +1,348 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file bartransform.c
+ * @brief Heikin-Ashi, Renko and range bars derived incrementally from candles.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bartransform.h"
+
+// Start with an empty cache.
+void bar_cache_init(BarCache *cache) {
+    memset(cache, 0, sizeof(*cache));
+}
+
+// Release every cached series.
+void bar_cache_free(BarCache *cache) {
+    for (int i = 0; i < BAR_CACHE_SLOTS; ++i) {
+        free(cache->slots[i].bars);
+    }
+    bar_cache_init(cache);
+}
+
+// Find the series for the key, or recycle the least recently used slot.
+BarSeries *bar_cache_get(BarCache *cache, const char *symbol, Period period, BarType type,
+                         double box_percent) {
+    BarSeries *victim = &cache->slots[0];
+    cache->tick++;
+    for (int i = 0; i < BAR_CACHE_SLOTS; ++i) {
+        BarSeries *slot = &cache->slots[i];
+        if (slot->last_used != 0 && slot->period == period && slot->type == type &&
+            slot->box_percent == box_percent && strcmp(slot->symbol, symbol) == 0) {
+            slot->last_used = cache->tick;
+            return slot;
+        }
+        if (slot->last_used < victim->last_used) {
+            victim = slot;
+        }
+    }
+    free(victim->bars);
+    memset(victim, 0, sizeof(*victim));
+    snprintf(victim->symbol, sizeof(victim->symbol), "%s", symbol);
+    victim->period = period;
+    victim->type = type;
+    victim->box_percent = box_percent;
+    victim->last_used = cache->tick;
+    return victim;
+}
+
+// Round @p value to 1, 2, 2.5 or 5 times a power of ten, so boxes read well
+// on the price axis.
+static double bar_round_box(double value) {
+    if (!(value > 0.0) || !isfinite(value)) {
+        return 1.0;
+    }
+    double scale = pow(10.0, floor(log10(value)));
+    double mantissa = value / scale;
+    double step = (mantissa < 1.5) ? 1.0 : (mantissa < 2.25) ? 2.0 : (mantissa < 3.5) ? 2.5
+        : (mantissa < 7.5) ? 5.0 : 10.0;
+    return step * scale;
+}
+
+// Append @p bar, growing the array geometrically.
+static int bar_emit(BarSeries *series, const PricePoint *bar) {
+    if (series->count == series->capacity) {
+        int capacity = series->capacity ? series->capacity * 2 : 256;
+        PricePoint *bars = realloc(series->bars, sizeof(PricePoint) * (size_t)capacity);
+        if (!bars) {
+            return -1;
+        }
+        series->bars = bars;
+        series->capacity = capacity;
+    }
+    series->bars[series->count++] = *bar;
+    return 0;
+}
+
+// Open a bar at @p price in @p candle, with no volume yet.
+static void bar_start(BarBuilder *builder, const PricePoint *candle, double price) {
+    memset(&builder->current, 0, sizeof(builder->current));
+    builder->current.timestamp = candle->timestamp;
+    builder->current.close_time = candle->close_time;
+    builder->current.open = price;
+    builder->current.high = price;
+    builder->current.low = price;
+    builder->current.close = price;
+    builder->open = true;
+}
+
+// Credit @p candle's volumes to the bar being built.
+static void bar_add_volume(BarBuilder *builder, const PricePoint *candle) {
+    builder->current.volume += candle->volume;
+    builder->current.quote_volume += candle->quote_volume;
+    builder->current.taker_buy_base_volume += candle->taker_buy_base_volume;
+    builder->current.taker_buy_quote_volume += candle->taker_buy_quote_volume;
+    builder->current.trade_count += candle->trade_count;
+    builder->current.close_time = candle->close_time;
+}
+
+// One Heikin-Ashi bar per candle.
+static int bar_fold_heikin_ashi(BarSeries *series, BarBuilder *builder,
+                                const PricePoint *candle) {
+    PricePoint bar = *candle;
+    // The exchange's price strings describe the candle, not the bar.
+    bar.open_text[0] = bar.high_text[0] = bar.low_text[0] = bar.close_text[0] = '\0';
+    bar.close = (candle->open + candle->high + candle->low + candle->close) / 4.0;
+    bar.open = builder->seeded ? (builder->ha_open + builder->ha_close) / 2.0
+                               : (candle->open + candle->close) / 2.0;
+    bar.high = fmax(candle->high, fmax(bar.open, bar.close));
+    bar.low = fmin(candle->low, fmin(bar.open, bar.close));
+    builder->ha_open = bar.open;
+    builder->ha_close = bar.close;
+    builder->seeded = true;
+    return bar_emit(series, &bar);
+}
+
+// Emit a wickless brick from @p from to @p to; the first brick of a run
+// carries the volume gathered since the previous one.
+static int bar_emit_brick(BarSeries *series, BarBuilder *builder, const PricePoint *candle,
+                          double from, double to) {
+    PricePoint brick = builder->current;
+    brick.open = from;
+    brick.close = to;
+    brick.high = fmax(from, to);
+    brick.low = fmin(from, to);
+    brick.close_time = candle->close_time;
+    if (bar_emit(series, &brick) != 0) {
+        return -1;
+    }
+    bar_start(builder, candle, to);
+    return 0;
+}
+
+// Renko on closes: a brick each time the close clears the last brick by a
+// box (so a reversal needs two boxes).
+static int bar_fold_renko(BarSeries *series, BarBuilder *builder, const PricePoint *candle) {
+    if (!builder->open) {
+        bar_start(builder, candle, candle->close);
+    }
+    bar_add_volume(builder, candle);
+    if (!builder->seeded) {
+        builder->brick_low = candle->close;
+        builder->brick_high = candle->close;
+        builder->seeded = true;
+        return 0;
+    }
+    double box = series->box;
+    while (candle->close >= builder->brick_high + box) {
+        double top = builder->brick_high + box;
+        if (bar_emit_brick(series, builder, candle, builder->brick_high, top) != 0) {
+            return -1;
+        }
+        builder->brick_low = builder->brick_high;
+        builder->brick_high = top;
+    }
+    while (candle->close <= builder->brick_low - box) {
+        double bottom = builder->brick_low - box;
+        if (bar_emit_brick(series, builder, candle, builder->brick_low, bottom) != 0) {
+            return -1;
+        }
+        builder->brick_high = builder->brick_low;
+        builder->brick_low = bottom;
+    }
+    return 0;
+}
+
+// Walk the range bar under construction to @p price, closing a bar at the
+// box edge whenever its span would reach the box.
+static int bar_range_walk(BarSeries *series, BarBuilder *builder, const PricePoint *candle,
+                          double price) {
+    PricePoint *bar = &builder->current;
+    for (;;) {
+        double edge;
+        if (price > bar->high && price - bar->low >= series->box) {
+            edge = bar->low + series->box;
+            bar->high = edge;
+        } else if (price < bar->low && bar->high - price >= series->box) {
+            edge = bar->high - series->box;
+            bar->low = edge;
+        } else {
+            if (price > bar->high) bar->high = price;
+            if (price < bar->low) bar->low = price;
+            bar->close = price;
+            return 0;
+        }
+        bar->close = edge;
+        bar->close_time = candle->close_time;
+        if (bar_emit(series, bar) != 0) {
+            return -1;
+        }
+        bar_start(builder, candle, edge);
+    }
+}
+
+// Range bars along the candle's likely path: open, the nearer extreme
+// first (low for an up candle), the other extreme, close.
+static int bar_fold_range(BarSeries *series, BarBuilder *builder, const PricePoint *candle) {
+    if (!builder->open) {
+        bar_start(builder, candle, candle->open);
+    }
+    bar_add_volume(builder, candle);
+    bool up = candle->close >= candle->open;
+    double path[4] = {candle->open, up ? candle->low : candle->high,
+                      up ? candle->high : candle->low, candle->close};
+    for (int i = 0; i < 4; ++i) {
+        if (bar_range_walk(series, builder, candle, path[i]) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Fold one candle into @p builder, appending completed bars.
+static int bar_fold(BarSeries *series, BarBuilder *builder, const PricePoint *candle) {
+    switch (series->type) {
+        case BAR_HEIKIN_ASHI:
+            return bar_fold_heikin_ashi(series, builder, candle);
+        case BAR_RENKO:
+            return bar_fold_renko(series, builder, candle);
+        case BAR_RANGE:
+            return bar_fold_range(series, builder, candle);
+        default:
+            return bar_emit(series, candle);
+    }
+}
+
+// Index of the candle opening at @p timestamp in points[0 .. count), or -1.
+static int bar_find_candle(const PricePoint *points, int count, uint64_t timestamp) {
+    int lo = 0;
+    int hi = count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (points[mid].timestamp == timestamp) {
+            return mid;
+        }
+        if (points[mid].timestamp < timestamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+// Fold the closed candles not seen yet, then the live one on a scratch builder.
+int bar_series_sync(BarSeries *series, const PricePoint *points, int count) {
+    if (count <= 0) {
+        series->count = series->closed;
+        return 0;
+    }
+    int closed = count - 1;
+    int start = 0;
+    if (series->last_timestamp != 0 && points[0].timestamp >= series->first_timestamp) {
+        int last = bar_find_candle(points, closed, series->last_timestamp);
+        start = (last >= 0 && points[last].close == series->last_close) ? last + 1 : -1;
+    } else if (series->last_timestamp != 0) {
+        start = -1;
+    }
+
+    if (start < 0 || series->last_timestamp == 0) {
+        series->count = 0;
+        series->closed = 0;
+        memset(&series->builder, 0, sizeof(series->builder));
+        series->box = bar_round_box(points[0].close * series->box_percent / 100.0);
+        series->first_timestamp = points[0].timestamp;
+        series->last_timestamp = 0;
+        series->rebuilds++;
+        start = 0;
+    } else if (points[0].timestamp > series->first_timestamp) {
+        // The window scrolled: drop the bars that ended before it.
+        int drop = 0;
+        while (drop < series->closed && series->bars[drop].close_time < points[0].timestamp) {
+            drop++;
+        }
+        if (drop > 0) {
+            memmove(series->bars, series->bars + drop,
+                    sizeof(PricePoint) * (size_t)(series->closed - drop));
+            series->closed -= drop;
+        }
+        series->first_timestamp = points[0].timestamp;
+    }
+
+    series->count = series->closed;
+    for (int i = start; i < closed; ++i) {
+        if (bar_fold(series, &series->builder, &points[i]) != 0) {
+            series->count = series->closed;
+            return -1;
+        }
+        series->closed = series->count;
+        series->last_timestamp = points[i].timestamp;
+        series->last_close = points[i].close;
+        series->candles_folded++;
+    }
+
+    BarBuilder live = series->builder;
+    if (bar_fold(series, &live, &points[closed]) != 0) {
+        series->count = series->closed;
+        return -1;
+    }
+    if (series->type == BAR_RANGE && live.open && bar_emit(series, &live.current) != 0) {
+        series->count = series->closed;
+        return -1;
+    }
+    return 0;
+}
+
+// First bar closing at or after @p timestamp; the last bar when none does.
+int bar_series_find(const BarSeries *series, uint64_t timestamp) {
+    if (series->count <= 0) {
+        return -1;
+    }
+    int lo = 0;
+    int hi = series->count - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (series->bars[mid].close_time >= timestamp) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
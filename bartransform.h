@@ -0,0 +1,124 @@
+#ifndef CTICKER_BARTRANSFORM_H
+#define CTICKER_BARTRANSFORM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/** Derived series kept at once (least recently used is evicted). */
+#define BAR_CACHE_SLOTS 8
+
+/**
+ * @brief How the chart draws its candles.
+ */
+typedef enum {
+    BAR_CANDLES,
+    /** Smoothed candles: close = OHLC average, open = midpoint of the previous bar. */
+    BAR_HEIKIN_ASHI,
+    /** Fixed-size bricks added each time the close moves a box past the last brick. */
+    BAR_RENKO,
+    /** Bars closed once their high-low span reaches the box. */
+    BAR_RANGE,
+    BAR_TYPE_COUNT
+} BarType;
+
+/**
+ * @brief Builder state carried from one source candle to the next.
+ */
+typedef struct {
+    /** Bar still being built (range bars; Renko volume until the next brick). */
+    PricePoint current;
+    bool open;
+    /** A candle has been folded in (Heikin-Ashi and Renko need a seed). */
+    bool seeded;
+    /** Heikin-Ashi: open and close of the previous bar. */
+    double ha_open;
+    double ha_close;
+    /** Renko: bottom and top of the last brick. */
+    double brick_low;
+    double brick_high;
+} BarBuilder;
+
+/**
+ * @brief Bars derived from one (symbol, period, type, box) candle stream.
+ *
+ * Closed candles are folded in once: a later sync finds the last folded
+ * candle in the new series (binary search on timestamps) and folds only
+ * the candles after it, so neither a new frame nor a reload of the same
+ * interval recomputes the series. The live candle is folded into a copy
+ * of the builder on every sync and its bars appended after the committed
+ * ones. A Renko brick still forming is not shown.
+ *
+ * Bar timestamps are those of the first candle a bar covers and close
+ * times those of the candle that completed it.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    Period period;
+    BarType type;
+    /** Box as a percentage of the first close, and in price once built. */
+    double box_percent;
+    double box;
+    /** Output bars; the first @ref closed come from closed candles only. */
+    PricePoint *bars;
+    int count;
+    int closed;
+    int capacity;
+    /** State after the closed candles. */
+    BarBuilder builder;
+    /** First candle covered, and the last closed candle folded in (0 = none yet). */
+    uint64_t first_timestamp;
+    uint64_t last_timestamp;
+    double last_close;
+    /** Cache bookkeeping: tick of the last lookup (0 = free slot). */
+    uint64_t last_used;
+    /** Statistics: closed candles folded and full rebuilds. */
+    uint64_t candles_folded;
+    uint64_t rebuilds;
+} BarSeries;
+
+/**
+ * @brief Small LRU cache of derived bar series.
+ */
+typedef struct {
+    BarSeries slots[BAR_CACHE_SLOTS];
+    uint64_t tick;
+} BarCache;
+
+/**
+ * @brief Start with an empty cache.
+ */
+void bar_cache_init(BarCache *cache);
+
+/**
+ * @brief Release every cached series.
+ */
+void bar_cache_free(BarCache *cache);
+
+/**
+ * @brief Series for the given key, recycling the least recently used slot
+ *        when it is not cached.
+ *
+ * @return The slot; call bar_series_sync() before reading its bars.
+ */
+BarSeries *bar_cache_get(BarCache *cache, const char *symbol, Period period, BarType type,
+                         double box_percent);
+
+/**
+ * @brief Bring @p series up to date with candles @p points (last one live).
+ *
+ * Candles older than @p points[0] are dropped from the front; earlier
+ * history than was folded, or a series that no longer contains the last
+ * folded candle, rebuilds from scratch.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int bar_series_sync(BarSeries *series, const PricePoint *points, int count);
+
+/**
+ * @brief Index of the bar covering the candle opening at @p timestamp
+ *        (the last bar when none does yet), or -1 when there are no bars.
+ */
+int bar_series_find(const BarSeries *series, uint64_t timestamp);
+
+#endif
@@ -0,0 +1,167 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file candle_cache.c
+ * @brief Shared in-memory cache of chart candle windows.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "candle_cache.h"
+
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    Period period;
+    PricePoint *points;
+    int count;
+    time_t fetched_at;
+    /** Access stamp for LRU eviction (0 = empty slot). */
+    uint64_t last_used;
+} CandleCacheSlot;
+
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static CandleCacheSlot cache_slots[CANDLE_CACHE_SLOTS];
+static uint64_t cache_clock = 0;
+
+// Copy a series into a fresh caller-owned buffer.
+static int copy_points(const PricePoint *src, int count, PricePoint **points, int *out_count) {
+    PricePoint *copy = malloc((size_t)(count > 0 ? count : 1) * sizeof(PricePoint));
+    if (!copy) {
+        return -1;
+    }
+    if (count > 0) {
+        memcpy(copy, src, (size_t)count * sizeof(PricePoint));
+    }
+    *points = copy;
+    *out_count = count;
+    return 0;
+}
+
+// Find the slot of a series, or -1.
+static int find_slot(const char *symbol, Period period) {
+    for (int i = 0; i < CANDLE_CACHE_SLOTS; i++) {
+        if (cache_slots[i].last_used && cache_slots[i].period == period &&
+            strcmp(cache_slots[i].symbol, symbol) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Pick an empty slot, else the least recently used one.
+static int victim_slot(void) {
+    int victim = 0;
+    for (int i = 0; i < CANDLE_CACHE_SLOTS; i++) {
+        if (!cache_slots[i].last_used) {
+            return i;
+        }
+        if (cache_slots[i].last_used < cache_slots[victim].last_used) {
+            victim = i;
+        }
+    }
+    return victim;
+}
+
+// Store an owned series under (symbol, period); caller holds cache_mutex.
+static void store_slot(const char *symbol, Period period, PricePoint *points, int count,
+                       time_t fetched_at) {
+    int slot = find_slot(symbol, period);
+    if (slot < 0) {
+        slot = victim_slot();
+    }
+    CandleCacheSlot *entry = &cache_slots[slot];
+    free(entry->points);
+    snprintf(entry->symbol, sizeof(entry->symbol), "%s", symbol);
+    entry->period = period;
+    entry->points = points;
+    entry->count = count;
+    entry->fetched_at = fetched_at;
+    entry->last_used = ++cache_clock;
+}
+
+int candle_cache_get(const char *symbol, Period period, bool refresh,
+                     PricePoint **points, int *count) {
+    *points = NULL;
+    *count = 0;
+    time_t now = time(NULL);
+
+    pthread_mutex_lock(&cache_mutex);
+    int slot = find_slot(symbol, period);
+    if (slot >= 0 && !refresh) {
+        CandleCacheSlot *entry = &cache_slots[slot];
+        bool open_candle = entry->count > 0 &&
+                           (uint64_t)now < entry->points[entry->count - 1].close_time;
+        if (open_candle && now - entry->fetched_at < CANDLE_CACHE_TTL) {
+            entry->last_used = ++cache_clock;
+            int rc = copy_points(entry->points, entry->count, points, count);
+            pthread_mutex_unlock(&cache_mutex);
+            return rc;
+        }
+    }
+    pthread_mutex_unlock(&cache_mutex);
+
+    // Fetch outside the lock; concurrent misses may both fetch, last one wins.
+    PricePoint *fresh = NULL;
+    int fresh_count = 0;
+    int rc = fetch_historical_data(symbol, period, &fresh, &fresh_count);
+    if (rc != 0) {
+        free(fresh);
+        return rc;
+    }
+    if (copy_points(fresh, fresh_count, points, count) != 0) {
+        free(fresh);
+        return -1;
+    }
+
+    pthread_mutex_lock(&cache_mutex);
+    store_slot(symbol, period, fresh, fresh_count, now);
+    pthread_mutex_unlock(&cache_mutex);
+    return 0;
+}
+
+int candle_cache_put(const char *symbol, Period period, const PricePoint *points, int count) {
+    PricePoint *copy = NULL;
+    int copy_count = 0;
+    if (copy_points(points, count, &copy, &copy_count) != 0) {
+        return -1;
+    }
+    pthread_mutex_lock(&cache_mutex);
+    store_slot(symbol, period, copy, copy_count, time(NULL));
+    pthread_mutex_unlock(&cache_mutex);
+    return 0;
+}
+
+void candle_cache_clear(void) {
+    pthread_mutex_lock(&cache_mutex);
+    for (int i = 0; i < CANDLE_CACHE_SLOTS; i++) {
+        free(cache_slots[i].points);
+        memset(&cache_slots[i], 0, sizeof(cache_slots[i]));
+    }
+    pthread_mutex_unlock(&cache_mutex);
+}
@@ -0,0 +1,43 @@
+#ifndef CTICKER_CANDLE_CACHE_H
+#define CTICKER_CANDLE_CACHE_H
+
+#include <stdbool.h>
+#include "cticker.h"
+
+/** Cached (symbol, period) series kept in memory. */
+#define CANDLE_CACHE_SLOTS 64
+
+/** Seconds a cached series is reused while its last candle is still open. */
+#define CANDLE_CACHE_TTL 30
+
+/**
+ * @brief Chart window for @p symbol / @p period, served from a process-wide
+ *        cache shared by plain, synthetic and basket charts.
+ *
+ * A series is re-fetched once its last candle has closed, after
+ * ::CANDLE_CACHE_TTL seconds, or when @p refresh is set; the least recently
+ * used slot is evicted when the cache is full. Thread-safe.
+ *
+ * @param[out] points Allocated copy on success; caller frees it.
+ * @return 0 on success, non-zero on failure.
+ */
+int candle_cache_get(const char *symbol, Period period, bool refresh,
+                     PricePoint **points, int *count);
+
+/**
+ * @brief Replace the cached series for @p symbol / @p period with a copy of
+ *        @p points, e.g. after patching gaps, so other charts reuse it.
+ *
+ * The series counts as freshly fetched for the ::CANDLE_CACHE_TTL check.
+ * Thread-safe.
+ *
+ * @return 0 on success, -1 on allocation failure (the cache is unchanged).
+ */
+int candle_cache_put(const char *symbol, Period period, const PricePoint *points, int count);
+
+/**
+ * @brief Drop every cached series (tests, memory pressure).
+ */
+void candle_cache_clear(void);
+
+#endif
@@ -0,0 +1,248 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file candle_gaps.c
+ * @brief Detect holes in candle series and fetch exactly the missing ranges.
+ *
+ * After an outage or a suspended laptop the chart array (and the candle
+ * store) stop at the moment the process lost the network. Instead of
+ * reloading the whole window, the repair path scans for discontinuities,
+ * requests only the missing open-time ranges and merges the answers into
+ * the existing array. A two-hour hole on a 1m chart costs one request.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "candle_gaps.h"
+
+// Candles per REST request (Binance maximum).
+#define CANDLE_GAP_PAGE_LIMIT 1000
+// Interior gaps examined per chart repair.
+#define CANDLE_GAP_SCAN_MAX 32
+// Remembered gaps that the exchange has no data for.
+#define KNOWN_EMPTY_SLOTS 64
+
+/**
+ * @brief Ring of gaps that came back empty (e.g. exchange maintenance).
+ */
+static struct {
+    pthread_mutex_t mutex;
+    struct {
+        char symbol[MAX_SYMBOL_LEN];
+        Period period;
+        CandleGap gap;
+    } slots[KNOWN_EMPTY_SLOTS];
+    int used;
+    int next;
+} known_empty = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+static bool known_empty_contains(const char *symbol, Period period, const CandleGap *gap) {
+    bool found = false;
+    pthread_mutex_lock(&known_empty.mutex);
+    for (int i = 0; i < known_empty.used && !found; i++) {
+        found = known_empty.slots[i].period == period &&
+                known_empty.slots[i].gap.start == gap->start &&
+                known_empty.slots[i].gap.end == gap->end &&
+                strcmp(known_empty.slots[i].symbol, symbol) == 0;
+    }
+    pthread_mutex_unlock(&known_empty.mutex);
+    return found;
+}
+
+static void known_empty_add(const char *symbol, Period period, const CandleGap *gap) {
+    pthread_mutex_lock(&known_empty.mutex);
+    int slot = known_empty.next;
+    snprintf(known_empty.slots[slot].symbol, MAX_SYMBOL_LEN, "%s", symbol);
+    known_empty.slots[slot].period = period;
+    known_empty.slots[slot].gap = *gap;
+    known_empty.next = (slot + 1) % KNOWN_EMPTY_SLOTS;
+    if (known_empty.used < KNOWN_EMPTY_SLOTS) {
+        known_empty.used++;
+    }
+    pthread_mutex_unlock(&known_empty.mutex);
+}
+
+size_t candle_gaps_find_points(const PricePoint *points, int count,
+                               CandleGap *gaps, size_t max) {
+    size_t found = 0;
+    for (int i = 1; i < count && found < max; i++) {
+        uint64_t expected = points[i - 1].close_time + 1;
+        if (points[i].timestamp > expected) {
+            gaps[found].start = expected;
+            gaps[found].end = points[i].timestamp - 1;
+            found++;
+        }
+    }
+    return found;
+}
+
+size_t candle_gaps_find_records(const CandleRecord *records, size_t count,
+                                CandleGap *gaps, size_t max) {
+    size_t found = 0;
+    for (size_t i = 1; i < count && found < max; i++) {
+        uint64_t expected = records[i - 1].close_time + 1;
+        if (records[i].timestamp > expected) {
+            gaps[found].start = expected;
+            gaps[found].end = records[i].timestamp - 1;
+            found++;
+        }
+    }
+    return found;
+}
+
+int candle_gaps_fetch(const char *symbol, Period period, const CandleGap *gap,
+                      PricePoint **points, int *count, int *requests) {
+    *points = NULL;
+    *count = 0;
+    if (gap->end && known_empty_contains(symbol, period, gap)) {
+        return 0;
+    }
+
+    PricePoint *all = NULL;
+    int total = 0;
+    uint64_t cursor = gap->start;
+    for (int page = 0; page < CANDLE_GAP_MAX_PAGES; page++) {
+        PricePoint *chunk = NULL;
+        int n = 0;
+        if (requests) {
+            (*requests)++;
+        }
+        if (fetch_historical_range(symbol, period, cursor, gap->end, CANDLE_GAP_PAGE_LIMIT,
+                                   &chunk, &n) != 0) {
+            free(chunk);
+            free(all);
+            return -1;
+        }
+        if (n > 0) {
+            PricePoint *grown = realloc(all, sizeof(PricePoint) * (size_t)(total + n));
+            if (!grown) {
+                free(chunk);
+                free(all);
+                return -1;
+            }
+            all = grown;
+            memcpy(all + total, chunk, sizeof(PricePoint) * (size_t)n);
+            total += n;
+        }
+        uint64_t next = n > 0 ? chunk[n - 1].close_time + 1 : cursor;
+        free(chunk);
+        if (n < CANDLE_GAP_PAGE_LIMIT || next <= cursor || (gap->end && next > gap->end)) {
+            break;
+        }
+        cursor = next;
+    }
+
+    if (total == 0 && gap->end) {
+        known_empty_add(symbol, period, gap);
+    }
+    *points = all;
+    *count = total;
+    return 0;
+}
+
+/**
+ * @brief Merge sorted @p fresh candles into sorted @p *points in place.
+ *
+ * Grows the array once and merges from the back; a fresh candle replaces
+ * an existing one with the same open time.
+ */
+static int merge_points(PricePoint **points, int *count, const PricePoint *fresh,
+                        int fresh_count) {
+    if (fresh_count <= 0) {
+        return 0;
+    }
+    PricePoint *merged = realloc(*points, sizeof(PricePoint) * (size_t)(*count + fresh_count));
+    if (!merged) {
+        return -1;
+    }
+    *points = merged;
+
+    int i = *count - 1;
+    int j = fresh_count - 1;
+    int w = *count + fresh_count - 1;
+    while (j >= 0) {
+        if (i >= 0 && merged[i].timestamp > fresh[j].timestamp) {
+            merged[w--] = merged[i--];
+        } else {
+            if (i >= 0 && merged[i].timestamp == fresh[j].timestamp) {
+                i--;
+            }
+            merged[w--] = fresh[j--];
+        }
+    }
+
+    /* Close the hole left behind by replaced duplicates. */
+    int head = i + 1;
+    int tail = w + 1;
+    int tail_len = *count + fresh_count - tail;
+    if (tail != head) {
+        memmove(merged + head, merged + tail, sizeof(PricePoint) * (size_t)tail_len);
+    }
+    *count = head + tail_len;
+    return 0;
+}
+
+int candle_gaps_repair_points(const char *symbol, Period period, uint64_t now,
+                              PricePoint **points, int *count, int *requests) {
+    if (!*points || *count <= 0) {
+        return 1;
+    }
+
+    const PricePoint *last = &(*points)[*count - 1];
+    uint64_t spacing = period_seconds(period);
+    if (spacing && now > last->timestamp && (now - last->timestamp) / spacing >= (uint64_t)*count) {
+        return 1;
+    }
+
+    CandleGap gaps[CANDLE_GAP_SCAN_MAX + 1];
+    size_t gap_count = candle_gaps_find_points(*points, *count, gaps, CANDLE_GAP_SCAN_MAX);
+    /* The last candle may still have been open when it was fetched. */
+    gaps[gap_count].start = last->timestamp;
+    gaps[gap_count].end = 0;
+    gap_count++;
+
+    int window = *count;
+    for (size_t g = 0; g < gap_count; g++) {
+        PricePoint *fresh = NULL;
+        int fresh_count = 0;
+        if (candle_gaps_fetch(symbol, period, &gaps[g], &fresh, &fresh_count, requests) != 0) {
+            return -1;
+        }
+        int rc = merge_points(points, count, fresh, fresh_count);
+        free(fresh);
+        if (rc != 0) {
+            return -1;
+        }
+    }
+
+    if (*count > window) {
+        int drop = *count - window;
+        memmove(*points, *points + drop, sizeof(PricePoint) * (size_t)window);
+        *count = window;
+    }
+    return 0;
+}
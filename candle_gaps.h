@@ -0,0 +1,64 @@
+#ifndef CTICKER_CANDLE_GAPS_H
+#define CTICKER_CANDLE_GAPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "candle_store.h"
+#include "cticker.h"
+
+/** Upper bound on requests spent on a single gap. */
+#define CANDLE_GAP_MAX_PAGES 16
+
+/**
+ * @brief A run of missing candles, as open times [start, end] (inclusive).
+ *
+ * Gaps are found from candle continuity: a candle is expected to open one
+ * second after its predecessor's close time, which also holds for the
+ * irregular monthly period.
+ */
+typedef struct {
+    uint64_t start;
+    uint64_t end;
+} CandleGap;
+
+/**
+ * @brief Find holes between consecutive chart candles.
+ * @return Number of gaps written to @p gaps (at most @p max).
+ */
+size_t candle_gaps_find_points(const PricePoint *points, int count,
+                               CandleGap *gaps, size_t max);
+
+/**
+ * @brief Find holes between consecutive stored candles.
+ * @return Number of gaps written to @p gaps (at most @p max).
+ */
+size_t candle_gaps_find_records(const CandleRecord *records, size_t count,
+                                CandleGap *gaps, size_t max);
+
+/**
+ * @brief Download the candles of one gap (paged, rate limited).
+ *
+ * An @p gap end of 0 means "up to now". Gaps that come back empty (exchange
+ * downtime) are remembered so later scans do not request them again.
+ *
+ * @param[out] points Allocated array on success; caller frees it.
+ * @param[out] requests Incremented by the number of REST requests made.
+ * @return 0 on success, -1 on network/parse errors.
+ */
+int candle_gaps_fetch(const char *symbol, Period period, const CandleGap *gap,
+                      PricePoint **points, int *count, int *requests);
+
+/**
+ * @brief Bring a chart candle array up to date with targeted requests.
+ *
+ * Fills interior holes plus the tail from the last (possibly still open)
+ * candle to now and merges the results in place, dropping the oldest
+ * candles so the window keeps its size.
+ *
+ * @return 0 on success, 1 when the tail gap is wider than the window (the
+ *         caller should do a full reload instead), -1 on failure.
+ */
+int candle_gaps_repair_points(const char *symbol, Period period, uint64_t now,
+                              PricePoint **points, int *count, int *requests);
+
+#endif
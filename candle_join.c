@@ -0,0 +1,267 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file candle_join.c
+ * @brief Timestamp-aligned merge-join of candle series.
+ */
+
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "candle_join.h"
+
+int candle_join_align(const PricePoint *const *series, const int *counts, int n,
+                      CandleJoin *join) {
+    memset(join, 0, sizeof(*join));
+    if (n <= 0) {
+        return 0;
+    }
+    int capacity = counts[0];
+    for (int s = 1; s < n; s++) {
+        if (counts[s] < capacity) {
+            capacity = counts[s];
+        }
+    }
+    if (capacity <= 0) {
+        join->series = n;
+        return 0;
+    }
+    int *positions = malloc((size_t)n * (size_t)capacity * sizeof(int));
+    int *cursor = calloc((size_t)n, sizeof(int));
+    if (!positions || !cursor) {
+        free(positions);
+        free(cursor);
+        return -1;
+    }
+
+    int rows = 0;
+    for (;;) {
+        // Target the latest head; every series must catch up to it.
+        uint64_t target = 0;
+        bool done = false;
+        for (int s = 0; s < n; s++) {
+            if (cursor[s] >= counts[s]) {
+                done = true;
+                break;
+            }
+            uint64_t ts = series[s][cursor[s]].timestamp;
+            if (ts > target) {
+                target = ts;
+            }
+        }
+        if (done) {
+            break;
+        }
+        bool aligned = true;
+        for (int s = 0; s < n; s++) {
+            while (cursor[s] < counts[s] && series[s][cursor[s]].timestamp < target) {
+                cursor[s]++;
+            }
+            if (cursor[s] >= counts[s] || series[s][cursor[s]].timestamp != target) {
+                aligned = false;
+            }
+        }
+        if (!aligned) {
+            continue;
+        }
+        for (int s = 0; s < n; s++) {
+            positions[s * capacity + rows] = cursor[s]++;
+        }
+        rows++;
+    }
+
+    free(cursor);
+    join->positions = positions;
+    join->series = n;
+    join->rows = rows;
+    join->capacity = capacity;
+    return 0;
+}
+
+void candle_join_left(const PricePoint *primary, int count, const PricePoint *other,
+                      int other_count, int *positions) {
+    int j = 0;
+    for (int i = 0; i < count; i++) {
+        uint64_t ts = primary[i].timestamp;
+        while (j < other_count && other[j].timestamp < ts) {
+            j++;
+        }
+        positions[i] = (j < other_count && other[j].timestamp == ts) ? j : -1;
+    }
+}
+
+void candle_join_free(CandleJoin *join) {
+    if (!join) {
+        return;
+    }
+    free(join->positions);
+    memset(join, 0, sizeof(*join));
+}
+
+// Raise to a small integer power without pow() for the common +/-1 case.
+static inline double ipow(double value, int exponent) {
+    if (exponent == 1) {
+        return value;
+    }
+    if (exponent == -1) {
+        return 1.0 / value;
+    }
+    return pow(value, exponent);
+}
+
+int candle_join_product(const PricePoint *const *series, const int *counts,
+                        const int *exponents, int n, PricePoint **out, int *out_count) {
+    *out = NULL;
+    *out_count = 0;
+    CandleJoin join;
+    if (candle_join_align(series, counts, n, &join) != 0) {
+        return -1;
+    }
+    PricePoint *points = calloc(join.rows > 0 ? (size_t)join.rows : 1, sizeof(PricePoint));
+    if (!points) {
+        candle_join_free(&join);
+        return -1;
+    }
+
+    for (int r = 0; r < join.rows; r++) {
+        PricePoint *point = &points[r];
+        point->open = 1.0;
+        point->high = 1.0;
+        point->low = 1.0;
+        point->close = 1.0;
+        for (int s = 0; s < n; s++) {
+            const PricePoint *src = &series[s][join.positions[s * join.capacity + r]];
+            int e = exponents[s];
+            point->open *= ipow(src->open, e);
+            point->close *= ipow(src->close, e);
+            // Dividing by a term moves opposite to it: its low bounds our high.
+            point->high *= ipow(e > 0 ? src->high : src->low, e);
+            point->low *= ipow(e > 0 ? src->low : src->high, e);
+        }
+        const PricePoint *first = &series[0][join.positions[r]];
+        point->timestamp = first->timestamp;
+        point->close_time = first->close_time;
+        point->high = fmax(point->high, fmax(point->open, point->close));
+        point->low = fmin(point->low, fmin(point->open, point->close));
+    }
+
+    *out = points;
+    *out_count = join.rows;
+    candle_join_free(&join);
+    return 0;
+}
+
+// Gather one double field of the aligned rows of a series into @p column.
+static void gather_column(const PricePoint *series, const int *positions, int rows,
+                          size_t field, double *restrict column) {
+    const char *base = (const char *)series;
+    for (int r = 0; r < rows; r++) {
+        memcpy(&column[r], base + (size_t)positions[r] * sizeof(PricePoint) + field,
+               sizeof(double));
+    }
+}
+
+// acc[r] += weight * column[r]; unrolled by four so the block is vectorised
+// even under -O2's cheap vectoriser cost model.
+static void axpy_column(double *restrict acc, const double *restrict column,
+                        double weight, int rows) {
+    int r = 0;
+    for (; r + 4 <= rows; r += 4) {
+        acc[r] += weight * column[r];
+        acc[r + 1] += weight * column[r + 1];
+        acc[r + 2] += weight * column[r + 2];
+        acc[r + 3] += weight * column[r + 3];
+    }
+    for (; r < rows; r++) {
+        acc[r] += weight * column[r];
+    }
+}
+
+int candle_join_weighted(const PricePoint *const *series, const int *counts,
+                         const double *weights, int n, PricePoint **out, int *out_count) {
+    *out = NULL;
+    *out_count = 0;
+    CandleJoin join;
+    if (candle_join_align(series, counts, n, &join) != 0) {
+        return -1;
+    }
+    int rows = join.rows;
+    size_t cells = rows > 0 ? (size_t)rows : 1;
+    // Accumulators open/high/low/close/quote volume, plus one gather column.
+    double *columns = calloc(6 * cells, sizeof(double));
+    PricePoint *points = calloc(cells, sizeof(PricePoint));
+    if (!columns || !points) {
+        free(columns);
+        free(points);
+        candle_join_free(&join);
+        return -1;
+    }
+    double *open = columns;
+    double *high = columns + cells;
+    double *low = columns + 2 * cells;
+    double *close = columns + 3 * cells;
+    double *quote = columns + 4 * cells;
+    double *scratch = columns + 5 * cells;
+
+    for (int s = 0; s < n; s++) {
+        const int *positions = join.positions + (size_t)s * (size_t)join.capacity;
+        double w = weights[s];
+        gather_column(series[s], positions, rows, offsetof(PricePoint, open), scratch);
+        axpy_column(open, scratch, w, rows);
+        gather_column(series[s], positions, rows, offsetof(PricePoint, close), scratch);
+        axpy_column(close, scratch, w, rows);
+        // A short leg's low bounds the index high and vice versa.
+        gather_column(series[s], positions, rows,
+                      w > 0 ? offsetof(PricePoint, high) : offsetof(PricePoint, low), scratch);
+        axpy_column(high, scratch, w, rows);
+        gather_column(series[s], positions, rows,
+                      w > 0 ? offsetof(PricePoint, low) : offsetof(PricePoint, high), scratch);
+        axpy_column(low, scratch, w, rows);
+        gather_column(series[s], positions, rows, offsetof(PricePoint, quote_volume), scratch);
+        axpy_column(quote, scratch, 1.0, rows);
+        for (int r = 0; r < rows; r++) {
+            points[r].trade_count += series[s][positions[r]].trade_count;
+        }
+    }
+
+    for (int r = 0; r < rows; r++) {
+        const PricePoint *first = &series[0][join.positions[r]];
+        PricePoint *point = &points[r];
+        point->timestamp = first->timestamp;
+        point->close_time = first->close_time;
+        point->open = open[r];
+        point->close = close[r];
+        point->high = fmax(high[r], fmax(open[r], close[r]));
+        point->low = fmin(low[r], fmin(open[r], close[r]));
+        point->quote_volume = quote[r];
+    }
+
+    free(columns);
+    candle_join_free(&join);
+    *out = points;
+    *out_count = rows;
+    return 0;
+}
@@ -0,0 +1,73 @@
+#ifndef CTICKER_CANDLE_JOIN_H
+#define CTICKER_CANDLE_JOIN_H
+
+#include "cticker.h"
+
+/**
+ * @brief Rows shared by several candle series, aligned on open time.
+ *
+ * Column-major: the position in series s of aligned row r is
+ * `positions[s * capacity + r]`, so per-series columns are contiguous.
+ */
+typedef struct {
+    int *positions;
+    int series;
+    int rows;
+    int capacity;
+} CandleJoin;
+
+/**
+ * @brief Inner-join @p n sorted candle series on ::PricePoint::timestamp.
+ *
+ * A single merge pass over all inputs; candles missing from any series
+ * are dropped.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int candle_join_align(const PricePoint *const *series, const int *counts, int n,
+                      CandleJoin *join);
+
+/**
+ * @brief For each candle of @p primary, the position of the candle with the
+ *        same open time in @p other, or -1 where @p other has a gap.
+ *
+ * A single linear merge pass over both sorted series.
+ */
+void candle_join_left(const PricePoint *primary, int count, const PricePoint *other,
+                      int other_count, int *positions);
+
+/**
+ * @brief Release memory owned by @p join.
+ */
+void candle_join_free(CandleJoin *join);
+
+/**
+ * @brief Candles of the product of powers of @p n series
+ *        (e.g. exponents {1, -1} for a cross rate A / B).
+ *
+ * Open and close are exact. High and low take each constituent's extreme in
+ * the direction it moves the result, an envelope of the true range since
+ * the extremes need not coincide. Volumes are left at zero.
+ *
+ * @param[out] out Allocated array on success; caller frees it.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int candle_join_product(const PricePoint *const *series, const int *counts,
+                        const int *exponents, int n, PricePoint **out, int *out_count);
+
+/**
+ * @brief Candles of the weighted sum of @p n series (basket index).
+ *
+ * After alignment each field is gathered into contiguous per-series
+ * columns and accumulated with straight multiply-add loops the compiler
+ * vectorises. High/low sum each constituent's extreme in the direction its
+ * weight moves the index (an envelope of the true range); quote volumes and
+ * trade counts are summed.
+ *
+ * @param[out] out Allocated array on success; caller frees it.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int candle_join_weighted(const PricePoint *const *series, const int *counts,
+                         const double *weights, int n, PricePoint **out, int *out_count);
+
+#endif
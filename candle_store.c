@@ -0,0 +1,455 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file candle_store.c
+ * @brief Local on-disk candle store (one mmap'd file per symbol + period).
+ *
+ * File layout: a 64-byte ::CandleStoreHeader followed by ::CandleRecord
+ * entries sorted by open time. Files live in `$HOME/.cticker/candles` and
+ * are named `<SYMBOL>-<tag>.candles`.
+ *
+ * Write strategy:
+ * - Appends and tail overwrites (the still-open candle, resumed backfills)
+ *   are written in place with pwrite(); the header count is updated last.
+ * - Anything that has to land in the middle of the file rewrites it into a
+ *   temporary file (unique per writer) that is renamed over the original.
+ * - Writers hold an exclusive flock() on the file for as long as the store
+ *   is open, so `import` and `backfill` on the same series take turns.
+ *   Readers take no lock: they only ever see committed records.
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "candle_store.h"
+
+#define CANDLE_STORE_MAGIC "CTCNDL01"
+#define CANDLE_STORE_SUBDIR "candles"
+
+// File name tags per period; avoids "1m" vs "1M" clashing on
+// case-insensitive file systems.
+static const char *const store_tags[PERIOD_COUNT] = {
+    [PERIOD_1MIN] = "1m",
+    [PERIOD_15MIN] = "15m",
+    [PERIOD_1HOUR] = "1h",
+    [PERIOD_4HOUR] = "4h",
+    [PERIOD_1DAY] = "1d",
+    [PERIOD_1WEEK] = "1w",
+    [PERIOD_1MONTH] = "1mo",
+};
+
+// Byte offset of record @p index within the file.
+static off_t record_offset(uint64_t index) {
+    return (off_t)(sizeof(CandleStoreHeader) + index * sizeof(CandleRecord));
+}
+
+// Write a whole buffer at @p offset, retrying short writes.
+static int write_fully(int fd, const void *buf, size_t len, off_t offset) {
+    const char *cursor = buf;
+    while (len > 0) {
+        ssize_t written = pwrite(fd, cursor, len, offset);
+        if (written <= 0) {
+            return -1;
+        }
+        cursor += written;
+        len -= (size_t)written;
+        offset += written;
+    }
+    return 0;
+}
+
+// Fill a fresh header for this store.
+static void init_header(const CandleStore *store, CandleStoreHeader *header, uint64_t count) {
+    memset(header, 0, sizeof(*header));
+    memcpy(header->magic, CANDLE_STORE_MAGIC, sizeof(header->magic));
+    header->record_size = sizeof(CandleRecord);
+    header->period = (uint32_t)store->period;
+    header->count = count;
+    snprintf(header->symbol, sizeof(header->symbol), "%s", store->symbol);
+}
+
+// Persist the committed record count.
+static int write_count(int fd, uint64_t count) {
+    return write_fully(fd, &count, sizeof(count), offsetof(CandleStoreHeader, count));
+}
+
+// Drop the current mapping.
+static void unmap_store(CandleStore *store) {
+    if (store->map) {
+        munmap(store->map, store->map_length);
+    }
+    store->map = NULL;
+    store->map_length = 0;
+    store->records = NULL;
+    store->count = 0;
+}
+
+// Re-read the header and map all committed records read-only.
+static int remap_store(CandleStore *store) {
+    unmap_store(store);
+
+    CandleStoreHeader header;
+    if (pread(store->fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        return -1;
+    }
+    if (memcmp(header.magic, CANDLE_STORE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.record_size != sizeof(CandleRecord) ||
+        header.period != (uint32_t)store->period) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(store->fd, &st) != 0) {
+        return -1;
+    }
+    size_t needed = (size_t)record_offset(header.count);
+    if ((size_t)st.st_size < needed) {
+        return -1;
+    }
+    if (header.count == 0) {
+        return 0;
+    }
+
+    void *map = mmap(NULL, needed, PROT_READ, MAP_SHARED, store->fd, 0);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    /* Queries scan forward; let the kernel read ahead aggressively. */
+    madvise(map, needed, MADV_SEQUENTIAL);
+
+    store->map = map;
+    store->map_length = needed;
+    store->records = (const CandleRecord *)((const char *)map + sizeof(CandleStoreHeader));
+    store->count = header.count;
+    return 0;
+}
+
+// Open (creating) the store file and wait for its writer lock. A rewrite
+// may have renamed a new file over the path while we waited; lock that one.
+static int open_locked(const char *path) {
+    for (;;) {
+        int fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            return -1;
+        }
+        struct stat held, current;
+        if (flock(fd, LOCK_EX) != 0 || fstat(fd, &held) != 0) {
+            close(fd);
+            return -1;
+        }
+        if (stat(path, &current) == 0 && held.st_dev == current.st_dev &&
+            held.st_ino == current.st_ino) {
+            return fd;
+        }
+        close(fd);
+    }
+}
+
+int candle_store_open(CandleStore *store, const char *symbol, Period period, bool writable) {
+    if (!store || !symbol || !symbol[0] || (int)period < 0 || period >= PERIOD_COUNT ||
+        period_is_local(period)) {
+        return -1;
+    }
+    memset(store, 0, sizeof(*store));
+    store->fd = -1;
+    store->writable = writable;
+    store->period = period;
+    snprintf(store->symbol, sizeof(store->symbol), "%s", symbol);
+
+    char dir[512];
+    if (config_data_path(dir, sizeof(dir), CANDLE_STORE_SUBDIR) != 0) {
+        return -1;
+    }
+    int written = snprintf(store->path, sizeof(store->path), "%s/%s-%s.candles",
+                           dir, symbol, store_tags[period]);
+    if (written < 0 || (size_t)written >= sizeof(store->path)) {
+        return -1;
+    }
+
+    store->fd = writable ? open_locked(store->path) : open(store->path, O_RDONLY);
+    if (store->fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(store->fd, &st) != 0) {
+        candle_store_close(store);
+        return -1;
+    }
+    if (st.st_size == 0 && writable) {
+        CandleStoreHeader header;
+        init_header(store, &header, 0);
+        if (write_fully(store->fd, &header, sizeof(header), 0) != 0) {
+            candle_store_close(store);
+            return -1;
+        }
+    }
+
+    if (remap_store(store) != 0) {
+        candle_store_close(store);
+        return -1;
+    }
+    return 0;
+}
+
+void candle_store_close(CandleStore *store) {
+    if (!store) {
+        return;
+    }
+    unmap_store(store);
+    if (store->fd >= 0) {
+        close(store->fd);
+    }
+    store->fd = -1;
+}
+
+size_t candle_store_lower_bound(const CandleStore *store, uint64_t timestamp) {
+    size_t low = 0;
+    size_t high = (size_t)store->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (store->records[mid].timestamp < timestamp) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Write @p count records at @p index and commit the new total.
+static int write_in_place(CandleStore *store, uint64_t index,
+                          const CandleRecord *records, size_t count) {
+    if (write_fully(store->fd, records, count * sizeof(CandleRecord),
+                    record_offset(index)) != 0) {
+        return -1;
+    }
+    uint64_t total = index + count;
+    if (total < store->count) {
+        total = store->count;
+    }
+    if (write_count(store->fd, total) != 0) {
+        return -1;
+    }
+    return remap_store(store);
+}
+
+// Merge existing and incoming records into a new file and swap it in.
+static long rewrite_merged(CandleStore *store, const CandleRecord *records, size_t count) {
+    size_t existing = (size_t)store->count;
+    CandleRecord *merged = malloc((existing + count) * sizeof(CandleRecord));
+    if (!merged) {
+        return -1;
+    }
+
+    size_t i = 0, j = 0, out = 0;
+    long added = 0;
+    while (i < existing || j < count) {
+        if (j >= count || (i < existing && store->records[i].timestamp < records[j].timestamp)) {
+            merged[out++] = store->records[i++];
+        } else if (i >= existing || records[j].timestamp < store->records[i].timestamp) {
+            merged[out++] = records[j++];
+            added++;
+        } else {
+            /* Same open time: the incoming candle is newer information. */
+            merged[out++] = records[j++];
+            i++;
+        }
+    }
+
+    char tmp_path[sizeof(store->path) + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", store->path);
+    int fd = mkstemp(tmp_path);
+    if (fd < 0) {
+        free(merged);
+        return -1;
+    }
+    // Lock before the rename so the new file is never unlocked under its name.
+    if (fchmod(fd, 0644) != 0 || flock(fd, LOCK_EX) != 0) {
+        close(fd);
+        unlink(tmp_path);
+        free(merged);
+        return -1;
+    }
+
+    CandleStoreHeader header;
+    init_header(store, &header, out);
+    int rc = write_fully(fd, &header, sizeof(header), 0);
+    if (rc == 0) {
+        rc = write_fully(fd, merged, out * sizeof(CandleRecord), record_offset(0));
+    }
+    free(merged);
+    if (rc == 0) {
+        rc = fdatasync(fd);
+    }
+    if (rc != 0 || rename(tmp_path, store->path) != 0) {
+        close(fd);
+        unlink(tmp_path);
+        return -1;
+    }
+
+    unmap_store(store);
+    close(store->fd);
+    store->fd = fd;
+    if (remap_store(store) != 0) {
+        return -1;
+    }
+    return added;
+}
+
+long candle_store_merge(CandleStore *store, const CandleRecord *records, size_t count) {
+    if (!store || store->fd < 0 || !store->writable) {
+        return -1;
+    }
+    if (!records || count == 0) {
+        return 0;
+    }
+
+    /* Pure append: everything is newer than the last stored candle. */
+    if (store->count == 0 ||
+        records[0].timestamp > store->records[store->count - 1].timestamp) {
+        if (write_in_place(store, store->count, records, count) != 0) {
+            return -1;
+        }
+        return (long)count;
+    }
+
+    /*
+     * Tail overwrite: the input starts inside the stored range but covers
+     * every remaining stored candle one-to-one (typically the still-open
+     * candle plus newer ones).
+     */
+    size_t start = candle_store_lower_bound(store, records[0].timestamp);
+    size_t overlap = (size_t)store->count - start;
+    if (overlap <= count) {
+        bool aligned = true;
+        for (size_t k = 0; k < overlap; k++) {
+            if (records[k].timestamp != store->records[start + k].timestamp) {
+                aligned = false;
+                break;
+            }
+        }
+        if (aligned) {
+            if (write_in_place(store, start, records, count) != 0) {
+                return -1;
+            }
+            return (long)(count - overlap);
+        }
+    }
+
+    return rewrite_merged(store, records, count);
+}
+
+int candle_columns_alloc(CandleColumns *columns, size_t count) {
+    memset(columns, 0, sizeof(*columns));
+    size_t n = count ? count : 1;
+    columns->timestamp = malloc(n * sizeof(uint64_t));
+    columns->open = malloc(n * sizeof(double));
+    columns->high = malloc(n * sizeof(double));
+    columns->low = malloc(n * sizeof(double));
+    columns->close = malloc(n * sizeof(double));
+    columns->volume = malloc(n * sizeof(double));
+    columns->quote_volume = malloc(n * sizeof(double));
+    columns->taker_buy_base_volume = malloc(n * sizeof(double));
+    columns->taker_buy_quote_volume = malloc(n * sizeof(double));
+    columns->trade_count = malloc(n * sizeof(uint64_t));
+    if (!columns->timestamp || !columns->open || !columns->high || !columns->low ||
+        !columns->close || !columns->volume || !columns->quote_volume ||
+        !columns->taker_buy_base_volume || !columns->taker_buy_quote_volume ||
+        !columns->trade_count) {
+        candle_columns_free(columns);
+        return -1;
+    }
+    columns->count = count;
+    return 0;
+}
+
+void candle_columns_free(CandleColumns *columns) {
+    if (!columns) {
+        return;
+    }
+    free(columns->timestamp);
+    free(columns->open);
+    free(columns->high);
+    free(columns->low);
+    free(columns->close);
+    free(columns->volume);
+    free(columns->quote_volume);
+    free(columns->taker_buy_base_volume);
+    free(columns->taker_buy_quote_volume);
+    free(columns->trade_count);
+    memset(columns, 0, sizeof(*columns));
+}
+
+void candle_columns_fill(CandleColumns *columns, const CandleRecord *records, size_t count) {
+    const CandleRecord *src = records;
+    columns->count = count;
+    for (size_t i = 0; i < count; i++) {
+        columns->timestamp[i] = src[i].timestamp;
+        columns->open[i] = src[i].open;
+        columns->high[i] = src[i].high;
+        columns->low[i] = src[i].low;
+        columns->close[i] = src[i].close;
+        columns->volume[i] = src[i].volume;
+        columns->quote_volume[i] = src[i].quote_volume;
+        columns->taker_buy_base_volume[i] = src[i].taker_buy_base_volume;
+        columns->taker_buy_quote_volume[i] = src[i].taker_buy_quote_volume;
+        columns->trade_count[i] = src[i].trade_count;
+    }
+}
+
+void candle_record_from_point(CandleRecord *record, const PricePoint *point) {
+    record->timestamp = point->timestamp;
+    record->close_time = point->close_time;
+    record->open = point->open;
+    record->high = point->high;
+    record->low = point->low;
+    record->close = point->close;
+    record->volume = point->volume;
+    record->quote_volume = point->quote_volume;
+    record->taker_buy_base_volume = point->taker_buy_base_volume;
+    record->taker_buy_quote_volume = point->taker_buy_quote_volume;
+    record->trade_count = point->trade_count > 0 ? (uint64_t)point->trade_count : 0;
+}
+
+void candle_record_to_point(PricePoint *point, const CandleRecord *record) {
+    memset(point, 0, sizeof(*point));
+    point->timestamp = record->timestamp;
+    point->close_time = record->close_time;
+    point->open = record->open;
+    point->high = record->high;
+    point->low = record->low;
+    point->close = record->close;
+    point->volume = record->volume;
+    point->quote_volume = record->quote_volume;
+    point->taker_buy_base_volume = record->taker_buy_base_volume;
+    point->taker_buy_quote_volume = record->taker_buy_quote_volume;
+    point->trade_count = (int)record->trade_count;
+}
@@ -0,0 +1,163 @@
+#ifndef CTICKER_CANDLE_STORE_H
+#define CTICKER_CANDLE_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/**
+ * @brief Fixed-size on-disk candle record.
+ *
+ * A compact, pointer-free version of ::PricePoint (the text fields are
+ * dropped; prices are re-formatted on display).
+ */
+typedef struct {
+    /** Candle open time in seconds since Unix epoch. */
+    uint64_t timestamp;
+    /** Candle close time in seconds since Unix epoch. */
+    uint64_t close_time;
+    double open;
+    double high;
+    double low;
+    double close;
+    /** Base asset volume. */
+    double volume;
+    /** Quote asset volume. */
+    double quote_volume;
+    /** Taker buy volume in base asset units. */
+    double taker_buy_base_volume;
+    /** Taker buy volume in quote asset units. */
+    double taker_buy_quote_volume;
+    /** Number of trades. */
+    uint64_t trade_count;
+} CandleRecord;
+
+/**
+ * @brief Header at the start of every candle store file.
+ */
+typedef struct {
+    /** File magic ("CTCNDL01"). */
+    char magic[8];
+    /** Size of one record in bytes (sizeof(CandleRecord)). */
+    uint32_t record_size;
+    /** ::Period of the stored candles. */
+    uint32_t period;
+    /** Number of committed records following the header. */
+    uint64_t count;
+    /** Symbol the file belongs to (NUL-terminated). */
+    char symbol[MAX_SYMBOL_LEN];
+    /** Pad the header to 64 bytes. */
+    uint8_t padding[20];
+} CandleStoreHeader;
+
+/**
+ * @brief Open handle on one (symbol, period) candle file.
+ *
+ * Records are kept sorted by open time without duplicates. Readers access
+ * them through a read-only mapping; writers go through
+ * candle_store_merge(), which remaps on success.
+ */
+typedef struct {
+    /** File descriptor, or -1 when closed. */
+    int fd;
+    /** Whether the store was opened for writing. */
+    bool writable;
+    /** Mapped file (NULL for an empty store). */
+    void *map;
+    /** Mapped length in bytes. */
+    size_t map_length;
+    /** First record inside the mapping (NULL for an empty store). */
+    const CandleRecord *records;
+    /** Number of records visible through ::CandleStore::records. */
+    uint64_t count;
+    /** Candle period of this store. */
+    Period period;
+    /** Symbol of this store. */
+    char symbol[MAX_SYMBOL_LEN];
+    /** Absolute file path. */
+    char path[768];
+} CandleStore;
+
+/**
+ * @brief Column-oriented (SoA) copy of a candle range.
+ *
+ * Each array holds ::CandleColumns::count values; scans over a single field
+ * stay contiguous so the compiler can vectorise them.
+ */
+typedef struct {
+    size_t count;
+    uint64_t *timestamp;
+    double *open;
+    double *high;
+    double *low;
+    double *close;
+    double *volume;
+    double *quote_volume;
+    double *taker_buy_base_volume;
+    double *taker_buy_quote_volume;
+    uint64_t *trade_count;
+} CandleColumns;
+
+/**
+ * @brief Open the store file for @p symbol and @p period.
+ *
+ * Read-only opens fail when the file does not exist; writable opens create it
+ * and block until no other writer holds the store (exclusive flock()).
+ *
+ * @return 0 on success, -1 on failure.
+ */
+int candle_store_open(CandleStore *store, const char *symbol, Period period, bool writable);
+
+/**
+ * @brief Unmap and close the store.
+ */
+void candle_store_close(CandleStore *store);
+
+/**
+ * @brief Merge sorted records into the store.
+ *
+ * Records newer than the last stored candle are appended in place. When the
+ * input overlaps existing data, existing candles with the same open time are
+ * replaced and the file is rewritten through a temporary file + rename.
+ *
+ * @param[in] records Records sorted by ascending open time.
+ * @param[in] count Number of records.
+ * @return Number of records that were new to the store, or -1 on failure.
+ */
+long candle_store_merge(CandleStore *store, const CandleRecord *records, size_t count);
+
+/**
+ * @brief Index of the first record with timestamp >= @p timestamp.
+ * @return A value in [0, store->count].
+ */
+size_t candle_store_lower_bound(const CandleStore *store, uint64_t timestamp);
+
+/**
+ * @brief Transpose @p count records into @p columns, which must have been
+ *        allocated for at least @p count candles.
+ */
+void candle_columns_fill(CandleColumns *columns, const CandleRecord *records, size_t count);
+
+/**
+ * @brief Allocate columns for @p count candles.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int candle_columns_alloc(CandleColumns *columns, size_t count);
+
+/**
+ * @brief Release memory owned by @p columns.
+ */
+void candle_columns_free(CandleColumns *columns);
+
+/**
+ * @brief Convert a ::PricePoint into a store record.
+ */
+void candle_record_from_point(CandleRecord *record, const PricePoint *point);
+
+/**
+ * @brief Convert a store record into a ::PricePoint (text fields left empty).
+ */
+void candle_record_to_point(PricePoint *point, const CandleRecord *record);
+
+#endif
@@ -48,7 +48,12 @@ SOFTWARE.
 #ifndef BUTTON5_PRESSED
 #define BUTTON5_PRESSED 0
 #endif
+#include "candle_cache.h"
+#include "candle_gaps.h"
+#include "candle_join.h"
 #include "chart.h"
+#include "probes.h"
+#include "trace.h"
 
 /*
  * Chart module notes:
@@ -57,12 +62,31 @@ SOFTWARE.
  * - Keeps UI calls outside of critical sections.
  */
 
-// Fetch a fresh candle array and swap it into the caller-owned buffer.
-static int chart_reload_data(const char *symbol, Period period,
-                             PricePoint **points, int *count) {
+// Load a candle array (via the shared candle cache unless @p refresh) and
+// swap it into the caller-owned buffer. Synthetic rows are built from their
+// constituents' candles.
+static int chart_load_points(const ChartContext *ctx, const char *symbol, Period period,
+                             bool refresh, PricePoint **points, int *count) {
     PricePoint *new_points = NULL;
     int new_count = 0;
-    int rc = fetch_historical_data(symbol, period, &new_points, &new_count);
+    const SyntheticRow *synthetic = ctx ? synthetic_find(ctx->synthetics, symbol) : NULL;
+    if (period_is_local(period)) {
+        // Sub-minute bars come from the trade poller, which follows one
+        // (real) symbol; the chart starts empty until the first page lands.
+        if (synthetic || !ctx || !ctx->trade_candles ||
+            trade_candle_feed_follow(ctx->trade_candles, symbol) != 0 ||
+            trade_candle_feed_sync(ctx->trade_candles, symbol, period, &new_points,
+                                   &new_count) < 0) {
+            return -1;
+        }
+        free(*points);
+        *points = new_points;
+        *count = new_count;
+        return 0;
+    }
+    int rc = synthetic
+        ? synthetic_fetch_candles(synthetic, period, &new_points, &new_count)
+        : candle_cache_get(symbol, period, refresh, &new_points, &new_count);
     if (rc == 0) {
         if (*points) {
             free(*points);
@@ -75,6 +99,41 @@ static int chart_reload_data(const char *symbol, Period period,
     return rc;
 }
 
+// chart_load_points() as a "chart reload" trace span and probe pair.
+static int chart_reload_data(const ChartContext *ctx, const char *symbol, Period period,
+                             bool refresh, PricePoint **points, int *count) {
+    uint64_t span = trace_begin();
+    CTICKER_PROBE2(chart__reload__start, symbol, (int)period);
+    int rc = chart_load_points(ctx, symbol, period, refresh, points, count);
+    CTICKER_PROBE3(chart__reload__end, symbol, *count, rc);
+    trace_end("chart reload", span, symbol);
+    return rc;
+}
+
+// Patch the closed/missing candles in place and hand the result back to the
+// shared cache; full reload only as fallback (and always for synthetic pairs,
+// which have no candles of their own).
+static int chart_patch_data(const ChartContext *ctx, const char *symbol, Period period,
+                            PricePoint **points, int *count) {
+    if (ctx && synthetic_find(ctx->synthetics, symbol)) {
+        return chart_reload_data(ctx, symbol, period, false, points, count);
+    }
+    int requests = 0;
+    int rc = candle_gaps_repair_points(symbol, period, (uint64_t)time(NULL),
+                                       points, count, &requests);
+    if (rc < 0) {
+        return rc;
+    }
+    if (rc == 0) {
+        // A failed put leaves the stale series, which simply expires later.
+        if (requests > 0) {
+            candle_cache_put(symbol, period, *points, *count);
+        }
+        return 0;
+    }
+    return chart_reload_data(ctx, symbol, period, true, points, count);
+}
+
 // Release chart buffers and reset the UI viewport for chart mode.
 static void chart_reset_state(PricePoint **chart_points,
                               int *chart_count,
@@ -127,17 +186,14 @@ static void chart_change_period(const ChartContext *ctx,
                                 PricePoint **chart_points,
                                 int *chart_count,
                                 int *chart_cursor_idx) {
-    (void)ctx;
-    int old_period = *current_period;
-    int next = (int)(*current_period) + step;
-    if (next < 0) {
-        next = PERIOD_COUNT - 1;
-    } else if (next >= PERIOD_COUNT) {
-        next = 0;
-    }
-    *current_period = (Period)next;
-    if (chart_reload_data(chart_symbol, *current_period, chart_points, chart_count) == 0) {
+    Period old_period = *current_period;
+    *current_period = period_step(*current_period, step);
+    if (chart_reload_data(ctx, chart_symbol, *current_period, false, chart_points,
+                          chart_count) == 0) {
         chart_clamp_cursor(chart_count, chart_cursor_idx);
+        if (!period_is_local(*current_period) && ctx && ctx->trade_candles) {
+            trade_candle_feed_follow(ctx->trade_candles, NULL);
+        }
     } else {
         *current_period = (Period)old_period;
         beep();
@@ -168,7 +224,8 @@ bool chart_open(const ChartContext *ctx,
     pthread_mutex_unlock(ctx->data_mutex);
     *chart_symbol_index = symbol_index;
 
-    if (chart_reload_data(chart_symbol, current_period, chart_points, chart_count) == 0) {
+    if (chart_reload_data(ctx, chart_symbol, current_period, false, chart_points,
+                          chart_count) == 0) {
         *chart_cursor_idx = (*chart_count > 0) ? (*chart_count - 1) : -1;
         return true;
     }
@@ -190,6 +247,42 @@ void chart_close(bool *show_chart,
     chart_reset_state(chart_points, chart_count, chart_cursor_idx);
 }
 
+// Latest published price of @p symbol, trying watchlist row @p hint first.
+// Returns 0 when the symbol is not on the board or has no price yet.
+static double chart_latest_price(const ChartContext *ctx, const char *symbol, int hint) {
+    double price = 0.0;
+    pthread_mutex_lock(ctx->data_mutex);
+    if (ctx->global_tickers) {
+        if (hint >= 0 && hint < *ctx->ticker_count &&
+            strncmp(ctx->global_tickers[hint].symbol, symbol, MAX_SYMBOL_LEN) == 0) {
+            price = ctx->global_tickers[hint].price;
+        } else {
+            for (int i = 0; i < *ctx->ticker_count; ++i) {
+                if (strncmp(ctx->global_tickers[i].symbol, symbol, MAX_SYMBOL_LEN) == 0) {
+                    price = ctx->global_tickers[i].price;
+                    break;
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(ctx->data_mutex);
+    return price;
+}
+
+// Fold a live price into the last (open) candle.
+static void chart_patch_last_candle(PricePoint *last, double current_price) {
+    if (current_price > last->high) {
+        last->high = current_price;
+        last->high_text[0] = '\0';
+    }
+    if (last->low == 0.0 || current_price < last->low) {
+        last->low = current_price;
+        last->low_text[0] = '\0';
+    }
+    last->close = current_price;
+    last->close_text[0] = '\0';
+}
+
 // Update the latest candle to reflect live ticker price.
 void chart_apply_live_price(const ChartContext *ctx,
                             const char *symbol,
@@ -200,59 +293,162 @@ void chart_apply_live_price(const ChartContext *ctx,
         return;
     }
 
-    TickerData latest = {0};
-    bool found = false;
+    double current_price = chart_latest_price(ctx, symbol, chart_symbol_index);
+    if (current_price <= 0.0) {
+        return;
+    }
+    chart_patch_last_candle(&points[chart_count - 1], current_price);
+}
 
+// Drop the comparison series and turn the overlay off.
+void chart_compare_reset(ChartComparison *compare) {
+    if (!compare) {
+        return;
+    }
+    free(compare->points);
+    free(compare->positions);
+    memset(compare, 0, sizeof(*compare));
+}
+
+// Point the comparison at the next watchlist row other than the charted
+// symbol. Returns false when there is none.
+static bool chart_compare_pick_next(const ChartContext *ctx, const char *chart_symbol) {
+    ChartComparison *compare = ctx->compare;
+    bool found = false;
     pthread_mutex_lock(ctx->data_mutex);
-    if (ctx->global_tickers) {
-        if (chart_symbol_index >= 0 && chart_symbol_index < *ctx->ticker_count) {
-            latest = ctx->global_tickers[chart_symbol_index];
-            if (strncmp(latest.symbol, symbol, MAX_SYMBOL_LEN) == 0) {
-                found = true;
-            }
+    int rows = *ctx->ticker_count;
+    for (int step = 1; step <= rows && !found; ++step) {
+        int row = ((compare->symbol[0] ? compare->symbol_index : -1) + step) % rows;
+        if (row < 0) {
+            row += rows;
         }
-        if (!found) {
-            for (int i = 0; i < *ctx->ticker_count; ++i) {
-                if (strncmp(ctx->global_tickers[i].symbol, symbol, MAX_SYMBOL_LEN) == 0) {
-                    latest = ctx->global_tickers[i];
-                    found = true;
-                    break;
-                }
-            }
+        const char *symbol = ctx->global_tickers[row].symbol;
+        if (strncmp(symbol, chart_symbol, MAX_SYMBOL_LEN) != 0 &&
+            strncmp(symbol, compare->symbol, MAX_SYMBOL_LEN) != 0) {
+            snprintf(compare->symbol, sizeof(compare->symbol), "%s", symbol);
+            compare->symbol_index = row;
+            found = true;
         }
     }
     pthread_mutex_unlock(ctx->data_mutex);
+    if (found) {
+        free(compare->points);
+        compare->points = NULL;
+        compare->count = 0;
+        compare->retry_at = 0;
+    }
+    return found;
+}
 
-    if (!found) {
+// Switch the comparison overlay off -> percent -> ratio -> off.
+static void chart_compare_cycle_mode(const ChartContext *ctx, const char *chart_symbol) {
+    ChartComparison *compare = ctx->compare;
+    compare->mode = (ChartCompareMode)((compare->mode + 1) % CHART_COMPARE_MODE_COUNT);
+    if (compare->mode != CHART_COMPARE_OFF && !compare->symbol[0] &&
+        !chart_compare_pick_next(ctx, chart_symbol)) {
+        compare->mode = CHART_COMPARE_OFF;
+        beep();
+    }
+}
+
+// Compare against the next watchlist symbol, turning the overlay on if needed.
+static void chart_compare_next_symbol(const ChartContext *ctx, const char *chart_symbol) {
+    ChartComparison *compare = ctx->compare;
+    if (!chart_compare_pick_next(ctx, chart_symbol)) {
+        beep();
         return;
     }
+    if (compare->mode == CHART_COMPARE_OFF) {
+        compare->mode = CHART_COMPARE_PERCENT;
+    }
+}
 
-    double current_price = latest.price;
-    if (current_price <= 0.0) {
+// Keep the comparison series loaded for @p period (through the shared
+// candle cache), follow its live price, and align it with the chart candles.
+void chart_compare_update(const ChartContext *ctx,
+                          const char *chart_symbol,
+                          Period period,
+                          const PricePoint *points,
+                          int chart_count) {
+    ChartComparison *compare = ctx ? ctx->compare : NULL;
+    if (!compare || compare->mode == CHART_COMPARE_OFF || !compare->symbol[0] ||
+        !chart_symbol[0]) {
         return;
     }
 
-    PricePoint *last = &points[chart_count - 1];
-    if (current_price > last->high) {
-        last->high = current_price;
-        last->high_text[0] = '\0';
+    if (period_is_local(period)) {
+        // The trade poller follows the charted symbol only.
+        free(compare->points);
+        compare->points = NULL;
+        compare->count = 0;
+        return;
     }
-    if (last->low == 0.0 || current_price < last->low) {
-        last->low = current_price;
-        last->low_text[0] = '\0';
+
+    uint64_t now = (uint64_t)time(NULL);
+    bool stale = !compare->points || compare->count <= 0 || compare->period != period ||
+                 now >= compare->points[compare->count - 1].close_time;
+    if (stale && now >= compare->retry_at) {
+        compare->retry_at = now + CHART_COMPARE_RETRY_SECONDS;
+        if (compare->period != period) {
+            free(compare->points);
+            compare->points = NULL;
+            compare->count = 0;
+        }
+        if (chart_reload_data(ctx, compare->symbol, period, false, &compare->points,
+                              &compare->count) == 0) {
+            compare->period = period;
+        }
     }
-    last->close = current_price;
-    last->close_text[0] = '\0';
+    if (!compare->points || compare->count <= 0) {
+        return;
+    }
+
+    double current_price = chart_latest_price(ctx, compare->symbol, compare->symbol_index);
+    if (current_price > 0.0) {
+        chart_patch_last_candle(&compare->points[compare->count - 1], current_price);
+    }
+
+    if (chart_count > compare->positions_capacity) {
+        int *positions = realloc(compare->positions, (size_t)chart_count * sizeof(int));
+        if (!positions) {
+            return;
+        }
+        compare->positions = positions;
+        compare->positions_capacity = chart_count;
+    }
+    candle_join_left(points, chart_count, compare->points, compare->count,
+                     compare->positions);
 }
 
 // Refresh candles when the last candle has closed, preserving selection.
+// Only the closed candle and any holes (e.g. after sleep) are requested.
 void chart_refresh_if_expired(const ChartContext *ctx,
                               char *chart_symbol,
                               Period current_period,
                               PricePoint **chart_points,
                               int *chart_count,
                               int *chart_cursor_idx) {
-    (void)ctx;
+    if (period_is_local(current_period)) {
+        // Sub-minute bars change with every trade: mirror the changed tail.
+        if (!chart_symbol[0] || !ctx || !ctx->trade_candles) {
+            return;
+        }
+        bool was_latest = *chart_cursor_idx < 0 || *chart_cursor_idx >= *chart_count - 1;
+        uint64_t retained_ts = was_latest ? 0 : (*chart_points)[*chart_cursor_idx].timestamp;
+        if (trade_candle_feed_sync(ctx->trade_candles, chart_symbol, current_period,
+                                   chart_points, chart_count) <= 0) {
+            return;
+        }
+        int restored_idx = was_latest ? -1
+            : chart_restore_cursor_by_timestamp(*chart_points, *chart_count, retained_ts);
+        if (restored_idx >= 0) {
+            *chart_cursor_idx = restored_idx;
+        } else {
+            *chart_cursor_idx = was_latest ? *chart_count - 1 : 0;
+        }
+        return;
+    }
+
     if (!chart_symbol[0] || !*chart_points || *chart_count <= 0) {
         return;
     }
@@ -272,7 +468,7 @@ void chart_refresh_if_expired(const ChartContext *ctx,
         was_latest = (*chart_cursor_idx == *chart_count - 1);
     }
 
-    if (chart_reload_data(chart_symbol, current_period, chart_points, chart_count) != 0) {
+    if (chart_patch_data(ctx, chart_symbol, current_period, chart_points, chart_count) != 0) {
         return;
     }
 
@@ -310,7 +506,6 @@ void chart_force_refresh(const ChartContext *ctx,
                          int *chart_count,
                          int *chart_cursor_idx,
                          bool follow_latest) {
-    (void)ctx;
     if (!chart_symbol[0]) {
         return;
     }
@@ -321,7 +516,8 @@ void chart_force_refresh(const ChartContext *ctx,
         retained_ts = (*chart_points)[*chart_cursor_idx].timestamp;
     }
 
-    if (chart_reload_data(chart_symbol, current_period, chart_points, chart_count) != 0) {
+    if (chart_reload_data(ctx, chart_symbol, current_period, true, chart_points,
+                          chart_count) != 0) {
         beep();
         return;
     }
@@ -393,6 +589,42 @@ void chart_handle_input(int ch,
                 *chart_cursor_idx = *chart_count - 1;
             }
             break;
+        case 'c':
+        case 'C':
+            if (ctx && ctx->compare) {
+                chart_compare_next_symbol(ctx, chart_symbol);
+            }
+            break;
+        case 'o':
+        case 'O':
+            if (ctx && ctx->compare) {
+                chart_compare_cycle_mode(ctx, chart_symbol);
+            }
+            break;
+        case 's':
+        case 'S':
+            if (*chart_cursor_idx >= 0 && *chart_cursor_idx < *chart_count) {
+                ui_chart_toggle_range((*chart_points)[*chart_cursor_idx].timestamp);
+            }
+            break;
+        case 'v':
+        case 'V':
+            ui_chart_toggle_volume_profile();
+            break;
+        case 'b':
+        case 'B':
+            ui_chart_cycle_bar_type();
+            break;
+        case 'l':
+        case 'L':
+            ui_chart_cycle_line_mode();
+            break;
+        case '[':
+            ui_chart_step_box_size(-1);
+            break;
+        case ']':
+            ui_chart_step_box_size(1);
+            break;
         case 'r':
         case 'R':
             chart_force_refresh(ctx, chart_symbol, *current_period, chart_points,
@@ -403,6 +635,10 @@ void chart_handle_input(int ch,
         case 27:  // ESC
             chart_close(show_chart, chart_points, chart_count, chart_cursor_idx,
                         chart_symbol, chart_symbol_index);
+            chart_compare_reset(ctx ? ctx->compare : NULL);
+            if (ctx && ctx->trade_candles) {
+                trade_candle_feed_follow(ctx->trade_candles, NULL);
+            }
             *follow_latest = true;
             break;
         default:
@@ -438,7 +674,7 @@ void chart_handle_mouse(const ChartContext *ctx,
         return;
     }
     if (ev.bstate & (BUTTON1_PRESSED | BUTTON1_RELEASED | BUTTON1_CLICKED)) {
-        int idx = ui_chart_hit_test_index(ev.x, *chart_count);
+        int idx = ui_chart_hit_test_index(ev.x, *chart_points, *chart_count);
         if (idx >= 0) {
             *chart_cursor_idx = idx;
             chart_clamp_cursor(chart_count, chart_cursor_idx);
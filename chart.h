@@ -4,6 +4,11 @@
 #include <stdbool.h>
 #include <pthread.h>
 #include "cticker.h"
+#include "synthetic.h"
+#include "tradecandles.h"
+
+/** Seconds between reload attempts of a stale comparison series. */
+#define CHART_COMPARE_RETRY_SECONDS 5
 
 typedef struct {
     /** Mutex guarding shared ticker snapshot updates. */
@@ -12,6 +17,12 @@ typedef struct {
     TickerData *global_tickers;
     /** Pointer to current ticker count (owned by main runtime). */
     int *ticker_count;
+    /** Synthetic pair definitions, for charting derived rows. */
+    const SyntheticSet *synthetics;
+    /** Comparison overlay state (owned by main; NULL disables comparisons). */
+    ChartComparison *compare;
+    /** Trade poller building the sub-minute periods (NULL disables them). */
+    TradeCandleFeed *trade_candles;
 } ChartContext;
 
 bool chart_open(const ChartContext *ctx,
@@ -51,6 +62,14 @@ void chart_apply_live_price(const ChartContext *ctx,
                             int chart_count,
                             int chart_symbol_index);
 
+void chart_compare_update(const ChartContext *ctx,
+                          const char *chart_symbol,
+                          Period period,
+                          const PricePoint *points,
+                          int chart_count);
+
+void chart_compare_reset(ChartComparison *compare);
+
 void chart_handle_input(int ch,
                         const ChartContext *ctx,
                         char *chart_symbol,
@@ -0,0 +1,146 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file cli_common.c
+ * @brief Argument parsing and formatting helpers shared by CLI commands.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "commands.h"
+
+// Parse an unsigned decimal prefix; returns a pointer past the digits.
+static const char *parse_digits(const char *text, uint64_t *value) {
+    uint64_t result = 0;
+    const char *cursor = text;
+    while (isdigit((unsigned char)*cursor)) {
+        result = result * 10 + (uint64_t)(*cursor - '0');
+        cursor++;
+    }
+    *value = result;
+    return cursor;
+}
+
+int cli_parse_time(const char *text, uint64_t now, uint64_t *out) {
+    if (!text || !text[0] || !out) {
+        return -1;
+    }
+
+    if (strcmp(text, "now") == 0) {
+        *out = now;
+        return 0;
+    }
+
+    /* Relative offsets such as -30d. */
+    if (text[0] == '-') {
+        uint64_t amount = 0;
+        const char *unit = parse_digits(text + 1, &amount);
+        if (unit == text + 1 || unit[0] == '\0' || unit[1] != '\0') {
+            return -1;
+        }
+        uint64_t scale = 0;
+        switch (*unit) {
+            case 'm': scale = 60; break;
+            case 'h': scale = 60 * 60; break;
+            case 'd': scale = 24 * 60 * 60; break;
+            case 'w': scale = 7 * 24 * 60 * 60; break;
+            default: return -1;
+        }
+        uint64_t delta = amount * scale;
+        *out = (delta > now) ? 0 : now - delta;
+        return 0;
+    }
+
+    /* Plain epoch seconds (or milliseconds when clearly too large). */
+    uint64_t number = 0;
+    const char *end = parse_digits(text, &number);
+    if (*end == '\0') {
+        *out = (number > 100000000000ULL) ? number / 1000 : number;
+        return 0;
+    }
+
+    /* Calendar date, interpreted as UTC. */
+    struct tm tm_buf;
+    memset(&tm_buf, 0, sizeof(tm_buf));
+    int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+    char sep = 0;
+    int fields = sscanf(text, "%d-%d-%d%c%d:%d:%d", &year, &month, &day, &sep,
+                        &hour, &minute, &second);
+    if (fields != 3 && fields < 6) {
+        return -1;
+    }
+    if (fields > 3 && sep != ' ' && sep != 'T') {
+        return -1;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 ||
+        hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return -1;
+    }
+    tm_buf.tm_year = year - 1900;
+    tm_buf.tm_mon = month - 1;
+    tm_buf.tm_mday = day;
+    tm_buf.tm_hour = hour;
+    tm_buf.tm_min = minute;
+    tm_buf.tm_sec = second;
+    time_t ts = timegm(&tm_buf);
+    if (ts < 0) {
+        return -1;
+    }
+    *out = (uint64_t)ts;
+    return 0;
+}
+
+int cli_parse_period(const char *text, Period *period) {
+    if (period_from_interval_code(text, period) == 0) {
+        return 0;
+    }
+    fprintf(stderr, "Unknown interval '%s' (expected 1m, 15m, 1h, 4h, 1d, 1w or 1M)\n",
+            text ? text : "");
+    return -1;
+}
+
+void cli_format_number(char *buf, size_t size, double value) {
+    snprintf(buf, size, "%.8f", value);
+    char *dot = strchr(buf, '.');
+    if (!dot) {
+        return;
+    }
+    char *end = buf + strlen(buf) - 1;
+    while (end > dot && *end == '0') {
+        *end-- = '\0';
+    }
+    if (end == dot) {
+        *end = '\0';
+    }
+}
+
+void cli_format_time(char *buf, size_t size, uint64_t timestamp) {
+    time_t ts = (time_t)timestamp;
+    struct tm tm_buf;
+    strftime(buf, size, "%Y-%m-%d %H:%M:%S", gmtime_r(&ts, &tm_buf));
+}
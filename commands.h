@@ -0,0 +1,71 @@
+#ifndef CTICKER_COMMANDS_H
+#define CTICKER_COMMANDS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/**
+ * @brief Offline sub-commands (`cticker <command> ...`).
+ *
+ * Commands run without ncurses and write results to stdout; diagnostics go
+ * to stderr. Each entry point receives argv starting at the command name
+ * and returns the process exit status.
+ */
+
+/**
+ * @brief `cticker query <symbol> --interval I --from T --to T [--agg I] [--csv] [--stats]`
+ */
+int command_query(int argc, char *argv[]);
+
+/**
+ * @brief `cticker import [--symbol S] [--interval I] [--jobs N] FILE...`
+ */
+int command_import(int argc, char *argv[]);
+
+/**
+ * @brief `cticker backfill [--interval I] [--days N] [--jobs N] [SYMBOL...]`
+ */
+int command_backfill(int argc, char *argv[]);
+
+/**
+ * @brief `cticker export SYMBOL... (--interval I | --ticks) [--format csv|col] [--out DIR] [--jobs N]`
+ */
+int command_export(int argc, char *argv[]);
+
+/**
+ * @brief `cticker backtest SYMBOL... [--strategy ma|breakout|rsi] [--interval I] [--fee PCT] [--jobs N] [RANGES]`
+ */
+int command_backtest(int argc, char *argv[]);
+
+/** @name Shared CLI helpers */
+///@{
+/**
+ * @brief Parse a time argument into seconds since Unix epoch (UTC).
+ *
+ * Accepts `now`, relative offsets (`-30d`, `-12h`, `-90m`, `-2w`), unix
+ * seconds or milliseconds, and `YYYY-MM-DD[ HH:MM[:SS]]` (a `T` separator
+ * is accepted too).
+ *
+ * @return 0 on success, -1 on malformed input.
+ */
+int cli_parse_time(const char *text, uint64_t now, uint64_t *out);
+
+/**
+ * @brief Parse an `--interval` argument, printing an error on failure.
+ * @return 0 on success, -1 on unknown interval codes.
+ */
+int cli_parse_period(const char *text, Period *period);
+
+/**
+ * @brief Format a price/volume with up to 8 decimals and no trailing zeros.
+ */
+void cli_format_number(char *buf, size_t size, double value);
+
+/**
+ * @brief Format a timestamp as `YYYY-MM-DD HH:MM:SS` (UTC).
+ */
+void cli_format_time(char *buf, size_t size, uint64_t timestamp);
+///@}
+
+#endif
@@ -30,6 +30,12 @@ SOFTWARE.
  * - One symbol per line (e.g. BTCUSDT)
  * - Empty lines are ignored
  * - Lines starting with '#' are treated as comments
+ * - Lines containing whitespace are directives: `<keyword> <args...>`
+ *   (e.g. `tick_log on`, `storage_sync 5`, `scan_interval 1h`, `hold BTCUSDT 0.5 42000`,
+ *   `synthetic ETHBTC = ETHUSDT / BTCUSDT`, `basket L1 BTCUSDT:0.01 ETHUSDT:0.2`,
+ *   `arbitrage_fee 0.075`, `arbitrage_threshold 0.05`, `trade_flow BTCUSDT ETHUSDT`,
+ *   `trade_candle_bars 900`);
+ *   unknown directives are ignored
  *
  * If the config file is missing, we create a small default set.
  */
@@ -39,6 +45,8 @@ SOFTWARE.
 #include <string.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <errno.h>
+#include <sys/stat.h>
 #include "cticker.h"
 
 /**
@@ -73,6 +81,233 @@ static char* trim_whitespace(char *str) {
     return str;
 }
 
+// Parse an on/off style flag; returns -1 when the token is not recognized.
+static int parse_bool_token(const char *token) {
+    if (!token) {
+        return -1;
+    }
+    if (strcmp(token, "on") == 0 || strcmp(token, "true") == 0 || strcmp(token, "1") == 0) {
+        return 1;
+    }
+    if (strcmp(token, "off") == 0 || strcmp(token, "false") == 0 || strcmp(token, "0") == 0) {
+        return 0;
+    }
+    return -1;
+}
+
+/**
+ * @brief Parse `NAME [=] TERM ((*|/) TERM)...` into @p pair.
+ *
+ * Operators may be written with or without surrounding spaces.
+ * @return 0 on success, -1 on syntax errors.
+ */
+static int parse_synthetic(SyntheticPair *pair, const char *name, const char *expr) {
+    if (!name || !expr || strlen(name) >= MAX_SYMBOL_LEN) {
+        return -1;
+    }
+    memset(pair, 0, sizeof(*pair));
+    snprintf(pair->symbol, sizeof(pair->symbol), "%s", name);
+
+    const char *p = expr;
+    while (*p == ' ' || *p == '\t' || *p == '=') {
+        p++;
+    }
+    int exponent = 1;
+    while (*p) {
+        size_t len = 0;
+        while (isalnum((unsigned char)p[len])) {
+            len++;
+        }
+        if (len == 0 || len >= MAX_SYMBOL_LEN || pair->term_count >= SYNTHETIC_MAX_TERMS) {
+            return -1;
+        }
+        memcpy(pair->terms[pair->term_count], p, len);
+        pair->terms[pair->term_count][len] = '\0';
+        pair->exponents[pair->term_count++] = exponent;
+        p += len;
+
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (!*p) {
+            break;
+        }
+        if (*p != '*' && *p != '/') {
+            return -1;
+        }
+        exponent = (*p == '/') ? -1 : 1;
+        p++;
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+    }
+    return pair->term_count > 0 ? 0 : -1;
+}
+
+/**
+ * @brief Parse `NAME SYMBOL:WEIGHT...` into a basket @p pair.
+ *
+ * @note Tokenizes via @p save (the directive's strtok_r state).
+ * @return 0 on success, -1 on syntax errors.
+ */
+static int parse_basket(SyntheticPair *pair, const char *name, char **save) {
+    if (!name || strlen(name) >= MAX_SYMBOL_LEN) {
+        return -1;
+    }
+    memset(pair, 0, sizeof(*pair));
+    snprintf(pair->symbol, sizeof(pair->symbol), "%s", name);
+    pair->basket = true;
+
+    char *token;
+    while ((token = strtok_r(NULL, " \t", save)) != NULL) {
+        char *colon = strchr(token, ':');
+        if (!colon || colon == token || (size_t)(colon - token) >= MAX_SYMBOL_LEN ||
+            pair->term_count >= SYNTHETIC_MAX_TERMS) {
+            return -1;
+        }
+        char *end = NULL;
+        double weight = strtod(colon + 1, &end);
+        if (end == colon + 1 || *end != '\0' || weight == 0.0) {
+            return -1;
+        }
+        memcpy(pair->terms[pair->term_count], token, (size_t)(colon - token));
+        pair->terms[pair->term_count][colon - token] = '\0';
+        pair->weights[pair->term_count++] = weight;
+    }
+    return pair->term_count > 0 ? 0 : -1;
+}
+
+/**
+ * @brief Apply a single `<keyword> <args...>` directive line.
+ *
+ * @note Tokenizes @p line in-place.
+ */
+static void parse_directive(Config *config, char *line) {
+    char *save = NULL;
+    char *keyword = strtok_r(line, " \t", &save);
+    if (!keyword) {
+        return;
+    }
+
+    if (strcmp(keyword, "tick_log") == 0) {
+        int flag = parse_bool_token(strtok_r(NULL, " \t", &save));
+        if (flag >= 0) {
+            config->tick_log = (flag == 1);
+        }
+    } else if (strcmp(keyword, "storage_sync") == 0) {
+        const char *value = strtok_r(NULL, " \t", &save);
+        if (!value) {
+            return;
+        }
+        if (strcmp(value, "none") == 0) {
+            config->storage_sync = STORAGE_SYNC_NONE;
+        } else if (strcmp(value, "always") == 0) {
+            config->storage_sync = STORAGE_SYNC_ALWAYS;
+        } else if (atoi(value) > 0) {
+            config->storage_sync = STORAGE_SYNC_INTERVAL;
+            config->storage_sync_interval = atoi(value);
+        }
+    } else if (strcmp(keyword, "hold") == 0) {
+        const char *symbol = strtok_r(NULL, " \t", &save);
+        const char *quantity = strtok_r(NULL, " \t", &save);
+        const char *entry = strtok_r(NULL, " \t", &save);
+        if (!symbol || !quantity || !entry || config->holding_count >= MAX_HOLDINGS ||
+            strlen(symbol) >= MAX_SYMBOL_LEN) {
+            return;
+        }
+        char *end = NULL;
+        double qty = strtod(quantity, &end);
+        if (*end != '\0' || qty == 0.0) {
+            return;
+        }
+        double price = strtod(entry, &end);
+        if (*end != '\0' || price < 0.0) {
+            return;
+        }
+        Holding *holding = &config->holdings[config->holding_count++];
+        snprintf(holding->symbol, sizeof(holding->symbol), "%s", symbol);
+        holding->quantity = qty;
+        holding->entry_price = price;
+    } else if (strcmp(keyword, "synthetic") == 0) {
+        const char *name = strtok_r(NULL, " \t=", &save);
+        if (config->synthetic_count < MAX_SYNTHETICS &&
+            parse_synthetic(&config->synthetics[config->synthetic_count], name, save) == 0) {
+            config->synthetic_count++;
+        }
+    } else if (strcmp(keyword, "basket") == 0) {
+        const char *name = strtok_r(NULL, " \t", &save);
+        if (config->synthetic_count < MAX_SYNTHETICS &&
+            parse_basket(&config->synthetics[config->synthetic_count], name, &save) == 0) {
+            config->synthetic_count++;
+        }
+    } else if (strcmp(keyword, "portfolio_currency") == 0) {
+        const char *currency = strtok_r(NULL, " \t", &save);
+        if (currency && strlen(currency) < MAX_SYMBOL_LEN) {
+            snprintf(config->portfolio_currency, sizeof(config->portfolio_currency),
+                     "%s", currency);
+        }
+    } else if (strcmp(keyword, "scan_interval") == 0) {
+        /* Validated against the known intervals when the scanner starts. */
+        const char *code = strtok_r(NULL, " \t", &save);
+        if (code && strlen(code) < sizeof(config->scan_interval)) {
+            snprintf(config->scan_interval, sizeof(config->scan_interval), "%s", code);
+        }
+    } else if (strcmp(keyword, "arbitrage_fee") == 0) {
+        const char *value = strtok_r(NULL, " \t", &save);
+        double fee = value ? atof(value) : -1.0;
+        if (fee >= 0.0 && fee < 100.0) {
+            config->arbitrage_fee = fee;
+        }
+    } else if (strcmp(keyword, "trade_flow") == 0) {
+        const char *symbol;
+        while ((symbol = strtok_r(NULL, " \t", &save)) != NULL &&
+               config->trade_flow_count < MAX_TRADE_FLOW_SYMBOLS) {
+            if (strlen(symbol) < MAX_SYMBOL_LEN) {
+                snprintf(config->trade_flow[config->trade_flow_count++], MAX_SYMBOL_LEN,
+                         "%s", symbol);
+            }
+        }
+    } else if (strcmp(keyword, "arbitrage_threshold") == 0) {
+        const char *value = strtok_r(NULL, " \t", &save);
+        if (value) {
+            config->arbitrage_threshold = atof(value);
+        }
+    } else if (strcmp(keyword, "trade_candle_bars") == 0) {
+        const char *value = strtok_r(NULL, " \t", &save);
+        int bars = value ? atoi(value) : 0;
+        if (bars >= 60 && bars <= 86400) {
+            config->trade_candle_bars = bars;
+        }
+    }
+}
+
+/**
+ * @brief Build a path under the per-user data directory, creating it if needed.
+ *
+ * Results look like `$HOME/.cticker/<subdir>`; pass NULL or "" for the root.
+ */
+int config_data_path(char *buf, size_t size, const char *subdir) {
+    char root[512];
+    snprintf(root, sizeof(root), "%s/%s", get_home_dir(), DATA_DIR);
+    if (mkdir(root, 0755) != 0 && errno != EEXIST) {
+        return -1;
+    }
+
+    if (!subdir || !subdir[0]) {
+        snprintf(buf, size, "%s", root);
+        return 0;
+    }
+
+    int written = snprintf(buf, size, "%s/%s", root, subdir);
+    if (written < 0 || (size_t)written >= size) {
+        return -1;
+    }
+    if (mkdir(buf, 0755) != 0 && errno != EEXIST) {
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * @brief Load configuration from $HOME/.cticker.conf.
  *
@@ -83,6 +318,16 @@ int load_config(Config *config) {
     char filepath[512];
     snprintf(filepath, sizeof(filepath), "%s/%s", get_home_dir(), CONFIG_FILE);
     
+    memset(config, 0, sizeof(*config));
+    config->storage_sync = STORAGE_SYNC_INTERVAL;
+    config->storage_sync_interval = STORAGE_SYNC_DEFAULT_INTERVAL;
+    snprintf(config->portfolio_currency, sizeof(config->portfolio_currency),
+             "%s", PORTFOLIO_DEFAULT_CURRENCY);
+    snprintf(config->scan_interval, sizeof(config->scan_interval), "%s",
+             SCAN_DEFAULT_INTERVAL);
+    config->arbitrage_fee = ARBITRAGE_DEFAULT_FEE;
+    config->trade_candle_bars = TRADE_CANDLE_DEFAULT_BARS;
+
     FILE *fp = fopen(filepath, "r");
     if (!fp) {
         /* No config file yet: create a simple default watchlist. */
@@ -94,10 +339,9 @@ int load_config(Config *config) {
         return 0;
     }
     
-    config->symbol_count = 0;
-    char line[MAX_SYMBOL_LEN + 2];
+    char line[512];
     
-    while (fgets(line, sizeof(line), fp) && config->symbol_count < MAX_SYMBOLS) {
+    while (fgets(line, sizeof(line), fp)) {
         /* Trim whitespace and newline. */
         char *trimmed = trim_whitespace(line);
         
@@ -105,6 +349,16 @@ int load_config(Config *config) {
         if (strlen(trimmed) == 0 || trimmed[0] == '#') {
             continue;
         }
+
+        /* Symbols never contain whitespace; anything else is a directive. */
+        if (strpbrk(trimmed, " \t")) {
+            parse_directive(config, trimmed);
+            continue;
+        }
+
+        if (config->symbol_count >= MAX_SYMBOLS) {
+            continue;
+        }
         
         snprintf(config->symbols[config->symbol_count], MAX_SYMBOL_LEN, "%s", trimmed);
         config->symbol_count++;
@@ -131,6 +385,87 @@ int save_config(const Config *config) {
     for (int i = 0; i < config->symbol_count; i++) {
         fprintf(fp, "%s\n", config->symbols[i]);
     }
+
+    /* Directives follow the symbols after a blank line; defaults are omitted. */
+    bool directives = false;
+    if (config->tick_log) {
+        fprintf(fp, "%stick_log on\n", directives ? "" : "\n");
+        directives = true;
+    }
+    if (config->storage_sync == STORAGE_SYNC_NONE) {
+        fprintf(fp, "%sstorage_sync none\n", directives ? "" : "\n");
+        directives = true;
+    } else if (config->storage_sync == STORAGE_SYNC_ALWAYS) {
+        fprintf(fp, "%sstorage_sync always\n", directives ? "" : "\n");
+        directives = true;
+    } else if (config->storage_sync_interval != STORAGE_SYNC_DEFAULT_INTERVAL &&
+               config->storage_sync_interval > 0) {
+        fprintf(fp, "%sstorage_sync %d\n", directives ? "" : "\n",
+                config->storage_sync_interval);
+        directives = true;
+    }
+    if (strcmp(config->portfolio_currency, PORTFOLIO_DEFAULT_CURRENCY) != 0 &&
+        config->portfolio_currency[0]) {
+        fprintf(fp, "%sportfolio_currency %s\n", directives ? "" : "\n",
+                config->portfolio_currency);
+        directives = true;
+    }
+    if (strcmp(config->scan_interval, SCAN_DEFAULT_INTERVAL) != 0 &&
+        config->scan_interval[0]) {
+        fprintf(fp, "%sscan_interval %s\n", directives ? "" : "\n",
+                config->scan_interval);
+        directives = true;
+    }
+    if (config->arbitrage_fee != ARBITRAGE_DEFAULT_FEE) {
+        fprintf(fp, "%sarbitrage_fee %.10g\n", directives ? "" : "\n", config->arbitrage_fee);
+        directives = true;
+    }
+    if (config->arbitrage_threshold != 0.0) {
+        fprintf(fp, "%sarbitrage_threshold %.10g\n", directives ? "" : "\n",
+                config->arbitrage_threshold);
+        directives = true;
+    }
+    if (config->trade_flow_count > 0) {
+        fprintf(fp, "%strade_flow", directives ? "" : "\n");
+        for (int i = 0; i < config->trade_flow_count; i++) {
+            fprintf(fp, " %s", config->trade_flow[i]);
+        }
+        fprintf(fp, "\n");
+        directives = true;
+    }
+    if (config->trade_candle_bars != TRADE_CANDLE_DEFAULT_BARS &&
+        config->trade_candle_bars > 0) {
+        fprintf(fp, "%strade_candle_bars %d\n", directives ? "" : "\n",
+                config->trade_candle_bars);
+        directives = true;
+    }
+    for (int i = 0; i < config->holding_count; i++) {
+        const Holding *holding = &config->holdings[i];
+        fprintf(fp, "%shold %s %.10g %.10g\n", directives ? "" : "\n",
+                holding->symbol, holding->quantity, holding->entry_price);
+        directives = true;
+    }
+    for (int i = 0; i < config->synthetic_count; i++) {
+        const SyntheticPair *pair = &config->synthetics[i];
+        if (pair->basket) {
+            fprintf(fp, "%sbasket %s", directives ? "" : "\n", pair->symbol);
+            for (int t = 0; t < pair->term_count; t++) {
+                fprintf(fp, " %s:%.10g", pair->terms[t], pair->weights[t]);
+            }
+            fprintf(fp, "\n");
+            directives = true;
+            continue;
+        }
+        fprintf(fp, "%ssynthetic %s =", directives ? "" : "\n", pair->symbol);
+        for (int t = 0; t < pair->term_count; t++) {
+            if (t > 0) {
+                fprintf(fp, " %c", pair->exponents[t] < 0 ? '/' : '*');
+            }
+            fprintf(fp, " %s", pair->terms[t]);
+        }
+        fprintf(fp, "\n");
+        directives = true;
+    }
     
     fclose(fp);
     return 0;
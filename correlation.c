@@ -0,0 +1,441 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file correlation.c
+ * @brief Sliding-window return correlations and their background feed.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "candle_cache.h"
+#include "candle_join.h"
+#include "correlation.h"
+
+// Seconds after a candle close before its bar is requested.
+#define CORRELATION_CLOSE_GRACE 2
+// Seconds between attempts after a failed load.
+#define CORRELATION_RETRY_SECONDS 15
+
+// Smaller of two ints.
+static int min_int(int a, int b) {
+    return a < b ? a : b;
+}
+
+// dst[j] += a * x[j] - s * y[j] over a tile row; len is a multiple of 4.
+// Unrolled by hand so GCC's cheap cost model at -O2 still vectorises it.
+static void tile_rank2(double *restrict dst, const double *restrict x, const double *restrict y,
+                       double a, double s, int len) {
+    for (int j = 0; j < len; j += 4) {
+        dst[j] += a * x[j] - s * y[j];
+        dst[j + 1] += a * x[j + 1] - s * y[j + 1];
+        dst[j + 2] += a * x[j + 2] - s * y[j + 2];
+        dst[j + 3] += a * x[j + 3] - s * y[j + 3];
+    }
+}
+
+// dst[j] += a * x[j] over a tile row; len is a multiple of 4.
+static void tile_rank1(double *restrict dst, const double *restrict x, double a, int len) {
+    for (int j = 0; j < len; j += 4) {
+        dst[j] += a * x[j];
+        dst[j + 1] += a * x[j + 1];
+        dst[j + 2] += a * x[j + 2];
+        dst[j + 3] += a * x[j + 3];
+    }
+}
+
+// cross += add·addᵀ - sub·subᵀ over the tiles on or above the diagonal.
+static void cross_rank2(CorrelationEngine *engine, const double *add, const double *sub) {
+    const int n = engine->n;
+    const int stride = engine->stride;
+    for (int ib = 0; ib < n; ib += CORRELATION_BLOCK) {
+        int iend = min_int(ib + CORRELATION_BLOCK, n);
+        for (int jb = ib; jb < stride; jb += CORRELATION_BLOCK) {
+            int len = min_int(CORRELATION_BLOCK, stride - jb);
+            for (int i = ib; i < iend; i++) {
+                tile_rank2(engine->cross + (size_t)i * stride + jb, add + jb, sub + jb,
+                           add[i], sub[i], len);
+            }
+        }
+    }
+}
+
+// Recompute sums and cross products exactly from the ring.
+static void correlation_rebuild(CorrelationEngine *engine) {
+    const int n = engine->n;
+    const int stride = engine->stride;
+    memset(engine->sum, 0, (size_t)stride * sizeof(double));
+    memset(engine->cross, 0, (size_t)n * stride * sizeof(double));
+    for (int ib = 0; ib < n; ib += CORRELATION_BLOCK) {
+        int iend = min_int(ib + CORRELATION_BLOCK, n);
+        for (int jb = ib; jb < stride; jb += CORRELATION_BLOCK) {
+            int len = min_int(CORRELATION_BLOCK, stride - jb);
+            // One tile stays in cache while every bar of the window streams by.
+            for (int t = 0; t < engine->filled; t++) {
+                const double *x = engine->ring + (size_t)t * stride;
+                for (int i = ib; i < iend; i++) {
+                    tile_rank1(engine->cross + (size_t)i * stride + jb, x + jb, x[i], len);
+                }
+            }
+        }
+    }
+    for (int t = 0; t < engine->filled; t++) {
+        const double *x = engine->ring + (size_t)t * stride;
+        for (int i = 0; i < n; i++) {
+            engine->sum[i] += x[i];
+        }
+    }
+    engine->since_rebuild = 0;
+}
+
+// Allocate the ring, sums and cross-product matrix.
+int correlation_init(CorrelationEngine *engine, int n, int window) {
+    memset(engine, 0, sizeof(*engine));
+    if (n < 1 || window < 2 || window > CORRELATION_MAX_WINDOW) {
+        return -1;
+    }
+    engine->n = n;
+    engine->stride = (n + 3) & ~3;
+    engine->window = window;
+    engine->ring = calloc((size_t)window * engine->stride, sizeof(double));
+    engine->sum = calloc((size_t)engine->stride, sizeof(double));
+    engine->cross = calloc((size_t)n * engine->stride, sizeof(double));
+    engine->scratch = calloc((size_t)engine->stride, sizeof(double));
+    if (!engine->ring || !engine->sum || !engine->cross || !engine->scratch) {
+        correlation_free(engine);
+        return -1;
+    }
+    return 0;
+}
+
+// Release the engine buffers.
+void correlation_free(CorrelationEngine *engine) {
+    free(engine->ring);
+    free(engine->sum);
+    free(engine->cross);
+    free(engine->scratch);
+    memset(engine, 0, sizeof(*engine));
+}
+
+// Slide the window: add the new vector, drop the oldest (a zero slot while filling).
+void correlation_push(CorrelationEngine *engine, const double *returns) {
+    const int stride = engine->stride;
+    bool full = engine->filled == engine->window;
+    int slot = full ? engine->head : engine->filled;
+    double *old = engine->ring + (size_t)slot * stride;
+
+    memcpy(engine->scratch, returns, (size_t)engine->n * sizeof(double));
+    cross_rank2(engine, engine->scratch, old);
+    for (int i = 0; i < engine->n; i++) {
+        engine->sum[i] += engine->scratch[i] - old[i];
+    }
+    memcpy(old, engine->scratch, (size_t)stride * sizeof(double));
+
+    if (full) {
+        engine->head = (engine->head + 1) % engine->window;
+        if (++engine->since_rebuild >= engine->window) {
+            correlation_rebuild(engine);
+        }
+    } else {
+        engine->filled++;
+    }
+}
+
+// One tile row of coefficients: (c / W - mi * mean) * si * inv_sd.
+static void tile_normalise(double *restrict dst, const double *restrict row,
+                           const double *restrict mean, const double *restrict inv_sd,
+                           double inv, double mi, double si, int len) {
+    int j = 0;
+    for (; j + 4 <= len; j += 4) {
+        dst[j] = (row[j] * inv - mi * mean[j]) * si * inv_sd[j];
+        dst[j + 1] = (row[j + 1] * inv - mi * mean[j + 1]) * si * inv_sd[j + 1];
+        dst[j + 2] = (row[j + 2] * inv - mi * mean[j + 2]) * si * inv_sd[j + 2];
+        dst[j + 3] = (row[j + 3] * inv - mi * mean[j + 3]) * si * inv_sd[j + 3];
+    }
+    for (; j < len; j++) {
+        dst[j] = (row[j] * inv - mi * mean[j]) * si * inv_sd[j];
+    }
+}
+
+// Normalise the cross products into Pearson coefficients tile by tile.
+void correlation_matrix(const CorrelationEngine *engine, double *out) {
+    const int n = engine->n;
+    const int stride = engine->stride;
+    double *mean = calloc((size_t)stride * 2, sizeof(double));
+    if (!mean || engine->filled < 2) {
+        for (size_t k = 0; k < (size_t)n * n; k++) {
+            out[k] = NAN;
+        }
+        free(mean);
+        return;
+    }
+    double *inv_sd = mean + stride;
+    const double inv = 1.0 / engine->filled;
+    for (int i = 0; i < n; i++) {
+        mean[i] = engine->sum[i] * inv;
+        double var = engine->cross[(size_t)i * stride + i] * inv - mean[i] * mean[i];
+        // Flat series (or rounding noise around zero) have no correlation.
+        inv_sd[i] = var > 1e-18 ? 1.0 / sqrt(var) : NAN;
+    }
+
+    for (int ib = 0; ib < n; ib += CORRELATION_BLOCK) {
+        int iend = min_int(ib + CORRELATION_BLOCK, n);
+        for (int jb = ib; jb < n; jb += CORRELATION_BLOCK) {
+            int jend = min_int(jb + CORRELATION_BLOCK, n);
+            for (int i = ib; i < iend; i++) {
+                tile_normalise(out + (size_t)i * n + jb, engine->cross + (size_t)i * stride + jb,
+                               mean + jb, inv_sd + jb, inv, mean[i], inv_sd[i], jend - jb);
+            }
+        }
+    }
+    // Clamp rounding overshoot and mirror the upper triangle.
+    for (int i = 0; i < n; i++) {
+        double *dst = out + (size_t)i * n;
+        dst[i] = isnan(inv_sd[i]) ? NAN : 1.0;
+        for (int j = i + 1; j < n; j++) {
+            double c = dst[j];
+            if (c > 1.0) {
+                c = 1.0;
+            } else if (c < -1.0) {
+                c = -1.0;
+            }
+            dst[j] = c;
+            out[(size_t)j * n + i] = c;
+        }
+    }
+    free(mean);
+}
+
+// Sleep until @p deadline in one-second steps; false when asked to stop.
+static bool correlation_wait(CorrelationView *view, time_t deadline) {
+    while (!atomic_load(&view->stop)) {
+        if (time(NULL) >= deadline) {
+            return true;
+        }
+        sleep(1);
+    }
+    return false;
+}
+
+/*
+ * Fetch every symbol's window from the candle cache and align them.
+ * Symbols whose fetch fails are dropped when @p drop_failed is set
+ * (first load); otherwise any failure fails the whole pass.
+ */
+static int correlation_fetch(CorrelationView *view, bool drop_failed,
+                             PricePoint **series, int *counts, CandleJoin *join) {
+    bool ok[MAX_SYMBOLS] = {false};
+    int kept = 0;
+    for (int s = 0; s < view->symbol_count; s++) {
+        if (atomic_load(&view->stop)) {
+            return -1;
+        }
+        ok[s] = candle_cache_get(view->symbols[s], view->period, false,
+                                 &series[kept], &counts[kept]) == 0 && counts[kept] >= 2;
+        if (!ok[s]) {
+            free(series[kept]);
+            series[kept] = NULL;
+            if (!drop_failed) {
+                return -1;
+            }
+            continue;
+        }
+        kept++;
+    }
+    if (kept != view->symbol_count) {
+        // The UI reads the names under the mutex.
+        pthread_mutex_lock(&view->mutex);
+        for (int s = 0, k = 0; s < view->symbol_count; s++) {
+            if (ok[s]) {
+                memmove(view->symbols[k++], view->symbols[s], MAX_SYMBOL_LEN);
+            }
+        }
+        view->symbol_count = kept;
+        pthread_mutex_unlock(&view->mutex);
+    }
+    if (kept < 2) {
+        return -1;
+    }
+    return candle_join_align((const PricePoint *const *)series, counts, kept, join);
+}
+
+// Log return between two closes (0 when either is unusable).
+static double log_return(double prev, double close) {
+    return (prev > 0.0 && close > 0.0) ? log(close / prev) : 0.0;
+}
+
+/*
+ * One feed pass: load or extend the window with bars closed since the last
+ * pass. Returns the close time of the still-open candle to wake at, or 0
+ * on failure.
+ */
+static uint64_t correlation_pass(CorrelationView *view, double *prev_close, double *returns,
+                                 double *matrix) {
+    PricePoint *series[MAX_SYMBOLS] = {0};
+    int counts[MAX_SYMBOLS] = {0};
+    CandleJoin join = {0};
+    bool first = view->engine.n == 0;
+    uint64_t wake = 0;
+
+    if (correlation_fetch(view, first, series, counts, &join) != 0) {
+        goto done;
+    }
+    const int n = view->symbol_count;
+    uint64_t now = (uint64_t)time(NULL);
+    // Only closed bars enter the window.
+    int closed = join.rows;
+    while (closed > 0 && series[0][join.positions[closed - 1]].close_time >= now) {
+        closed--;
+    }
+    // First aligned row to push; its predecessor seeds prev_close on the first load.
+    int from = 0;
+    if (first) {
+        int window = min_int(CORRELATION_MAX_WINDOW, closed - 1);
+        if (window < 2 || correlation_init(&view->engine, n, window) != 0) {
+            goto done;
+        }
+        from = closed - window;
+        for (int s = 0; s < n; s++) {
+            prev_close[s] = series[s][join.positions[(size_t)s * join.capacity + from - 1]].close;
+        }
+    } else {
+        while (from < closed &&
+               series[0][join.positions[from]].close_time <= view->last_close) {
+            from++;
+        }
+    }
+
+    if (from < closed) {
+        for (int r = from; r < closed; r++) {
+            for (int s = 0; s < n; s++) {
+                double close = series[s][join.positions[(size_t)s * join.capacity + r]].close;
+                returns[s] = log_return(prev_close[s], close);
+                prev_close[s] = close;
+            }
+            correlation_push(&view->engine, returns);
+        }
+        correlation_matrix(&view->engine, matrix);
+
+        pthread_mutex_lock(&view->mutex);
+        memcpy(view->matrix, matrix, (size_t)n * n * sizeof(double));
+        view->window = view->engine.filled;
+        view->last_close = series[0][join.positions[closed - 1]].close_time;
+        view->status = CORRELATION_READY;
+        view->version++;
+        pthread_mutex_unlock(&view->mutex);
+    }
+
+    // Wake once the newest candle of the reference series has closed.
+    wake = series[0][counts[0] - 1].close_time;
+    if (wake < now) {
+        wake = now + CORRELATION_RETRY_SECONDS;
+    }
+
+done:
+    candle_join_free(&join);
+    for (int s = 0; s < MAX_SYMBOLS; s++) {
+        free(series[s]);
+    }
+    return wake;
+}
+
+// Worker: load, then extend the window each time a candle closes.
+static void *correlation_worker(void *arg) {
+    CorrelationView *view = arg;
+    double prev_close[MAX_SYMBOLS] = {0};
+    double returns[MAX_SYMBOLS] = {0};
+    double *matrix = malloc(sizeof(view->matrix));
+
+    while (matrix && !atomic_load(&view->stop)) {
+        uint64_t wake = correlation_pass(view, prev_close, returns, matrix);
+        if (wake == 0) {
+            pthread_mutex_lock(&view->mutex);
+            if (view->status == CORRELATION_LOADING) {
+                view->status = CORRELATION_FAILED;
+            }
+            pthread_mutex_unlock(&view->mutex);
+            wake = (uint64_t)time(NULL) + CORRELATION_RETRY_SECONDS;
+        } else {
+            wake += CORRELATION_CLOSE_GRACE;
+        }
+        if (!correlation_wait(view, (time_t)wake)) {
+            break;
+        }
+    }
+    free(matrix);
+    return NULL;
+}
+
+// Copy the watchlist and start the feed thread.
+int correlation_view_start(CorrelationView *view, const Config *config, Period period) {
+    memset(view, 0, sizeof(*view));
+    pthread_mutex_init(&view->mutex, NULL);
+    atomic_init(&view->stop, false);
+    view->period = period;
+    view->status = CORRELATION_LOADING;
+    // Local sub-minute candles only exist for the open chart, not as history.
+    if (period_is_local(period)) {
+        view->status = CORRELATION_FAILED;
+        return -1;
+    }
+    for (int i = 0; i < config->symbol_count && i < MAX_SYMBOLS; i++) {
+        snprintf(view->symbols[i], MAX_SYMBOL_LEN, "%s", config->symbols[i]);
+        view->symbol_count++;
+    }
+    if (pthread_create(&view->thread, NULL, correlation_worker, view) != 0) {
+        view->status = CORRELATION_FAILED;
+        return -1;
+    }
+    view->thread_started = true;
+    return 0;
+}
+
+// Stop the feed thread and release the engine.
+void correlation_view_stop(CorrelationView *view) {
+    if (view->thread_started) {
+        atomic_store(&view->stop, true);
+        pthread_join(view->thread, NULL);
+        view->thread_started = false;
+    }
+    correlation_free(&view->engine);
+    pthread_mutex_destroy(&view->mutex);
+}
+
+// Copy the published state for rendering.
+void correlation_view_snapshot(CorrelationView *view, CorrelationSnapshot *snapshot) {
+    pthread_mutex_lock(&view->mutex);
+    int n = view->symbol_count;
+    snapshot->period = view->period;
+    snapshot->symbol_count = n;
+    memcpy(snapshot->symbols, view->symbols, (size_t)n * MAX_SYMBOL_LEN);
+    memcpy(snapshot->matrix, view->matrix, (size_t)n * n * sizeof(double));
+    snapshot->window = view->window;
+    snapshot->last_close = view->last_close;
+    snapshot->status = view->status;
+    pthread_mutex_unlock(&view->mutex);
+}
@@ -0,0 +1,140 @@
+#ifndef CTICKER_CORRELATION_H
+#define CTICKER_CORRELATION_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/** Largest rolling window, in returns. */
+#define CORRELATION_MAX_WINDOW 500
+
+/** Matrix tile edge (doubles) for the blocked update and read-out. */
+#define CORRELATION_BLOCK 64
+
+/**
+ * @brief Sliding-window return correlations between n series.
+ *
+ * Keeps the last ::CorrelationEngine::window return vectors plus running
+ * sums and the cross-product matrix Σ x·xᵀ, so a new bar costs one blocked
+ * rank-2 update (add the new vector, remove the oldest) instead of an
+ * O(n²·W) recomputation. The matrix is rebuilt from the ring every
+ * `window` updates to shed rounding drift.
+ */
+typedef struct {
+    /** Number of series. */
+    int n;
+    /** Padded row length of the matrix and ring rows (multiple of 4). */
+    int stride;
+    /** Window length in returns. */
+    int window;
+    /** Returns currently in the window (<= window). */
+    int filled;
+    /** Ring slot of the oldest return vector once full. */
+    int head;
+    /** window x stride return vectors. */
+    double *ring;
+    /** Per-series sums of the windowed returns. */
+    double *sum;
+    /** n x stride cross products (upper triangle, tile granularity). */
+    double *cross;
+    /** Padded copy of the incoming return vector. */
+    double *scratch;
+    /** Full-window updates since the last rebuild. */
+    int since_rebuild;
+} CorrelationEngine;
+
+/**
+ * @brief Allocate an engine for @p n series and a @p window-return window.
+ * @return 0 on success, -1 on invalid sizes or allocation failure.
+ */
+int correlation_init(CorrelationEngine *engine, int n, int window);
+
+/**
+ * @brief Release memory owned by @p engine.
+ */
+void correlation_free(CorrelationEngine *engine);
+
+/**
+ * @brief Slide the window forward by one bar of @p n returns.
+ */
+void correlation_push(CorrelationEngine *engine, const double *returns);
+
+/**
+ * @brief Write the n x n Pearson correlation matrix (row-major) to @p out.
+ *
+ * Entries of series without variance are NAN.
+ */
+void correlation_matrix(const CorrelationEngine *engine, double *out);
+
+/** Loader state reported to the view. */
+typedef enum {
+    CORRELATION_LOADING = 0,
+    CORRELATION_READY,
+    CORRELATION_FAILED
+} CorrelationStatus;
+
+/**
+ * @brief Background correlation feed for the watchlist on one interval.
+ *
+ * A worker thread loads closed candles from the shared candle cache,
+ * pushes new bars into the engine as candles close, and publishes the
+ * matrix under ::CorrelationView::mutex; the UI only copies it out.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_t thread;
+    bool thread_started;
+    atomic_bool stop;
+    Period period;
+    char symbols[MAX_SYMBOLS][MAX_SYMBOL_LEN];
+    int symbol_count;
+    CorrelationEngine engine;
+    /** Published n x n matrix (guarded by the mutex). */
+    double matrix[MAX_SYMBOLS * MAX_SYMBOLS];
+    /** Returns in the published window. */
+    int window;
+    /** Close time of the newest bar in the window. */
+    uint64_t last_close;
+    CorrelationStatus status;
+    /** Bumped on every publish. */
+    uint64_t version;
+} CorrelationView;
+
+/**
+ * @brief Start the worker for @p config's symbols on @p period.
+ * @return 0 on success, -1 for a local (sub-minute) period or if the thread
+ *         could not be created.
+ */
+int correlation_view_start(CorrelationView *view, const Config *config, Period period);
+
+/**
+ * @brief Stop and join the worker and release its engine.
+ */
+void correlation_view_stop(CorrelationView *view);
+
+/**
+ * @brief UI copy of the published state.
+ */
+typedef struct {
+    Period period;
+    char symbols[MAX_SYMBOLS][MAX_SYMBOL_LEN];
+    int symbol_count;
+    double matrix[MAX_SYMBOLS * MAX_SYMBOLS];
+    int window;
+    uint64_t last_close;
+    CorrelationStatus status;
+} CorrelationSnapshot;
+
+/**
+ * @brief Copy the published matrix and labels (takes the view mutex).
+ */
+void correlation_view_snapshot(CorrelationView *view, CorrelationSnapshot *snapshot);
+
+/**
+ * @brief Render the heat grid with the cursor on (@p row, @p col).
+ */
+void draw_correlation_screen(const CorrelationSnapshot *snapshot, int row, int col);
+
+#endif
@@ -47,6 +47,9 @@ SOFTWARE.
 /** User config file name stored under $HOME. */
 #define CONFIG_FILE ".cticker.conf"
 
+/** Per-user data directory (tick logs, candle store) stored under $HOME. */
+#define DATA_DIR ".cticker"
+
 /**
  * @brief Trading pair information displayed on the price board.
  */
@@ -75,8 +78,43 @@ typedef struct {
     char high_text[32];
     /** Raw low price text returned by the API. */
     char low_text[32];
+    /** Row derived from other rows (no 24h range, volume or trade stats). */
+    bool synthetic;
+    /** Realised volatility of 1-minute log returns, scaled to 24h (%). */
+    double volatility;
+    /** Average true range of 1-minute bars (% of price). */
+    double atr_pct;
+    /** Move since the last 1-minute close, in standard deviations. */
+    double move_z;
+    /** Enough bars were seen for the three statistics above. */
+    bool stats_ready;
+    /** Candlestick patterns of the last closed scan candle (PatternFlag bits). */
+    unsigned patterns;
 } TickerData;
 
+/**
+ * @brief One aggregated trade from the exchange trade feed.
+ */
+typedef struct {
+    /** Aggregate trade id (increasing per symbol). */
+    uint64_t id;
+    /** Trade time in milliseconds since Unix epoch. */
+    uint64_t time_ms;
+    double price;
+    double quantity;
+    /** The buyer was the maker, i.e. the taker sold. */
+    bool buyer_maker;
+} TradeSample;
+
+/**
+ * @brief Best bid/ask of one pair from the all-symbol book ticker.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    double bid;
+    double ask;
+} BookQuote;
+
 /**
  * @brief Price history point (candlestick OHLC).
  */
@@ -113,6 +151,77 @@ typedef struct {
     char close_text[32];
 } PricePoint;
 
+/** Default seconds between background fdatasync() calls. */
+#define STORAGE_SYNC_DEFAULT_INTERVAL 5
+
+/**
+ * @brief Durability policy for background file writes (`storage_sync`).
+ */
+typedef enum {
+    /** Leave write-back to the kernel. */
+    STORAGE_SYNC_NONE,
+    /** fdatasync() written files every ::Config::storage_sync_interval seconds. */
+    STORAGE_SYNC_INTERVAL,
+    /** fdatasync() after every write batch. */
+    STORAGE_SYNC_ALWAYS
+} StorageSync;
+
+/** Maximum number of portfolio lots (`hold` directives). */
+#define MAX_HOLDINGS 512
+
+/** Currency portfolio values are reported in unless configured. */
+#define PORTFOLIO_DEFAULT_CURRENCY "USDT"
+
+/** Default candle interval of the pattern scanner. */
+#define SCAN_DEFAULT_INTERVAL "15m"
+
+/** Maximum number of symbols followed by the trade-flow monitor (`trade_flow`). */
+#define MAX_TRADE_FLOW_SYMBOLS 8
+
+/** Default taker fee charged on each arbitrage leg (percent). */
+#define ARBITRAGE_DEFAULT_FEE 0.1
+
+/** Sub-minute bars kept per interval unless configured (`trade_candle_bars`). */
+#define TRADE_CANDLE_DEFAULT_BARS 900
+
+/**
+ * @brief One portfolio lot (`hold SYMBOL QUANTITY ENTRY_PRICE`).
+ */
+typedef struct {
+    /** Trading pair symbol (e.g. "ETHBTC"). */
+    char symbol[MAX_SYMBOL_LEN];
+    /** Base asset quantity (negative for shorts). */
+    double quantity;
+    /** Average entry price in the pair's quote currency. */
+    double entry_price;
+} Holding;
+
+/** Maximum number of derived rows (`synthetic` and `basket` directives). */
+#define MAX_SYNTHETICS 16
+
+/** Maximum number of terms in one synthetic pair or basket. */
+#define SYNTHETIC_MAX_TERMS 16
+
+/**
+ * @brief A derived row: a product/ratio of other symbols
+ *        (`synthetic ETHBTC = ETHUSDT / BTCUSDT`) or a weighted basket
+ *        (`basket L1 BTCUSDT:0.01 ETHUSDT:0.2 SOLUSDT:2`).
+ */
+typedef struct {
+    /** Name shown on the price board. */
+    char symbol[MAX_SYMBOL_LEN];
+    /** Weighted sum of watched symbols rather than a product. */
+    bool basket;
+    /** Watched symbols (or, for products, earlier synthetic pairs). */
+    char terms[SYNTHETIC_MAX_TERMS][MAX_SYMBOL_LEN];
+    /** Products: +1 to multiply by a term, -1 to divide by it. */
+    int exponents[SYNTHETIC_MAX_TERMS];
+    /** Baskets: units of each term in the basket. */
+    double weights[SYNTHETIC_MAX_TERMS];
+    /** Number of valid terms. */
+    int term_count;
+} SyntheticPair;
+
 /**
  * @brief Configuration structure loaded from the user's config file.
  */
@@ -121,10 +230,41 @@ typedef struct {
     char symbols[MAX_SYMBOLS][MAX_SYMBOL_LEN];
     /** Number of valid entries in ::Config::symbols. */
     int symbol_count;
+    /** Persist tick samples to the on-disk log (`tick_log on`). */
+    bool tick_log;
+    /** Durability of background writes (`storage_sync none|always|<seconds>`). */
+    StorageSync storage_sync;
+    /** Seconds between syncs for ::STORAGE_SYNC_INTERVAL. */
+    int storage_sync_interval;
+    /** Portfolio lots in config order. */
+    Holding holdings[MAX_HOLDINGS];
+    /** Number of valid entries in ::Config::holdings. */
+    int holding_count;
+    /** Valuation currency of the portfolio (`portfolio_currency EUR`). */
+    char portfolio_currency[MAX_SYMBOL_LEN];
+    /** Derived pairs and baskets in config order. */
+    SyntheticPair synthetics[MAX_SYNTHETICS];
+    /** Number of valid entries in ::Config::synthetics. */
+    int synthetic_count;
+    /** Pattern scanner interval code (`scan_interval 1h`), or "off". */
+    char scan_interval[8];
+    /** Taker fee per arbitrage leg in percent (`arbitrage_fee 0.075`). */
+    double arbitrage_fee;
+    /** Net profit in percent a cycle must exceed to be flagged (`arbitrage_threshold 0.05`). */
+    double arbitrage_threshold;
+    /** Symbols whose trades are watched for anomalies (`trade_flow BTCUSDT ETHUSDT`). */
+    char trade_flow[MAX_TRADE_FLOW_SYMBOLS][MAX_SYMBOL_LEN];
+    /** Number of valid entries in ::Config::trade_flow. */
+    int trade_flow_count;
+    /** Sub-minute bars kept per interval in chart mode (`trade_candle_bars 900`). */
+    int trade_candle_bars;
 } Config;
 
 /**
  * @brief Chart time interval selection.
+ *
+ * Values are saved in candle store and .ctcol headers: append new periods,
+ * never renumber. period_step() gives the on-screen order.
  */
 typedef enum {
     /** 1-minute candles. */
@@ -141,10 +281,49 @@ typedef enum {
     PERIOD_1WEEK,
     /** 1-month candles. */
     PERIOD_1MONTH,
+    /** 1-second candles (built locally from trades, see period_is_local()). */
+    PERIOD_1SEC,
+    /** 5-second candles (local). */
+    PERIOD_5SEC,
+    /** 15-second candles (local). */
+    PERIOD_15SEC,
+    /** 30-second candles (local). */
+    PERIOD_30SEC,
     /** Number of supported periods (sentinel). */
     PERIOD_COUNT
 } Period;
 
+/**
+ * @brief How a second symbol is drawn over the chart.
+ */
+typedef enum {
+    CHART_COMPARE_OFF,
+    /** Closes rebased onto the chart's first shared close (relative performance). */
+    CHART_COMPARE_PERCENT,
+    /** Chart close / comparison close, on its own scale. */
+    CHART_COMPARE_RATIO,
+    CHART_COMPARE_MODE_COUNT
+} ChartCompareMode;
+
+/**
+ * @brief Comparison series shown over the chart (owned by the chart loop).
+ */
+typedef struct {
+    ChartCompareMode mode;
+    char symbol[MAX_SYMBOL_LEN];
+    /** Watchlist row of @ref symbol, used as a lookup hint for live prices. */
+    int symbol_index;
+    /** Candles of @ref symbol for @ref period. */
+    Period period;
+    PricePoint *points;
+    int count;
+    /** Earliest time (Unix seconds) of the next reload attempt. */
+    uint64_t retry_at;
+    /** Position in @ref points of each chart candle, -1 where it has no candle. */
+    int *positions;
+    int positions_capacity;
+} ChartComparison;
+
 /**
  * @brief Status indicators for the footer panel.
  */
@@ -177,6 +356,57 @@ int load_config(Config *config);
  * @return 0 on success, non-zero on failure.
  */
 int save_config(const Config *config);
+
+/**
+ * @brief Resolve a directory under the per-user data directory.
+ *
+ * Creates `$HOME/.cticker` and @p subdir when they do not exist yet.
+ *
+ * @param[out] buf Output path buffer.
+ * @param[in] size Size of @p buf in bytes.
+ * @param[in] subdir Sub-directory name, or NULL for the data root.
+ * @return 0 on success, non-zero on failure.
+ */
+int config_data_path(char *buf, size_t size, const char *subdir);
+///@}
+
+/** @name Period helpers */
+///@{
+/**
+ * @brief Binance kline interval code for a period (e.g. "1m", "4h", "1M").
+ */
+const char *period_interval_code(Period period);
+
+/**
+ * @brief Parse a Binance kline interval code back into a ::Period.
+ *
+ * Only periods served by the REST API are accepted (local sub-minute
+ * periods exist in chart mode only).
+ *
+ * @param[in] code Interval code such as "15m" (case-sensitive: "1M" is a month).
+ * @param[out] period Parsed period on success.
+ * @return 0 on success, non-zero if the code is unknown.
+ */
+int period_from_interval_code(const char *code, Period *period);
+
+/**
+ * @brief Fixed spacing between consecutive candles, in seconds.
+ *
+ * @return Candle length, or 0 for calendar-based periods (1 month).
+ */
+uint64_t period_seconds(Period period);
+
+/**
+ * @brief Whether @p period is built locally from the trade feed
+ *        (the sub-minute periods) rather than fetched as klines.
+ */
+bool period_is_local(Period period);
+
+/**
+ * @brief Period @p step places after @p period in chart order (1s .. 30s,
+ *        1m .. 1M), wrapping at either end.
+ */
+Period period_step(Period period, int step);
 ///@}
 
 /** @name API functions */
@@ -192,6 +422,30 @@ int save_config(const Config *config);
  */
 int fetch_ticker_data(const char *symbol, TickerData *data);
 
+/**
+ * @brief Fetch the best bid/ask of every listed pair in one request.
+ *
+ * The caller owns the returned array and must free(@p *quotes).
+ *
+ * @param[out] quotes Allocated array of ::BookQuote on success.
+ * @param[out] count Number of valid entries in @p *quotes.
+ * @return 0 on success, non-zero on failure.
+ */
+int fetch_book_tickers(BookQuote **quotes, int *count);
+
+/**
+ * @brief Fetch up to 1000 aggregated trades of @p symbol.
+ *
+ * With @p from_id 0 the most recent trades are returned; otherwise trades
+ * starting at that id, so consecutive calls page through the feed without
+ * gaps. The caller owns the returned array and must free(@p *trades).
+ *
+ * @param[out] trades Allocated array of ::TradeSample on success, oldest first.
+ * @param[out] count Number of valid entries in @p *trades.
+ * @return 0 on success, non-zero on failure.
+ */
+int fetch_agg_trades(const char *symbol, uint64_t from_id, TradeSample **trades, int *count);
+
 /**
  * @brief Fetch historical candlestick (OHLC) data for charting.
  *
@@ -206,6 +460,22 @@ int fetch_ticker_data(const char *symbol, TickerData *data);
  */
 int fetch_historical_data(const char *symbol, Period period,
                           PricePoint **points, int *count);
+
+/**
+ * @brief Fetch up to @p limit candles opening in [@p start_time, @p end_time].
+ *
+ * Used for paged backfills. Requests share the process-wide rate limiter
+ * with the UI fetches. Memory ownership is the same as
+ * fetch_historical_data().
+ *
+ * @param[in] start_time First open time (seconds since epoch).
+ * @param[in] end_time Last open time (seconds), or 0 for "up to now".
+ * @param[in] limit Maximum candles per request (1..1000).
+ * @return 0 on success, non-zero on failure.
+ */
+int fetch_historical_range(const char *symbol, Period period,
+                           uint64_t start_time, uint64_t end_time, int limit,
+                           PricePoint **points, int *count);
 ///@}
 
 /** @name UI functions */
@@ -239,9 +509,11 @@ void draw_splash_screen(void);
  * @param[in] selected Selected row index within @p tickers.
  * @param[in] sort_hint_price Symbol describing the next F5 sort outcome.
  * @param[in] sort_hint_change Symbol describing the next F6 sort outcome.
+ * @param[in] move_stats Show volatility/ATR/z-score instead of 24h activity.
  */
 void draw_main_screen(TickerData *tickers, int count, int selected,
-                      const char *sort_hint_price, const char *sort_hint_change);
+                      const char *sort_hint_price, const char *sort_hint_change,
+                      bool move_stats);
 
 /**
  * @brief Map a mouse Y coordinate to a price board row index.
@@ -255,11 +527,15 @@ int ui_price_board_hit_test_row(int mouse_y, int total_rows);
 /**
  * @brief Map a mouse X coordinate to a candle index in the current chart viewport.
  *
+ * When derived bars are drawn, the candle that completed the bar under the
+ * mouse is returned.
+ *
  * @param[in] mouse_x Screen X coordinate from ncurses mouse event.
+ * @param[in] points Candles passed to the last draw_chart() call.
  * @param[in] total_points Total candle count in the series.
  * @return Candle index within [0, total_points), or -1 if outside the chart area.
  */
-int ui_chart_hit_test_index(int mouse_x, int total_points);
+int ui_chart_hit_test_index(int mouse_x, const PricePoint *points, int total_points);
 
 /**
  * @brief Render the candlestick chart view.
@@ -269,20 +545,79 @@ int ui_chart_hit_test_index(int mouse_x, int total_points);
  * @param[in] points Array of historical price points.
  * @param[in] period Time interval label for the chart.
  * @param[in] selected_index Selected candle index within @p points.
+ * @param[in] compare Comparison overlay, or NULL.
  */
 void draw_chart(const char *restrict symbol, int count,
-                PricePoint points[count], Period period, int selected_index);
+                PricePoint points[count], Period period, int selected_index,
+                const ChartComparison *compare);
 
 /**
  * @brief Reset cached chart viewport metrics (used when leaving chart mode).
  */
 void ui_chart_reset_viewport(void);
 
+/**
+ * @brief Toggle the volume-at-price strip beside the candles.
+ *
+ * The strip marks the point of control (POC) and the 70% value area
+ * (VAH/VAL) of the visible candles.
+ */
+void ui_chart_toggle_volume_profile(void);
+
+/**
+ * @brief Anchor a range selection at the candle opening at @p timestamp,
+ *        or clear the current selection.
+ *
+ * The selection runs from the anchor to the chart cursor; its return,
+ * high/low, drawdown, volumes and trade count replace the candle info box.
+ */
+void ui_chart_toggle_range(uint64_t timestamp);
+
+/**
+ * @brief Draw the next bar type: candles, Heikin-Ashi, Renko or range bars.
+ *
+ * Renko and range bars use a box of a fixed percentage of the first close
+ * (see ui_chart_step_box_size()).
+ */
+void ui_chart_cycle_bar_type(void);
+
+/**
+ * @brief Pick a smaller (@p step < 0) or larger Renko/range box.
+ */
+void ui_chart_step_box_size(int step);
+
+/**
+ * @brief Cycle candles, line and area drawing.
+ *
+ * Line and area modes fit every loaded candle into the chart width, drawing
+ * each screen column from the first/last/min/max close (M4) of the candles
+ * it covers.
+ */
+void ui_chart_cycle_line_mode(void);
+
+/**
+ * @brief Move the hover crosshair to screen cell (@p x, @p y).
+ *
+ * Only the cells under the old and new crosshair and its price/time
+ * readouts are repainted; draw_chart() repaints it after a full redraw.
+ *
+ * @return Number of cells repainted.
+ */
+int ui_chart_move_crosshair(int x, int y);
+
 /**
  * @brief Update the footer status panel state.
  */
 void ui_set_status_panel_state(StatusPanelState state);
 
+/**
+ * @brief Show @p text in the footer status panel for @p seconds.
+ *
+ * Alerts take precedence over the fetch state while they last; a newer
+ * alert replaces the current one. Safe to call from any thread.
+ */
+void ui_set_status_alert(const char *text, int seconds);
+
 /**
  * @brief Read a key press from the UI.
  *
@@ -292,6 +627,17 @@ void ui_set_status_panel_state(StatusPanelState state);
  * @return Key code (ncurses) or ERR on timeout.
  */
 int handle_input(void);
+
+/**
+ * @brief Coalesce queued pointer-motion events into the newest position.
+ *
+ * Reads without waiting while the input queue holds bare motion reports,
+ * leaving the last position in @p x / @p y; any other key or mouse event
+ * is pushed back so the next handle_input() returns it.
+ *
+ * @return Number of motion events consumed.
+ */
+int ui_coalesce_pointer_motion(int *x, int *y);
 ///@}
 
 #endif // CTICKER_H
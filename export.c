@@ -0,0 +1,618 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file export.c
+ * @brief `cticker export`: stream candles or ticks to CSV / columnar files.
+ *
+ * Sources are the memory-mapped candle store and tick log, so exports read
+ * straight from the page cache and see samples the running UI has just
+ * appended. Rows are formatted in place into one large per-file buffer
+ * (no per-row allocation, no stdio); columnar output transposes blocks of
+ * rows into per-column staging buffers. Full buffers are handed to the
+ * ::StorageIO writer, so formatting of the next block overlaps the disk
+ * write of the previous one. Several symbols are exported in parallel.
+ *
+ * Examples:
+ *   cticker export BTCUSDT ETHUSDT --interval 1m --from -30d --out ./dump
+ *   cticker export BTCUSDT --ticks --format col --out ./dump
+ *   cticker export BTCUSDT --interval 1h --out - | head
+ */
+
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "candle_store.h"
+#include "commands.h"
+#include "export.h"
+#include "storage_io.h"
+#include "tick_history.h"
+
+// Output buffer per file; flushed with a single write() when full.
+#define EXPORT_BUFFER_SIZE (4u << 20)
+// Upper bound for one formatted CSV row.
+#define EXPORT_ROW_MAX 512
+// Rows transposed per columnar block.
+#define EXPORT_BLOCK_ROWS 65536
+#define EXPORT_DEFAULT_JOBS 4
+#define EXPORT_MAX_JOBS 16
+#define EXPORT_MAX_FIELDS 12
+
+typedef enum {
+    EXPORT_CSV,
+    EXPORT_COLUMNAR
+} ExportFormat;
+
+/**
+ * @brief One exported column: where to find it inside a source record.
+ */
+typedef struct {
+    const char *name;
+    ColumnType type;
+    size_t offset;
+} ExportField;
+
+static const ExportField candle_fields[] = {
+    {"open_time", COLUMN_U64, offsetof(CandleRecord, timestamp)},
+    {"open", COLUMN_F64, offsetof(CandleRecord, open)},
+    {"high", COLUMN_F64, offsetof(CandleRecord, high)},
+    {"low", COLUMN_F64, offsetof(CandleRecord, low)},
+    {"close", COLUMN_F64, offsetof(CandleRecord, close)},
+    {"volume", COLUMN_F64, offsetof(CandleRecord, volume)},
+    {"quote_volume", COLUMN_F64, offsetof(CandleRecord, quote_volume)},
+    {"trades", COLUMN_U64, offsetof(CandleRecord, trade_count)},
+    {"taker_buy_base_volume", COLUMN_F64, offsetof(CandleRecord, taker_buy_base_volume)},
+    {"taker_buy_quote_volume", COLUMN_F64, offsetof(CandleRecord, taker_buy_quote_volume)},
+};
+
+static const ExportField tick_fields[] = {
+    {"timestamp", COLUMN_U64, offsetof(TickSample, timestamp)},
+    {"price", COLUMN_F64, offsetof(TickSample, price)},
+    {"volume_base", COLUMN_F64, offsetof(TickSample, volume_base)},
+    {"volume_quote", COLUMN_F64, offsetof(TickSample, volume_quote)},
+};
+
+/**
+ * @brief A contiguous run of fixed-size records to export.
+ */
+typedef struct {
+    const unsigned char *base;
+    size_t stride;
+    size_t rows;
+    const ExportField *fields;
+    int field_count;
+    ColumnarKind kind;
+} ExportSource;
+
+/**
+ * @brief Per-symbol work item and result.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    char path[1024];
+    uint64_t rows;
+    uint64_t bytes;
+    int status;
+} ExportJob;
+
+/**
+ * @brief Shared settings and work queue of one export run.
+ */
+typedef struct {
+    ExportJob *jobs;
+    int job_count;
+    atomic_int next;
+    ExportFormat format;
+    bool ticks;
+    Period period;
+    uint64_t from;
+    uint64_t to;
+    /** Write the single job to stdout instead of a file. */
+    bool to_stdout;
+    /** Asynchronous writer for file outputs. */
+    StorageIO *storage;
+} ExportQueue;
+
+/**
+ * @brief Sequential buffered writer on a raw file descriptor.
+ *
+ * With a ::StorageIO, each full buffer is handed off and replaced by a
+ * fresh one; otherwise (stdout, pipes) it is written synchronously.
+ */
+typedef struct {
+    int fd;
+    StorageIO *storage;
+    char *buf;
+    size_t len;
+    uint64_t bytes;
+    int error;
+} ExportWriter;
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static int write_all(int fd, const void *data, size_t length) {
+    const char *p = data;
+    while (length > 0) {
+        ssize_t n = write(fd, p, length);
+        if (n < 0) {
+            return -1;
+        }
+        p += n;
+        length -= (size_t)n;
+    }
+    return 0;
+}
+
+static void writer_flush(ExportWriter *writer) {
+    if (writer->len == 0 || writer->error) {
+        writer->len = 0;
+        return;
+    }
+    if (writer->storage) {
+        // Hand the full buffer off first: the queue owns it (and frees it on
+        // failure) whether or not a fresh one can be allocated.
+        if (storage_write(writer->storage, writer->fd, writer->bytes, writer->buf,
+                          writer->len, STORAGE_WRITE_TAKE) != 0) {
+            writer->error = 1;
+        }
+        writer->buf = malloc(EXPORT_BUFFER_SIZE);
+        if (!writer->buf) {
+            writer->error = 1;
+        }
+    } else if (write_all(writer->fd, writer->buf, writer->len) != 0) {
+        writer->error = 1;
+    }
+    writer->bytes += writer->len;
+    writer->len = 0;
+}
+
+// Return space for at least @p size bytes at the end of the buffer.
+static char *writer_reserve(ExportWriter *writer, size_t size) {
+    if (writer->len + size > EXPORT_BUFFER_SIZE) {
+        writer_flush(writer);
+        if (!writer->buf) {
+            return NULL;
+        }
+    }
+    return writer->buf + writer->len;
+}
+
+static char *put_u64(char *p, uint64_t value) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    while (n) {
+        *p++ = digits[--n];
+    }
+    return p;
+}
+
+/**
+ * @brief Format like cli_format_number() (8 decimals, zeros trimmed).
+ *
+ * Values that fit a scaled 64-bit integer take the fast path; anything else
+ * (huge volumes, NaN) falls back to snprintf.
+ */
+static char *put_f64(char *p, double value) {
+    double magnitude = fabs(value);
+    if (!(magnitude < 9.0e10)) {
+        return p + snprintf(p, 32, "%.17g", value);
+    }
+    uint64_t scaled = (uint64_t)(magnitude * 1e8 + 0.5);
+    if (value < 0 && scaled) {
+        *p++ = '-';
+    }
+    p = put_u64(p, scaled / 100000000u);
+    uint32_t frac = (uint32_t)(scaled % 100000000u);
+    if (frac) {
+        char digits[8];
+        for (int i = 7; i >= 0; i--) {
+            digits[i] = (char)('0' + frac % 10);
+            frac /= 10;
+        }
+        int n = 8;
+        while (digits[n - 1] == '0') {
+            n--;
+        }
+        *p++ = '.';
+        memcpy(p, digits, (size_t)n);
+        p += n;
+    }
+    return p;
+}
+
+static int export_csv(const ExportSource *src, int fd, StorageIO *storage, uint64_t *bytes) {
+    ExportWriter writer = {.fd = fd, .storage = storage, .buf = malloc(EXPORT_BUFFER_SIZE)};
+    if (!writer.buf) {
+        return -1;
+    }
+
+    char *p = writer_reserve(&writer, EXPORT_ROW_MAX);
+    for (int f = 0; f < src->field_count; f++) {
+        size_t n = strlen(src->fields[f].name);
+        memcpy(p, src->fields[f].name, n);
+        p += n;
+        *p++ = (f + 1 < src->field_count) ? ',' : '\n';
+    }
+    writer.len = (size_t)(p - writer.buf);
+
+    const unsigned char *row = src->base;
+    for (size_t r = 0; r < src->rows; r++, row += src->stride) {
+        p = writer_reserve(&writer, EXPORT_ROW_MAX);
+        if (!p) {
+            break;
+        }
+        for (int f = 0; f < src->field_count; f++) {
+            const unsigned char *field = row + src->fields[f].offset;
+            if (src->fields[f].type == COLUMN_U64) {
+                uint64_t v;
+                memcpy(&v, field, sizeof(v));
+                p = put_u64(p, v);
+            } else {
+                double v;
+                memcpy(&v, field, sizeof(v));
+                p = put_f64(p, v);
+            }
+            *p++ = ',';
+        }
+        p[-1] = '\n';
+        writer.len = (size_t)(p - writer.buf);
+    }
+    writer_flush(&writer);
+    free(writer.buf);
+    *bytes = writer.bytes;
+    return writer.error ? -1 : 0;
+}
+
+static uint64_t align64(uint64_t value) {
+    return (value + 63) & ~(uint64_t)63;
+}
+
+static int export_columnar(const ExportSource *src, const char *symbol, Period period,
+                           int fd, StorageIO *storage, uint64_t *bytes) {
+    int fields = src->field_count;
+    ColumnarHeader header;
+    ColumnarColumn columns[EXPORT_MAX_FIELDS];
+    memset(&header, 0, sizeof(header));
+    memset(columns, 0, sizeof(columns));
+    memcpy(header.magic, COLUMNAR_MAGIC, sizeof(header.magic));
+    header.column_count = (uint32_t)fields;
+    header.kind = (uint32_t)src->kind;
+    header.row_count = src->rows;
+    header.period = (uint32_t)period;
+    snprintf(header.symbol, sizeof(header.symbol), "%s", symbol);
+
+    uint64_t column_bytes = align64((uint64_t)src->rows * 8);
+    uint64_t data_start = align64(sizeof(header) + (uint64_t)fields * sizeof(ColumnarColumn));
+    for (int f = 0; f < fields; f++) {
+        snprintf(columns[f].name, sizeof(columns[f].name), "%s", src->fields[f].name);
+        columns[f].type = (uint32_t)src->fields[f].type;
+        columns[f].offset = data_start + (uint64_t)f * column_bytes;
+    }
+    uint64_t total = data_start + (uint64_t)fields * column_bytes;
+
+    /* Size the file up front so column blocks can be written in any order. */
+    if (ftruncate(fd, (off_t)total) != 0 ||
+        storage_write(storage, fd, 0, &header, sizeof(header), STORAGE_WRITE_COPY) != 0 ||
+        storage_write(storage, fd, sizeof(header), columns,
+                      (size_t)fields * sizeof(ColumnarColumn), STORAGE_WRITE_COPY) != 0) {
+        return -1;
+    }
+
+    size_t block_rows = src->rows < EXPORT_BLOCK_ROWS ? src->rows : EXPORT_BLOCK_ROWS;
+    int status = 0;
+    for (size_t begin = 0; begin < src->rows && status == 0; begin += block_rows) {
+        size_t n = src->rows - begin;
+        if (n > block_rows) {
+            n = block_rows;
+        }
+        const unsigned char *rows = src->base + begin * src->stride;
+        for (int f = 0; f < fields && status == 0; f++) {
+            /* Each block column is its own buffer; the writer frees it. */
+            unsigned char *dst = malloc(n * 8);
+            if (!dst) {
+                status = -1;
+                break;
+            }
+            const unsigned char *field = rows + src->fields[f].offset;
+            for (size_t r = 0; r < n; r++) {
+                memcpy(dst + r * 8, field + r * src->stride, 8);
+            }
+            status = storage_write(storage, fd, columns[f].offset + (uint64_t)begin * 8, dst,
+                                   n * 8, STORAGE_WRITE_TAKE);
+        }
+    }
+    *bytes = total;
+    return status;
+}
+
+// First tick sample with timestamp >= @p timestamp.
+static size_t tick_lower_bound(const TickLogView *view, uint64_t timestamp) {
+    size_t low = 0;
+    size_t high = (size_t)view->count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (view->samples[mid].timestamp < timestamp) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+static int write_source(const ExportQueue *queue, ExportJob *job, const ExportSource *src) {
+    int fd = STDOUT_FILENO;
+    if (!queue->to_stdout) {
+        fd = open(job->path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) {
+            fprintf(stderr, "%s: cannot create %s\n", job->symbol, job->path);
+            return -1;
+        }
+    }
+
+    StorageIO *storage = queue->to_stdout ? NULL : queue->storage;
+    int status = (queue->format == EXPORT_CSV)
+                     ? export_csv(src, fd, storage, &job->bytes)
+                     : export_columnar(src, job->symbol, queue->period, fd, storage,
+                                       &job->bytes);
+    /* The source mapping must stay valid only until the copies are queued. */
+    if (!queue->to_stdout && storage_close(storage, fd) != 0) {
+        status = -1;
+    }
+    if (status != 0) {
+        fprintf(stderr, "%s: write failed\n", job->symbol);
+    }
+    job->rows = src->rows;
+    return status;
+}
+
+static int export_symbol(const ExportQueue *queue, ExportJob *job) {
+    if (queue->ticks) {
+        TickLogView view;
+        if (tick_log_open_view(job->symbol, &view) != 0) {
+            fprintf(stderr, "%s: no tick log (enable `tick_log on`)\n", job->symbol);
+            return -1;
+        }
+        size_t begin = tick_lower_bound(&view, queue->from);
+        size_t end = tick_lower_bound(&view, queue->to);
+        ExportSource src = {
+            .base = (const unsigned char *)(view.samples + begin),
+            .stride = sizeof(TickSample),
+            .rows = end > begin ? end - begin : 0,
+            .fields = tick_fields,
+            .field_count = (int)(sizeof(tick_fields) / sizeof(tick_fields[0])),
+            .kind = COLUMNAR_TICKS,
+        };
+        int status = write_source(queue, job, &src);
+        tick_log_close_view(&view);
+        return status;
+    }
+
+    CandleStore store;
+    if (candle_store_open(&store, job->symbol, queue->period, false) != 0) {
+        fprintf(stderr, "%s: no local %s candles\n", job->symbol,
+                period_interval_code(queue->period));
+        return -1;
+    }
+    size_t begin = candle_store_lower_bound(&store, queue->from);
+    size_t end = candle_store_lower_bound(&store, queue->to);
+    ExportSource src = {
+        .base = (const unsigned char *)(store.records + begin),
+        .stride = sizeof(CandleRecord),
+        .rows = end > begin ? end - begin : 0,
+        .fields = candle_fields,
+        .field_count = (int)(sizeof(candle_fields) / sizeof(candle_fields[0])),
+        .kind = COLUMNAR_CANDLES,
+    };
+    int status = write_source(queue, job, &src);
+    candle_store_close(&store);
+    return status;
+}
+
+static void *export_worker(void *arg) {
+    ExportQueue *queue = arg;
+    for (;;) {
+        int index = atomic_fetch_add(&queue->next, 1);
+        if (index >= queue->job_count) {
+            break;
+        }
+        ExportJob *job = &queue->jobs[index];
+        job->status = export_symbol(queue, job);
+    }
+    return NULL;
+}
+
+static void print_export_usage(void) {
+    fprintf(stderr,
+            "Usage: cticker export SYMBOL... (--interval INTERVAL | --ticks)\n"
+            "                      [--from TIME] [--to TIME] [--format csv|col]\n"
+            "                      [--out DIR|-] [--jobs N]\n"
+            "Files are named SYMBOL-INTERVAL.csv / SYMBOL-ticks.ctcol etc. in DIR\n"
+            "(default: current directory); `--out -` streams one symbol to stdout.\n");
+}
+
+int command_export(int argc, char *argv[]) {
+    const char *interval_arg = NULL;
+    const char *from_arg = NULL;
+    const char *to_arg = NULL;
+    const char *out_dir = ".";
+    ExportFormat format = EXPORT_CSV;
+    bool ticks = false;
+    int jobs_wanted = EXPORT_DEFAULT_JOBS;
+
+    ExportJob *jobs = calloc((size_t)(argc > 1 ? argc : 1), sizeof(ExportJob));
+    if (!jobs) {
+        return 1;
+    }
+    int job_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (strcmp(arg, "--interval") == 0 && has_value) {
+            interval_arg = argv[++i];
+        } else if (strcmp(arg, "--ticks") == 0) {
+            ticks = true;
+        } else if (strcmp(arg, "--from") == 0 && has_value) {
+            from_arg = argv[++i];
+        } else if (strcmp(arg, "--to") == 0 && has_value) {
+            to_arg = argv[++i];
+        } else if (strcmp(arg, "--format") == 0 && has_value) {
+            const char *name = argv[++i];
+            if (strcmp(name, "csv") == 0) {
+                format = EXPORT_CSV;
+            } else if (strcmp(name, "col") == 0 || strcmp(name, "columnar") == 0) {
+                format = EXPORT_COLUMNAR;
+            } else {
+                print_export_usage();
+                free(jobs);
+                return 2;
+            }
+        } else if (strcmp(arg, "--out") == 0 && has_value) {
+            out_dir = argv[++i];
+        } else if (strcmp(arg, "--jobs") == 0 && has_value) {
+            jobs_wanted = atoi(argv[++i]);
+        } else if (arg[0] == '-') {
+            print_export_usage();
+            free(jobs);
+            return 2;
+        } else {
+            snprintf(jobs[job_count++].symbol, sizeof(jobs[0].symbol), "%s", arg);
+        }
+    }
+
+    bool to_stdout = (strcmp(out_dir, "-") == 0);
+    if (job_count == 0 || ticks == (interval_arg != NULL) ||
+        (to_stdout && (job_count != 1 || format != EXPORT_CSV))) {
+        print_export_usage();
+        free(jobs);
+        return 2;
+    }
+
+    Period period = PERIOD_1MIN;
+    if (interval_arg && cli_parse_period(interval_arg, &period) != 0) {
+        free(jobs);
+        return 2;
+    }
+
+    uint64_t now = (uint64_t)time(NULL);
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    if ((from_arg && cli_parse_time(from_arg, now, &from) != 0) ||
+        (to_arg && cli_parse_time(to_arg, now, &to) != 0)) {
+        fprintf(stderr, "Invalid --from/--to time\n");
+        free(jobs);
+        return 2;
+    }
+
+    const char *extension = (format == EXPORT_CSV) ? "csv" : "ctcol";
+    for (int i = 0; i < job_count; i++) {
+        snprintf(jobs[i].path, sizeof(jobs[i].path), "%s/%s-%s.%s", out_dir, jobs[i].symbol,
+                 ticks ? "ticks" : period_interval_code(period), extension);
+    }
+
+    if (jobs_wanted < 1) {
+        jobs_wanted = 1;
+    }
+    if (jobs_wanted > EXPORT_MAX_JOBS) {
+        jobs_wanted = EXPORT_MAX_JOBS;
+    }
+    if (jobs_wanted > job_count) {
+        jobs_wanted = job_count;
+    }
+
+    /* Exports are reproducible from the store, so skip fsync. */
+    StorageIO storage;
+    if (!to_stdout && storage_init(&storage, STORAGE_SYNC_NONE, 0, 0) != 0) {
+        fprintf(stderr, "Failed to start the storage writer\n");
+        free(jobs);
+        return 1;
+    }
+
+    ExportQueue queue = {
+        .jobs = jobs,
+        .storage = to_stdout ? NULL : &storage,
+        .job_count = job_count,
+        .format = format,
+        .ticks = ticks,
+        .period = period,
+        .from = from,
+        .to = to,
+        .to_stdout = to_stdout,
+    };
+    atomic_init(&queue.next, 0);
+
+    double started = wall_seconds();
+    pthread_t threads[EXPORT_MAX_JOBS];
+    int spawned = 0;
+    for (int i = 1; i < jobs_wanted; i++) {
+        if (pthread_create(&threads[spawned], NULL, export_worker, &queue) == 0) {
+            spawned++;
+        }
+    }
+    export_worker(&queue);
+    for (int i = 0; i < spawned; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = wall_seconds() - started;
+    const char *backend = to_stdout ? "stdout" : storage_backend_name(&storage);
+    if (!to_stdout) {
+        storage_shutdown(&storage);
+    }
+
+    int failures = 0;
+    uint64_t rows = 0;
+    uint64_t bytes = 0;
+    for (int i = 0; i < job_count; i++) {
+        failures += jobs[i].status ? 1 : 0;
+        rows += jobs[i].rows;
+        bytes += jobs[i].bytes;
+        if (jobs[i].status == 0 && !to_stdout) {
+            fprintf(stderr, "%s: %llu rows -> %s\n", jobs[i].symbol,
+                    (unsigned long long)jobs[i].rows, jobs[i].path);
+        }
+    }
+    double megabytes = (double)bytes / (1024.0 * 1024.0);
+    fprintf(stderr, "Exported %llu rows (%.1f MiB) in %.3f s, %.0f MiB/s on %d thread(s) (%s)\n",
+            (unsigned long long)rows, megabytes, elapsed,
+            elapsed > 0.0 ? megabytes / elapsed : 0.0, spawned + 1, backend);
+
+    free(jobs);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+#ifndef CTICKER_EXPORT_H
+#define CTICKER_EXPORT_H
+
+#include <stdint.h>
+#include "cticker.h"
+
+/**
+ * @brief Columnar export file layout (`.ctcol`).
+ *
+ * A fixed header, followed by ::ColumnarHeader::column_count descriptors,
+ * followed by the column data. Every column stores
+ * ::ColumnarHeader::row_count little-endian 8-byte values at
+ * ::ColumnarColumn::offset (64-byte aligned), so a reader can mmap the file
+ * and hand each column to numpy/Arrow without parsing.
+ */
+#define COLUMNAR_MAGIC "CTCOL001"
+
+/** Column value types. */
+typedef enum {
+    COLUMN_U64 = 1,
+    COLUMN_F64 = 2
+} ColumnType;
+
+/** What the rows of a columnar file describe. */
+typedef enum {
+    COLUMNAR_CANDLES = 0,
+    COLUMNAR_TICKS = 1
+} ColumnarKind;
+
+/**
+ * @brief Fixed 64-byte header of a columnar export.
+ */
+typedef struct {
+    /** File magic (::COLUMNAR_MAGIC, not NUL-terminated). */
+    char magic[8];
+    /** Number of column descriptors following the header. */
+    uint32_t column_count;
+    /** ::ColumnarKind of the rows. */
+    uint32_t kind;
+    /** Rows per column. */
+    uint64_t row_count;
+    /** Symbol (NUL-terminated). */
+    char symbol[MAX_SYMBOL_LEN];
+    /** ::Period of exported candles (unused for ticks). */
+    uint32_t period;
+    /** Pad the header to 64 bytes. */
+    uint8_t padding[16];
+} ColumnarHeader;
+
+/**
+ * @brief Descriptor of one column.
+ */
+typedef struct {
+    /** Column name (NUL-terminated), same as the CSV header. */
+    char name[24];
+    /** ::ColumnType of every value. */
+    uint32_t type;
+    /** Reserved, zero. */
+    uint32_t reserved;
+    /** Absolute file offset of the first value. */
+    uint64_t offset;
+} ColumnarColumn;
+
+#endif
@@ -28,7 +28,11 @@ SOFTWARE.
  *
  * Design notes:
  * - Fetch happens without holding the runtime mutex.
- * - Only publish updated rows under the mutex to keep UI responsive.
+ * - Only publish updated rows under the mutex to keep UI responsive; the
+ *   synthetic pairs reading those rows and the portfolio are updated in the
+ *   same critical section.
+ * - Published rows are appended to the tick history after the mutex is
+ *   released.
  * - Uses runtime_is_running() to cooperate with shutdown requests.
  */
 
@@ -38,6 +42,9 @@ SOFTWARE.
 #include "fetcher.h"
 #include "cticker.h"
 #include "runtime.h"
+#include "probes.h"
+#include "tick_history.h"
+#include "trace.h"
 
 // Background refresh cadence (seconds).
 #define REFRESH_INTERVAL 5
@@ -58,17 +65,38 @@ static void fetch_all_symbols(const Config *config,
     }
 }
 
-// Publish updated rows to the shared ticker buffer under mutex.
+// Publish updated rows to the shared ticker buffer (recomputing dependent
+// synthetic rows and the portfolio) under mutex, then record the fetched rows
+// in the tick history (which has its own lock).
 static void apply_updated_tickers(RuntimeContext *ctx,
                                   const TickerData *scratch,
-                                  const bool *updated) {
+                                  bool *updated) {
+    int symbol_count = ctx->config.symbol_count;
+    int rows = 0;
+    uint64_t span = trace_begin();
     pthread_mutex_lock(&ctx->data_mutex);
-    for (int i = 0; i < ctx->ticker_count; i++) {
+    for (int i = 0; i < symbol_count; i++) {
         if (updated[i]) {
             ctx->global_tickers[i] = scratch[i];
+            rows++;
+        }
+    }
+    synthetic_update(&ctx->synthetics, ctx->global_tickers, updated);
+    for (int i = 0; i < ctx->ticker_count; i++) {
+        if (updated[i]) {
+            portfolio_update(&ctx->portfolio, i, ctx->global_tickers[i].price);
+            movestats_update(&ctx->move_stats, i, &ctx->global_tickers[i]);
         }
     }
     pthread_mutex_unlock(&ctx->data_mutex);
+
+    for (int i = 0; i < symbol_count; i++) {
+        if (updated[i]) {
+            tick_history_append(&ctx->tick_history, i, &scratch[i]);
+        }
+    }
+    trace_end("publish", span, NULL);
+    CTICKER_PROBE1(publish, rows);
 }
 
 // Initial synchronous fetch so the first render has data.
@@ -79,7 +107,7 @@ int fetcher_initial_fetch(RuntimeContext *ctx) {
 
     int symbol_count = ctx->config.symbol_count;
     TickerData *scratch = calloc(symbol_count, sizeof(TickerData));
-    bool *updated = calloc(symbol_count, sizeof(bool));
+    bool *updated = calloc(ctx->ticker_count, sizeof(bool));
     if (!scratch || !updated) {
         free(scratch);
         free(updated);
@@ -105,10 +133,11 @@ void *fetcher_thread_main(void *arg) {
     if (!ctx) {
         return NULL;
     }
+    trace_set_thread_name("fetcher");
 
     int symbol_count = ctx->config.symbol_count;
     TickerData *scratch = calloc(symbol_count, sizeof(TickerData));
-    bool *updated = calloc(symbol_count, sizeof(bool));
+    bool *updated = calloc(ctx->ticker_count, sizeof(bool));
     if (!scratch || !updated) {
         free(scratch);
         free(updated);
@@ -119,7 +148,7 @@ void *fetcher_thread_main(void *arg) {
 
     while (runtime_is_running()) {
         ui_set_status_panel_state(STATUS_PANEL_FETCHING);
-        memset(updated, 0, (size_t)symbol_count * sizeof(bool));
+        memset(updated, 0, (size_t)ctx->ticker_count * sizeof(bool));
         bool had_failure = false;
 
         fetch_all_symbols(&ctx->config, scratch, updated, &had_failure);
@@ -0,0 +1,759 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file kline_import.c
+ * @brief Bulk import of Binance kline archives into the candle store.
+ *
+ * Binance publishes daily/monthly kline dumps as ZIP files holding a single
+ * CSV (https://data.binance.vision). This module reads those archives (or
+ * already extracted CSVs), parses them with a hand-rolled number parser,
+ * validates each candle and merges the result into the candle store.
+ *
+ * `cticker import` fans files out over worker threads; each worker inflates
+ * and parses one file at a time into its own ::KlineBatch, and the main
+ * thread merges the per-(symbol, interval) results once all workers finish.
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <zlib.h>
+#include "commands.h"
+#include "kline_import.h"
+
+#define ZIP_LOCAL_HEADER_SIG 0x04034b50u
+#define ZIP_CENTRAL_HEADER_SIG 0x02014b50u
+#define ZIP_END_OF_DIR_SIG 0x06054b50u
+#define ZIP_METHOD_STORED 0
+#define ZIP_METHOD_DEFLATE 8
+
+// Default number of parser threads for `cticker import`.
+#define IMPORT_DEFAULT_JOBS 4
+#define IMPORT_MAX_JOBS 64
+
+// Exact powers of ten; any integer mantissa below 2^53 divided by one of
+// these is correctly rounded, which covers every Binance price/volume field.
+static const double pow10_table[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Ensure room for @p extra more records.
+static int batch_reserve(KlineBatch *batch, size_t extra) {
+    if (batch->count + extra <= batch->capacity) {
+        return 0;
+    }
+    size_t capacity = batch->capacity ? batch->capacity : 1024;
+    while (capacity < batch->count + extra) {
+        capacity *= 2;
+    }
+    CandleRecord *records = realloc(batch->records, capacity * sizeof(CandleRecord));
+    if (!records) {
+        return -1;
+    }
+    batch->records = records;
+    batch->capacity = capacity;
+    return 0;
+}
+
+// Parse an unsigned integer field ending at ',' / end of line.
+static bool parse_uint_field(const char **cursor, const char *end, uint64_t *out) {
+    const char *p = *cursor;
+    uint64_t value = 0;
+    const char *start = p;
+    while (p < end && (unsigned)(*p - '0') < 10u) {
+        value = value * 10 + (uint64_t)(*p - '0');
+        p++;
+    }
+    if (p == start) {
+        return false;
+    }
+    *cursor = p;
+    *out = value;
+    return true;
+}
+
+// Slow path for unusual number spellings (exponents, very long mantissas).
+static bool parse_double_slow(const char *start, const char *end, double *out) {
+    char buf[64];
+    size_t len = (size_t)(end - start);
+    if (len == 0 || len >= sizeof(buf)) {
+        return false;
+    }
+    memcpy(buf, start, len);
+    buf[len] = '\0';
+    char *stop = NULL;
+    *out = strtod(buf, &stop);
+    return stop == buf + len;
+}
+
+// Parse a decimal field such as "42123.45000000" without strtod().
+static bool parse_double_field(const char **cursor, const char *end, double *out) {
+    const char *p = *cursor;
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int frac_digits = 0;
+    while (p < end && (unsigned)(*p - '0') < 10u) {
+        mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        digits++;
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && (unsigned)(*p - '0') < 10u) {
+            mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+            digits++;
+            frac_digits++;
+            p++;
+        }
+    }
+
+    bool field_done = (p == end || *p == ',' || *p == '\n' || *p == '\r');
+    if (digits == 0 && field_done) {
+        return false;
+    }
+    if (!field_done || digits > 15 || frac_digits > 22) {
+        const char *field_end = p;
+        while (field_end < end && *field_end != ',' && *field_end != '\n' && *field_end != '\r') {
+            field_end++;
+        }
+        if (!parse_double_slow(start, field_end, out)) {
+            return false;
+        }
+        *cursor = field_end;
+        return true;
+    }
+
+    double value = (double)mantissa / pow10_table[frac_digits];
+    *out = negative ? -value : value;
+    *cursor = p;
+    return true;
+}
+
+// Expect a ',' separator and step over it.
+static bool skip_comma(const char **cursor, const char *end) {
+    if (*cursor >= end || **cursor != ',') {
+        return false;
+    }
+    (*cursor)++;
+    return true;
+}
+
+// Normalise ms/µs timestamps to seconds.
+static uint64_t to_seconds(uint64_t value) {
+    if (value >= 1000000000000000ULL) {
+        return value / 1000000ULL;
+    }
+    if (value >= 100000000000ULL) {
+        return value / 1000ULL;
+    }
+    return value;
+}
+
+// Parse one CSV row into @p record; returns false on malformed rows.
+static bool parse_row(const char *line, const char *end, CandleRecord *record) {
+    const char *p = line;
+    uint64_t open_time = 0, close_time = 0, trades = 0;
+    if (!parse_uint_field(&p, end, &open_time) || !skip_comma(&p, end) ||
+        !parse_double_field(&p, end, &record->open) || !skip_comma(&p, end) ||
+        !parse_double_field(&p, end, &record->high) || !skip_comma(&p, end) ||
+        !parse_double_field(&p, end, &record->low) || !skip_comma(&p, end) ||
+        !parse_double_field(&p, end, &record->close) || !skip_comma(&p, end) ||
+        !parse_double_field(&p, end, &record->volume) || !skip_comma(&p, end) ||
+        !parse_uint_field(&p, end, &close_time) || !skip_comma(&p, end) ||
+        !parse_double_field(&p, end, &record->quote_volume) || !skip_comma(&p, end) ||
+        !parse_uint_field(&p, end, &trades) || !skip_comma(&p, end) ||
+        !parse_double_field(&p, end, &record->taker_buy_base_volume) || !skip_comma(&p, end) ||
+        !parse_double_field(&p, end, &record->taker_buy_quote_volume)) {
+        return false;
+    }
+    record->timestamp = to_seconds(open_time);
+    record->close_time = to_seconds(close_time);
+    record->trade_count = trades;
+    return true;
+}
+
+// Sanity checks that reject corrupted or truncated rows.
+static bool record_valid(const CandleRecord *r) {
+    if (r->close_time < r->timestamp || r->low <= 0.0) {
+        return false;
+    }
+    double body_low = r->open < r->close ? r->open : r->close;
+    double body_high = r->open > r->close ? r->open : r->close;
+    if (r->low > body_low || r->high < body_high) {
+        return false;
+    }
+    return r->volume >= 0.0 && r->quote_volume >= 0.0 &&
+           r->taker_buy_base_volume >= 0.0 && r->taker_buy_quote_volume >= 0.0;
+}
+
+int kline_parse_csv(const char *data, size_t length, KlineBatch *batch) {
+    if (!data || !batch) {
+        return -1;
+    }
+    /* Rows are ~110-150 bytes; reserve up front to avoid repeated growth. */
+    if (batch_reserve(batch, length / 100 + 1) != 0) {
+        return -1;
+    }
+
+    const char *cursor = data;
+    const char *end = data + length;
+    while (cursor < end) {
+        const char *line_end = memchr(cursor, '\n', (size_t)(end - cursor));
+        if (!line_end) {
+            line_end = end;
+        }
+        const char *content_end = line_end;
+        if (content_end > cursor && content_end[-1] == '\r') {
+            content_end--;
+        }
+
+        if (content_end > cursor && (unsigned)(*cursor - '0') < 10u) {
+            if (batch_reserve(batch, 1) != 0) {
+                return -1;
+            }
+            CandleRecord *record = &batch->records[batch->count];
+            if (parse_row(cursor, content_end, record) && record_valid(record)) {
+                batch->count++;
+            } else {
+                batch->rejected++;
+            }
+        }
+        /* Non-numeric lines are headers (newer archives ship one). */
+        cursor = line_end + 1;
+    }
+    return 0;
+}
+
+// Little-endian readers for ZIP structures.
+static uint16_t read_le16(const unsigned char *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_le32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+// Inflate one ZIP member into a temporary buffer and parse it.
+static int parse_zip_member(const unsigned char *data, size_t compressed,
+                            size_t uncompressed, uint32_t crc, int method,
+                            KlineBatch *batch) {
+    if (method == ZIP_METHOD_STORED) {
+        if (compressed != uncompressed ||
+            crc32(0L, data, (uInt)compressed) != crc) {
+            return -1;
+        }
+        return kline_parse_csv((const char *)data, compressed, batch);
+    }
+    if (method != ZIP_METHOD_DEFLATE) {
+        return -1;
+    }
+
+    unsigned char *out = malloc(uncompressed ? uncompressed : 1);
+    if (!out) {
+        return -1;
+    }
+
+    z_stream zs;
+    memset(&zs, 0, sizeof(zs));
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+        free(out);
+        return -1;
+    }
+    zs.next_in = (Bytef *)data;
+    zs.avail_in = (uInt)compressed;
+    zs.next_out = out;
+    zs.avail_out = (uInt)uncompressed;
+    int zrc = inflate(&zs, Z_FINISH);
+    size_t produced = zs.total_out;
+    inflateEnd(&zs);
+
+    int rc = -1;
+    if (zrc == Z_STREAM_END && produced == uncompressed &&
+        crc32(0L, out, (uInt)produced) == crc) {
+        rc = kline_parse_csv((const char *)out, produced, batch);
+    }
+    free(out);
+    return rc;
+}
+
+// Walk the central directory and parse every .csv member.
+static int parse_zip(const unsigned char *data, size_t size, KlineBatch *batch) {
+    if (size < 22) {
+        return -1;
+    }
+
+    /* The end-of-central-directory record sits within the last 64 KiB. */
+    size_t min_pos = size > 22 + 65535 ? size - 22 - 65535 : 0;
+    size_t eocd = SIZE_MAX;
+    for (size_t pos = size - 22; ; pos--) {
+        if (read_le32(data + pos) == ZIP_END_OF_DIR_SIG) {
+            eocd = pos;
+            break;
+        }
+        if (pos == min_pos) {
+            break;
+        }
+    }
+    if (eocd == SIZE_MAX) {
+        return -1;
+    }
+
+    uint16_t entries = read_le16(data + eocd + 10);
+    size_t dir_offset = read_le32(data + eocd + 16);
+    int parsed_members = 0;
+
+    size_t pos = dir_offset;
+    for (uint16_t i = 0; i < entries; i++) {
+        if (pos + 46 > size || read_le32(data + pos) != ZIP_CENTRAL_HEADER_SIG) {
+            return -1;
+        }
+        uint16_t method = read_le16(data + pos + 10);
+        uint32_t crc = read_le32(data + pos + 16);
+        size_t compressed = read_le32(data + pos + 20);
+        size_t uncompressed = read_le32(data + pos + 24);
+        uint16_t name_len = read_le16(data + pos + 28);
+        uint16_t extra_len = read_le16(data + pos + 30);
+        uint16_t comment_len = read_le16(data + pos + 32);
+        size_t local = read_le32(data + pos + 42);
+        const char *name = (const char *)data + pos + 46;
+        if (pos + 46 + name_len > size) {
+            return -1;
+        }
+        pos += 46 + (size_t)name_len + extra_len + comment_len;
+
+        if (name_len < 4 || memcmp(name + name_len - 4, ".csv", 4) != 0) {
+            continue;
+        }
+
+        if (local + 30 > size || read_le32(data + local) != ZIP_LOCAL_HEADER_SIG) {
+            return -1;
+        }
+        size_t payload = local + 30 + read_le16(data + local + 26) + read_le16(data + local + 28);
+        if (payload + compressed > size) {
+            return -1;
+        }
+        if (parse_zip_member(data + payload, compressed, uncompressed, crc, method, batch) != 0) {
+            return -1;
+        }
+        parsed_members++;
+    }
+    return parsed_members > 0 ? 0 : -1;
+}
+
+int kline_read_archive(const char *path, KlineBatch *batch) {
+    if (!path || !batch) {
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+    madvise(map, size, MADV_SEQUENTIAL);
+
+    const unsigned char *data = map;
+    int rc;
+    if (size >= 4 && read_le32(data) == ZIP_LOCAL_HEADER_SIG) {
+        rc = parse_zip(data, size, batch);
+    } else {
+        rc = kline_parse_csv(map, size, batch);
+    }
+    munmap(map, size);
+    return rc;
+}
+
+int kline_parse_archive_name(const char *path, char *symbol, size_t symbol_size,
+                             Period *period) {
+    if (!path || !symbol || !period) {
+        return -1;
+    }
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+
+    const char *dash = strchr(base, '-');
+    if (!dash || dash == base || (size_t)(dash - base) >= symbol_size) {
+        return -1;
+    }
+    const char *interval = dash + 1;
+    const char *interval_end = strchr(interval, '-');
+    if (!interval_end || interval_end - interval >= 8) {
+        return -1;
+    }
+
+    char code[8];
+    memcpy(code, interval, (size_t)(interval_end - interval));
+    code[interval_end - interval] = '\0';
+    if (period_from_interval_code(code, period) != 0) {
+        return -1;
+    }
+    memcpy(symbol, base, (size_t)(dash - base));
+    symbol[dash - base] = '\0';
+    return 0;
+}
+
+// Stable bottom-up merge sort by open time.
+static int sort_records(CandleRecord *records, size_t count) {
+    CandleRecord *tmp = malloc(count * sizeof(CandleRecord));
+    if (!tmp) {
+        return -1;
+    }
+    CandleRecord *src = records;
+    CandleRecord *dst = tmp;
+    for (size_t width = 1; width < count; width *= 2) {
+        for (size_t lo = 0; lo < count; lo += 2 * width) {
+            size_t mid = lo + width < count ? lo + width : count;
+            size_t hi = lo + 2 * width < count ? lo + 2 * width : count;
+            size_t i = lo, j = mid, k = lo;
+            while (i < mid && j < hi) {
+                dst[k++] = (src[j].timestamp < src[i].timestamp) ? src[j++] : src[i++];
+            }
+            while (i < mid) {
+                dst[k++] = src[i++];
+            }
+            while (j < hi) {
+                dst[k++] = src[j++];
+            }
+        }
+        CandleRecord *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != records) {
+        memcpy(records, src, count * sizeof(CandleRecord));
+    }
+    free(tmp);
+    return 0;
+}
+
+int kline_batch_normalize(KlineBatch *batch) {
+    if (!batch || batch->count < 2) {
+        return 0;
+    }
+
+    bool sorted = true;
+    for (size_t i = 1; i < batch->count; i++) {
+        if (batch->records[i].timestamp < batch->records[i - 1].timestamp) {
+            sorted = false;
+            break;
+        }
+    }
+    if (!sorted && sort_records(batch->records, batch->count) != 0) {
+        return -1;
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < batch->count; i++) {
+        if (out > 0 && batch->records[out - 1].timestamp == batch->records[i].timestamp) {
+            batch->records[out - 1] = batch->records[i];
+        } else {
+            batch->records[out++] = batch->records[i];
+        }
+    }
+    batch->count = out;
+    return 0;
+}
+
+void kline_batch_free(KlineBatch *batch) {
+    if (!batch) {
+        return;
+    }
+    free(batch->records);
+    memset(batch, 0, sizeof(*batch));
+}
+
+/**
+ * @brief One input file of `cticker import` and its parse result.
+ */
+typedef struct {
+    const char *path;
+    char symbol[MAX_SYMBOL_LEN];
+    Period period;
+    KlineBatch batch;
+    int status;
+    /** CPU time spent parsing this file (seconds). */
+    double cpu_seconds;
+} ImportJob;
+
+/**
+ * @brief Shared work queue for import workers.
+ */
+typedef struct {
+    ImportJob *jobs;
+    int job_count;
+    atomic_int next;
+} ImportQueue;
+
+static double thread_cpu_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double wall_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Worker: pull files off the queue until it is drained.
+static void *import_worker(void *arg) {
+    ImportQueue *queue = arg;
+    for (;;) {
+        int index = atomic_fetch_add(&queue->next, 1);
+        if (index >= queue->job_count) {
+            break;
+        }
+        ImportJob *job = &queue->jobs[index];
+        double started = thread_cpu_seconds();
+        job->status = kline_read_archive(job->path, &job->batch);
+        job->cpu_seconds = thread_cpu_seconds() - started;
+    }
+    return NULL;
+}
+
+static void print_import_usage(void) {
+    fprintf(stderr,
+            "Usage: cticker import [--symbol SYMBOL] [--interval INTERVAL] [--jobs N] FILE...\n"
+            "FILE: Binance kline archive (.zip) or CSV; symbol/interval default to the\n"
+            "      file name convention, e.g. BTCUSDT-1m-2024-01.zip\n");
+}
+
+// Merge all jobs that share a (symbol, period) into the candle store.
+static int merge_group(ImportJob *jobs, int job_count, int first, bool *merged,
+                       long *added_total) {
+    ImportJob *lead = &jobs[first];
+    KlineBatch combined = {0};
+    for (int i = first; i < job_count; i++) {
+        ImportJob *job = &jobs[i];
+        if (merged[i] || job->status != 0 || job->period != lead->period ||
+            strcmp(job->symbol, lead->symbol) != 0) {
+            continue;
+        }
+        merged[i] = true;
+        if (batch_reserve(&combined, job->batch.count) != 0) {
+            kline_batch_free(&combined);
+            return -1;
+        }
+        memcpy(combined.records + combined.count, job->batch.records,
+               job->batch.count * sizeof(CandleRecord));
+        combined.count += job->batch.count;
+    }
+
+    if (kline_batch_normalize(&combined) != 0) {
+        fprintf(stderr, "%s %s: out of memory sorting candles\n", lead->symbol,
+                period_interval_code(lead->period));
+        kline_batch_free(&combined);
+        return -1;
+    }
+
+    CandleStore store;
+    if (candle_store_open(&store, lead->symbol, lead->period, true) != 0) {
+        fprintf(stderr, "%s %s: cannot open candle store\n", lead->symbol,
+                period_interval_code(lead->period));
+        kline_batch_free(&combined);
+        return -1;
+    }
+    long added = candle_store_merge(&store, combined.records, combined.count);
+    uint64_t stored = store.count;
+    candle_store_close(&store);
+    if (added < 0) {
+        fprintf(stderr, "%s %s: failed to write candle store\n", lead->symbol,
+                period_interval_code(lead->period));
+        kline_batch_free(&combined);
+        return -1;
+    }
+
+    fprintf(stderr, "%s %s: %zu candles, %ld new, %llu stored\n", lead->symbol,
+            period_interval_code(lead->period), combined.count, added,
+            (unsigned long long)stored);
+    *added_total += added;
+    kline_batch_free(&combined);
+    return 0;
+}
+
+int command_import(int argc, char *argv[]) {
+    const char *symbol_override = NULL;
+    const char *interval_override = NULL;
+    int jobs_wanted = IMPORT_DEFAULT_JOBS;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0 && cpus < jobs_wanted) {
+        jobs_wanted = (int)cpus;
+    }
+
+    ImportJob *jobs = calloc((size_t)(argc > 1 ? argc : 1), sizeof(ImportJob));
+    if (!jobs) {
+        return 1;
+    }
+    int job_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (strcmp(arg, "--symbol") == 0 && has_value) {
+            symbol_override = argv[++i];
+        } else if (strcmp(arg, "--interval") == 0 && has_value) {
+            interval_override = argv[++i];
+        } else if (strcmp(arg, "--jobs") == 0 && has_value) {
+            jobs_wanted = atoi(argv[++i]);
+        } else if (arg[0] == '-') {
+            print_import_usage();
+            free(jobs);
+            return 2;
+        } else {
+            jobs[job_count++].path = arg;
+        }
+    }
+
+    if (job_count == 0) {
+        print_import_usage();
+        free(jobs);
+        return 2;
+    }
+    if (jobs_wanted < 1) {
+        jobs_wanted = 1;
+    }
+    if (jobs_wanted > IMPORT_MAX_JOBS) {
+        jobs_wanted = IMPORT_MAX_JOBS;
+    }
+    if (jobs_wanted > job_count) {
+        jobs_wanted = job_count;
+    }
+
+    Period override_period = PERIOD_1MIN;
+    if (interval_override && cli_parse_period(interval_override, &override_period) != 0) {
+        free(jobs);
+        return 2;
+    }
+
+    for (int i = 0; i < job_count; i++) {
+        ImportJob *job = &jobs[i];
+        bool named = kline_parse_archive_name(job->path, job->symbol, sizeof(job->symbol),
+                                              &job->period) == 0;
+        if (symbol_override) {
+            snprintf(job->symbol, sizeof(job->symbol), "%s", symbol_override);
+        }
+        if (interval_override) {
+            job->period = override_period;
+        }
+        if (!named && (!symbol_override || !interval_override)) {
+            fprintf(stderr, "%s: cannot infer symbol/interval; pass --symbol and --interval\n",
+                    job->path);
+            free(jobs);
+            return 2;
+        }
+    }
+
+    double started = wall_seconds();
+    ImportQueue queue = {.jobs = jobs, .job_count = job_count};
+    atomic_init(&queue.next, 0);
+
+    pthread_t threads[IMPORT_MAX_JOBS];
+    int spawned = 0;
+    for (int i = 1; i < jobs_wanted; i++) {
+        if (pthread_create(&threads[spawned], NULL, import_worker, &queue) == 0) {
+            spawned++;
+        }
+    }
+    import_worker(&queue);
+    for (int i = 0; i < spawned; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double parsed_at = wall_seconds();
+
+    size_t parsed = 0;
+    size_t rejected = 0;
+    double cpu_seconds = 0.0;
+    int failures = 0;
+    for (int i = 0; i < job_count; i++) {
+        if (jobs[i].status != 0) {
+            fprintf(stderr, "%s: unreadable or corrupt archive\n", jobs[i].path);
+            failures++;
+        }
+        parsed += jobs[i].batch.count;
+        rejected += jobs[i].batch.rejected;
+        cpu_seconds += jobs[i].cpu_seconds;
+    }
+
+    bool *merged = calloc((size_t)job_count, sizeof(bool));
+    long added = 0;
+    if (!merged) {
+        failures++;
+    } else {
+        for (int i = 0; i < job_count; i++) {
+            if (!merged[i] && jobs[i].status == 0 &&
+                merge_group(jobs, job_count, i, merged, &added) != 0) {
+                failures++;
+            }
+        }
+    }
+    free(merged);
+
+    double elapsed = wall_seconds() - started;
+    double parse_wall = parsed_at - started;
+    fprintf(stderr,
+            "Imported %zu candles from %d file(s) in %.3f s (%ld new, %zu rejected)\n"
+            "Parse: %.0f candles/s wall on %d thread(s), %.0f candles/s per core\n",
+            parsed, job_count, elapsed, added, rejected,
+            parse_wall > 0.0 ? (double)parsed / parse_wall : 0.0, spawned + 1,
+            cpu_seconds > 0.0 ? (double)parsed / cpu_seconds : 0.0);
+
+    for (int i = 0; i < job_count; i++) {
+        kline_batch_free(&jobs[i].batch);
+    }
+    free(jobs);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+#ifndef CTICKER_KLINE_IMPORT_H
+#define CTICKER_KLINE_IMPORT_H
+
+#include <stddef.h>
+#include "candle_store.h"
+
+/**
+ * @brief Growable batch of parsed candles.
+ */
+typedef struct {
+    /** Parsed records in input order. */
+    CandleRecord *records;
+    /** Number of valid records. */
+    size_t count;
+    /** Allocated capacity of ::KlineBatch::records. */
+    size_t capacity;
+    /** Rows that were malformed or failed validation. */
+    size_t rejected;
+} KlineBatch;
+
+/**
+ * @brief Parse Binance kline CSV rows and append them to @p batch.
+ *
+ * Accepts the public archive layout (open time, OHLC, volume, close time,
+ * quote volume, trades, taker buy base/quote, ignore). An optional header
+ * row is skipped; open/close times in ms or µs are normalised to seconds.
+ * Rows with inconsistent OHLC values or negative volumes are counted in
+ * ::KlineBatch::rejected and dropped.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+int kline_parse_csv(const char *data, size_t length, KlineBatch *batch);
+
+/**
+ * @brief Read a `.zip` archive (every `.csv` entry) or a plain `.csv` file.
+ * @return 0 on success, -1 on I/O, format or allocation errors.
+ */
+int kline_read_archive(const char *path, KlineBatch *batch);
+
+/**
+ * @brief Infer symbol and interval from a Binance archive file name.
+ *
+ * Works for names such as `BTCUSDT-1m-2024-01.zip` or
+ * `ETHUSDT-1h-2024-03-15.csv` (any leading directories are ignored).
+ *
+ * @return 0 on success, -1 if the name does not follow the convention.
+ */
+int kline_parse_archive_name(const char *path, char *symbol, size_t symbol_size,
+                             Period *period);
+
+/**
+ * @brief Sort by open time and drop duplicate candles (last one wins).
+ *
+ * @return 0 on success, -1 if the sort scratch buffer cannot be allocated
+ *         (the batch is then left untouched).
+ */
+int kline_batch_normalize(KlineBatch *batch);
+
+/**
+ * @brief Release memory owned by @p batch.
+ */
+void kline_batch_free(KlineBatch *batch);
+
+#endif
@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file m4.c
+ * @brief M4 (first/last/min/max) column aggregation for the line chart.
+ */
+
+#include <stdint.h>
+#include "m4.h"
+
+// First candle of column @p c when @p n candles share @p columns columns.
+static int m4_column_start(int n, int columns, int c) {
+    return (int)((int64_t)c * n / columns);
+}
+
+// One pass over the closes: each column keeps its first, last, min and max.
+int m4_aggregate(const PricePoint *points, int from, int to, int columns, M4Column *out) {
+    int n = to - from;
+    if (n <= 0 || columns <= 0) {
+        return 0;
+    }
+    if (columns > n) {
+        columns = n;
+    }
+    for (int c = 0; c < columns; ++c) {
+        int start = from + m4_column_start(n, columns, c);
+        int end = from + m4_column_start(n, columns, c + 1);
+        double lo = points[start].close;
+        double hi = lo;
+        for (int i = start + 1; i < end; ++i) {
+            double v = points[i].close;
+            lo = (v < lo) ? v : lo;
+            hi = (v > hi) ? v : hi;
+        }
+        out[c].from = start;
+        out[c].to = end;
+        out[c].first = points[start].close;
+        out[c].last = points[end - 1].close;
+        out[c].min = lo;
+        out[c].max = hi;
+    }
+    return columns;
+}
+
+// Inverse of the bucketing in m4_aggregate().
+int m4_column_of(int from, int to, int columns, int index) {
+    int n = to - from;
+    if (n <= 0 || columns <= 0) {
+        return -1;
+    }
+    if (columns > n) {
+        columns = n;
+    }
+    // Largest c with start(c) <= index - from.
+    int c = (int)(((int64_t)(index - from) * columns + columns - 1) / n);
+    while (c > 0 && m4_column_start(n, columns, c) > index - from) {
+        c--;
+    }
+    while (c + 1 < columns && m4_column_start(n, columns, c + 1) <= index - from) {
+        c++;
+    }
+    return c;
+}
+
+// Same mapping as the chart's price axis.
+int m4_price_row(double price, double min_price, double max_price, int rows) {
+    double range = max_price - min_price;
+    if (range <= 0.0000001) {
+        range = 1.0;
+    }
+    double normalized = (price - min_price) / range;
+    if (normalized < 0.0) normalized = 0.0;
+    if (normalized > 1.0) normalized = 1.0;
+    int usable_height = rows - 1;
+    if (usable_height < 1) usable_height = 1;
+    return rows - 1 - (int)(normalized * usable_height);
+}
+
+// Rows between the column's extremes, stretched to meet the previous
+// column's last close (the segment joining the two columns).
+void m4_column_rows(const M4Column *columns, int c, double min_price, double max_price,
+                    int rows, int *top, int *bottom) {
+    double lo = columns[c].min;
+    double hi = columns[c].max;
+    if (c > 0) {
+        double prev = columns[c - 1].last;
+        lo = (prev < lo) ? prev : lo;
+        hi = (prev > hi) ? prev : hi;
+    }
+    *top = m4_price_row(hi, min_price, max_price, rows);
+    *bottom = m4_price_row(lo, min_price, max_price, rows);
+}
@@ -0,0 +1,54 @@
+#ifndef CTICKER_M4_H
+#define CTICKER_M4_H
+
+#include "cticker.h"
+
+/**
+ * @brief First, last, lowest and highest close of the candles in one
+ *        chart column.
+ */
+typedef struct {
+    /** Candles points[from .. to) fall in this column. */
+    int from;
+    int to;
+    double first;
+    double last;
+    double min;
+    double max;
+} M4Column;
+
+/**
+ * @brief Bucket points[from .. to) into @p columns columns of (near) equal
+ *        candle counts and keep the M4 aggregate of each.
+ *
+ * When there are fewer candles than columns each candle gets a column.
+ * A line through every close, drawn at character resolution, covers in
+ * each column exactly the rows between its min and max and the previous
+ * column's last close, so these four values per column draw the same
+ * picture as the full series.
+ *
+ * @param[out] out At least @p columns entries.
+ * @return Columns filled (0 when the range is empty).
+ */
+int m4_aggregate(const PricePoint *points, int from, int to, int columns, M4Column *out);
+
+/**
+ * @brief Column holding candle @p index in an aggregate from m4_aggregate().
+ */
+int m4_column_of(int from, int to, int columns, int index);
+
+/**
+ * @brief Rows (0 = top) a line through the closes covers in column @p c.
+ *
+ * Prices map to rows as on the chart axis: @p max_price on row 0 and
+ * @p min_price on row @p rows - 1.
+ */
+void m4_column_rows(const M4Column *columns, int c, double min_price, double max_price,
+                    int rows, int *top, int *bottom);
+
+/**
+ * @brief Row (0 = top) of @p price on a @p rows-row axis from @p min_price to @p max_price.
+ */
+int m4_price_row(double price, double min_price, double max_price, int rows);
+
+#endif
@@ -56,24 +56,216 @@ SOFTWARE.
 #endif
 #include "cticker.h"
 #include "chart.h"
+#include "commands.h"
+#include "arbitrage.h"
+#include "correlation.h"
+#include "portfolio.h"
 #include "priceboard.h"
+#include "probes.h"
 #include "runtime.h"
+#include "trace.h"
+
+/** Longest a stream of pointer motion may hold back a full redraw (seconds). */
+#define POINTER_REDRAW_SECONDS 1.0
+
+/**
+ * @brief Offline sub-command table (`cticker <name> ...`).
+ */
+typedef struct {
+    const char *name;
+    int (*run)(int argc, char *argv[]);
+} CommandEntry;
+
+static const CommandEntry commands[] = {
+    {"query", command_query},
+    {"import", command_import},
+    {"backfill", command_backfill},
+    {"export", command_export},
+    {"backtest", command_backtest},
+};
+
+/**
+ * @brief Run an offline sub-command if argv names one.
+ * @return true when a command was dispatched (its status is in @p status).
+ */
+static bool dispatch_command(int argc, char *argv[], int *status) {
+    if (argc < 2) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        if (strcmp(argv[1], commands[i].name) == 0) {
+            *status = commands[i].run(argc - 1, argv + 1);
+            return true;
+        }
+    }
+    fprintf(stderr, "Unknown command '%s'\n", argv[1]);
+    fprintf(stderr, "Usage: cticker [");
+    for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+        fprintf(stderr, "%s%s", i ? "|" : "", commands[i].name);
+    }
+    fprintf(stderr, " ...]\n");
+    *status = 2;
+    return true;
+}
+
+/**
+ * @brief Keyboard handling for the portfolio panel.
+ * @return true when the user asked to quit.
+ */
+static bool handle_portfolio_input(int ch, int *selected, int lot_count,
+                                   bool *show_portfolio) {
+    switch (ch) {
+        case KEY_UP:
+            (*selected)--;
+            break;
+        case KEY_DOWN:
+            (*selected)++;
+            break;
+        case KEY_PPAGE:
+            *selected -= 10;
+            break;
+        case KEY_NPAGE:
+            *selected += 10;
+            break;
+        case 'p':
+        case 'P':
+        case 27:
+            *show_portfolio = false;
+            break;
+        case 'q':
+        case 'Q':
+            return true;
+        default:
+            break;
+    }
+    if (*selected >= lot_count) {
+        *selected = lot_count - 1;
+    }
+    if (*selected < 0) {
+        *selected = 0;
+    }
+    return false;
+}
+
+/**
+ * @brief Keyboard handling for the correlation grid; TAB restarts the feed
+ *        on the next interval.
+ * @return true when the user asked to quit.
+ */
+static bool handle_correlation_input(int ch, RuntimeContext *runtime, int *row, int *col,
+                                     bool *show_correlation) {
+    CorrelationView *view = &runtime->correlation;
+    int n = runtime->correlation_snapshot.symbol_count;
+    switch (ch) {
+        case KEY_UP:
+            (*row)--;
+            break;
+        case KEY_DOWN:
+            (*row)++;
+            break;
+        case KEY_LEFT:
+            (*col)--;
+            break;
+        case KEY_RIGHT:
+            (*col)++;
+            break;
+        case '\t': {
+            // Sub-minute periods follow PERIOD_1MONTH and are chart-only.
+            Period next = (view->period + 1 < PERIOD_1SEC) ? (Period)(view->period + 1)
+                                                           : PERIOD_1MIN;
+            correlation_view_stop(view);
+            correlation_view_start(view, &runtime->config, next);
+            break;
+        }
+        case 'c':
+        case 'C':
+        case 27:
+            correlation_view_stop(view);
+            *show_correlation = false;
+            break;
+        case 'q':
+        case 'Q':
+            return true;
+        default:
+            break;
+    }
+    *row = *row >= n ? n - 1 : *row;
+    *col = *col >= n ? n - 1 : *col;
+    *row = *row < 0 ? 0 : *row;
+    *col = *col < 0 ? 0 : *col;
+    return false;
+}
 
 /**
- * @brief Main UI loop dispatching draw/input for board vs chart.
+ * @brief Keyboard handling for the arbitrage list.
+ * @return true when the user asked to quit.
+ */
+static bool handle_arbitrage_input(int ch, RuntimeContext *runtime, int *selected,
+                                   bool *show_arbitrage) {
+    int count = runtime->arbitrage_snapshot.shown_count;
+    switch (ch) {
+        case KEY_UP:
+            (*selected)--;
+            break;
+        case KEY_DOWN:
+            (*selected)++;
+            break;
+        case 'a':
+        case 'A':
+        case 27:
+            arbitrage_stop(&runtime->arbitrage);
+            *show_arbitrage = false;
+            break;
+        case 'q':
+        case 'Q':
+            return true;
+        default:
+            break;
+    }
+    *selected = *selected >= count ? count - 1 : *selected;
+    *selected = *selected < 0 ? 0 : *selected;
+    return false;
+}
+
+// Monotonic clock in seconds, for pacing redraws.
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Main UI loop dispatching draw/input for board, portfolio, correlation,
+ *        arbitrage and chart.
+ *
+ * Pointer motion is coalesced to the newest position per wake-up; a wake-up
+ * caused only by motion updates the chart crosshair instead of redrawing
+ * the screen, unless a full redraw is overdue.
  */
 static void run_event_loop(RuntimeContext *runtime) {
     /* UI loop for main board and chart mode. */
     PricePoint *chart_points = NULL;
+    ChartComparison chart_compare = {0};
     Period current_period = PERIOD_1MIN;
     bool show_chart = false;
+    bool show_portfolio = false;
+    bool show_correlation = false;
+    bool show_arbitrage = false;
     int selected = 0;
+    int portfolio_selected = 0;
+    int correlation_row = 0;
+    int correlation_col = 0;
+    int arbitrage_selected = 0;
     char chart_symbol[MAX_SYMBOL_LEN] = {0};
     int chart_count = 0;
     int chart_cursor_idx = -1;
     bool chart_follow_latest = true;
     int chart_symbol_index = -1;
     bool exit_requested = false;
+    bool pointer_moved = false;
+    int pointer_x = 0;
+    int pointer_y = 0;
+    double drawn_at = 0.0;
 
     PriceboardContext priceboard_ctx = {
         .data_mutex = &runtime->data_mutex,
@@ -81,17 +273,34 @@ static void run_event_loop(RuntimeContext *runtime) {
         .ticker_snapshot = runtime->ticker_snapshot,
         .ticker_snapshot_order = runtime->ticker_snapshot_order,
         .ticker_count = &runtime->ticker_count,
+        .patterns = &runtime->patterns,
     };
 
     ChartContext chart_ctx = {
         .data_mutex = &runtime->data_mutex,
         .global_tickers = runtime->global_tickers,
         .ticker_count = &runtime->ticker_count,
+        .synthetics = &runtime->synthetics,
+        .compare = &chart_compare,
+        .trade_candles = &runtime->trade_candles,
     };
 
     while (runtime_is_running()) {
         /* Render phase. */
-        if (show_chart) {
+        trace_poll();
+        uint64_t span = trace_begin();
+        CTICKER_PROBE0(frame__start);
+        const char *screen = "board";
+        int cells = 0;
+        double now = monotonic_seconds();
+        bool crosshair_only = pointer_moved && now - drawn_at < POINTER_REDRAW_SECONDS;
+        if (crosshair_only) {
+            screen = "crosshair";
+            if (show_chart) {
+                cells = ui_chart_move_crosshair(pointer_x, pointer_y);
+            }
+        } else if (show_chart) {
+            screen = "chart";
             bool follow_latest = chart_follow_latest ||
                                  (chart_cursor_idx >= 0 && chart_cursor_idx == chart_count - 1);
             chart_refresh_if_expired(&chart_ctx, chart_symbol, current_period,
@@ -101,12 +310,41 @@ static void run_event_loop(RuntimeContext *runtime) {
             if (follow_latest && chart_count > 0) {
                 chart_cursor_idx = chart_count - 1;
             }
+            chart_compare_update(&chart_ctx, chart_symbol, current_period, chart_points,
+                                 chart_count);
             draw_chart(chart_symbol, chart_count, chart_points, current_period,
-                       chart_cursor_idx);
+                       chart_cursor_idx, &chart_compare);
+            if (pointer_moved) {
+                ui_chart_move_crosshair(pointer_x, pointer_y);
+            }
+        } else if (show_portfolio) {
+            screen = "portfolio";
+            pthread_mutex_lock(&runtime->data_mutex);
+            portfolio_snapshot(&runtime->portfolio, &runtime->portfolio_snapshot);
+            pthread_mutex_unlock(&runtime->data_mutex);
+            draw_portfolio_screen(&runtime->portfolio, &runtime->portfolio_snapshot,
+                                  portfolio_selected);
+        } else if (show_correlation) {
+            screen = "correlation";
+            correlation_view_snapshot(&runtime->correlation, &runtime->correlation_snapshot);
+            draw_correlation_screen(&runtime->correlation_snapshot, correlation_row,
+                                    correlation_col);
+        } else if (show_arbitrage) {
+            screen = "arbitrage";
+            arbitrage_snapshot(&runtime->arbitrage, &runtime->arbitrage_snapshot);
+            draw_arbitrage_screen(&runtime->arbitrage_snapshot, arbitrage_selected);
         } else {
             priceboard_clamp_selected(&priceboard_ctx, &selected);
             priceboard_render(&priceboard_ctx, selected);
         }
+        if (!crosshair_only) {
+            /* Full redraws erase and repaint the whole window. */
+            drawn_at = now;
+            cells = LINES * COLS;
+        }
+        pointer_moved = false;
+        CTICKER_PROBE2(frame__end, screen, cells);
+        trace_end("render", span, screen);
 
         /* Input phase. */
         int ch = handle_input();
@@ -117,7 +355,36 @@ static void run_event_loop(RuntimeContext *runtime) {
         if (ch == KEY_MOUSE) {
             MEVENT ev;
             if (getmouse(&ev) == OK) {
-                if (show_chart) {
+                if (ev.bstate == REPORT_MOUSE_POSITION) {
+                    pointer_x = ev.x;
+                    pointer_y = ev.y;
+                    ui_coalesce_pointer_motion(&pointer_x, &pointer_y);
+                    pointer_moved = true;
+                } else if (show_arbitrage) {
+                    if (ev.bstate & BUTTON4_PRESSED) {
+                        handle_arbitrage_input(KEY_UP, runtime, &arbitrage_selected,
+                                               &show_arbitrage);
+                    } else if (ev.bstate & BUTTON5_PRESSED) {
+                        handle_arbitrage_input(KEY_DOWN, runtime, &arbitrage_selected,
+                                               &show_arbitrage);
+                    }
+                } else if (show_correlation) {
+                    if (ev.bstate & BUTTON4_PRESSED) {
+                        handle_correlation_input(KEY_UP, runtime, &correlation_row,
+                                                 &correlation_col, &show_correlation);
+                    } else if (ev.bstate & BUTTON5_PRESSED) {
+                        handle_correlation_input(KEY_DOWN, runtime, &correlation_row,
+                                                 &correlation_col, &show_correlation);
+                    }
+                } else if (show_portfolio) {
+                    if (ev.bstate & BUTTON4_PRESSED) {
+                        handle_portfolio_input(KEY_UP, &portfolio_selected,
+                                               runtime->portfolio.lot_count, &show_portfolio);
+                    } else if (ev.bstate & BUTTON5_PRESSED) {
+                        handle_portfolio_input(KEY_DOWN, &portfolio_selected,
+                                               runtime->portfolio.lot_count, &show_portfolio);
+                    }
+                } else if (show_chart) {
                     chart_handle_mouse(&chart_ctx, ev, chart_symbol, &current_period,
                                        &chart_points, &chart_count, &chart_cursor_idx,
                                        &show_chart, &chart_follow_latest,
@@ -137,6 +404,39 @@ static void run_event_loop(RuntimeContext *runtime) {
                                &chart_points, &chart_count, &chart_cursor_idx,
                                &show_chart, &chart_follow_latest,
                                &chart_symbol_index);
+        } else if (show_portfolio) {
+            if (handle_portfolio_input(ch, &portfolio_selected,
+                                       runtime->portfolio.lot_count, &show_portfolio)) {
+                runtime_request_shutdown();
+            }
+        } else if (show_correlation) {
+            if (handle_correlation_input(ch, runtime, &correlation_row, &correlation_col,
+                                         &show_correlation)) {
+                runtime_request_shutdown();
+            }
+        } else if (show_arbitrage) {
+            if (handle_arbitrage_input(ch, runtime, &arbitrage_selected, &show_arbitrage)) {
+                runtime_request_shutdown();
+            }
+        } else if (ch == 'p' || ch == 'P') {
+            show_portfolio = true;
+        } else if (ch == 'a' || ch == 'A') {
+            if (arbitrage_start(&runtime->arbitrage, &runtime->config) == 0) {
+                arbitrage_selected = 0;
+                show_arbitrage = true;
+            } else {
+                arbitrage_stop(&runtime->arbitrage);
+                beep();
+            }
+        } else if (ch == 'c' || ch == 'C') {
+            // The chart may have left a local sub-minute period behind.
+            Period period = period_is_local(current_period) ? PERIOD_1MIN : current_period;
+            if (correlation_view_start(&runtime->correlation, &runtime->config, period) == 0) {
+                show_correlation = true;
+            } else {
+                correlation_view_stop(&runtime->correlation);
+                beep();
+            }
         } else {
             exit_requested = priceboard_handle_input(&priceboard_ctx, ch, &selected,
                                                      current_period, &show_chart,
@@ -149,19 +449,40 @@ static void run_event_loop(RuntimeContext *runtime) {
         }
     }
 
+    if (show_correlation) {
+        correlation_view_stop(&runtime->correlation);
+    }
+    if (show_arbitrage) {
+        arbitrage_stop(&runtime->arbitrage);
+    }
     if (chart_points) {
         free(chart_points);
     }
+    chart_compare_reset(&chart_compare);
 }
 
 /**
  * @brief Program entry point.
  *
- * Sets up config, starts the worker thread, then runs the UI state machine.
+ * Dispatches offline sub-commands (see commands.h); otherwise sets up
+ * config, starts the worker thread, then runs the UI state machine.
  */
 int main(int argc, char *argv[]) {
-    (void)argc;
-    (void)argv;
+    int status = 0;
+    if (argc >= 2 && strcmp(argv[1], "--trace") == 0) {
+        if (argc < 3 || trace_open(argv[2]) != 0) {
+            fprintf(stderr, "Usage: cticker --trace FILE [command ...]\n");
+            return 2;
+        }
+        trace_set_thread_name("ui");
+        argv[2] = argv[0];
+        argc -= 2;
+        argv += 2;
+    }
+    if (dispatch_command(argc, argv, &status)) {
+        trace_close();
+        return status;
+    }
 
     RuntimeContext runtime = {0};
 
@@ -173,12 +494,16 @@ int main(int argc, char *argv[]) {
 
     /*
      * Main loop.
-     * Two UI modes:
+     * Five UI modes:
      *  - Price board: select symbol and open chart (Enter)
+     *  - Portfolio  : holdings with live P&L (P toggles)
+     *  - Correlation: rolling return correlations (C toggles, TAB interval)
+     *  - Arbitrage  : triangular cycles and their edge (A toggles)
      *  - Chart view : left/right candle cursor, up/down change interval
      */
     run_event_loop(&runtime);
 
     runtime_shutdown(&runtime);
+    trace_close();
     return 0;
 }
@@ -0,0 +1,98 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file movestats.c
+ * @brief Incremental realised volatility, ATR and move z-scores.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "movestats.h"
+
+// Bars in 24 hours, for scaling the per-bar volatility.
+#define MOVESTATS_BARS_PER_DAY (86400.0 / MOVESTATS_BAR_SECONDS)
+
+// Weight of the newest observation: 1/k while warming up (exact running
+// averages), then a fixed 1/window (exponential forgetting).
+static double movestats_alpha(int count) {
+    return 1.0 / (count < MOVESTATS_WINDOW ? count : MOVESTATS_WINDOW);
+}
+
+// Fold the bar that just closed into the estimators.
+static void movestats_close_bar(MoveStats *stats, uint64_t elapsed) {
+    if (stats->prev_close > 0.0 && stats->close > 0.0) {
+        // Bars skipped while nothing was published are folded as one
+        // return, normalised to a single bar.
+        double r = log(stats->close / stats->prev_close) / sqrt((double)elapsed);
+        double high = fmax(stats->high, stats->prev_close);
+        double low = fmin(stats->low, stats->prev_close);
+
+        stats->bars++;
+        double alpha = movestats_alpha(stats->bars);
+        double delta = r - stats->mean;
+        stats->mean += alpha * delta;
+        stats->variance = (1.0 - alpha) * (stats->variance + alpha * delta * delta);
+        stats->atr += alpha * ((high - low) - stats->atr);
+    }
+    stats->prev_close = stats->close;
+}
+
+// Clear every row.
+void movestats_init(MoveStatsSet *set, int row_count) {
+    memset(set, 0, sizeof(*set));
+    set->row_count = row_count < MAX_SYMBOLS ? row_count : MAX_SYMBOLS;
+}
+
+// Update the row's bar and derive the published statistics.
+void movestats_update(MoveStatsSet *set, int row, TickerData *ticker) {
+    if (row < 0 || row >= set->row_count || !(ticker->price > 0.0)) {
+        return;
+    }
+    MoveStats *stats = &set->rows[row];
+    double price = ticker->price;
+    uint64_t bar = ticker->timestamp / MOVESTATS_BAR_SECONDS;
+
+    if (stats->bar == 0) {
+        stats->bar = bar;
+        stats->high = stats->low = stats->close = price;
+    } else if (bar > stats->bar) {
+        movestats_close_bar(stats, bar - stats->bar);
+        stats->bar = bar;
+        stats->high = stats->low = stats->close = price;
+    } else {
+        stats->high = fmax(stats->high, price);
+        stats->low = fmin(stats->low, price);
+        stats->close = price;
+    }
+
+    ticker->stats_ready = stats->bars >= MOVESTATS_MIN_BARS;
+    if (!ticker->stats_ready) {
+        return;
+    }
+    double sd = sqrt(stats->variance);
+    ticker->volatility = sd * sqrt(MOVESTATS_BARS_PER_DAY) * 100.0;
+    ticker->atr_pct = stats->atr / price * 100.0;
+    ticker->move_z = sd > 0.0 ? (log(price / stats->prev_close) - stats->mean) / sd : 0.0;
+}
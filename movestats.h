@@ -0,0 +1,63 @@
+#ifndef CTICKER_MOVESTATS_H
+#define CTICKER_MOVESTATS_H
+
+#include <stdint.h>
+#include "cticker.h"
+
+/** Length of the bars sampled from published prices, in seconds. */
+#define MOVESTATS_BAR_SECONDS 60
+
+/** Horizon of the exponentially weighted estimators, in bars. */
+#define MOVESTATS_WINDOW 30
+
+/** Closed bars required before the statistics are shown. */
+#define MOVESTATS_MIN_BARS 5
+
+/**
+ * @brief Running move statistics of one board row.
+ *
+ * Published prices are folded into ::MOVESTATS_BAR_SECONDS bars. Each
+ * closed bar updates an exponentially weighted Welford mean/variance of
+ * log returns and a Wilder ATR in O(1); both use plain running averages
+ * until ::MOVESTATS_WINDOW bars have been seen.
+ */
+typedef struct {
+    /** Bar index (timestamp / bar length) being built, 0 before the first price. */
+    uint64_t bar;
+    double high;
+    double low;
+    double close;
+    /** Close of the last completed bar (0 until one completes). */
+    double prev_close;
+    /** Completed bars folded into the estimators. */
+    int bars;
+    /** Mean and variance of per-bar log returns. */
+    double mean;
+    double variance;
+    /** Average true range of completed bars. */
+    double atr;
+} MoveStats;
+
+/**
+ * @brief Move statistics for every board row, updated on publish.
+ *
+ * Callers serialize access with the runtime data mutex.
+ */
+typedef struct {
+    MoveStats rows[MAX_SYMBOLS];
+    int row_count;
+} MoveStatsSet;
+
+/**
+ * @brief Reset the estimators for @p row_count rows.
+ */
+void movestats_init(MoveStatsSet *set, int row_count);
+
+/**
+ * @brief Fold a published row into its bar and refresh the row's
+ *        ::TickerData::volatility, ::TickerData::atr_pct and
+ *        ::TickerData::move_z (call with the data mutex held).
+ */
+void movestats_update(MoveStatsSet *set, int row, TickerData *ticker);
+
+#endif
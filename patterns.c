@@ -0,0 +1,234 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file patterns.c
+ * @brief Candlestick pattern detection and the background scanner.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "candle_cache.h"
+#include "patterns.h"
+
+// Seconds after a candle close before the scanner asks for it.
+#define PATTERN_CLOSE_GRACE 2
+// Seconds between attempts after a failed fetch.
+#define PATTERN_RETRY_SECONDS 30
+
+// Body-engulfing reversal of the previous candle in direction @p bull.
+static bool is_engulfing(const PricePoint *prev, const PricePoint *bar, bool bull) {
+    if (bull) {
+        return prev->close < prev->open && bar->close > bar->open &&
+               bar->open <= prev->close && bar->close >= prev->open &&
+               bar->close - bar->open > prev->open - prev->close;
+    }
+    return prev->close > prev->open && bar->close < bar->open &&
+           bar->open >= prev->close && bar->close <= prev->open &&
+           bar->open - bar->close > prev->close - prev->open;
+}
+
+// Small body near the top of the range with a lower shadow twice its size.
+static bool is_hammer(const PricePoint *bar) {
+    double range = bar->high - bar->low;
+    if (!(range > 0.0)) {
+        return false;
+    }
+    double body = fabs(bar->close - bar->open);
+    double lower = fmin(bar->open, bar->close) - bar->low;
+    double upper = bar->high - fmax(bar->open, bar->close);
+    return body <= range / 3.0 && lower >= 2.0 * body && upper <= range * 0.1;
+}
+
+// Evaluate the patterns the last candle completes.
+unsigned pattern_detect(const PricePoint *bars, int count) {
+    if (count < 2) {
+        return 0;
+    }
+    const PricePoint *bar = &bars[count - 1];
+    const PricePoint *prev = &bars[count - 2];
+    unsigned flags = 0;
+
+    if (is_engulfing(prev, bar, true)) {
+        flags |= PATTERN_BULL_ENGULFING;
+    }
+    if (is_engulfing(prev, bar, false)) {
+        flags |= PATTERN_BEAR_ENGULFING;
+    }
+    if (count > PATTERN_TREND_BARS && is_hammer(bar) &&
+        prev->close < bars[count - 1 - PATTERN_TREND_BARS].close) {
+        flags |= PATTERN_HAMMER;
+    }
+    if (bar->high < prev->high && bar->low > prev->low) {
+        flags |= PATTERN_INSIDE_BAR;
+    }
+    if (count > PATTERN_BREAKOUT_BARS) {
+        double high = -INFINITY;
+        double low = INFINITY;
+        for (int i = count - 1 - PATTERN_BREAKOUT_BARS; i < count - 1; i++) {
+            high = fmax(high, bars[i].high);
+            low = fmin(low, bars[i].low);
+        }
+        if (bar->close > high) {
+            flags |= PATTERN_BREAKOUT_HIGH;
+        } else if (bar->close < low) {
+            flags |= PATTERN_BREAKOUT_LOW;
+        }
+    }
+    return flags;
+}
+
+/*
+ * Scan one symbol if its open candle has closed. Returns when the symbol
+ * is next due.
+ */
+static uint64_t pattern_scan_symbol(PatternScanner *scanner, int s, uint64_t now) {
+    PatternRow *row = &scanner->rows[s];
+    if (now < row->next_due) {
+        return row->next_due;
+    }
+
+    PricePoint *points = NULL;
+    int count = 0;
+    if (candle_cache_get(scanner->symbols[s], scanner->period, false, &points, &count) != 0 ||
+        count == 0) {
+        free(points);
+        row->next_due = now + PATTERN_RETRY_SECONDS;
+        return row->next_due;
+    }
+    int closed = count;
+    while (closed > 0 && points[closed - 1].close_time >= now) {
+        closed--;
+    }
+
+    // Only a candle that closed since the last pass is evaluated.
+    if (closed > 0 && points[closed - 1].close_time > row->last_close) {
+        unsigned flags = pattern_detect(points, closed);
+        atomic_fetch_add(&scanner->evaluated, 1);
+        pthread_mutex_lock(&scanner->mutex);
+        row->flags = flags;
+        row->last_close = points[closed - 1].close_time;
+        pthread_mutex_unlock(&scanner->mutex);
+    }
+
+    // A stale window (exchange delay) is retried rather than spun on.
+    uint64_t open_close = points[count - 1].close_time;
+    row->next_due = open_close >= now ? open_close + PATTERN_CLOSE_GRACE
+                                      : now + PATTERN_RETRY_SECONDS;
+    free(points);
+    return row->next_due;
+}
+
+// Worker: scan its share of the symbols, then sleep until the next close.
+static void *pattern_worker_main(void *arg) {
+    PatternWorker *worker = arg;
+    PatternScanner *scanner = worker->scanner;
+
+    while (!atomic_load(&scanner->stop)) {
+        uint64_t now = (uint64_t)time(NULL);
+        uint64_t wake = now + PATTERN_RETRY_SECONDS;
+        for (int s = worker->index; s < scanner->symbol_count; s += scanner->thread_count) {
+            if (atomic_load(&scanner->stop)) {
+                break;
+            }
+            uint64_t due = pattern_scan_symbol(scanner, s, now);
+            if (due < wake) {
+                wake = due;
+            }
+        }
+        while (!atomic_load(&scanner->stop) && (uint64_t)time(NULL) < wake) {
+            sleep(1);
+        }
+    }
+    return NULL;
+}
+
+// Copy the watchlist and start the workers.
+int pattern_scanner_start(PatternScanner *scanner, const Config *config, Period period) {
+    memset(scanner, 0, sizeof(*scanner));
+    pthread_mutex_init(&scanner->mutex, NULL);
+    atomic_init(&scanner->stop, false);
+    atomic_init(&scanner->evaluated, 0);
+    scanner->period = period;
+    for (int i = 0; i < config->symbol_count && i < MAX_SYMBOLS; i++) {
+        snprintf(scanner->symbols[i], MAX_SYMBOL_LEN, "%s", config->symbols[i]);
+        scanner->symbol_count++;
+    }
+
+    int wanted = scanner->symbol_count < PATTERN_SCAN_THREADS ? scanner->symbol_count
+                                                               : PATTERN_SCAN_THREADS;
+    // Workers stride by thread_count, so fix it before any of them runs.
+    scanner->thread_count = wanted;
+    int started = 0;
+    for (int i = 0; i < wanted; i++) {
+        scanner->workers[i].scanner = scanner;
+        scanner->workers[i].index = i;
+        if (pthread_create(&scanner->threads[i], NULL, pattern_worker_main,
+                           &scanner->workers[i]) != 0) {
+            break;
+        }
+        started++;
+    }
+    if (started < wanted) {
+        // The symbols of a missing worker would never be scanned.
+        atomic_store(&scanner->stop, true);
+        for (int i = 0; i < started; i++) {
+            pthread_join(scanner->threads[i], NULL);
+        }
+        scanner->thread_count = 0;
+        pthread_mutex_destroy(&scanner->mutex);
+        return -1;
+    }
+    return started > 0 ? 0 : -1;
+}
+
+// Stop and join the workers.
+void pattern_scanner_stop(PatternScanner *scanner) {
+    if (scanner->thread_count == 0) {
+        return;
+    }
+    atomic_store(&scanner->stop, true);
+    for (int i = 0; i < scanner->thread_count; i++) {
+        pthread_join(scanner->threads[i], NULL);
+    }
+    scanner->thread_count = 0;
+    pthread_mutex_destroy(&scanner->mutex);
+}
+
+// Copy the published flags for the board.
+void pattern_scanner_flags(PatternScanner *scanner, unsigned *flags, int count) {
+    if (scanner->thread_count == 0) {
+        memset(flags, 0, (size_t)count * sizeof(unsigned));
+        return;
+    }
+    pthread_mutex_lock(&scanner->mutex);
+    for (int i = 0; i < count; i++) {
+        flags[i] = i < scanner->symbol_count ? scanner->rows[i].flags : 0;
+    }
+    pthread_mutex_unlock(&scanner->mutex);
+}
@@ -0,0 +1,102 @@
+#ifndef CTICKER_PATTERNS_H
+#define CTICKER_PATTERNS_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/** Bars whose high/low a close must clear to count as a breakout. */
+#define PATTERN_BREAKOUT_BARS 20
+
+/** Bars a hammer's preceding decline is measured over. */
+#define PATTERN_TREND_BARS 5
+
+/** Scanner worker threads; symbols are split across them round-robin. */
+#define PATTERN_SCAN_THREADS 4
+
+/** Pattern flags of one closed candle. */
+typedef enum {
+    /** Bullish body engulfing the previous bearish body. */
+    PATTERN_BULL_ENGULFING = 1u << 0,
+    /** Bearish body engulfing the previous bullish body. */
+    PATTERN_BEAR_ENGULFING = 1u << 1,
+    /** Long lower shadow and small upper body after a decline. */
+    PATTERN_HAMMER = 1u << 2,
+    /** Range inside the previous candle's range. */
+    PATTERN_INSIDE_BAR = 1u << 3,
+    /** Close above the highest high of the previous ::PATTERN_BREAKOUT_BARS. */
+    PATTERN_BREAKOUT_HIGH = 1u << 4,
+    /** Close below the lowest low of the previous ::PATTERN_BREAKOUT_BARS. */
+    PATTERN_BREAKOUT_LOW = 1u << 5
+} PatternFlag;
+
+/**
+ * @brief Patterns completed by the last of @p count closed candles.
+ * @return Bitwise OR of ::PatternFlag values.
+ */
+unsigned pattern_detect(const PricePoint *bars, int count);
+
+/**
+ * @brief Scan state of one watchlist symbol.
+ */
+typedef struct {
+    /** Close time of the newest evaluated candle (0 before the first scan). */
+    uint64_t last_close;
+    /** Patterns of that candle. */
+    unsigned flags;
+    /** When the symbol's open candle closes (worker-private). */
+    uint64_t next_due;
+} PatternRow;
+
+struct PatternScanner;
+
+/**
+ * @brief Worker thread argument.
+ */
+typedef struct {
+    struct PatternScanner *scanner;
+    int index;
+} PatternWorker;
+
+/**
+ * @brief Background candlestick pattern scanner for the watchlist.
+ *
+ * Each worker owns every ::PATTERN_SCAN_THREADS-th symbol, sleeps until
+ * the earliest of their open candles closes, then reads the window from
+ * the shared candle cache and evaluates only the candle that just closed.
+ * Results are published under ::PatternScanner::mutex; the UI only copies
+ * the flags.
+ */
+typedef struct PatternScanner {
+    pthread_mutex_t mutex;
+    Period period;
+    char symbols[MAX_SYMBOLS][MAX_SYMBOL_LEN];
+    int symbol_count;
+    PatternRow rows[MAX_SYMBOLS];
+    PatternWorker workers[PATTERN_SCAN_THREADS];
+    pthread_t threads[PATTERN_SCAN_THREADS];
+    int thread_count;
+    atomic_bool stop;
+    /** Candles evaluated so far (statistics). */
+    atomic_uint evaluated;
+} PatternScanner;
+
+/**
+ * @brief Start scanning @p config's symbols on @p period.
+ * @return 0 on success, -1 if no worker could be started.
+ */
+int pattern_scanner_start(PatternScanner *scanner, const Config *config, Period period);
+
+/**
+ * @brief Stop and join the workers.
+ */
+void pattern_scanner_stop(PatternScanner *scanner);
+
+/**
+ * @brief Copy the current flags of the first @p count symbols.
+ */
+void pattern_scanner_flags(PatternScanner *scanner, unsigned *flags, int count);
+
+#endif
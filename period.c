@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file period.c
+ * @brief ::Period helpers shared by the API layer and offline commands.
+ *
+ * Kept free of network/UI dependencies so the candle store and CLI
+ * commands can use them without pulling in libcurl or ncurses.
+ */
+
+#include <string.h>
+#include "cticker.h"
+
+// Binance kline interval codes, indexed by ::Period.
+static const char *const interval_codes[PERIOD_COUNT] = {
+    [PERIOD_1SEC] = "1s",
+    [PERIOD_5SEC] = "5s",
+    [PERIOD_15SEC] = "15s",
+    [PERIOD_30SEC] = "30s",
+    [PERIOD_1MIN] = "1m",
+    [PERIOD_15MIN] = "15m",
+    [PERIOD_1HOUR] = "1h",
+    [PERIOD_4HOUR] = "4h",
+    [PERIOD_1DAY] = "1d",
+    [PERIOD_1WEEK] = "1w",
+    [PERIOD_1MONTH] = "1M",
+};
+
+// Fixed candle spacing in seconds, indexed by ::Period (0 = calendar based).
+static const uint64_t period_spacing[PERIOD_COUNT] = {
+    [PERIOD_1SEC] = 1,
+    [PERIOD_5SEC] = 5,
+    [PERIOD_15SEC] = 15,
+    [PERIOD_30SEC] = 30,
+    [PERIOD_1MIN] = 60,
+    [PERIOD_15MIN] = 15 * 60,
+    [PERIOD_1HOUR] = 60 * 60,
+    [PERIOD_4HOUR] = 4 * 60 * 60,
+    [PERIOD_1DAY] = 24 * 60 * 60,
+    [PERIOD_1WEEK] = 7 * 24 * 60 * 60,
+    [PERIOD_1MONTH] = 0,
+};
+
+const char *period_interval_code(Period period) {
+    if ((int)period < 0 || period >= PERIOD_COUNT) {
+        return "1M";
+    }
+    return interval_codes[period];
+}
+
+int period_from_interval_code(const char *code, Period *period) {
+    if (!code || !period) {
+        return -1;
+    }
+    for (int i = PERIOD_1MIN; i < PERIOD_1SEC; i++) {
+        if (strcmp(code, interval_codes[i]) == 0) {
+            *period = (Period)i;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+uint64_t period_seconds(Period period) {
+    if ((int)period < 0 || period >= PERIOD_COUNT) {
+        return 0;
+    }
+    return period_spacing[period];
+}
+
+bool period_is_local(Period period) {
+    return period >= PERIOD_1SEC && period < PERIOD_COUNT;
+}
+
+// Chart order: the local periods lead into the exchange intervals.
+static const Period chart_order[PERIOD_COUNT] = {
+    PERIOD_1SEC, PERIOD_5SEC, PERIOD_15SEC, PERIOD_30SEC,
+    PERIOD_1MIN, PERIOD_15MIN, PERIOD_1HOUR, PERIOD_4HOUR,
+    PERIOD_1DAY, PERIOD_1WEEK, PERIOD_1MONTH,
+};
+
+Period period_step(Period period, int step) {
+    int pos = 0;
+    for (int i = 0; i < PERIOD_COUNT; i++) {
+        if (chart_order[i] == period) {
+            pos = i;
+            break;
+        }
+    }
+    pos = ((pos + step) % PERIOD_COUNT + PERIOD_COUNT) % PERIOD_COUNT;
+    return chart_order[pos];
+}
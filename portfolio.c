@@ -0,0 +1,260 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file portfolio.c
+ * @brief Portfolio lots, quote conversion and incremental P&L totals.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "portfolio.h"
+
+// Quote assets recognised as pair suffixes; the longest match wins.
+static const char *const known_quotes[] = {
+    "FDUSD", "USDT", "USDC", "TUSD", "BUSD", "USDP",
+    "BTC", "ETH", "BNB", "DAI", "EUR", "GBP", "TRY", "BRL", "JPY", "AUD",
+    "XRP", "TRX", "DOGE", "SOL",
+};
+
+int portfolio_split_symbol(const char *symbol, char *base, size_t base_size,
+                           char *quote, size_t quote_size) {
+    size_t len = strlen(symbol);
+    size_t best = 0;
+    for (size_t i = 0; i < sizeof(known_quotes) / sizeof(known_quotes[0]); i++) {
+        size_t qlen = strlen(known_quotes[i]);
+        if (qlen < len && qlen > best &&
+            strcmp(symbol + len - qlen, known_quotes[i]) == 0) {
+            best = qlen;
+        }
+    }
+    if (best == 0 || len - best >= base_size || best >= quote_size) {
+        return -1;
+    }
+    memcpy(base, symbol, len - best);
+    base[len - best] = '\0';
+    memcpy(quote, symbol + len - best, best + 1);
+    return 0;
+}
+
+// Find the watchlist row of @p symbol, or -1.
+static int find_row(const Config *config, const char *symbol) {
+    for (int i = 0; i < config->symbol_count; i++) {
+        if (strcmp(config->symbols[i], symbol) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Find a watched pair between two assets; sets @p inverse when it is quoted
+// as to/from rather than from/to.
+static int find_pair_row(const Config *config, const char *from, const char *to,
+                         bool *inverse) {
+    char pair[2 * MAX_SYMBOL_LEN];
+    snprintf(pair, sizeof(pair), "%s%s", from, to);
+    int row = find_row(config, pair);
+    *inverse = false;
+    if (row < 0) {
+        snprintf(pair, sizeof(pair), "%s%s", to, from);
+        row = find_row(config, pair);
+        *inverse = true;
+    }
+    return row;
+}
+
+// Resolve the conversion path of @p quote into the portfolio currency: a
+// direct pair, else two pairs through one of the known quote assets.
+static void find_rate_path(Portfolio *portfolio, int row, const Config *config,
+                           const char *quote) {
+    const char *currency = portfolio->currency;
+    portfolio->rate_hops[row] = 0;
+    if (strcmp(quote, currency) == 0) {
+        return;
+    }
+    int direct = find_pair_row(config, quote, currency, &portfolio->rate_inverse[row][0]);
+    if (direct >= 0) {
+        portfolio->rate_path[row][0] = direct;
+        portfolio->rate_hops[row] = 1;
+        return;
+    }
+    for (size_t i = 0; i < sizeof(known_quotes) / sizeof(known_quotes[0]); i++) {
+        const char *bridge = known_quotes[i];
+        if (strcmp(bridge, quote) == 0 || strcmp(bridge, currency) == 0) {
+            continue;
+        }
+        bool first_inverse = false;
+        bool second_inverse = false;
+        int first = find_pair_row(config, quote, bridge, &first_inverse);
+        int second = first >= 0 ? find_pair_row(config, bridge, currency, &second_inverse) : -1;
+        if (second >= 0) {
+            portfolio->rate_path[row][0] = first;
+            portfolio->rate_inverse[row][0] = first_inverse;
+            portfolio->rate_path[row][1] = second;
+            portfolio->rate_inverse[row][1] = second_inverse;
+            portfolio->rate_hops[row] = 2;
+            return;
+        }
+    }
+    portfolio->rate_hops[row] = -1;
+}
+
+void portfolio_init(Portfolio *portfolio, const Config *config) {
+    memset(portfolio, 0, sizeof(*portfolio));
+    snprintf(portfolio->currency, sizeof(portfolio->currency), "%s",
+             config->portfolio_currency[0] ? config->portfolio_currency
+                                           : PORTFOLIO_DEFAULT_CURRENCY);
+    portfolio->row_count = config->symbol_count;
+
+    for (int i = 0; i < portfolio->row_count; i++) {
+        char base[MAX_SYMBOL_LEN];
+        char quote[MAX_SYMBOL_LEN];
+        portfolio->rate_hops[i] = -1;
+        if (portfolio_split_symbol(config->symbols[i], base, sizeof(base),
+                                   quote, sizeof(quote)) == 0) {
+            find_rate_path(portfolio, i, config, quote);
+        }
+    }
+
+    // Build the reverse index (counting sort into CSR form). A pair that
+    // converts its own quote (EURUSDT valued in EUR) is repriced anyway.
+    for (int i = 0; i < portfolio->row_count; i++) {
+        for (int h = 0; h < portfolio->rate_hops[i]; h++) {
+            if (portfolio->rate_path[i][h] != i) {
+                portfolio->rate_dep_start[portfolio->rate_path[i][h] + 1]++;
+            }
+        }
+    }
+    for (int i = 0; i < portfolio->row_count; i++) {
+        portfolio->rate_dep_start[i + 1] += portfolio->rate_dep_start[i];
+    }
+    int fill[MAX_SYMBOLS];
+    memcpy(fill, portfolio->rate_dep_start, sizeof(fill));
+    for (int i = 0; i < portfolio->row_count; i++) {
+        for (int h = 0; h < portfolio->rate_hops[i]; h++) {
+            int source = portfolio->rate_path[i][h];
+            if (source != i) {
+                portfolio->rate_dependents[fill[source]++] = i;
+            }
+        }
+    }
+
+    portfolio->lot_count = config->holding_count;
+    for (int i = 0; i < config->holding_count; i++) {
+        const Holding *lot = &config->holdings[i];
+        portfolio->lots[i] = *lot;
+        int row = find_row(config, lot->symbol);
+        portfolio->lot_rows[i] = row;
+        if (row < 0) {
+            continue;
+        }
+        PortfolioRow *state = &portfolio->rows[row];
+        if (state->lots++ == 0) {
+            portfolio->totals.held_rows++;
+        }
+        state->quantity += lot->quantity;
+        state->cost += lot->quantity * lot->entry_price;
+    }
+}
+
+// Replace one row's contribution to the totals with its current valuation.
+static void portfolio_reprice(Portfolio *portfolio, int row) {
+    PortfolioRow *state = &portfolio->rows[row];
+    if (state->lots == 0) {
+        return;
+    }
+
+    double rate = portfolio->rate_hops[row] >= 0 ? 1.0 : 0.0;
+    for (int h = 0; h < portfolio->rate_hops[row]; h++) {
+        double hop_price = portfolio->rows[portfolio->rate_path[row][h]].price;
+        if (hop_price <= 0.0) {
+            rate = 0.0;
+            break;
+        }
+        rate *= portfolio->rate_inverse[row][h] ? 1.0 / hop_price : hop_price;
+    }
+
+    PortfolioTotals *totals = &portfolio->totals;
+    if (state->priced) {
+        totals->value -= state->value;
+        totals->cost -= state->cost_value;
+        totals->pnl -= state->pnl;
+        totals->priced_rows--;
+    }
+
+    state->rate = rate;
+    state->priced = rate > 0.0 && state->price > 0.0;
+    if (!state->priced) {
+        state->value = 0.0;
+        state->cost_value = 0.0;
+        state->pnl = 0.0;
+        return;
+    }
+    state->value = state->quantity * state->price * rate;
+    state->cost_value = state->cost * rate;
+    state->pnl = state->value - state->cost_value;
+    totals->value += state->value;
+    totals->cost += state->cost_value;
+    totals->pnl += state->pnl;
+    totals->priced_rows++;
+}
+
+// Recompute the totals from the row contributions to shed rounding drift.
+static void portfolio_resync(Portfolio *portfolio) {
+    PortfolioTotals *totals = &portfolio->totals;
+    totals->value = 0.0;
+    totals->cost = 0.0;
+    totals->pnl = 0.0;
+    for (int i = 0; i < portfolio->row_count; i++) {
+        const PortfolioRow *state = &portfolio->rows[i];
+        if (state->priced) {
+            totals->value += state->value;
+            totals->cost += state->cost_value;
+            totals->pnl += state->pnl;
+        }
+    }
+    portfolio->updates_since_resync = 0;
+}
+
+void portfolio_update(Portfolio *portfolio, int row, double price) {
+    if (!portfolio || row < 0 || row >= portfolio->row_count || !isfinite(price)) {
+        return;
+    }
+    portfolio->rows[row].price = price;
+    portfolio_reprice(portfolio, row);
+    for (int i = portfolio->rate_dep_start[row]; i < portfolio->rate_dep_start[row + 1]; i++) {
+        portfolio_reprice(portfolio, portfolio->rate_dependents[i]);
+    }
+    if (++portfolio->updates_since_resync >= PORTFOLIO_RESYNC_UPDATES) {
+        portfolio_resync(portfolio);
+    }
+}
+
+void portfolio_snapshot(const Portfolio *portfolio, PortfolioView *view) {
+    view->row_count = portfolio->row_count;
+    memcpy(view->rows, portfolio->rows,
+           (size_t)portfolio->row_count * sizeof(PortfolioRow));
+    view->totals = portfolio->totals;
+}
@@ -0,0 +1,125 @@
+#ifndef CTICKER_PORTFOLIO_H
+#define CTICKER_PORTFOLIO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "cticker.h"
+
+/** Row updates between exact recomputations of the running totals. */
+#define PORTFOLIO_RESYNC_UPDATES 4096
+
+/** Conversion pairs chained to reach the portfolio currency (e.g. BTC -> USDT -> EUR). */
+#define PORTFOLIO_MAX_HOPS 2
+
+/**
+ * @brief Aggregated holdings and current valuation of one watchlist row.
+ */
+typedef struct {
+    /** Lots priced off this row. */
+    int lots;
+    /** Sum of the lot quantities priced off this row. */
+    double quantity;
+    /** Sum of quantity * entry price, in the pair's quote currency. */
+    double cost;
+    /** Last published price (0 until the first publish). */
+    double price;
+    /** Quote -> portfolio currency rate behind the current contribution. */
+    double rate;
+    /** Contribution to ::PortfolioTotals, in the portfolio currency. */
+    double value;
+    double cost_value;
+    double pnl;
+    /** The contribution is currently counted in the totals. */
+    bool priced;
+} PortfolioRow;
+
+/**
+ * @brief Running portfolio totals in the portfolio currency.
+ */
+typedef struct {
+    double value;
+    double cost;
+    double pnl;
+    /** Rows holding at least one lot. */
+    int held_rows;
+    /** Held rows with a price and conversion rate. */
+    int priced_rows;
+} PortfolioTotals;
+
+/**
+ * @brief Incremental portfolio valuation keyed by watchlist row.
+ *
+ * Lots are aggregated per row at load, so a published price touches only
+ * that row's contribution plus the rows whose quote it converts (e.g. a
+ * BTCUSDT update re-values ETHBTC holdings): the totals are adjusted by the
+ * difference instead of being recomputed. Callers serialize access with the
+ * runtime data mutex, the same lock that guards `global_tickers`.
+ */
+typedef struct {
+    /** Valuation currency (e.g. "USDT"). */
+    char currency[MAX_SYMBOL_LEN];
+    /** Number of watchlist rows. */
+    int row_count;
+    PortfolioRow rows[MAX_SYMBOLS];
+    /** Conversion pairs per row: 0 when quoted in the portfolio currency, -1 when unconvertible. */
+    int rate_hops[MAX_SYMBOLS];
+    int rate_path[MAX_SYMBOLS][PORTFOLIO_MAX_HOPS];
+    /** The hop pair is quoted the other way round (rate = 1 / price). */
+    bool rate_inverse[MAX_SYMBOLS][PORTFOLIO_MAX_HOPS];
+    /** Rows converted through row r: rate_dependents[rate_dep_start[r] .. rate_dep_start[r + 1]). */
+    int rate_dep_start[MAX_SYMBOLS + 1];
+    int rate_dependents[MAX_SYMBOLS * PORTFOLIO_MAX_HOPS];
+    /** Lots in config order and the row each one prices off (-1 when not watched). */
+    Holding lots[MAX_HOLDINGS];
+    int lot_rows[MAX_HOLDINGS];
+    int lot_count;
+    PortfolioTotals totals;
+    /** Updates since the totals were last recomputed exactly. */
+    int updates_since_resync;
+} Portfolio;
+
+/**
+ * @brief UI copy of the mutable portfolio state.
+ */
+typedef struct {
+    PortfolioRow rows[MAX_SYMBOLS];
+    int row_count;
+    PortfolioTotals totals;
+} PortfolioView;
+
+/**
+ * @brief Split a pair such as "ETHBTC" into base and quote assets using the
+ *        known quote currencies (longest suffix wins).
+ * @return 0 on success, -1 if no known quote matches.
+ */
+int portfolio_split_symbol(const char *symbol, char *base, size_t base_size,
+                           char *quote, size_t quote_size);
+
+/**
+ * @brief Index the configured lots against the watchlist rows.
+ *
+ * Quotes are converted through at most one intermediate currency. Lots on
+ * unwatched symbols, or quoted in a currency no watched pairs convert, are
+ * kept but stay unpriced.
+ */
+void portfolio_init(Portfolio *portfolio, const Config *config);
+
+/**
+ * @brief Apply a published price for @p row (call with the data mutex held).
+ */
+void portfolio_update(Portfolio *portfolio, int row, double price);
+
+/**
+ * @brief Copy the mutable state for rendering (call with the data mutex held).
+ */
+void portfolio_snapshot(const Portfolio *portfolio, PortfolioView *view);
+
+/**
+ * @brief Render the portfolio panel (lots with P&L plus totals).
+ *
+ * @param[in] selected Selected lot index.
+ */
+void draw_portfolio_screen(const Portfolio *portfolio, const PortfolioView *view,
+                           int selected);
+
+#endif
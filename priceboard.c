@@ -41,6 +41,7 @@ SOFTWARE.
 #  include <ncurses.h>
 #endif
 #include "priceboard.h"
+#include "trace.h"
 
 /*
  * Priceboard module notes:
@@ -56,6 +57,8 @@ typedef enum {
 
 static PriceboardSortField current_sort_field = SORT_FIELD_DEFAULT;
 static PriceboardSortDirection current_sort_direction = SORT_DIR_DESC;
+// Volatility/ATR/z-score columns replace the 24h activity columns ('v').
+static bool show_move_stats = false;
 
 // Clamp an integer into the inclusive range [low, high].
 static inline int clamp_int(int value, int low, int high) {
@@ -160,6 +163,7 @@ static void priceboard_apply_sort(const PriceboardContext *ctx) {
     if (current_sort_field == SORT_FIELD_DEFAULT) {
         return;
     }
+    uint64_t span = trace_begin();
     for (int i = 1; i < count; ++i) {
         int j = i;
         while (j > 0 && priceboard_compare_rows(ctx, j - 1, j) > 0) {
@@ -167,6 +171,7 @@ static void priceboard_apply_sort(const PriceboardContext *ctx) {
             --j;
         }
     }
+    trace_end("sort", span, NULL);
 }
 
 // Cycle between desc/asc/default order for a sort field.
@@ -232,6 +237,14 @@ void priceboard_render(const PriceboardContext *ctx, int selected) {
            (size_t)(*ctx->ticker_count) * sizeof(TickerData));
     pthread_mutex_unlock(ctx->data_mutex);
 
+    if (ctx->patterns) {
+        unsigned flags[MAX_SYMBOLS];
+        pattern_scanner_flags(ctx->patterns, flags, *ctx->ticker_count);
+        for (int i = 0; i < *ctx->ticker_count; ++i) {
+            ctx->ticker_snapshot[i].patterns = flags[i];
+        }
+    }
+
     if (ctx->ticker_snapshot_order) {
         for (int i = 0; i < *ctx->ticker_count; ++i) {
             ctx->ticker_snapshot_order[i] = i;
@@ -242,7 +255,7 @@ void priceboard_render(const PriceboardContext *ctx, int selected) {
     const char *price_hint = priceboard_next_sort_hint(SORT_FIELD_PRICE);
     const char *change_hint = priceboard_next_sort_hint(SORT_FIELD_CHANGE);
     draw_main_screen(ctx->ticker_snapshot, *ctx->ticker_count, selected,
-                     price_hint, change_hint);
+                     price_hint, change_hint, show_move_stats);
 }
 
 // Handle keyboard input while price board is active.
@@ -287,6 +300,10 @@ bool priceboard_handle_input(const PriceboardContext *ctx,
         case KEY_F(6):
             priceboard_cycle_sort(SORT_FIELD_CHANGE);
             return false;
+        case 'v':
+        case 'V':
+            show_move_stats = !show_move_stats;
+            return false;
         default:
             return false;
     }
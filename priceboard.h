@@ -24,6 +24,7 @@
 #endif
 #include "cticker.h"
 #include "chart.h"
+#include "patterns.h"
 
 typedef enum {
     /** Default order (config order). */
@@ -45,6 +46,8 @@ typedef struct {
     int *ticker_snapshot_order;
     /** Pointer to current ticker count (owned by main runtime). */
     int *ticker_count;
+    /** Pattern scanner whose flags are shown next to the symbols. */
+    PatternScanner *patterns;
 } PriceboardContext;
 
 void priceboard_clamp_selected(const PriceboardContext *ctx, int *selected);
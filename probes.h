@@ -0,0 +1,47 @@
+#ifndef CTICKER_PROBES_H
+#define CTICKER_PROBES_H
+
+/**
+ * @brief USDT (sys/sdt.h) static tracepoints under the "cticker" provider.
+ *
+ * Each probe compiles to a single nop plus an ELF note describing where its
+ * arguments live, so a probe nobody is attached to costs nothing beyond
+ * keeping those (cheap) arguments in registers. Attach with bpftrace, e.g.
+ * @code
+ * bpftrace -e 'usdt:./cticker:cticker:request__end { @bytes = hist(arg1); }'
+ * @endcode
+ *
+ * Probes (string arguments are NUL-terminated):
+ *  - request__start(symbol, url)         before a REST request ("*" = all pairs)
+ *  - request__end(symbol, bytes, status) after it (bytes 0 on failure)
+ *  - parse__done(symbol, rows)           JSON decoded (rows -1 on error)
+ *  - publish(rows)                       fetched tickers published to the board
+ *  - frame__start()                      UI render phase begins
+ *  - frame__end(screen, cells)           render done, cells repainted
+ *  - chart__reload__start(symbol, period) chart reload begins (::Period value)
+ *  - chart__reload__end(symbol, candles, rc)
+ *
+ * Without <sys/sdt.h>, or built with -DCTICKER_NO_USDT, the macros only
+ * evaluate their arguments.
+ */
+
+#if !defined(CTICKER_NO_USDT) && defined(__has_include)
+#  if __has_include(<sys/sdt.h>)
+#    include <sys/sdt.h>
+#    define CTICKER_HAVE_USDT 1
+#  endif
+#endif
+
+#ifdef CTICKER_HAVE_USDT
+#  define CTICKER_PROBE0(name) DTRACE_PROBE(cticker, name)
+#  define CTICKER_PROBE1(name, a) DTRACE_PROBE1(cticker, name, a)
+#  define CTICKER_PROBE2(name, a, b) DTRACE_PROBE2(cticker, name, a, b)
+#  define CTICKER_PROBE3(name, a, b, c) DTRACE_PROBE3(cticker, name, a, b, c)
+#else
+#  define CTICKER_PROBE0(name) do { } while (0)
+#  define CTICKER_PROBE1(name, a) do { (void)(a); } while (0)
+#  define CTICKER_PROBE2(name, a, b) do { (void)(a); (void)(b); } while (0)
+#  define CTICKER_PROBE3(name, a, b, c) do { (void)(a); (void)(b); (void)(c); } while (0)
+#endif
+
+#endif
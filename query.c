@@ -0,0 +1,411 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file query.c
+ * @brief `cticker query`: ad-hoc reads over the local candle store.
+ *
+ * The command never touches the network or ncurses. It maps the store,
+ * binary-searches the requested range and streams it bucket by bucket:
+ * each bucket is transposed into columns one bounded block at a time and
+ * reduced with tight per-column loops, so memory use does not grow with
+ * the range.
+ *
+ * Examples:
+ *   cticker query ETHUSDT --interval 1h --from -30d --stats
+ *   cticker query BTCUSDT --interval 1m --from 2024-01-01 --to 2024-02-01 --agg 1d --csv
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "candle_store.h"
+#include "commands.h"
+
+// Monday 1970-01-05 00:00 UTC; Binance weekly candles open on Mondays.
+#define WEEK_ANCHOR (4 * 24 * 60 * 60)
+
+// Candles transposed at a time (~300 KiB of columns, stays in L2).
+#define QUERY_BLOCK 4096
+
+/**
+ * @brief One output row (either a stored candle or an aggregated bucket).
+ */
+typedef struct {
+    uint64_t timestamp;
+    double open;
+    double high;
+    double low;
+    double close;
+    double volume;
+    double quote_volume;
+    double taker_buy_base_volume;
+    double taker_buy_quote_volume;
+    uint64_t trade_count;
+} QueryRow;
+
+/**
+ * @brief Running summary for `--stats`.
+ */
+typedef struct {
+    uint64_t rows;
+    double first_open;
+    double last_close;
+    double highest;
+    uint64_t highest_ts;
+    double lowest;
+    uint64_t lowest_ts;
+    double max_range;
+    double max_range_pct;
+    uint64_t max_range_ts;
+    double volume;
+    double quote_volume;
+    uint64_t trades;
+} QueryStats;
+
+static void print_usage(void) {
+    fprintf(stderr,
+            "Usage: cticker query <SYMBOL> --interval <1m|15m|1h|4h|1d|1w|1M>\n"
+            "                     [--from TIME] [--to TIME] [--agg INTERVAL] [--csv] [--stats]\n"
+            "TIME: now, -30d/-12h/-90m/-2w, unix seconds, or YYYY-MM-DD[ HH:MM[:SS]] (UTC)\n");
+}
+
+// Start of the aggregation bucket that contains @p ts.
+static uint64_t bucket_start(uint64_t ts, Period agg) {
+    if (agg == PERIOD_1MONTH) {
+        time_t t = (time_t)ts;
+        struct tm tm_buf;
+        gmtime_r(&t, &tm_buf);
+        tm_buf.tm_mday = 1;
+        tm_buf.tm_hour = 0;
+        tm_buf.tm_min = 0;
+        tm_buf.tm_sec = 0;
+        return (uint64_t)timegm(&tm_buf);
+    }
+    uint64_t span = period_seconds(agg);
+    if (agg == PERIOD_1WEEK) {
+        if (ts < WEEK_ANCHOR) {
+            return 0;
+        }
+        return ts - (ts - WEEK_ANCHOR) % span;
+    }
+    return ts - ts % span;
+}
+
+// Start of the bucket following the one that starts at @p start.
+static uint64_t bucket_next(uint64_t start, Period agg) {
+    if (agg == PERIOD_1MONTH) {
+        time_t t = (time_t)start;
+        struct tm tm_buf;
+        gmtime_r(&t, &tm_buf);
+        tm_buf.tm_mon += 1;
+        return (uint64_t)timegm(&tm_buf);
+    }
+    return start + period_seconds(agg);
+}
+
+// Column reductions. The extremes are plain loops (a max/min reduction
+// only vectorises under -ffinite-math-only); the sums keep four independent
+// lanes, as backtest.c and correlation.c do, so GCC's cheap -O2 cost model
+// vectorises them without needing -ffast-math to reassociate.
+static double column_max(const double *restrict values, size_t count) {
+    double result = values[0];
+    for (size_t i = 1; i < count; i++) {
+        result = values[i] > result ? values[i] : result;
+    }
+    return result;
+}
+
+static double column_min(const double *restrict values, size_t count) {
+    double result = values[0];
+    for (size_t i = 1; i < count; i++) {
+        result = values[i] < result ? values[i] : result;
+    }
+    return result;
+}
+
+static double column_sum(const double *restrict values, size_t count) {
+    double lane[4] = {0.0, 0.0, 0.0, 0.0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        lane[0] += values[i];
+        lane[1] += values[i + 1];
+        lane[2] += values[i + 2];
+        lane[3] += values[i + 3];
+    }
+    double result = (lane[0] + lane[1]) + (lane[2] + lane[3]);
+    for (; i < count; i++) {
+        result += values[i];
+    }
+    return result;
+}
+
+static uint64_t column_sum_u64(const uint64_t *restrict values, size_t count) {
+    uint64_t lane[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        lane[0] += values[i];
+        lane[1] += values[i + 1];
+        lane[2] += values[i + 2];
+        lane[3] += values[i + 3];
+    }
+    uint64_t result = lane[0] + lane[1] + lane[2] + lane[3];
+    for (; i < count; i++) {
+        result += values[i];
+    }
+    return result;
+}
+
+// Reduce records [begin, end) into a single row, QUERY_BLOCK at a time.
+static void reduce_bucket(const CandleRecord *records, size_t begin, size_t end,
+                          CandleColumns *block, uint64_t bucket_ts, QueryRow *row) {
+    memset(row, 0, sizeof(*row));
+    row->timestamp = bucket_ts;
+    row->open = records[begin].open;
+    row->close = records[end - 1].close;
+    for (size_t at = begin; at < end; at += QUERY_BLOCK) {
+        size_t n = end - at < QUERY_BLOCK ? end - at : QUERY_BLOCK;
+        candle_columns_fill(block, records + at, n);
+        double high = column_max(block->high, n);
+        double low = column_min(block->low, n);
+        row->high = (at == begin || high > row->high) ? high : row->high;
+        row->low = (at == begin || low < row->low) ? low : row->low;
+        row->volume += column_sum(block->volume, n);
+        row->quote_volume += column_sum(block->quote_volume, n);
+        row->taker_buy_base_volume += column_sum(block->taker_buy_base_volume, n);
+        row->taker_buy_quote_volume += column_sum(block->taker_buy_quote_volume, n);
+        row->trade_count += column_sum_u64(block->trade_count, n);
+    }
+}
+
+static void print_header(bool csv) {
+    if (csv) {
+        fputs("open_time,open,high,low,close,volume,quote_volume,trades,"
+              "taker_buy_base_volume,taker_buy_quote_volume\n", stdout);
+        return;
+    }
+    printf("%-19s %16s %16s %16s %16s %18s %10s\n",
+           "OPEN TIME (UTC)", "OPEN", "HIGH", "LOW", "CLOSE", "VOLUME", "TRADES");
+}
+
+static void print_row(const QueryRow *row, bool csv) {
+    char open[32], high[32], low[32], close[32], volume[40];
+    cli_format_number(open, sizeof(open), row->open);
+    cli_format_number(high, sizeof(high), row->high);
+    cli_format_number(low, sizeof(low), row->low);
+    cli_format_number(close, sizeof(close), row->close);
+    cli_format_number(volume, sizeof(volume), row->volume);
+
+    if (csv) {
+        char quote[40], taker_base[40], taker_quote[40];
+        cli_format_number(quote, sizeof(quote), row->quote_volume);
+        cli_format_number(taker_base, sizeof(taker_base), row->taker_buy_base_volume);
+        cli_format_number(taker_quote, sizeof(taker_quote), row->taker_buy_quote_volume);
+        printf("%llu,%s,%s,%s,%s,%s,%s,%llu,%s,%s\n",
+               (unsigned long long)row->timestamp, open, high, low, close, volume,
+               quote, (unsigned long long)row->trade_count, taker_base, taker_quote);
+        return;
+    }
+
+    char time_str[32];
+    cli_format_time(time_str, sizeof(time_str), row->timestamp);
+    printf("%-19s %16s %16s %16s %16s %18s %10llu\n", time_str, open, high, low, close,
+           volume, (unsigned long long)row->trade_count);
+}
+
+static void stats_add(QueryStats *stats, const QueryRow *row) {
+    if (stats->rows == 0) {
+        stats->first_open = row->open;
+        stats->highest = row->high;
+        stats->highest_ts = row->timestamp;
+        stats->lowest = row->low;
+        stats->lowest_ts = row->timestamp;
+    }
+    stats->rows++;
+    stats->last_close = row->close;
+    if (row->high > stats->highest) {
+        stats->highest = row->high;
+        stats->highest_ts = row->timestamp;
+    }
+    if (row->low < stats->lowest) {
+        stats->lowest = row->low;
+        stats->lowest_ts = row->timestamp;
+    }
+    double range = row->high - row->low;
+    if (range > stats->max_range || stats->rows == 1) {
+        stats->max_range = range;
+        stats->max_range_pct = row->open != 0.0 ? range / row->open * 100.0 : 0.0;
+        stats->max_range_ts = row->timestamp;
+    }
+    stats->volume += row->volume;
+    stats->quote_volume += row->quote_volume;
+    stats->trades += row->trade_count;
+}
+
+static void print_stats(const QueryStats *stats, const char *symbol, Period period) {
+    if (stats->rows == 0) {
+        printf("%s %s: no candles in range\n", symbol, period_interval_code(period));
+        return;
+    }
+    char a[32], b[32], t[32];
+    printf("%s %s: %llu rows\n", symbol, period_interval_code(period),
+           (unsigned long long)stats->rows);
+    cli_format_number(a, sizeof(a), stats->first_open);
+    cli_format_number(b, sizeof(b), stats->last_close);
+    double ret = stats->first_open != 0.0
+        ? (stats->last_close - stats->first_open) / stats->first_open * 100.0
+        : 0.0;
+    printf("  open -> close : %s -> %s (%+.2f%%)\n", a, b, ret);
+    cli_format_number(a, sizeof(a), stats->highest);
+    cli_format_time(t, sizeof(t), stats->highest_ts);
+    printf("  highest high  : %s at %s\n", a, t);
+    cli_format_number(a, sizeof(a), stats->lowest);
+    cli_format_time(t, sizeof(t), stats->lowest_ts);
+    printf("  lowest low    : %s at %s\n", a, t);
+    cli_format_number(a, sizeof(a), stats->max_range);
+    cli_format_time(t, sizeof(t), stats->max_range_ts);
+    printf("  max range     : %s (%.2f%%) at %s\n", a, stats->max_range_pct, t);
+    cli_format_number(a, sizeof(a), stats->volume);
+    cli_format_number(b, sizeof(b), stats->quote_volume);
+    printf("  volume        : %s base, %s quote, %llu trades\n", a, b,
+           (unsigned long long)stats->trades);
+}
+
+int command_query(int argc, char *argv[]) {
+    const char *symbol = NULL;
+    const char *interval_arg = NULL;
+    const char *agg_arg = NULL;
+    const char *from_arg = NULL;
+    const char *to_arg = NULL;
+    bool csv = false;
+    bool stats_only = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        bool has_value = (i + 1 < argc);
+        if (strcmp(arg, "--interval") == 0 && has_value) {
+            interval_arg = argv[++i];
+        } else if (strcmp(arg, "--from") == 0 && has_value) {
+            from_arg = argv[++i];
+        } else if (strcmp(arg, "--to") == 0 && has_value) {
+            to_arg = argv[++i];
+        } else if (strcmp(arg, "--agg") == 0 && has_value) {
+            agg_arg = argv[++i];
+        } else if (strcmp(arg, "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(arg, "--stats") == 0) {
+            stats_only = true;
+        } else if (arg[0] != '-' && !symbol) {
+            symbol = arg;
+        } else {
+            print_usage();
+            return 2;
+        }
+    }
+
+    if (!symbol || !interval_arg) {
+        print_usage();
+        return 2;
+    }
+
+    Period period;
+    if (cli_parse_period(interval_arg, &period) != 0) {
+        return 2;
+    }
+    Period agg = period;
+    bool aggregate = false;
+    if (agg_arg) {
+        if (cli_parse_period(agg_arg, &agg) != 0) {
+            return 2;
+        }
+        if (agg < period) {
+            fprintf(stderr, "--agg must not be finer than --interval\n");
+            return 2;
+        }
+        aggregate = (agg != period);
+    }
+
+    uint64_t now = (uint64_t)time(NULL);
+    uint64_t from = 0;
+    uint64_t to = UINT64_MAX;
+    if ((from_arg && cli_parse_time(from_arg, now, &from) != 0) ||
+        (to_arg && cli_parse_time(to_arg, now, &to) != 0)) {
+        fprintf(stderr, "Invalid --from/--to time\n");
+        return 2;
+    }
+
+    CandleStore store;
+    if (candle_store_open(&store, symbol, period, false) != 0) {
+        fprintf(stderr, "No local candles for %s %s (try `cticker backfill`)\n",
+                symbol, period_interval_code(period));
+        return 1;
+    }
+
+    CandleColumns block;
+    if (candle_columns_alloc(&block, QUERY_BLOCK) != 0) {
+        candle_store_close(&store);
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    size_t begin = candle_store_lower_bound(&store, from);
+    size_t end_all = candle_store_lower_bound(&store, to);
+    const CandleRecord *records = store.records;
+
+    /* Results can be large; batch stdout writes. */
+    static char stdout_buffer[1 << 20];
+    setvbuf(stdout, stdout_buffer, _IOFBF, sizeof(stdout_buffer));
+
+    QueryStats stats = {0};
+    if (!stats_only) {
+        print_header(csv);
+    }
+
+    while (begin < end_all) {
+        size_t end = begin + 1;
+        uint64_t bucket_ts = records[begin].timestamp;
+        if (aggregate) {
+            bucket_ts = bucket_start(records[begin].timestamp, agg);
+            end = candle_store_lower_bound(&store, bucket_next(bucket_ts, agg));
+            end = end < end_all ? end : end_all;
+        }
+
+        QueryRow row;
+        reduce_bucket(records, begin, end, &block, bucket_ts, &row);
+        stats_add(&stats, &row);
+        if (!stats_only) {
+            print_row(&row, csv);
+        }
+        begin = end;
+    }
+
+    if (stats_only) {
+        print_stats(&stats, symbol, agg);
+    }
+
+    candle_columns_free(&block);
+    candle_store_close(&store);
+    fflush(stdout);
+    return 0;
+}
@@ -0,0 +1,220 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file rangestats.c
+ * @brief Prefix sums and a disjoint sparse table for chart range statistics.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "rangestats.h"
+
+// Aggregate of a single candle.
+static RangeNode range_leaf(const PricePoint *point) {
+    RangeNode node = {
+        .high = point->high,
+        .low = point->low,
+        .peak = point->close,
+        .trough = point->close,
+        .drawdown = 0.0,
+    };
+    return node;
+}
+
+// Aggregate of span @p a followed by span @p b.
+static RangeNode range_combine(RangeNode a, RangeNode b) {
+    RangeNode node = {
+        .high = (a.high > b.high) ? a.high : b.high,
+        .low = (a.low < b.low) ? a.low : b.low,
+        .peak = (a.peak > b.peak) ? a.peak : b.peak,
+        .trough = (a.trough < b.trough) ? a.trough : b.trough,
+        .drawdown = (a.drawdown > b.drawdown) ? a.drawdown : b.drawdown,
+    };
+    if (a.peak > 0.0) {
+        double cross = 1.0 - b.trough / a.peak;
+        if (cross > node.drawdown) {
+            node.drawdown = cross;
+        }
+    }
+    return node;
+}
+
+// Start with an empty index.
+void range_index_init(RangeIndex *index) {
+    memset(index, 0, sizeof(*index));
+}
+
+// Release the arrays and empty the index.
+void range_index_free(RangeIndex *index) {
+    free(index->volume_prefix);
+    free(index->quote_prefix);
+    free(index->taker_prefix);
+    free(index->trades_prefix);
+    free(index->table);
+    range_index_init(index);
+}
+
+// Size the arrays for at least @p needed closed candles and empty them.
+static int range_index_reserve(RangeIndex *index, int needed) {
+    int capacity = 64;
+    int levels = 6;
+    while (capacity < needed) {
+        capacity *= 2;
+        levels++;
+    }
+    if (capacity != index->capacity) {
+        uint64_t rebuilds = index->rebuilds;
+        range_index_free(index);
+        index->rebuilds = rebuilds;
+        size_t prefix = (size_t)capacity + 1;
+        index->volume_prefix = malloc(prefix * sizeof(double));
+        index->quote_prefix = malloc(prefix * sizeof(double));
+        index->taker_prefix = malloc(prefix * sizeof(double));
+        index->trades_prefix = malloc(prefix * sizeof(long long));
+        index->table = malloc((size_t)levels * (size_t)capacity * sizeof(RangeNode));
+        if (!index->volume_prefix || !index->quote_prefix || !index->taker_prefix ||
+            !index->trades_prefix || !index->table) {
+            range_index_free(index);
+            return -1;
+        }
+        index->capacity = capacity;
+        index->levels = levels;
+    }
+    index->volume_prefix[0] = 0.0;
+    index->quote_prefix[0] = 0.0;
+    index->taker_prefix[0] = 0.0;
+    index->trades_prefix[0] = 0;
+    index->closed = 0;
+    return 0;
+}
+
+// Append closed candle i = index->closed. Right of a block's middle the
+// entry extends its left neighbour; the left half is filled backwards once
+// its last candle arrives, since no query reads it before then.
+static void range_index_append(RangeIndex *index, const PricePoint *points) {
+    int i = index->closed;
+    const PricePoint *point = &points[i];
+    index->volume_prefix[i + 1] = index->volume_prefix[i] + point->volume;
+    index->quote_prefix[i + 1] = index->quote_prefix[i] + point->quote_volume;
+    index->taker_prefix[i + 1] = index->taker_prefix[i] + point->taker_buy_base_volume;
+    index->trades_prefix[i + 1] = index->trades_prefix[i] + point->trade_count;
+
+    for (int h = 1; h <= index->levels; ++h) {
+        RangeNode *level = &index->table[(size_t)(h - 1) * (size_t)index->capacity];
+        int block = i & ~((1 << h) - 1);
+        int mid = block + (1 << (h - 1));
+        if (i >= mid) {
+            level[i] = (i == mid) ? range_leaf(point)
+                                  : range_combine(level[i - 1], range_leaf(point));
+        } else if (i == mid - 1) {
+            level[i] = range_leaf(point);
+            for (int p = i - 1; p >= block; --p) {
+                level[p] = range_combine(range_leaf(&points[p]), level[p + 1]);
+            }
+        }
+    }
+    index->closed = i + 1;
+    index->last_closed_timestamp = point->timestamp;
+}
+
+// Rebuild for a new series, or append the candles that closed since the last sync.
+int range_index_sync(RangeIndex *index, const PricePoint *points, int count) {
+    int closed = (count > 0) ? count - 1 : 0;
+    bool rebuild = points != index->source || closed < index->closed ||
+                   closed > index->capacity;
+    if (!rebuild && index->closed > 0) {
+        rebuild = points[0].timestamp != index->first_timestamp ||
+                  points[index->closed - 1].timestamp != index->last_closed_timestamp;
+    }
+    if (rebuild) {
+        index->source = NULL;
+        if (range_index_reserve(index, closed) != 0) {
+            return -1;
+        }
+        index->source = points;
+        index->first_timestamp = (count > 0) ? points[0].timestamp : 0;
+        index->rebuilds++;
+    }
+    while (index->closed < closed) {
+        range_index_append(index, points);
+    }
+    return 0;
+}
+
+// Aggregate of closed candles [from, to] from the two table halves.
+static RangeNode range_index_span(const RangeIndex *index, const PricePoint *points,
+                                  int from, int to) {
+    if (from == to) {
+        return range_leaf(&points[from]);
+    }
+    int h = 32 - __builtin_clz((unsigned)(from ^ to));
+    const RangeNode *level = &index->table[(size_t)(h - 1) * (size_t)index->capacity];
+    return range_combine(level[from], level[to]);
+}
+
+// Combine the indexed closed candles with the live one as needed.
+void range_index_query(const RangeIndex *index, const PricePoint *points, int count,
+                       int from, int to, RangeStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (count <= 0) {
+        return;
+    }
+    if (from > to) {
+        int tmp = from;
+        from = to;
+        to = tmp;
+    }
+    if (from < 0) from = 0;
+    if (to > count - 1) to = count - 1;
+    if (from > to) from = to;
+
+    int closed_to = (to < index->closed) ? to : index->closed - 1;
+    RangeNode node = {0};
+    if (closed_to >= from) {
+        node = range_index_span(index, points, from, closed_to);
+        stats->volume = index->volume_prefix[closed_to + 1] - index->volume_prefix[from];
+        stats->quote_volume = index->quote_prefix[closed_to + 1] - index->quote_prefix[from];
+        stats->taker_buy_volume = index->taker_prefix[closed_to + 1] - index->taker_prefix[from];
+        stats->trades = index->trades_prefix[closed_to + 1] - index->trades_prefix[from];
+    }
+    for (int i = (closed_to >= from) ? closed_to + 1 : from; i <= to; ++i) {
+        RangeNode leaf = range_leaf(&points[i]);
+        node = (i == from) ? leaf : range_combine(node, leaf);
+        stats->volume += points[i].volume;
+        stats->quote_volume += points[i].quote_volume;
+        stats->taker_buy_volume += points[i].taker_buy_base_volume;
+        stats->trades += points[i].trade_count;
+    }
+
+    stats->from = from;
+    stats->to = to;
+    stats->candles = to - from + 1;
+    stats->open = points[from].open;
+    stats->close = points[to].close;
+    stats->change = (stats->open != 0.0) ? stats->close / stats->open - 1.0 : 0.0;
+    stats->high = node.high;
+    stats->low = node.low;
+    stats->max_drawdown = node.drawdown;
+}
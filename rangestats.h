@@ -0,0 +1,106 @@
+#ifndef CTICKER_RANGESTATS_H
+#define CTICKER_RANGESTATS_H
+
+#include <stdint.h>
+#include "cticker.h"
+
+/**
+ * @brief Price aggregate of a candle span.
+ *
+ * Drawdown is measured on closes: the largest fall from a close to any
+ * later close in the span, as a fraction of the earlier close.
+ */
+typedef struct {
+    double high;
+    double low;
+    /** Highest and lowest close. */
+    double peak;
+    double trough;
+    double drawdown;
+} RangeNode;
+
+/**
+ * @brief Statistics of the candles points[from .. to] (inclusive).
+ */
+typedef struct {
+    int from;
+    int to;
+    int candles;
+    /** Open of the first candle and close of the last. */
+    double open;
+    double close;
+    /** close / open - 1. */
+    double change;
+    double high;
+    double low;
+    /** Maximum close-to-close drawdown as a fraction (0 when none). */
+    double max_drawdown;
+    double volume;
+    double quote_volume;
+    double taker_buy_volume;
+    long long trades;
+} RangeStats;
+
+/**
+ * @brief O(1) span queries over a candle series.
+ *
+ * Volumes and trade counts are prefix sums; high, low and drawdown come
+ * from a disjoint sparse table, which answers any span by combining two
+ * precomputed halves (drawdown is associative but, unlike a max, not
+ * idempotent, so the overlapping halves of a plain sparse table would not
+ * do). Both cover the closed candles only: the last (live) candle is read
+ * from the series at query time, so live price ticks cost nothing and a
+ * newly closed candle is appended in O(log n) amortised.
+ */
+typedef struct {
+    /** Series the index was built from, and its first timestamp. */
+    const PricePoint *source;
+    uint64_t first_timestamp;
+    /** Closed candles indexed (all but the last) and the last one's timestamp. */
+    int closed;
+    uint64_t last_closed_timestamp;
+    /** Candles the arrays can hold (power of two) and table levels. */
+    int capacity;
+    int levels;
+    /** Prefix sums over the closed candles (capacity + 1 entries each). */
+    double *volume_prefix;
+    double *quote_prefix;
+    double *taker_prefix;
+    long long *trades_prefix;
+    /** Level h (1-based) at table[(h - 1) * capacity]: in each block of 2^h candles,
+     *  an entry left of the middle covers itself up to the middle, one right
+     *  of it covers the middle up to itself. */
+    RangeNode *table;
+    /** Statistics: full builds. */
+    uint64_t rebuilds;
+} RangeIndex;
+
+/**
+ * @brief Start with an empty index.
+ */
+void range_index_init(RangeIndex *index);
+
+/**
+ * @brief Release memory owned by @p index and empty it.
+ */
+void range_index_free(RangeIndex *index);
+
+/**
+ * @brief Bring the index up to date with @p points.
+ *
+ * A new buffer or rewritten history rebuilds the index; candles appended
+ * to the same series are added incrementally.
+ *
+ * @return 0 on success, -1 on allocation failure (the index is left empty).
+ */
+int range_index_sync(RangeIndex *index, const PricePoint *points, int count);
+
+/**
+ * @brief Statistics of points[from .. to] (either order) in O(1).
+ *
+ * @p points and @p count must be the series last passed to range_index_sync().
+ */
+void range_index_query(const RangeIndex *index, const PricePoint *points, int count,
+                       int from, int to, RangeStats *stats);
+
+#endif
@@ -29,11 +29,12 @@ SOFTWARE.
  * This module owns:
  * - the global "running" flag shared by threads
  * - signal handling for clean shutdown
- * - initialization of UI, buffers, mutex, and fetch thread
+ * - initialization of UI, buffers, tick history, mutex, and fetch thread
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <signal.h>
 #include <stdatomic.h>
 #include "runtime.h"
@@ -82,12 +83,15 @@ int runtime_init(RuntimeContext *ctx) {
         return -1;
     }
 
-    ctx->ticker_count = ctx->config.symbol_count;
+    ctx->ticker_count = ctx->config.symbol_count + synthetic_init(&ctx->synthetics, &ctx->config);
+    portfolio_init(&ctx->portfolio, &ctx->config);
+    movestats_init(&ctx->move_stats, ctx->ticker_count);
     ctx->global_tickers = calloc(ctx->ticker_count, sizeof(TickerData));
     if (!ctx->global_tickers) {
         fprintf(stderr, "Failed to allocate memory\n");
         return -1;
     }
+    synthetic_prepare_rows(&ctx->synthetics, ctx->global_tickers);
 
     ctx->ticker_snapshot = malloc((size_t)ctx->ticker_count * sizeof(TickerData));
     if (!ctx->ticker_snapshot) {
@@ -107,7 +111,27 @@ int runtime_init(RuntimeContext *ctx) {
         return -1;
     }
 
+    /* Without a writer thread, tick logs fall back to synchronous writes. */
+    StorageIO *storage = &ctx->storage;
+    if (storage_init(storage, ctx->config.storage_sync, ctx->config.storage_sync_interval, 0) != 0) {
+        storage = NULL;
+    }
+
+    if (tick_history_init(&ctx->tick_history, &ctx->config, storage) != 0) {
+        storage_shutdown(&ctx->storage);
+        free(ctx->ticker_snapshot_order);
+        ctx->ticker_snapshot_order = NULL;
+        free(ctx->ticker_snapshot);
+        ctx->ticker_snapshot = NULL;
+        free(ctx->global_tickers);
+        ctx->global_tickers = NULL;
+        fprintf(stderr, "Failed to allocate tick history\n");
+        return -1;
+    }
+
     if (pthread_mutex_init(&ctx->data_mutex, NULL) != 0) {
+        tick_history_destroy(&ctx->tick_history);
+        storage_shutdown(&ctx->storage);
         free(ctx->ticker_snapshot_order);
         ctx->ticker_snapshot_order = NULL;
         free(ctx->ticker_snapshot);
@@ -124,6 +148,8 @@ int runtime_init(RuntimeContext *ctx) {
     if (pthread_create(&ctx->fetch_thread, NULL, fetcher_thread_main, ctx) != 0) {
         cleanup_ui();
         pthread_mutex_destroy(&ctx->data_mutex);
+        tick_history_destroy(&ctx->tick_history);
+        storage_shutdown(&ctx->storage);
         free(ctx->ticker_snapshot_order);
         ctx->ticker_snapshot_order = NULL;
         free(ctx->ticker_snapshot);
@@ -135,6 +161,17 @@ int runtime_init(RuntimeContext *ctx) {
     }
 
     fetcher_initial_fetch(ctx);
+
+    /* The scanner is optional: the board simply shows no pattern flags without it. */
+    Period scan_period;
+    if (strcmp(ctx->config.scan_interval, "off") != 0 &&
+        period_from_interval_code(ctx->config.scan_interval, &scan_period) == 0) {
+        pattern_scanner_start(&ctx->patterns, &ctx->config, scan_period);
+    }
+    /* Likewise optional: alerts only appear in the status panel. */
+    tradeflow_monitor_start(&ctx->trade_flow, &ctx->config);
+    /* The sub-minute poller only starts once a chart asks for it. */
+    trade_candle_feed_init(&ctx->trade_candles, &ctx->config);
     return 0;
 }
 
@@ -145,8 +182,13 @@ void runtime_shutdown(RuntimeContext *ctx) {
     }
 
     pthread_join(ctx->fetch_thread, NULL);
+    pattern_scanner_stop(&ctx->patterns);
+    tradeflow_monitor_stop(&ctx->trade_flow);
+    trade_candle_feed_stop(&ctx->trade_candles);
     cleanup_ui();
     pthread_mutex_destroy(&ctx->data_mutex);
+    tick_history_destroy(&ctx->tick_history);
+    storage_shutdown(&ctx->storage);
     free(ctx->global_tickers);
     ctx->global_tickers = NULL;
     free(ctx->ticker_snapshot_order);
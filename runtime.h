@@ -3,7 +3,16 @@
 
 #include <stdbool.h>
 #include <pthread.h>
+#include "arbitrage.h"
+#include "correlation.h"
 #include "cticker.h"
+#include "movestats.h"
+#include "patterns.h"
+#include "portfolio.h"
+#include "synthetic.h"
+#include "tick_history.h"
+#include "tradecandles.h"
+#include "tradeflow.h"
 
 /**
  * @brief Shared runtime state for the application.
@@ -22,10 +31,36 @@ typedef struct {
     TickerData *ticker_snapshot;
     /** Snapshot index map used for sorting. */
     int *ticker_snapshot_order;
-    /** Number of tracked symbols. */
+    /** Number of rows: watchlist symbols followed by synthetic pairs. */
     int ticker_count;
     /** Loaded configuration (kept alive for the fetch thread). */
     Config config;
+    /** Append-only per-symbol tick history fed by the fetch thread. */
+    TickHistory tick_history;
+    /** Background file writer (tick logs); outlives ::RuntimeContext::tick_history. */
+    StorageIO storage;
+    /** Synthetic pairs recomputed from published rows. */
+    SyntheticSet synthetics;
+    /** Holdings valued on every publish (guarded by ::RuntimeContext::data_mutex). */
+    Portfolio portfolio;
+    /** Volatility/ATR/z-score estimators (guarded by ::RuntimeContext::data_mutex). */
+    MoveStatsSet move_stats;
+    /** Background candlestick pattern scanner (own mutex). */
+    PatternScanner patterns;
+    /** Trade-flow anomaly monitor for the `trade_flow` symbols (own mutex). */
+    TradeFlowMonitor trade_flow;
+    /** Sub-minute chart candles built from the charted symbol's trades (own mutex). */
+    TradeCandleFeed trade_candles;
+    /** Portfolio snapshot used by the UI thread. */
+    PortfolioView portfolio_snapshot;
+    /** Correlation feed, running only while the view is open. */
+    CorrelationView correlation;
+    /** Correlation snapshot used by the UI thread. */
+    CorrelationSnapshot correlation_snapshot;
+    /** Triangular arbitrage detector, running only while the view is open. */
+    ArbitrageDetector arbitrage;
+    /** Arbitrage snapshot used by the UI thread. */
+    ArbitrageSnapshot arbitrage_snapshot;
     /** Background fetch thread handle. */
     pthread_t fetch_thread;
 } RuntimeContext;
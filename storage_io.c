@@ -0,0 +1,644 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file storage_io.c
+ * @brief Asynchronous file writer: io_uring with a pwrite() thread fallback.
+ *
+ * Design notes:
+ * - Producers enqueue under a shard mutex and return; one worker per shard
+ *   drains the queue in batches. The io_uring backend submits a whole
+ *   batch with a single io_uring_enter() call, linking consecutive writes
+ *   to the same file so they land in order; the thread backend shards
+ *   files over a few workers that pwrite() sequentially.
+ * - Writes that fail or complete short on the ring are redone with
+ *   pwrite() in submission order, so callers see one consistent outcome.
+ * - Durability follows ::StorageSync: nothing, a periodic fdatasync() of
+ *   dirty files, or fdatasync() after every batch. Syncs run on the
+ *   worker, never on the thread that queued the write.
+ * - The ring is driven with raw syscalls so no liburing is needed.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "storage_io.h"
+#include "trace.h"
+
+#if defined(__linux__) && defined(__has_include)
+#  if __has_include(<linux/io_uring.h>)
+#    include <linux/io_uring.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#      define STORAGE_HAVE_IO_URING 1
+#    endif
+#  endif
+#endif
+
+// Submission queue depth (also the maximum batch size).
+#define STORAGE_BATCH_MAX 256
+// Default queue budget before writers are throttled.
+#define STORAGE_DEFAULT_PENDING (64u << 20)
+// Worker shards for the thread backend.
+#define STORAGE_THREAD_SHARDS 2
+
+static bool file_set_contains(const StorageFileSet *set, int fd) {
+    for (int i = 0; i < set->count; i++) {
+        if (set->fds[i] == fd) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Add @p fd; a full set silently drops it (only costs a missed sync/report).
+static void file_set_add(StorageFileSet *set, int fd) {
+    if (!file_set_contains(set, fd) && set->count < STORAGE_MAX_FILES) {
+        set->fds[set->count++] = fd;
+    }
+}
+
+static bool file_set_remove(StorageFileSet *set, int fd) {
+    for (int i = 0; i < set->count; i++) {
+        if (set->fds[i] == fd) {
+            set->fds[i] = set->fds[--set->count];
+            return true;
+        }
+    }
+    return false;
+}
+
+static int pwrite_all(int fd, const void *data, size_t length, uint64_t offset) {
+    const char *p = data;
+    while (length > 0) {
+        ssize_t n = pwrite(fd, p, length, (off_t)offset);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        length -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return 0;
+}
+
+#ifdef STORAGE_HAVE_IO_URING
+/**
+ * @brief Mapped submission/completion rings of one io_uring instance.
+ */
+typedef struct {
+    int fd;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_map;
+    size_t sq_map_length;
+    void *cq_map;
+    size_t cq_map_length;
+    size_t sqes_length;
+} UringState;
+
+static void uring_destroy(UringState *ring) {
+    if (!ring) {
+        return;
+    }
+    if (ring->sqes) {
+        munmap(ring->sqes, ring->sqes_length);
+    }
+    if (ring->cq_map && ring->cq_map != ring->sq_map) {
+        munmap(ring->cq_map, ring->cq_map_length);
+    }
+    if (ring->sq_map) {
+        munmap(ring->sq_map, ring->sq_map_length);
+    }
+    if (ring->fd >= 0) {
+        close(ring->fd);
+    }
+    free(ring);
+}
+
+static UringState *uring_create(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    UringState *ring = calloc(1, sizeof(UringState));
+    if (!ring) {
+        close(fd);
+        return NULL;
+    }
+    ring->fd = fd;
+
+    size_t sq_length = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_length = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_map) {
+        sq_length = sq_length > cq_length ? sq_length : cq_length;
+    }
+
+    ring->sq_map = mmap(NULL, sq_length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd, IORING_OFF_SQ_RING);
+    if (ring->sq_map == MAP_FAILED) {
+        ring->sq_map = NULL;
+        uring_destroy(ring);
+        return NULL;
+    }
+    ring->sq_map_length = sq_length;
+
+    if (single_map) {
+        ring->cq_map = ring->sq_map;
+    } else {
+        ring->cq_map = mmap(NULL, cq_length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            fd, IORING_OFF_CQ_RING);
+        if (ring->cq_map == MAP_FAILED) {
+            ring->cq_map = NULL;
+            uring_destroy(ring);
+            return NULL;
+        }
+        ring->cq_map_length = cq_length;
+    }
+
+    ring->sqes_length = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_length, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        uring_destroy(ring);
+        return NULL;
+    }
+
+    char *sq = ring->sq_map;
+    char *cq = ring->cq_map;
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    return ring;
+}
+
+/**
+ * @brief Submit a batch and wait for all of its completions.
+ *
+ * When io_uring_enter() fails, the requests the kernel already took are
+ * still waited for (it writes from their buffers until their completions
+ * are posted), and the rest keep -ECANCELED. The failed requests then go
+ * through the synchronous retry in storage_run_batch().
+ *
+ * @return 0, or -1 after a failure; the ring must not be used again since
+ *         unsubmitted entries are left in its submission queue.
+ */
+static int uring_run_batch(UringState *ring, StorageRequest **batch, int count) {
+    unsigned tail = *ring->sq_tail;
+    unsigned mask = *ring->sq_mask;
+    for (int i = 0; i < count; i++) {
+        StorageRequest *req = batch[i];
+        unsigned index = tail & mask;
+        struct io_uring_sqe *sqe = &ring->sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        req->iov.iov_base = req->data;
+        req->iov.iov_len = req->length;
+        req->result = -ECANCELED;
+        sqe->opcode = IORING_OP_WRITEV;
+        sqe->fd = req->fd;
+        sqe->off = req->offset;
+        sqe->addr = (uint64_t)(uintptr_t)&req->iov;
+        sqe->len = 1;
+        sqe->user_data = (uint64_t)(uintptr_t)req;
+        if (i + 1 < count && batch[i + 1]->fd == req->fd) {
+            sqe->flags |= IOSQE_IO_LINK;
+        }
+        ring->sq_array[index] = index;
+        tail++;
+    }
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+    int to_submit = count;
+    int reaped = 0;
+    bool failed = false;
+    while (reaped < count - (failed ? to_submit : 0)) {
+        if (failed) {
+            /* Completions are posted to the mapped ring without entering. */
+            struct timespec pause = {.tv_sec = 0, .tv_nsec = 1000000L};
+            nanosleep(&pause, NULL);
+        } else {
+            int rc = (int)syscall(__NR_io_uring_enter, ring->fd, (unsigned)to_submit, 1u,
+                                  IORING_ENTER_GETEVENTS, NULL, 0);
+            if (rc < 0) {
+                failed = errno != EINTR;
+                continue;
+            }
+            to_submit = rc < to_submit ? to_submit - rc : 0;
+        }
+
+        unsigned head = *ring->cq_head;
+        while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            StorageRequest *req = (StorageRequest *)(uintptr_t)cqe->user_data;
+            req->result = cqe->res;
+            head++;
+            reaped++;
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+    return failed ? -1 : 0;
+}
+#endif
+
+// Stable grouping by fd so same-file writes form contiguous linked chains.
+static void group_by_fd(StorageRequest **batch, int count) {
+    for (int i = 1; i < count; i++) {
+        StorageRequest *req = batch[i];
+        int j = i - 1;
+        while (j >= 0 && batch[j]->fd > req->fd) {
+            batch[j + 1] = batch[j];
+            j--;
+        }
+        batch[j + 1] = req;
+    }
+}
+
+// Write the batch; returns with every request's result filled in. A ring
+// that fails is dropped once its writes are back, and the shard continues
+// with pwrite().
+static void storage_run_batch(StorageShard *shard, StorageRequest **batch, int count) {
+    group_by_fd(batch, count);
+    bool ring_used = false;
+#ifdef STORAGE_HAVE_IO_URING
+    if (shard->ring) {
+        ring_used = true;
+        if (uring_run_batch(shard->ring, batch, count) != 0) {
+            uring_destroy(shard->ring);
+            shard->ring = NULL;
+        }
+    }
+#endif
+    for (int i = 0; i < count; i++) {
+        StorageRequest *req = batch[i];
+        if (!ring_used) {
+            req->result = pwrite_all(req->fd, req->data, req->length, req->offset) == 0
+                              ? (long)req->length
+                              : -errno;
+            continue;
+        }
+        /* Retry failed, cancelled or short ring writes synchronously, in order. */
+        if (req->result < 0 || (size_t)req->result < req->length) {
+            size_t done = req->result > 0 ? (size_t)req->result : 0;
+            req->result = pwrite_all(req->fd, (char *)req->data + done, req->length - done,
+                                     req->offset + done) == 0
+                              ? (long)req->length
+                              : -errno;
+        }
+    }
+}
+
+// fdatasync() a snapshot of the dirty set without holding the shard mutex.
+static void storage_sync_dirty(StorageShard *shard) {
+    StorageFileSet files = shard->dirty;
+    shard->dirty.count = 0;
+    pthread_mutex_unlock(&shard->mutex);
+    for (int i = 0; i < files.count; i++) {
+        fdatasync(files.fds[i]);
+    }
+    pthread_mutex_lock(&shard->mutex);
+}
+
+static void recycle_request(StorageShard *shard, StorageRequest *req) {
+    if (req->owned) {
+        free(req->data);
+    }
+    req->data = NULL;
+    req->owned = false;
+    req->next = shard->free_list;
+    shard->free_list = req;
+}
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void *storage_worker(void *arg) {
+    StorageShard *shard = arg;
+    StorageIO *io = shard->io;
+    StorageRequest *batch[STORAGE_BATCH_MAX];
+    double next_sync = monotonic_seconds() + io->sync_interval;
+    trace_set_thread_name("storage");
+
+    pthread_mutex_lock(&shard->mutex);
+    for (;;) {
+        while (!shard->head && !shard->stop) {
+            if (io->sync == STORAGE_SYNC_INTERVAL && shard->dirty.count > 0) {
+                double now = monotonic_seconds();
+                if (now >= next_sync) {
+                    storage_sync_dirty(shard);
+                    next_sync = now + io->sync_interval;
+                    continue;
+                }
+                struct timespec deadline;
+                clock_gettime(CLOCK_REALTIME, &deadline);
+                double wait = next_sync - now;
+                deadline.tv_sec += (time_t)wait;
+                deadline.tv_nsec += (long)((wait - (double)(time_t)wait) * 1e9);
+                if (deadline.tv_nsec >= 1000000000L) {
+                    deadline.tv_sec++;
+                    deadline.tv_nsec -= 1000000000L;
+                }
+                pthread_cond_timedwait(&shard->wake, &shard->mutex, &deadline);
+            } else {
+                pthread_cond_wait(&shard->wake, &shard->mutex);
+            }
+        }
+        if (!shard->head) {
+            break;
+        }
+
+        int count = 0;
+        while (shard->head && count < STORAGE_BATCH_MAX) {
+            StorageRequest *req = shard->head;
+            shard->head = req->next;
+            batch[count++] = req;
+        }
+        if (!shard->head) {
+            shard->tail = NULL;
+        }
+        pthread_mutex_unlock(&shard->mutex);
+
+        uint64_t span = trace_begin();
+        storage_run_batch(shard, batch, count);
+        if (io->sync == STORAGE_SYNC_ALWAYS) {
+            for (int i = 0; i < count; i++) {
+                if (i == 0 || batch[i]->fd != batch[i - 1]->fd) {
+                    fdatasync(batch[i]->fd);
+                }
+            }
+        }
+        if (span) {
+            char detail[TRACE_DETAIL_LEN];
+            snprintf(detail, sizeof(detail), "%d writes", count);
+            trace_end("flush", span, detail);
+        }
+
+        unsigned long long bytes = 0;
+        pthread_mutex_lock(&shard->mutex);
+        for (int i = 0; i < count; i++) {
+            StorageRequest *req = batch[i];
+            shard->pending_bytes -= req->length;
+            if (req->result < 0) {
+                file_set_add(&shard->failed, req->fd);
+            } else {
+                bytes += (unsigned long long)req->result;
+            }
+            if (io->sync == STORAGE_SYNC_INTERVAL) {
+                file_set_add(&shard->dirty, req->fd);
+            }
+            recycle_request(shard, req);
+        }
+        shard->completed += (uint64_t)count;
+        pthread_cond_broadcast(&shard->done);
+        atomic_fetch_add(&io->bytes_written, bytes);
+        atomic_fetch_add(&io->batches, 1);
+        atomic_fetch_add(&io->requests, (unsigned long long)count);
+
+        if (io->sync == STORAGE_SYNC_INTERVAL && monotonic_seconds() >= next_sync) {
+            storage_sync_dirty(shard);
+            next_sync = monotonic_seconds() + io->sync_interval;
+        }
+    }
+
+    if (io->sync != STORAGE_SYNC_NONE) {
+        storage_sync_dirty(shard);
+    }
+    pthread_mutex_unlock(&shard->mutex);
+    return NULL;
+}
+
+static StorageShard *shard_for(StorageIO *io, int fd) {
+    return &io->shards[(unsigned)fd % (unsigned)io->shard_count];
+}
+
+static void shard_destroy(StorageShard *shard) {
+    while (shard->free_list) {
+        StorageRequest *req = shard->free_list;
+        shard->free_list = req->next;
+        free(req);
+    }
+#ifdef STORAGE_HAVE_IO_URING
+    uring_destroy(shard->ring);
+#endif
+    shard->ring = NULL;
+    pthread_cond_destroy(&shard->wake);
+    pthread_cond_destroy(&shard->done);
+    pthread_mutex_destroy(&shard->mutex);
+}
+
+int storage_init(StorageIO *io, StorageSync sync, int sync_interval, size_t max_pending_bytes) {
+    memset(io, 0, sizeof(*io));
+    io->sync = sync;
+    io->sync_interval = sync_interval > 0 ? sync_interval : STORAGE_SYNC_DEFAULT_INTERVAL;
+    io->max_pending_bytes = max_pending_bytes ? max_pending_bytes : STORAGE_DEFAULT_PENDING;
+    atomic_init(&io->bytes_written, 0);
+    atomic_init(&io->batches, 0);
+    atomic_init(&io->requests, 0);
+    atomic_init(&io->dropped, 0);
+
+    void *ring = NULL;
+#ifdef STORAGE_HAVE_IO_URING
+    const char *forced = getenv("CTICKER_STORAGE");
+    if (!forced || strcmp(forced, "threads") != 0) {
+        ring = uring_create(STORAGE_BATCH_MAX);
+    }
+#endif
+    io->backend = ring ? STORAGE_BACKEND_IO_URING : STORAGE_BACKEND_THREADS;
+    io->shard_count = ring ? 1 : STORAGE_THREAD_SHARDS;
+
+    int started = 0;
+    for (int i = 0; i < io->shard_count; i++) {
+        StorageShard *shard = &io->shards[i];
+        pthread_mutex_init(&shard->mutex, NULL);
+        pthread_cond_init(&shard->wake, NULL);
+        pthread_cond_init(&shard->done, NULL);
+        shard->ring = (i == 0) ? ring : NULL;
+        shard->io = io;
+        shard->running = pthread_create(&shard->thread, NULL, storage_worker, shard) == 0;
+        started += shard->running ? 1 : 0;
+    }
+    if (started < io->shard_count) {
+        storage_shutdown(io);
+        return -1;
+    }
+    return 0;
+}
+
+void storage_shutdown(StorageIO *io) {
+    if (!io || io->shard_count == 0) {
+        return;
+    }
+    for (int i = 0; i < io->shard_count; i++) {
+        StorageShard *shard = &io->shards[i];
+        pthread_mutex_lock(&shard->mutex);
+        shard->stop = true;
+        pthread_cond_signal(&shard->wake);
+        pthread_mutex_unlock(&shard->mutex);
+    }
+    for (int i = 0; i < io->shard_count; i++) {
+        StorageShard *shard = &io->shards[i];
+        if (shard->running) {
+            pthread_join(shard->thread, NULL);
+            shard->running = false;
+        }
+        shard_destroy(shard);
+    }
+    io->shard_count = 0;
+}
+
+int storage_write(StorageIO *io, int fd, uint64_t offset, void *data, size_t length, int flags) {
+    bool take = (flags & STORAGE_WRITE_TAKE) != 0;
+    if (!io || io->shard_count == 0 || fd < 0) {
+        if (take) {
+            free(data);
+        }
+        return -1;
+    }
+
+    StorageShard *shard = shard_for(io, fd);
+    pthread_mutex_lock(&shard->mutex);
+    while (shard->pending_bytes > 0 && shard->pending_bytes + length > io->max_pending_bytes) {
+        if (flags & STORAGE_WRITE_NOWAIT) {
+            pthread_mutex_unlock(&shard->mutex);
+            atomic_fetch_add(&io->dropped, 1);
+            if (take) {
+                free(data);
+            }
+            return -1;
+        }
+        pthread_cond_wait(&shard->done, &shard->mutex);
+    }
+
+    StorageRequest *req = shard->free_list;
+    if (req) {
+        shard->free_list = req->next;
+    } else {
+        req = malloc(sizeof(StorageRequest));
+    }
+    if (!req) {
+        pthread_mutex_unlock(&shard->mutex);
+        if (take) {
+            free(data);
+        }
+        return -1;
+    }
+
+    req->next = NULL;
+    req->fd = fd;
+    req->offset = offset;
+    req->length = length;
+    req->owned = false;
+    if (take) {
+        req->data = data;
+        req->owned = true;
+    } else if (length <= STORAGE_INLINE_BYTES) {
+        memcpy(req->inline_data, data, length);
+        req->data = req->inline_data;
+    } else {
+        req->data = malloc(length);
+        if (!req->data) {
+            recycle_request(shard, req);
+            pthread_mutex_unlock(&shard->mutex);
+            return -1;
+        }
+        memcpy(req->data, data, length);
+        req->owned = true;
+    }
+
+    if (shard->tail) {
+        shard->tail->next = req;
+    } else {
+        shard->head = req;
+    }
+    shard->tail = req;
+    shard->pending_bytes += length;
+    shard->submitted++;
+    pthread_cond_signal(&shard->wake);
+    pthread_mutex_unlock(&shard->mutex);
+    return 0;
+}
+
+int storage_flush(StorageIO *io, int fd) {
+    if (!io || io->shard_count == 0 || fd < 0) {
+        return -1;
+    }
+    StorageShard *shard = shard_for(io, fd);
+    pthread_mutex_lock(&shard->mutex);
+    uint64_t target = shard->submitted;
+    while (shard->completed < target) {
+        pthread_cond_wait(&shard->done, &shard->mutex);
+    }
+    bool failed = file_set_remove(&shard->failed, fd);
+    pthread_mutex_unlock(&shard->mutex);
+    return failed ? -1 : 0;
+}
+
+int storage_close(StorageIO *io, int fd) {
+    if (fd < 0) {
+        return -1;
+    }
+    int status = 0;
+    if (io && io->shard_count > 0) {
+        status = storage_flush(io, fd);
+        StorageShard *shard = shard_for(io, fd);
+        pthread_mutex_lock(&shard->mutex);
+        file_set_remove(&shard->dirty, fd);
+        pthread_mutex_unlock(&shard->mutex);
+        if (io->sync != STORAGE_SYNC_NONE && fdatasync(fd) != 0) {
+            status = -1;
+        }
+    }
+    if (close(fd) != 0) {
+        status = -1;
+    }
+    return status;
+}
+
+const char *storage_backend_name(const StorageIO *io) {
+    return io->backend == STORAGE_BACKEND_IO_URING ? "io_uring" : "threads";
+}
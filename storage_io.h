@@ -0,0 +1,163 @@
+#ifndef CTICKER_STORAGE_IO_H
+#define CTICKER_STORAGE_IO_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include "cticker.h"
+
+/** Worker shards of the thread-pool backend (io_uring uses one ring). */
+#define STORAGE_MAX_SHARDS 4
+/** Files tracked per shard for deferred syncs and error reporting. */
+#define STORAGE_MAX_FILES 128
+/** Payloads up to this size are copied into the request itself. */
+#define STORAGE_INLINE_BYTES 64
+
+/** Copy the payload; the caller keeps its buffer (default). */
+#define STORAGE_WRITE_COPY 0
+/** Take ownership of a malloc()ed payload and free() it once written. */
+#define STORAGE_WRITE_TAKE 1
+/** Fail instead of waiting when the queue is over its byte budget. */
+#define STORAGE_WRITE_NOWAIT 2
+
+/**
+ * @brief Which mechanism performs the writes.
+ */
+typedef enum {
+    /** Batched submissions on an io_uring instance. */
+    STORAGE_BACKEND_IO_URING,
+    /** pwrite() on worker threads (kernels/platforms without io_uring). */
+    STORAGE_BACKEND_THREADS
+} StorageBackend;
+
+/**
+ * @brief One queued write (internal; exposed for sizing only).
+ */
+typedef struct StorageRequest {
+    struct StorageRequest *next;
+    int fd;
+    uint64_t offset;
+    /** Payload (points at ::StorageRequest::inline_data for small writes). */
+    void *data;
+    size_t length;
+    /** free() @p data after completion. */
+    bool owned;
+    /** Vector used by the io_uring submission. */
+    struct iovec iov;
+    /** Completion result (bytes or -errno). */
+    long result;
+    unsigned char inline_data[STORAGE_INLINE_BYTES];
+} StorageRequest;
+
+/**
+ * @brief Small set of file descriptors.
+ */
+typedef struct {
+    int fds[STORAGE_MAX_FILES];
+    int count;
+} StorageFileSet;
+
+struct StorageIO;
+
+/**
+ * @brief Queue plus worker thread; requests on one fd always use one shard,
+ *        so writes to the same file complete in submission order.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    /** Signalled when work arrives or on shutdown. */
+    pthread_cond_t wake;
+    /** Signalled when a batch completes. */
+    pthread_cond_t done;
+    StorageRequest *head;
+    StorageRequest *tail;
+    /** Recycled request structs. */
+    StorageRequest *free_list;
+    /** Payload bytes queued or in flight. */
+    size_t pending_bytes;
+    /** Sequence numbers for storage_flush(). */
+    uint64_t submitted;
+    uint64_t completed;
+    /** Files written since their last sync. */
+    StorageFileSet dirty;
+    /** Files that saw a failed write since the last flush. */
+    StorageFileSet failed;
+    pthread_t thread;
+    bool running;
+    bool stop;
+    /** Opaque io_uring state (NULL for the thread backend). */
+    void *ring;
+    /** Owning writer (worker thread argument). */
+    struct StorageIO *io;
+} StorageShard;
+
+/**
+ * @brief Background writer shared by journals, stores and exports.
+ *
+ * Producers only take a shard mutex and enqueue; disk latency is absorbed
+ * by the worker, so fetch and UI threads never wait on write(2)/fsync(2)
+ * (writers that pass ::STORAGE_WRITE_NOWAIT never wait at all).
+ */
+typedef struct StorageIO {
+    StorageBackend backend;
+    StorageShard shards[STORAGE_MAX_SHARDS];
+    int shard_count;
+    StorageSync sync;
+    /** Seconds between syncs for ::STORAGE_SYNC_INTERVAL. */
+    int sync_interval;
+    /** Queue byte budget before writers wait (or fail with NOWAIT). */
+    size_t max_pending_bytes;
+    /** Statistics. */
+    atomic_ullong bytes_written;
+    atomic_ullong batches;
+    atomic_ullong requests;
+    atomic_ullong dropped;
+} StorageIO;
+
+/**
+ * @brief Start the writer; io_uring is tried first unless
+ *        `CTICKER_STORAGE=threads` is set in the environment.
+ *
+ * @param[in] max_pending_bytes Queue budget (0 selects 64 MiB).
+ * @return 0 on success, -1 if no worker thread could be started.
+ */
+int storage_init(StorageIO *io, StorageSync sync, int sync_interval, size_t max_pending_bytes);
+
+/**
+ * @brief Drain all queues, sync per policy and stop the workers.
+ */
+void storage_shutdown(StorageIO *io);
+
+/**
+ * @brief Queue a positional write of @p length bytes at @p offset.
+ *
+ * Writes to the same fd are applied in call order.
+ *
+ * @param[in] flags ::STORAGE_WRITE_COPY, ::STORAGE_WRITE_TAKE and/or
+ *                  ::STORAGE_WRITE_NOWAIT.
+ * @return 0 when queued, -1 when rejected (NOWAIT over budget or no memory;
+ *         a TAKE payload is freed in that case).
+ */
+int storage_write(StorageIO *io, int fd, uint64_t offset, void *data, size_t length, int flags);
+
+/**
+ * @brief Wait until every write queued for @p fd so far has completed.
+ * @return 0 on success, -1 if any of them failed.
+ */
+int storage_flush(StorageIO *io, int fd);
+
+/**
+ * @brief Flush, sync (unless the policy is ::STORAGE_SYNC_NONE) and close.
+ * @return 0 on success, -1 if a write, sync or close failed.
+ */
+int storage_close(StorageIO *io, int fd);
+
+/**
+ * @brief Human-readable backend name ("io_uring" or "threads").
+ */
+const char *storage_backend_name(const StorageIO *io);
+
+#endif
@@ -0,0 +1,300 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file synthetic.c
+ * @brief Cross-rate pairs and basket indices derived from published tickers.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "candle_cache.h"
+#include "candle_join.h"
+#include "synthetic.h"
+
+// Find a watchlist row by symbol, or -1.
+static int find_base_row(const Config *config, const char *symbol) {
+    for (int i = 0; i < config->symbol_count; i++) {
+        if (strcmp(config->symbols[i], symbol) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Accumulate row^exponent (products) or weight * row (baskets) into @p row,
+// merging repeated rows.
+static int add_term(SyntheticRow *row, int term_row, const char *symbol,
+                    int exponent, double weight) {
+    for (int t = 0; t < row->term_count; t++) {
+        if (row->term_rows[t] == term_row) {
+            row->exponents[t] += exponent;
+            row->weights[t] += weight;
+            return 0;
+        }
+    }
+    if (row->term_count >= SYNTHETIC_MAX_TERMS) {
+        return -1;
+    }
+    row->term_rows[row->term_count] = term_row;
+    snprintf(row->term_symbols[row->term_count], MAX_SYMBOL_LEN, "%s", symbol);
+    row->exponents[row->term_count] = exponent;
+    row->weights[row->term_count++] = weight;
+    return 0;
+}
+
+// Flatten one configured pair into powers of fetched rows.
+static int resolve_pair(const SyntheticSet *set, const Config *config,
+                        const SyntheticPair *pair, SyntheticRow *row) {
+    memset(row, 0, sizeof(*row));
+    snprintf(row->symbol, sizeof(row->symbol), "%s", pair->symbol);
+    row->basket = pair->basket;
+    if (find_base_row(config, pair->symbol) >= 0 || synthetic_find(set, pair->symbol)) {
+        return -1;
+    }
+    for (int t = 0; t < pair->term_count; t++) {
+        int base = find_base_row(config, pair->terms[t]);
+        if (base >= 0) {
+            int exponent = pair->basket ? 0 : pair->exponents[t];
+            double weight = pair->basket ? pair->weights[t] : 0.0;
+            if (add_term(row, base, pair->terms[t], exponent, weight) != 0) {
+                return -1;
+            }
+            continue;
+        }
+        const SyntheticRow *nested = synthetic_find(set, pair->terms[t]);
+        if (!nested || nested->basket || pair->basket) {
+            return -1;
+        }
+        for (int n = 0; n < nested->term_count; n++) {
+            if (add_term(row, nested->term_rows[n], nested->term_symbols[n],
+                         nested->exponents[n] * pair->exponents[t], 0.0) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    // Drop cancelled terms (A * B / B, or zero net basket weight).
+    int kept = 0;
+    for (int t = 0; t < row->term_count; t++) {
+        if (row->basket ? row->weights[t] != 0.0 : row->exponents[t] != 0) {
+            row->term_rows[kept] = row->term_rows[t];
+            row->exponents[kept] = row->exponents[t];
+            row->weights[kept] = row->weights[t];
+            memcpy(row->term_symbols[kept], row->term_symbols[t], MAX_SYMBOL_LEN);
+            kept++;
+        }
+    }
+    row->term_count = kept;
+    return kept > 0 ? 0 : -1;
+}
+
+int synthetic_init(SyntheticSet *set, const Config *config) {
+    memset(set, 0, sizeof(*set));
+    set->base_rows = config->symbol_count;
+    for (int i = 0; i < config->synthetic_count; i++) {
+        if (set->base_rows + set->count >= MAX_SYMBOLS) {
+            break;
+        }
+        SyntheticRow row;
+        if (resolve_pair(set, config, &config->synthetics[i], &row) != 0) {
+            continue;
+        }
+        row.row = set->base_rows + set->count;
+        set->rows[set->count++] = row;
+    }
+
+    // Reverse index from fetched rows to synthetics (counting sort).
+    for (int k = 0; k < set->count; k++) {
+        for (int t = 0; t < set->rows[k].term_count; t++) {
+            set->dep_start[set->rows[k].term_rows[t] + 1]++;
+        }
+    }
+    for (int r = 0; r < set->base_rows; r++) {
+        set->dep_start[r + 1] += set->dep_start[r];
+    }
+    int fill[MAX_SYMBOLS];
+    memcpy(fill, set->dep_start, sizeof(fill));
+    for (int k = 0; k < set->count; k++) {
+        for (int t = 0; t < set->rows[k].term_count; t++) {
+            int slot = fill[set->rows[k].term_rows[t]]++;
+            set->dependents[slot] = k;
+            set->dependent_terms[slot] = t;
+        }
+    }
+    return set->count;
+}
+
+void synthetic_prepare_rows(const SyntheticSet *set, TickerData *tickers) {
+    for (int k = 0; k < set->count; k++) {
+        TickerData *row = &tickers[set->rows[k].row];
+        memset(row, 0, sizeof(*row));
+        snprintf(row->symbol, sizeof(row->symbol), "%s", set->rows[k].symbol);
+        row->synthetic = true;
+    }
+}
+
+// Evaluate one pair from its constituent rows; false until all are priced.
+static bool synthetic_evaluate(const SyntheticRow *def, const TickerData *tickers,
+                               TickerData *out) {
+    double price = 1.0;
+    double open = 1.0;
+    uint64_t timestamp = 0;
+    for (int t = 0; t < def->term_count; t++) {
+        const TickerData *term = &tickers[def->term_rows[t]];
+        double term_open = term->price / (1.0 + term->change_24h / 100.0);
+        if (term->price <= 0.0 || !(term_open > 0.0)) {
+            return false;
+        }
+        double e = (double)def->exponents[t];
+        price *= def->exponents[t] == 1 ? term->price : pow(term->price, e);
+        open *= def->exponents[t] == 1 ? term_open : pow(term_open, e);
+        if (term->timestamp > timestamp) {
+            timestamp = term->timestamp;
+        }
+    }
+    out->price = price;
+    out->change_24h = (price / open - 1.0) * 100.0;
+    out->timestamp = timestamp;
+    snprintf(out->price_text, sizeof(out->price_text), "%.*f",
+             price >= 1.0 ? 2 : 8, price);
+    return true;
+}
+
+// Recompute a basket's running sums from its term state.
+static void basket_resync(SyntheticRow *def) {
+    def->value = 0.0;
+    def->open_value = 0.0;
+    for (int t = 0; t < def->term_count; t++) {
+        def->value += def->weights[t] * def->term_prices[t];
+        def->open_value += def->weights[t] * def->term_opens[t];
+    }
+    def->updates_since_resync = 0;
+}
+
+// Fold one constituent publish into a basket's sums (O(1)).
+static void basket_apply_term(SyntheticRow *def, int term, const TickerData *source) {
+    double price = source->price;
+    double open = price / (1.0 + source->change_24h / 100.0);
+    if (price <= 0.0 || !isfinite(open)) {
+        return;
+    }
+    if (def->term_prices[term] <= 0.0) {
+        def->priced_terms++;
+    }
+    def->value += def->weights[term] * (price - def->term_prices[term]);
+    def->open_value += def->weights[term] * (open - def->term_opens[term]);
+    def->term_prices[term] = price;
+    def->term_opens[term] = open;
+    if (source->timestamp > def->timestamp) {
+        def->timestamp = source->timestamp;
+    }
+    if (++def->updates_since_resync >= SYNTHETIC_RESYNC_UPDATES) {
+        basket_resync(def);
+    }
+}
+
+// Publish a basket's sums into its row once every constituent is priced.
+static bool basket_evaluate(const SyntheticRow *def, TickerData *out) {
+    if (def->priced_terms < def->term_count) {
+        return false;
+    }
+    out->price = def->value;
+    out->change_24h = def->open_value != 0.0
+        ? (def->value / def->open_value - 1.0) * 100.0 : 0.0;
+    out->timestamp = def->timestamp;
+    snprintf(out->price_text, sizeof(out->price_text), "%.*f",
+             fabs(def->value) >= 1.0 ? 2 : 8, def->value);
+    return true;
+}
+
+int synthetic_update(SyntheticSet *set, TickerData *tickers, bool *updated) {
+    bool dirty[MAX_SYNTHETICS] = {false};
+    bool any = false;
+    for (int r = 0; r < set->base_rows; r++) {
+        if (!updated[r]) {
+            continue;
+        }
+        for (int d = set->dep_start[r]; d < set->dep_start[r + 1]; d++) {
+            SyntheticRow *def = &set->rows[set->dependents[d]];
+            if (def->basket) {
+                basket_apply_term(def, set->dependent_terms[d], &tickers[r]);
+            }
+            dirty[set->dependents[d]] = true;
+            any = true;
+        }
+    }
+    if (!any) {
+        return 0;
+    }
+
+    int recomputed = 0;
+    for (int k = 0; k < set->count; k++) {
+        if (!dirty[k]) {
+            continue;
+        }
+        const SyntheticRow *def = &set->rows[k];
+        bool ok = def->basket ? basket_evaluate(def, &tickers[def->row])
+                              : synthetic_evaluate(def, tickers, &tickers[def->row]);
+        if (ok) {
+            updated[def->row] = true;
+            recomputed++;
+        }
+    }
+    return recomputed;
+}
+
+const SyntheticRow *synthetic_find(const SyntheticSet *set, const char *symbol) {
+    if (!set || !symbol) {
+        return NULL;
+    }
+    for (int k = 0; k < set->count; k++) {
+        if (strcmp(set->rows[k].symbol, symbol) == 0) {
+            return &set->rows[k];
+        }
+    }
+    return NULL;
+}
+
+int synthetic_fetch_candles(const SyntheticRow *row, Period period,
+                            PricePoint **points, int *count) {
+    PricePoint *series[SYNTHETIC_MAX_TERMS] = {NULL};
+    int counts[SYNTHETIC_MAX_TERMS] = {0};
+    int rc = 0;
+    for (int t = 0; t < row->term_count && rc == 0; t++) {
+        rc = candle_cache_get(row->term_symbols[t], period, false, &series[t], &counts[t]);
+    }
+    if (rc == 0) {
+        const PricePoint *const *columns = (const PricePoint *const *)series;
+        rc = row->basket
+            ? candle_join_weighted(columns, counts, row->weights, row->term_count, points, count)
+            : candle_join_product(columns, counts, row->exponents, row->term_count, points, count);
+    }
+    for (int t = 0; t < row->term_count; t++) {
+        free(series[t]);
+    }
+    return rc;
+}
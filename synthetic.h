@@ -0,0 +1,101 @@
+#ifndef CTICKER_SYNTHETIC_H
+#define CTICKER_SYNTHETIC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/** Basket updates between exact recomputations of the running sums. */
+#define SYNTHETIC_RESYNC_UPDATES 1024
+
+/**
+ * @brief One derived row over watched (fetched) rows.
+ *
+ * Products are flattened to powers: `ETHBTC = ETHUSDT / BTCUSDT` becomes
+ * terms {ETHUSDT^1, BTCUSDT^-1}, and a pair built on an earlier synthetic
+ * pair is expanded into that pair's terms. Baskets keep running sums of
+ * weight * price (and of the 24h opens) that each constituent publish
+ * adjusts by its own difference.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    bool basket;
+    /** Row in the shared ticker array. */
+    int row;
+    int term_rows[SYNTHETIC_MAX_TERMS];
+    char term_symbols[SYNTHETIC_MAX_TERMS][MAX_SYMBOL_LEN];
+    int exponents[SYNTHETIC_MAX_TERMS];
+    double weights[SYNTHETIC_MAX_TERMS];
+    int term_count;
+    /** Basket state: last price/open per term and the running sums. */
+    double term_prices[SYNTHETIC_MAX_TERMS];
+    double term_opens[SYNTHETIC_MAX_TERMS];
+    double value;
+    double open_value;
+    int priced_terms;
+    uint64_t timestamp;
+    int updates_since_resync;
+} SyntheticRow;
+
+/**
+ * @brief Derived rows and their dependency graph.
+ *
+ * Rows [0, base_rows) are fetched; synthetic rows follow them. The reverse
+ * index lists, for every fetched row, the synthetic rows that read it, so a
+ * publish recomputes only the affected pairs.
+ */
+typedef struct {
+    SyntheticRow rows[MAX_SYNTHETICS];
+    int count;
+    /** Number of fetched rows (the watchlist symbols). */
+    int base_rows;
+    /** Synthetics reading row r: dependents[dep_start[r] .. dep_start[r + 1]),
+     *  with the term index of that row in dependent_terms. */
+    int dep_start[MAX_SYMBOLS + 1];
+    int dependents[MAX_SYNTHETICS * SYNTHETIC_MAX_TERMS];
+    int dependent_terms[MAX_SYNTHETICS * SYNTHETIC_MAX_TERMS];
+} SyntheticSet;
+
+/**
+ * @brief Resolve the configured pairs against the watchlist.
+ *
+ * Pairs naming unknown symbols (baskets accept watched symbols only),
+ * colliding with a watched symbol, or not fitting in ::MAX_SYMBOLS rows are
+ * skipped.
+ *
+ * @return Number of synthetic rows (appended after the watchlist rows).
+ */
+int synthetic_init(SyntheticSet *set, const Config *config);
+
+/**
+ * @brief Initialise the synthetic rows of @p tickers (names and flags).
+ */
+void synthetic_prepare_rows(const SyntheticSet *set, TickerData *tickers);
+
+/**
+ * @brief Recompute rows whose constituents were published.
+ *
+ * Call with the data mutex held after writing the fetched rows; sets
+ * @p updated for every synthetic row that changed.
+ *
+ * @return Number of rows recomputed.
+ */
+int synthetic_update(SyntheticSet *set, TickerData *tickers, bool *updated);
+
+/**
+ * @brief Look up a synthetic row by name.
+ * @return The row, or NULL for ordinary symbols.
+ */
+const SyntheticRow *synthetic_find(const SyntheticSet *set, const char *symbol);
+
+/**
+ * @brief Chart candles of a synthetic row: constituent candles from the
+ *        shared candle cache, merge-joined on open time.
+ *
+ * @param[out] points Allocated array on success; caller frees it.
+ * @return 0 on success, non-zero on failure.
+ */
+int synthetic_fetch_candles(const SyntheticRow *row, Period period,
+                            PricePoint **points, int *count);
+
+#endif
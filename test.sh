@@ -4,10 +4,32 @@
 echo "Testing CTicker Configuration"
 echo "=============================="
 
-# Set test home directory
+# Set test home directory (cleared first: a failed run skips the cleanup)
 export HOME="/tmp/cticker_test"
+rm -rf "$HOME"
 mkdir -p "$HOME"
 
+# Timing helpers for the throughput parts of the tests below. Timings are
+# always printed, but budgets only fail a test when benchmarking
+# (CTICKER_BENCH=1 ./test.sh), so loaded, -O0 or sanitizer runs still pass.
+cat > test_bench.h << 'EOF'
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static inline int bench_within(double elapsed, double budget) {
+    if (!getenv("CTICKER_BENCH") || elapsed < budget) return 1;
+    printf("  over the %.1f s budget\n", budget);
+    return 0;
+}
+EOF
+
 # Test 1: Check if default config is created
 echo "Test 1: Testing default configuration creation..."
 rm -f "$HOME/.cticker.conf"
@@ -78,8 +100,2425 @@ else
     exit 1
 fi
 
+# Test 2: Import bundled kline archive fixtures into the candle store
+echo ""
+echo "Test 2: Testing kline archive import..."
+
+cat > test_import.c << 'EOF'
+#include <stdio.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "kline_import.h"
+
+static int import_file(const char *path, size_t expect_count, size_t expect_rejected) {
+    KlineBatch batch = {0};
+    if (kline_read_archive(path, &batch) != 0) {
+        fprintf(stderr, "Failed to read %s\n", path);
+        return 1;
+    }
+    printf("  %s: %zu candles, %zu rejected\n", path, batch.count, batch.rejected);
+    if (batch.count != expect_count || batch.rejected != expect_rejected) {
+        kline_batch_free(&batch);
+        return 1;
+    }
+
+    char symbol[MAX_SYMBOL_LEN];
+    Period period;
+    if (kline_parse_archive_name(path, symbol, sizeof(symbol), &period) != 0) {
+        kline_batch_free(&batch);
+        return 1;
+    }
+
+    if (kline_batch_normalize(&batch) != 0) {
+        kline_batch_free(&batch);
+        return 1;
+    }
+    CandleStore store;
+    if (candle_store_open(&store, symbol, period, true) != 0) {
+        kline_batch_free(&batch);
+        return 1;
+    }
+    long added = candle_store_merge(&store, batch.records, batch.count);
+    candle_store_close(&store);
+    kline_batch_free(&batch);
+    return added < 0;
+}
+
+/* Candle @p minute past 2024-01-01 00:00. */
+static CandleRecord minute(uint64_t minute) {
+    CandleRecord record;
+    memset(&record, 0, sizeof(record));
+    record.timestamp = 1704067200 + minute * 60;
+    record.close_time = record.timestamp + 59;
+    record.open = record.high = record.low = record.close = 1.0;
+    return record;
+}
+
+/* A second writer waits for the first, then sees (and appends to) its rewrite. */
+static int two_writers(void) {
+    CandleStore store;
+    CandleRecord seed[2] = {minute(0), minute(2)};
+    if (candle_store_open(&store, "LOCKUSDT", PERIOD_1MIN, true) != 0 ||
+        candle_store_merge(&store, seed, 2) != 2) return 1;
+    pid_t child = fork();
+    if (child == 0) {
+        /* Drop the inherited descriptor and mapping: they share the parent's lock. */
+        candle_store_close(&store);
+        CandleStore other;
+        CandleRecord tail = minute(4);
+        if (candle_store_open(&other, "LOCKUSDT", PERIOD_1MIN, true) != 0) _exit(1);
+        long added = candle_store_merge(&other, &tail, 1);
+        candle_store_close(&other);
+        _exit(added == 1 ? 0 : 1);
+    }
+    usleep(100000);
+    CandleRecord hole = minute(1);
+    long added = candle_store_merge(&store, &hole, 1);
+    candle_store_close(&store);
+    int status = 0;
+    if (child < 0 || waitpid(child, &status, 0) != child || status != 0 || added != 1) return 1;
+
+    if (candle_store_open(&store, "LOCKUSDT", PERIOD_1MIN, false) != 0) return 1;
+    int ok = store.count == 4 && store.records[1].timestamp == minute(1).timestamp &&
+             store.records[3].timestamp == minute(4).timestamp;
+    printf("  two writers on LOCKUSDT 1m: %llu candles\n", (unsigned long long)store.count);
+    candle_store_close(&store);
+    return ok ? 0 : 1;
+}
+
+int main() {
+    const char *dir = "tests/fixtures";
+    char path[256];
+
+    /* Monthly-style zip: 10 candles, ms timestamps, no header. */
+    snprintf(path, sizeof(path), "%s/BTCUSDT-1m-2024-01-01.zip", dir);
+    if (import_file(path, 10, 0)) return 1;
+
+    /* Plain CSV overlapping the last 3 candles above, CRLF line endings. */
+    snprintf(path, sizeof(path), "%s/BTCUSDT-1m-2024-01-01-tail.csv", dir);
+    if (import_file(path, 8, 0)) return 1;
+
+    /* Newer archive layout: header row, microsecond timestamps, 1 corrupt row. */
+    snprintf(path, sizeof(path), "%s/ETHUSDT-1h-2025-01-01.zip", dir);
+    if (import_file(path, 5, 1)) return 1;
+
+    CandleStore store;
+    if (candle_store_open(&store, "BTCUSDT", PERIOD_1MIN, false) != 0) return 1;
+    printf("  BTCUSDT 1m stored: %llu candles\n", (unsigned long long)store.count);
+    int ok = store.count == 15 && store.records[0].timestamp == 1704067200;
+    for (uint64_t i = 1; ok && i < store.count; i++) {
+        ok = store.records[i].timestamp == store.records[i - 1].timestamp + 60;
+    }
+    candle_store_close(&store);
+    if (!ok) return 1;
+
+    if (candle_store_open(&store, "ETHUSDT", PERIOD_1HOUR, false) != 0) return 1;
+    ok = store.count == 5 && store.records[0].timestamp == 1735689600;
+    candle_store_close(&store);
+    return ok ? two_writers() : 1;
+}
+EOF
+
+gcc -o test_import test_import.c kline_import.c candle_store.c config.c period.c cli_common.c \
+    -I. -pthread -lz
+if [ $? -eq 0 ] && ./test_import; then
+    echo "Test 2: PASSED"
+else
+    echo "Test 2: FAILED"
+    exit 1
+fi
+
+# Test 3: Export the imported candles to CSV and columnar files
+echo ""
+echo "Test 3: Testing candle export..."
+
+cat > test_export.c << 'EOF'
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "commands.h"
+#include "export.h"
+
+int main() {
+    const char *dir = getenv("HOME");
+    char *csv_args[] = {"export", "BTCUSDT", "--interval", "1m", "--out", (char *)dir,
+                        "--from", "1704067260", "--to", "1704067800"};
+    if (command_export(10, csv_args) != 0) return 1;
+    char *col_args[] = {"export", "BTCUSDT", "ETHUSDT", "--interval", "1m", "--format", "col",
+                        "--out", (char *)dir};
+    if (command_export(9, col_args) == 0) return 1; /* ETHUSDT has no 1m candles */
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/BTCUSDT-1m.csv", dir);
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 1;
+    char line[512];
+    int lines = 0;
+    int first_ok = 0;
+    while (fgets(line, sizeof(line), fp)) {
+        if (lines == 1) first_ok = strncmp(line, "1704067260,", 11) == 0;
+        lines++;
+    }
+    fclose(fp);
+    printf("  CSV: %d lines\n", lines);
+    if (lines != 10 || !first_ok) return 1;
+
+    snprintf(path, sizeof(path), "%s/BTCUSDT-1m.ctcol", dir);
+    fp = fopen(path, "rb");
+    if (!fp) return 1;
+    ColumnarHeader header;
+    ColumnarColumn column;
+    uint64_t ts[15];
+    int ok = fread(&header, sizeof(header), 1, fp) == 1 &&
+             memcmp(header.magic, COLUMNAR_MAGIC, 8) == 0 && header.row_count == 15 &&
+             header.column_count == 10 && fread(&column, sizeof(column), 1, fp) == 1 &&
+             strcmp(column.name, "open_time") == 0 &&
+             fseek(fp, (long)column.offset, SEEK_SET) == 0 && fread(ts, 8, 15, fp) == 15;
+    fclose(fp);
+    for (int i = 1; ok && i < 15; i++) {
+        ok = ts[i] == ts[i - 1] + 60;
+    }
+    printf("  Columnar: %llu rows\n", (unsigned long long)header.row_count);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -o test_export test_export.c export.c storage_io.c trace.c candle_store.c tick_history.c config.c period.c \
+    cli_common.c -I. -pthread -lm
+if [ $? -eq 0 ] && ./test_export; then
+    echo "Test 3: PASSED"
+else
+    echo "Test 3: FAILED"
+    exit 1
+fi
+
+# Test 4: Repair chart holes with targeted requests (network stubbed)
+echo ""
+echo "Test 4: Testing candle gap repair..."
+
+cat > test_gaps.c << 'EOF'
+#include <stdio.h>
+#include <stdlib.h>
+#include "candle_gaps.h"
+
+static int requests_seen = 0;
+
+/* Serve a synthetic 1m series: close = open time / 60. */
+int fetch_historical_range(const char *symbol, Period period, uint64_t start_time,
+                           uint64_t end_time, int limit, PricePoint **points, int *count) {
+    (void)symbol;
+    (void)period;
+    uint64_t now = 1704067200;
+    uint64_t last = (end_time && end_time < now) ? end_time : now;
+    requests_seen++;
+    *points = calloc((size_t)limit, sizeof(PricePoint));
+    *count = 0;
+    for (uint64_t ts = (start_time + 59) / 60 * 60; ts <= last && *count < limit; ts += 60) {
+        PricePoint *p = &(*points)[(*count)++];
+        p->timestamp = ts;
+        p->close_time = ts + 59;
+        p->close = (double)(ts / 60);
+    }
+    return 0;
+}
+
+int main() {
+    /* 4h of 1m candles ending two hours ago, with a 5-candle hole. */
+    int count = 0;
+    PricePoint *points = calloc(240, sizeof(PricePoint));
+    for (uint64_t ts = 1704060000 - 239 * 60; ts <= 1704060000; ts += 60) {
+        if (ts >= 1704057000 && ts < 1704057300) continue;
+        points[count].timestamp = ts;
+        points[count].close_time = ts + 59;
+        points[count].close = -1.0;
+        count++;
+    }
+
+    CandleGap gaps[4];
+    if (candle_gaps_find_points(points, count, gaps, 4) != 1 || gaps[0].start != 1704057000 ||
+        gaps[0].end != 1704057299) return 1;
+
+    int requests = 0;
+    if (candle_gaps_repair_points("BTCUSDT", PERIOD_1MIN, 1704067200, &points, &count,
+                                  &requests) != 0) return 1;
+    printf("  %d candles after repair, %d request(s)\n", count, requests);
+    int ok = count == 235 && requests == 2 && requests_seen == 2 &&
+             points[count - 1].timestamp == 1704067200 &&
+             points[count - 1].close == 1704067200.0 / 60;
+    for (int i = 1; ok && i < count; i++) {
+        ok = points[i].timestamp == points[i - 1].timestamp + 60;
+    }
+    free(points);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -o test_gaps test_gaps.c candle_gaps.c period.c -I. -pthread
+if [ $? -eq 0 ] && ./test_gaps; then
+    echo "Test 4: PASSED"
+else
+    echo "Test 4: FAILED"
+    exit 1
+fi
+
+# Test 5: Tick log appends through the asynchronous writer (both backends)
+echo ""
+echo "Test 5: Testing asynchronous tick log writes..."
+
+cat > test_storage.c << 'EOF'
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "tick_history.h"
+
+int main() {
+    Config config;
+    memset(&config, 0, sizeof(config));
+    config.symbol_count = 2;
+    snprintf(config.symbols[0], MAX_SYMBOL_LEN, "AAAUSDT");
+    snprintf(config.symbols[1], MAX_SYMBOL_LEN, "BBBUSDT");
+    config.tick_log = true;
+
+    StorageIO storage;
+    if (storage_init(&storage, STORAGE_SYNC_ALWAYS, 1, 0) != 0) return 1;
+    TickHistory history;
+    if (tick_history_init(&history, &config, &storage) != 0) return 1;
+    for (int i = 0; i < 20000; i++) {
+        TickerData row;
+        memset(&row, 0, sizeof(row));
+        row.timestamp = 1700000000ULL + (uint64_t)i;
+        row.price = 100.0 + i;
+        tick_history_append(&history, i % 2, &row);
+    }
+    tick_history_destroy(&history);
+    printf("  backend %s, %llu batches, %llu dropped\n", storage_backend_name(&storage),
+           (unsigned long long)storage.batches, (unsigned long long)storage.dropped);
+    storage_shutdown(&storage);
+
+    TickLogView view;
+    if (tick_log_open_view("BBBUSDT", &view) != 0) return 1;
+    int ok = view.count % 10000 == 0 && view.count > 0;
+    for (uint64_t i = view.count - 10000; ok && i < view.count; i++) {
+        ok = view.samples[i].price == 101.0 + 2.0 * (double)(i % 10000);
+    }
+    printf("  BBBUSDT log: %llu samples\n", (unsigned long long)view.count);
+    tick_log_close_view(&view);
+
+    /* Power loss: the count survived, the last record and a half did not. */
+    if (!ok || tick_log_open_view("AAAUSDT", &view) != 0) return 1;
+    uint64_t before = view.count;
+    tick_log_close_view(&view);
+    char path[768];
+    snprintf(path, sizeof(path), "%s/.cticker/ticks/AAAUSDT.ticks", getenv("HOME"));
+    if (truncate(path, (off_t)(sizeof(TickLogHeader) + (before - 1) * sizeof(TickSample) -
+                               sizeof(TickSample) / 2)) != 0) return 1;
+    if (tick_log_open_view("AAAUSDT", &view) != 0) return 1;
+    ok = view.count == before - 2;
+    tick_log_close_view(&view);
+    /* The writer resumes after the last whole record. */
+    if (tick_history_init(&history, &config, NULL) != 0) return 1;
+    TickerData row;
+    memset(&row, 0, sizeof(row));
+    row.price = 42.0;
+    tick_history_append(&history, 0, &row);
+    tick_history_destroy(&history);
+    if (tick_log_open_view("AAAUSDT", &view) != 0) return 1;
+    ok = ok && view.count == before - 1 && view.samples[before - 2].price == 42.0;
+    tick_log_close_view(&view);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -o test_storage test_storage.c tick_history.c storage_io.c trace.c config.c -I. -pthread
+if [ $? -eq 0 ] && ./test_storage && CTICKER_STORAGE=threads ./test_storage; then
+    echo "Test 5: PASSED"
+else
+    echo "Test 5: FAILED"
+    exit 1
+fi
+
+# Test 6: Portfolio totals follow publishes incrementally (with conversion)
+echo ""
+echo "Test 6: Testing incremental portfolio valuation..."
+
+cat > "$HOME/.cticker.conf" << 'EOF'
+BTCUSDT
+ETHBTC
+EURUSDT
+
+portfolio_currency EUR
+hold BTCUSDT 0.5 40000
+hold BTCUSDT 0.5 60000
+hold ETHBTC 10 0.05
+hold SOLUSDT 3 100
+EOF
+
+cat > test_portfolio.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include "portfolio.h"
+
+static int near(double a, double b) { return fabs(a - b) < 1e-6 * (1.0 + fabs(b)); }
+
+int main() {
+    Config config;
+    if (load_config(&config) != 0 || config.holding_count != 4) return 1;
+    static Portfolio portfolio;
+    portfolio_init(&portfolio, &config);
+    if (portfolio.totals.held_rows != 2 || portfolio.lot_rows[3] != -1) return 1;
+
+    portfolio_update(&portfolio, 0, 50000.0);
+    portfolio_update(&portfolio, 1, 0.06);
+    if (portfolio.totals.priced_rows != 0) return 1;   /* no EUR rate yet */
+    portfolio_update(&portfolio, 2, 1.25);             /* EURUSDT: rate 0.8 */
+    int ok = portfolio.totals.priced_rows == 2 &&
+             near(portfolio.totals.value, (50000.0 + 10 * 0.06 * 50000.0) * 0.8) &&
+             near(portfolio.totals.pnl, (0.0 + 10 * 0.01 * 50000.0) * 0.8);
+
+    /* Random walk: running totals must match an exact recomputation. */
+    double prices[3] = {50000.0, 0.06, 1.25};
+    unsigned seed = 7;
+    for (int i = 0; i < 100000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int row = (int)((seed >> 16) % 3);
+        prices[row] *= 1.0 + ((double)((seed >> 4) % 2001) - 1000.0) / 1e5;
+        portfolio_update(&portfolio, row, prices[row]);
+    }
+    double rate = 1.0 / prices[2];
+    double value = prices[0] * rate + 10 * prices[1] * prices[0] * rate;
+    double cost = 50000.0 * rate + 0.5 * prices[0] * rate;
+    ok = ok && near(portfolio.totals.value, value) &&
+         near(portfolio.totals.pnl, value - cost);
+    printf("  value %.2f %s, pnl %+.2f\n", portfolio.totals.value, portfolio.currency,
+           portfolio.totals.pnl);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -o test_portfolio test_portfolio.c portfolio.c config.c -I. -lm
+if [ $? -eq 0 ] && ./test_portfolio; then
+    echo "Test 6: PASSED"
+else
+    echo "Test 6: FAILED"
+    exit 1
+fi
+
+# Test 7: Synthetic pairs recompute from constituents; candles merge-join
+echo ""
+echo "Test 7: Testing synthetic pairs..."
+
+cat > "$HOME/.cticker.conf" << 'EOF'
+BTCUSDT
+ETHUSDT
+EURUSDT
+SOLUSDT
+
+synthetic ETHBTC = ETHUSDT / BTCUSDT
+synthetic BTCEUR=BTCUSDT/EURUSDT
+synthetic ETHEUR = ETHBTC * BTCEUR
+synthetic BROKEN = ETHUSDT / NOPEUSDT
+EOF
+
+cat > test_synthetic.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "candle_join.h"
+#include "synthetic.h"
+
+/* Chart candles are covered by the merge-join below; no network here. */
+int fetch_historical_data(const char *symbol, Period period, PricePoint **points, int *count) {
+    (void)symbol; (void)period; *points = NULL; *count = 0;
+    return -1;
+}
+
+int main() {
+    Config config;
+    if (load_config(&config) != 0 || config.synthetic_count != 4) return 1;
+    if (save_config(&config) != 0 || load_config(&config) != 0 ||
+        config.synthetic_count != 4) return 1;
+    SyntheticSet set;
+    if (synthetic_init(&set, &config) != 3) return 1;
+    const SyntheticRow *etheur = synthetic_find(&set, "ETHEUR");
+    if (!etheur || etheur->term_count != 2 || etheur->row != 6) return 1;
+
+    TickerData tickers[7];
+    bool updated[7] = {false};
+    memset(tickers, 0, sizeof(tickers));
+    synthetic_prepare_rows(&set, tickers);
+    tickers[0].price = 50000.0; tickers[0].change_24h = 25.0;
+    tickers[1].price = 2500.0;
+    tickers[2].price = 1.25;
+    updated[0] = updated[1] = updated[2] = true;
+    int ok = synthetic_update(&set, tickers, updated) == 3 &&
+             fabs(tickers[4].price - 0.05) < 1e-12 &&
+             fabs(tickers[4].change_24h + 20.0) < 1e-9 &&
+             fabs(tickers[6].price - 2000.0) < 1e-9 && tickers[6].synthetic;
+
+    /* A SOLUSDT publish touches no synthetic row. */
+    memset(updated, 0, sizeof(updated));
+    updated[3] = true;
+    ok = ok && synthetic_update(&set, tickers, updated) == 0 && !updated[4];
+    memset(updated, 0, sizeof(updated));
+    updated[2] = true;
+    ok = ok && synthetic_update(&set, tickers, updated) == 2 && !updated[4];
+
+    /* Merge-join skips candles missing from either side. */
+    PricePoint a[4], b[3];
+    memset(a, 0, sizeof(a));
+    memset(b, 0, sizeof(b));
+    uint64_t ta[4] = {60, 120, 180, 240}, tb[3] = {120, 240, 300};
+    for (int i = 0; i < 4; i++) {
+        a[i].timestamp = ta[i]; a[i].open = a[i].close = 100.0;
+        a[i].high = 110.0; a[i].low = 90.0;
+    }
+    for (int i = 0; i < 3; i++) {
+        b[i].timestamp = tb[i]; b[i].open = b[i].close = 50.0;
+        b[i].high = 55.0; b[i].low = 45.0;
+    }
+    const PricePoint *series[2] = {a, b};
+    int counts[2] = {4, 3};
+    int exponents[2] = {1, -1};
+    PricePoint *out = NULL;
+    int out_count = 0;
+    ok = ok && candle_join_product(series, counts, exponents, 2, &out, &out_count) == 0 &&
+         out_count == 2 && out[0].timestamp == 120 && out[1].timestamp == 240 &&
+         fabs(out[1].close - 2.0) < 1e-12 && fabs(out[1].high - 110.0 / 45.0) < 1e-12 &&
+         fabs(out[1].low - 90.0 / 55.0) < 1e-12;
+
+    /* Chart comparisons keep every chart candle and mark the gaps. */
+    int positions[4];
+    candle_join_left(a, 4, b, 3, positions);
+    ok = ok && positions[0] == -1 && positions[1] == 0 && positions[2] == -1 &&
+         positions[3] == 1;
+    candle_join_left(b, 3, a, 4, positions);
+    ok = ok && positions[0] == 1 && positions[1] == 3 && positions[2] == -1;
+    printf("  ETHBTC %.8f (%+.2f%%), ETHEUR %.2f, %d joined candles\n",
+           tickers[4].price, tickers[4].change_24h, tickers[6].price, out_count);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -o test_synthetic test_synthetic.c synthetic.c candle_join.c candle_cache.c config.c \
+    -I. -lm -pthread
+if [ $? -eq 0 ] && ./test_synthetic; then
+    echo "Test 7: PASSED"
+else
+    echo "Test 7: FAILED"
+    exit 1
+fi
+
+# Test 8: Basket index updates incrementally; chart candles come from the cache
+echo ""
+echo "Test 8: Testing basket index..."
+
+cat > "$HOME/.cticker.conf" << 'EOF'
+BTCUSDT
+ETHUSDT
+SOLUSDT
+
+basket L1 BTCUSDT:0.01 ETHUSDT:0.2 SOLUSDT:2
+EOF
+
+cat > test_basket.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "candle_cache.h"
+#include "synthetic.h"
+
+static int fetches = 0;
+
+/* 240 one-minute candles ending at the open one; SOL misses one minute. */
+int fetch_historical_data(const char *symbol, Period period, PricePoint **points, int *count) {
+    (void)period;
+    fetches++;
+    uint64_t now = (uint64_t)time(NULL) / 60 * 60;
+    double base = symbol[0] == 'B' ? 50000.0 : symbol[0] == 'E' ? 2500.0 : 100.0;
+    PricePoint *out = calloc(240, sizeof(PricePoint));
+    int n = 0;
+    for (int i = 0; i < 240; i++) {
+        if (symbol[0] == 'S' && i == 100) continue;
+        PricePoint *p = &out[n++];
+        p->timestamp = now - (uint64_t)(239 - i) * 60;
+        p->close_time = p->timestamp + 59;
+        p->open = base + i;
+        p->close = base + i + 1;
+        p->high = base + i + 2;
+        p->low = base + i - 1;
+        p->quote_volume = 1000.0;
+    }
+    *points = out;
+    *count = n;
+    return 0;
+}
+
+int main() {
+    Config config;
+    if (load_config(&config) != 0 || config.synthetic_count != 1 ||
+        !config.synthetics[0].basket) return 1;
+    static SyntheticSet set;
+    if (synthetic_init(&set, &config) != 1) return 1;
+
+    TickerData tickers[4];
+    bool updated[4] = {true, true, false, false};
+    memset(tickers, 0, sizeof(tickers));
+    synthetic_prepare_rows(&set, tickers);
+    tickers[0].price = 50000.0;
+    tickers[1].price = 2500.0;
+    /* Not all constituents priced yet: the row stays empty. */
+    int ok = synthetic_update(&set, tickers, updated) == 0 && tickers[3].price == 0.0;
+
+    double prices[3] = {50000.0, 2500.0, 100.0};
+    unsigned seed = 11;
+    for (int i = 0; i < 50000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int row = (int)((seed >> 16) % 3);
+        prices[row] *= 1.0 + ((double)((seed >> 4) % 2001) - 1000.0) / 1e5;
+        memset(updated, 0, sizeof(updated));
+        updated[row] = true;
+        tickers[row].price = prices[row];
+        tickers[row].change_24h = 10.0;
+        synthetic_update(&set, tickers, updated);
+    }
+    double expected = 0.01 * prices[0] + 0.2 * prices[1] + 2.0 * prices[2];
+    ok = ok && updated[3] && fabs(tickers[3].price - expected) < 1e-9 * expected &&
+         fabs(tickers[3].change_24h - 10.0) < 1e-6;
+
+    PricePoint *points = NULL;
+    int count = 0;
+    const SyntheticRow *l1 = synthetic_find(&set, "L1");
+    ok = ok && synthetic_fetch_candles(l1, PERIOD_1MIN, &points, &count) == 0 &&
+         count == 239 && fetches == 3;
+    const PricePoint *last = &points[count - 1];
+    ok = ok && fabs(last->close - (0.01 * 50240.0 + 0.2 * 2740.0 + 2.0 * 340.0)) < 1e-9 &&
+         last->high >= last->close && last->low <= last->open &&
+         last->quote_volume == 3000.0;
+    free(points);
+    /* Reopening the chart is served from the shared cache. */
+    ok = ok && synthetic_fetch_candles(l1, PERIOD_1MIN, &points, &count) == 0 &&
+         fetches == 3;
+    free(points);
+    /* A series patched by a chart replaces the cached one. */
+    PricePoint patched[2];
+    memset(patched, 0, sizeof(patched));
+    patched[1].timestamp = (uint64_t)time(NULL);
+    patched[1].close_time = patched[1].timestamp + 3600;
+    patched[1].close = 123.0;
+    ok = ok && candle_cache_put("BTCUSDT", PERIOD_1MIN, patched, 2) == 0 &&
+         candle_cache_get("BTCUSDT", PERIOD_1MIN, false, &points, &count) == 0 &&
+         count == 2 && points[1].close == 123.0 && fetches == 3;
+    free(points);
+    printf("  L1 %.2f (%+.2f%%), %d candles, %d fetches\n", tickers[3].price,
+           tickers[3].change_24h, count, fetches);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_basket test_basket.c synthetic.c candle_join.c candle_cache.c config.c \
+    -I. -lm -pthread
+if [ $? -eq 0 ] && ./test_basket; then
+    echo "Test 8: PASSED"
+else
+    echo "Test 8: FAILED"
+    exit 1
+fi
+
+# Test 9: Sliding-window correlations match a direct computation
+echo ""
+echo "Test 9: Testing rolling correlations..."
+
+cat > "$HOME/.cticker.conf" << 'EOF'
+BTCUSDT
+ETHUSDT
+SOLUSDT
+EOF
+
+cat > test_correlation.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "correlation.h"
+
+/* Deterministic walk shared by the stub: SOL mirrors BTC, ETH is BTC scaled. */
+static double walk_step(int i) {
+    return sin(i * 12.9898) * 0.01;
+}
+
+static int local_fetches = 0;
+
+int fetch_historical_data(const char *symbol, Period period, PricePoint **points, int *count) {
+    if (period >= PERIOD_1SEC) local_fetches++;
+    const int n = 240;
+    PricePoint *p = calloc(n, sizeof(PricePoint));
+    uint64_t open = (uint64_t)time(NULL) / 60 * 60 - (uint64_t)(n - 1) * 60;
+    double level = 0.0;
+    for (int i = 0; i < n; i++) {
+        level += walk_step(i);
+        double sign = strcmp(symbol, "SOLUSDT") == 0 ? -1.0 : 1.0;
+        double scale = strcmp(symbol, "ETHUSDT") == 0 ? 0.05 : 1.0;
+        p[i].timestamp = open + (uint64_t)i * 60;
+        p[i].close_time = p[i].timestamp + 59;
+        p[i].close = p[i].open = p[i].high = p[i].low = scale * 100.0 * exp(sign * level);
+    }
+    *points = p;
+    *count = n;
+    return 0;
+}
+
+/* Pearson correlation of columns a, b over rows [from, to). */
+static double direct(const double *x, int stride, int from, int to, int a, int b) {
+    double ma = 0, mb = 0, sab = 0, saa = 0, sbb = 0;
+    int w = to - from;
+    for (int t = from; t < to; t++) {
+        ma += x[t * stride + a];
+        mb += x[t * stride + b];
+    }
+    ma /= w;
+    mb /= w;
+    for (int t = from; t < to; t++) {
+        double da = x[t * stride + a] - ma, db = x[t * stride + b] - mb;
+        sab += da * db;
+        saa += da * da;
+        sbb += db * db;
+    }
+    return sab / sqrt(saa * sbb);
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+int main(void) {
+    int ok = 1;
+    /* Factor model: 70 series, window 150, 1000 bars (several rebuilds). */
+    const int n = 70, window = 150, bars = 1000;
+    double *x = malloc(sizeof(double) * n * bars);
+    srand(7);
+    for (int t = 0; t < bars; t++) {
+        double market = (rand() / (double)RAND_MAX - 0.5) * 0.02;
+        for (int s = 0; s < n; s++) {
+            double beta = (s % 7 - 3) / 3.0;
+            x[t * n + s] = beta * market + (rand() / (double)RAND_MAX - 0.5) * 0.01 + 1e-3;
+        }
+    }
+    CorrelationEngine engine;
+    double *out = malloc(sizeof(double) * n * n);
+    ok = ok && correlation_init(&engine, n, window) == 0;
+    double worst = 0.0;
+    for (int t = 0; t < bars && ok; t++) {
+        correlation_push(&engine, &x[t * n]);
+        if (t == 40 || t == 149 || t == 150 + 299 || t == bars - 1) {
+            correlation_matrix(&engine, out);
+            int from = t + 1 > window ? t + 1 - window : 0;
+            for (int a = 0; a < n; a++) {
+                for (int b = 0; b < n; b++) {
+                    double err = fabs(out[a * n + b] - direct(x, n, from, t + 1, a, b));
+                    worst = err > worst ? err : worst;
+                }
+            }
+        }
+    }
+    ok = ok && worst < 1e-9;
+    correlation_free(&engine);
+    printf("  max |incremental - direct| = %.2e\n", worst);
+
+    /* 200 symbols x 500-bar window: one bar update plus matrix read-out. */
+    const int big = 200, big_window = 500;
+    double *row = malloc(sizeof(double) * big);
+    double *big_out = malloc(sizeof(double) * big * big);
+    ok = ok && correlation_init(&engine, big, big_window) == 0;
+    for (int t = 0; t < big_window; t++) {
+        for (int s = 0; s < big; s++) {
+            row[s] = rand() / (double)RAND_MAX - 0.5;
+        }
+        correlation_push(&engine, row);
+    }
+    const int rounds = 200;
+    double start = now_ms();
+    for (int t = 0; t < rounds; t++) {
+        row[t % big] += 0.1;
+        correlation_push(&engine, row);
+        correlation_matrix(&engine, big_out);
+    }
+    double per_bar = (now_ms() - start) / rounds;
+    ok = ok && per_bar < 20.0;
+    correlation_free(&engine);
+    printf("  200 x 500 update + matrix: %.3f ms per bar\n", per_bar);
+
+    /* Feed: candles from the cache, closed bars only, published for the UI. */
+    Config config = {0};
+    ok = ok && load_config(&config) == 0;
+    CorrelationView view;
+    CorrelationSnapshot snapshot;
+    ok = ok && correlation_view_start(&view, &config, PERIOD_1MIN) == 0;
+    for (int i = 0; i < 50; i++) {
+        correlation_view_snapshot(&view, &snapshot);
+        if (snapshot.status != CORRELATION_LOADING) {
+            break;
+        }
+        usleep(100000);
+    }
+    correlation_view_stop(&view);
+    ok = ok && snapshot.status == CORRELATION_READY && snapshot.symbol_count == 3 &&
+         snapshot.window == 238 && fabs(snapshot.matrix[1] - 1.0) < 1e-9 &&
+         fabs(snapshot.matrix[2] + 1.0) < 1e-9 && fabs(snapshot.matrix[4] - 1.0) < 1e-12;
+    printf("  feed: %d symbols, window %d, BTC~ETH %+.3f, BTC~SOL %+.3f\n",
+           snapshot.symbol_count, snapshot.window, snapshot.matrix[1], snapshot.matrix[2]);
+
+    /* Local sub-minute periods have no history to correlate. */
+    ok = ok && correlation_view_start(&view, &config, PERIOD_5SEC) == -1;
+    correlation_view_snapshot(&view, &snapshot);
+    correlation_view_stop(&view);
+    ok = ok && snapshot.status == CORRELATION_FAILED && local_fetches == 0;
+    free(x);
+    free(out);
+    free(row);
+    free(big_out);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_correlation test_correlation.c correlation.c candle_join.c candle_cache.c \
+    config.c period.c -I. -lm -pthread
+if [ $? -eq 0 ] && ./test_correlation; then
+    echo "Test 9: PASSED"
+else
+    echo "Test 9: FAILED"
+    exit 1
+fi
+
+# Test 10: Move statistics are maintained incrementally from published prices
+echo ""
+echo "Test 10: Testing volatility, ATR and move z-score..."
+
+cat > test_movestats.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "movestats.h"
+
+#define BARS 600
+
+static double gauss(void) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0), v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * v);
+}
+
+int main(void) {
+    int ok = 1;
+    static MoveStatsSet set;
+    double closes[BARS], highs[BARS], lows[BARS];
+    movestats_init(&set, 1);
+    TickerData row = {0};
+    srand(11);
+    double price = 100.0;
+    const uint64_t start = 1700000000 / 60 * 60;
+    const double sigma = 0.001;
+    /* Twelve 5 s samples per bar, so per-bar log returns have sd sigma. */
+    for (int b = 0; b < BARS; b++) {
+        highs[b] = 0.0;
+        lows[b] = INFINITY;
+        for (int k = 0; k < 12; k++) {
+            price *= exp(gauss() * sigma / sqrt(12.0));
+            row.price = price;
+            row.timestamp = start + (uint64_t)b * 60 + (uint64_t)k * 5;
+            movestats_update(&set, 0, &row);
+            highs[b] = fmax(highs[b], price);
+            lows[b] = fmin(lows[b], price);
+            if (b == 21 && k == 0) {
+                /* Warm-up is exact: bars 1..20 closed, plain averages. */
+                double mean = 0.0, var = 0.0, atr = 0.0;
+                for (int i = 1; i <= 20; i++) {
+                    mean += log(closes[i] / closes[i - 1]) / 20.0;
+                    atr += (fmax(highs[i], closes[i - 1]) - fmin(lows[i], closes[i - 1])) / 20.0;
+                }
+                for (int i = 1; i <= 20; i++) {
+                    double d = log(closes[i] / closes[i - 1]) - mean;
+                    var += d * d / 20.0;
+                }
+                const MoveStats *st = &set.rows[0];
+                ok = ok && st->bars == 20 && fabs(st->mean - mean) < 1e-15 &&
+                     fabs(st->variance - var) < 1e-15 && fabs(st->atr - atr) < 1e-12;
+                printf("  warm-up: var %.3e (direct %.3e), atr %.5f (direct %.5f)\n",
+                       st->variance, var, st->atr, atr);
+            }
+        }
+        closes[b] = price;
+    }
+    double expected = sigma * sqrt(1440.0) * 100.0;
+    ok = ok && row.stats_ready && fabs(row.volatility - expected) < 0.35 * expected &&
+         row.atr_pct > 0.0;
+    printf("  vol %.2f%% (true %.2f%%), atr %.3f%%\n", row.volatility, expected, row.atr_pct);
+
+    /* A six-sigma jump right after a close stands out. */
+    row.price = price * exp(6.0 * sigma);
+    row.timestamp = start + (uint64_t)BARS * 60;
+    movestats_update(&set, 0, &row);
+    ok = ok && row.move_z > 4.0;
+    printf("  jump z %+.2f\n", row.move_z);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_movestats test_movestats.c movestats.c -I. -lm
+if [ $? -eq 0 ] && ./test_movestats; then
+    echo "Test 10: PASSED"
+else
+    echo "Test 10: FAILED"
+    exit 1
+fi
+
+# Test 11: Pattern scanner evaluates each closed candle once, off the UI thread
+echo ""
+echo "Test 11: Testing candlestick pattern scanner..."
+
+cat > test_patterns.c << 'EOF'
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "patterns.h"
+
+static int fetches = 0;
+
+static void set_bar(PricePoint *p, double o, double h, double l, double c) {
+    p->open = o;
+    p->high = h;
+    p->low = l;
+    p->close = c;
+}
+
+/* 1m candles ending with an open one; the last closed candle carries a pattern. */
+int fetch_historical_data(const char *symbol, Period period, PricePoint **points, int *count) {
+    (void)period;
+    const int n = 60;
+    PricePoint *p = calloc(n, sizeof(PricePoint));
+    uint64_t open = (uint64_t)time(NULL) / 60 * 60 - (uint64_t)(n - 1) * 60;
+    bool sol = strcmp(symbol, "SOLUSDT") == 0;
+    for (int i = 0; i < n; i++) {
+        p[i].timestamp = open + (uint64_t)i * 60;
+        p[i].close_time = p[i].timestamp + 59;
+        if (sol) {
+            double c = 100.0 - 0.1 * i;
+            set_bar(&p[i], c + 0.05, c + 1.0, c - 1.0, c);
+        } else {
+            set_bar(&p[i], 100.0, 103.0, 97.0, 100.5);
+        }
+    }
+    if (strcmp(symbol, "BTCUSDT") == 0) {
+        set_bar(&p[n - 3], 101.0, 103.0, 97.0, 99.0);
+        set_bar(&p[n - 2], 98.5, 102.5, 98.0, 102.0);
+    } else if (strcmp(symbol, "ETHUSDT") == 0) {
+        set_bar(&p[n - 2], 100.0, 111.0, 99.5, 110.0);
+    } else if (sol) {
+        set_bar(&p[n - 2], 93.9, 94.05, 92.0, 94.0);
+    }
+    fetches++;
+    *points = p;
+    *count = n;
+    return 0;
+}
+
+int main(void) {
+    int ok = 1;
+    PricePoint bars[25];
+    for (int i = 0; i < 25; i++) {
+        set_bar(&bars[i], 100.0, 101.0, 99.0, 100.5);
+    }
+    set_bar(&bars[24], 101.0, 101.5, 90.0, 95.0);
+    ok = ok && pattern_detect(bars, 25) == (PATTERN_BEAR_ENGULFING | PATTERN_BREAKOUT_LOW);
+
+    Config config = {0};
+    config.symbol_count = 3;
+    snprintf(config.symbols[0], MAX_SYMBOL_LEN, "BTCUSDT");
+    snprintf(config.symbols[1], MAX_SYMBOL_LEN, "ETHUSDT");
+    snprintf(config.symbols[2], MAX_SYMBOL_LEN, "SOLUSDT");
+    static PatternScanner scanner;
+    ok = ok && pattern_scanner_start(&scanner, &config, PERIOD_1MIN) == 0;
+    for (int i = 0; i < 50 && atomic_load(&scanner.evaluated) < 3; i++) {
+        usleep(100000);
+    }
+    unsigned flags[3];
+    pattern_scanner_flags(&scanner, flags, 3);
+    /* Nothing new closes within the next two seconds (unless the minute rolls). */
+    sleep(2);
+    unsigned evaluated = atomic_load(&scanner.evaluated);
+    pattern_scanner_stop(&scanner);
+    ok = ok && flags[0] == (PATTERN_BULL_ENGULFING | PATTERN_INSIDE_BAR) &&
+         flags[1] == PATTERN_BREAKOUT_HIGH && flags[2] == PATTERN_HAMMER &&
+         (evaluated == 3 || time(NULL) % 60 < 5);
+    printf("  flags %#x %#x %#x, %u candles evaluated, %d fetches\n", flags[0], flags[1],
+           flags[2], evaluated, fetches);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_patterns test_patterns.c patterns.c candle_cache.c -I. -lm -pthread
+if [ $? -eq 0 ] && ./test_patterns; then
+    echo "Test 11: PASSED"
+else
+    echo "Test 11: FAILED"
+    exit 1
+fi
+
+# Test 12: Backtest kernels match a naive reference; a 1000-run sweep is timed
+echo ""
+echo "Test 12: Testing vectorised backtests..."
+cat > test_backtest.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "backtest.h"
+#include "test_bench.h"
+
+/* Straightforward per-candle evaluation of the same rules. */
+static void reference(const CandleRecord *c, size_t n, BacktestStrategy strategy,
+                      const int *p, double fee, BacktestStats *out) {
+    double position = 0, equity = 0, peak = 0, worst = 0, held = 0;
+    double gain = 0, loss = 0;
+    int trades = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) {
+            equity += position * log(c[i].close / c[i - 1].close);
+        }
+        held += position;
+        double target = position;
+        if (strategy == BACKTEST_MA_CROSS) {
+            target = 0;
+            if (i + 1 >= (size_t)p[1]) {
+                double f = 0, s = 0;
+                for (int k = 0; k < p[1]; k++) {
+                    s += c[i - k].close;
+                    f += k < p[0] ? c[i - k].close : 0;
+                }
+                target = f / p[0] > s / p[1] ? 1 : 0;
+            }
+        } else if (strategy == BACKTEST_BREAKOUT) {
+            size_t warmup = (size_t)(p[0] > p[1] ? p[0] : p[1]);
+            if (i >= warmup) {
+                double top = -INFINITY, bottom = INFINITY;
+                for (int k = 1; k <= p[0]; k++) top = fmax(top, c[i - k].high);
+                for (int k = 1; k <= p[1]; k++) bottom = fmin(bottom, c[i - k].low);
+                target = c[i].close > top ? 1 : (c[i].close < bottom ? 0 : position);
+            }
+        } else if (i > 0) {
+            double change = c[i].close - c[i - 1].close;
+            double up = change > 0 ? change : 0, down = change < 0 ? -change : 0;
+            if (i <= (size_t)p[0]) {
+                gain += up / p[0];
+                loss += down / p[0];
+            } else {
+                gain = (gain * (p[0] - 1) + up) / p[0];
+                loss = (loss * (p[0] - 1) + down) / p[0];
+            }
+            if (i >= (size_t)p[0]) {
+                double rsi = loss > 0 ? 100 - 100 / (1 + gain / loss) : 100;
+                target = rsi < p[1] ? 1 : (rsi > p[2] ? 0 : position);
+            }
+        }
+        if (target != position) {
+            trades++;
+            equity += log1p(-fee);
+            position = target;
+        }
+        if (equity > peak) peak = equity;
+        if (peak - equity > worst) worst = peak - equity;
+    }
+    out->total_return = expm1(equity);
+    out->max_drawdown = -expm1(-worst);
+    out->trades = trades;
+    out->exposure = held / n;
+}
+
+static CandleRecord *random_walk(size_t n, unsigned seed) {
+    CandleRecord *c = calloc(n, sizeof(*c));
+    double price = 100.0;
+    srand(seed);
+    for (size_t i = 0; i < n; i++) {
+        double open = price;
+        price *= exp(((double)rand() / RAND_MAX - 0.5) * 0.004);
+        c[i].timestamp = 1700000000ull + i * 60;
+        c[i].open = open;
+        c[i].close = price;
+        c[i].high = fmax(open, price) * (1 + (double)rand() / RAND_MAX * 0.001);
+        c[i].low = fmin(open, price) * (1 - (double)rand() / RAND_MAX * 0.001);
+    }
+    return c;
+}
+
+static int check(const CandleRecord *c, size_t n, BacktestStrategy strategy,
+                 const BacktestParams *grid, size_t runs) {
+    BacktestSeries series;
+    double *scratch = malloc(2 * n * sizeof(double));
+    if (backtest_series_init(&series, c, n, strategy, grid, runs) != 0) return 0;
+    int ok = 1;
+    for (size_t r = 0; r < runs; r++) {
+        BacktestStats got, want;
+        backtest_run(&series, strategy, &grid[r], 0.001, scratch, &got);
+        reference(c, n, strategy, grid[r].values, 0.001, &want);
+        if (got.trades != want.trades || fabs(got.total_return - want.total_return) > 1e-9 ||
+            fabs(got.max_drawdown - want.max_drawdown) > 1e-9 ||
+            fabs(got.exposure - want.exposure) > 1e-12) {
+            printf("  strategy %d run %zu: %d trades %.9f vs %d trades %.9f\n", strategy, r,
+                   got.trades, got.total_return, want.trades, want.total_return);
+            ok = 0;
+        }
+    }
+    backtest_series_free(&series);
+    free(scratch);
+    return ok;
+}
+
+int main(void) {
+    size_t n = 5000;
+    CandleRecord *c = random_walk(n, 7);
+    BacktestParams ma[] = {{{5, 20}}, {{3, 50}}, {{10, 11}}, {{1, 200}}};
+    BacktestParams breakout[] = {{{20, 10}}, {{7, 30}}, {{50, 50}}, {{1, 1}}};
+    BacktestParams rsi[] = {{{14, 30, 70}}, {{7, 25, 75}}, {{21, 40, 60}}};
+    int ok = check(c, n, BACKTEST_MA_CROSS, ma, 4) &&
+             check(c, n, BACKTEST_BREAKOUT, breakout, 4) &&
+             check(c, n, BACKTEST_RSI, rsi, 3);
+    free(c);
+
+    /* A year of minute candles against 1000 MA-cross combinations. */
+    n = 525600;
+    c = random_walk(n, 11);
+    BacktestParams *grid = calloc(1000, sizeof(*grid));
+    for (int i = 0; i < 1000; i++) {
+        grid[i].values[0] = 2 + i % 25;
+        grid[i].values[1] = 30 + (i / 25) * 10;
+    }
+    double started = bench_now();
+    BacktestSeries series;
+    double *scratch = malloc(2 * n * sizeof(double));
+    backtest_series_init(&series, c, n, BACKTEST_MA_CROSS, grid, 1000);
+    int trades = 0;
+    for (int i = 0; i < 1000; i++) {
+        BacktestStats stats;
+        backtest_run(&series, BACKTEST_MA_CROSS, &grid[i], 0.001, scratch, &stats);
+        trades += stats.trades > 0;
+    }
+    double elapsed = bench_now() - started;
+    printf("  1000 runs x %zu candles in %.2f s on one thread\n", n, elapsed);
+    ok = ok && trades == 1000 && bench_within(elapsed, 30.0);
+    backtest_series_free(&series);
+    free(scratch);
+    free(grid);
+    free(c);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_backtest test_backtest.c backtest.c period.c config.c cli_common.c candle_store.c \
+    -I. -lm -pthread
+if [ $? -eq 0 ] && ./test_backtest; then
+    echo "Test 12: PASSED"
+else
+    echo "Test 12: FAILED"
+    exit 1
+fi
+
+# Test 13: Arbitrage cycles are re-evaluated per edge and match a brute-force scan
+echo ""
+echo "Test 13: Testing triangular arbitrage detection..."
+cat > test_arbitrage.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arbitrage.h"
+#include "portfolio.h"
+
+/* The detector thread is not started here. */
+int fetch_book_tickers(BookQuote **quotes, int *count) {
+    *quotes = NULL;
+    *count = 0;
+    return -1;
+}
+
+static const char *assets[] = {"USDT", "BTC", "ETH", "BNB", "ADA", "XRP", "DOT", "LINK", "LTC"};
+#define ASSETS (int)(sizeof(assets) / sizeof(assets[0]))
+static double usd[ASSETS] = {1, 60000, 3000, 500, 0.5, 0.6, 7, 15, 80};
+
+/* Rate of converting asset a into b through the pair list, or 0 without a pair. */
+static double convert_named(const BookQuote *q, int n, const char *a, const char *b, double fee) {
+    char name[MAX_SYMBOL_LEN];
+    snprintf(name, sizeof(name), "%s%s", a, b);
+    for (int i = 0; i < n; i++) {
+        if (strcmp(q[i].symbol, name) == 0) return q[i].bid * (1 - fee);
+    }
+    snprintf(name, sizeof(name), "%s%s", b, a);
+    for (int i = 0; i < n; i++) {
+        if (strcmp(q[i].symbol, name) == 0) return (1 - fee) / q[i].ask;
+    }
+    return 0;
+}
+
+static double convert(const BookQuote *q, int n, int a, int b, double fee) {
+    return convert_named(q, n, assets[a], assets[b], fee);
+}
+
+int main(void) {
+    BookQuote quotes[64];
+    int n = 0;
+    /* Quote currencies must be known to the splitter: USDT, BTC, ETH, BNB. */
+    for (int b = 1; b < ASSETS; b++) {
+        for (int q = 0; q < 4 && q < b; q++) {
+            if ((b + q) % 5 == 4) continue; /* leave a few pairs unlisted */
+            snprintf(quotes[n].symbol, MAX_SYMBOL_LEN, "%s%s", assets[b], assets[q]);
+            double mid = usd[b] / usd[q];
+            quotes[n].bid = mid * 0.9999;
+            quotes[n].ask = mid * 1.0001;
+            n++;
+        }
+    }
+    double fee = 0.001;
+    ArbGraph graph;
+    if (arb_graph_build(&graph, quotes, n, fee, 0.0) != 0) return 1;
+
+    int expected_cycles = 0;
+    for (int a = 0; a < ASSETS; a++)
+        for (int b = 0; b < ASSETS; b++)
+            for (int c = 0; c < ASSETS; c++)
+                if (a != b && b != c && a != c && convert(quotes, n, a, b, 0) > 0 &&
+                    convert(quotes, n, b, c, 0) > 0 && convert(quotes, n, c, a, 0) > 0)
+                    expected_cycles++;
+    int ok = graph.cycle_count * 3 == expected_cycles && graph.flagged_count == 0;
+    printf("  %d pairs, %d assets, %d cycles (brute force %d), %d flagged\n", graph.edge_count,
+           graph.asset_count, graph.cycle_count, expected_cycles / 3, graph.flagged_count);
+
+    srand(3);
+    long evaluated = 0;
+    for (int step = 0; step < 2000 && ok; step++) {
+        int i = rand() % n;
+        double move = 1 + ((double)rand() / RAND_MAX - 0.5) * 0.01;
+        quotes[i].bid *= move;
+        quotes[i].ask *= move;
+        int edge = arb_graph_find(&graph, quotes[i].symbol);
+        int touched = arb_graph_update(&graph, edge, quotes[i].bid, quotes[i].ask);
+        evaluated += touched;
+        ok = ok && touched == graph.edge_cycle_start[edge + 1] - graph.edge_cycle_start[edge];
+
+        /* Every flagged cycle, and only those, beats 1 after fees. */
+        int profitable = 0;
+        for (int a = 0; a < ASSETS; a++)
+            for (int b = 0; b < ASSETS; b++)
+                for (int c = 0; c < ASSETS; c++) {
+                    if (a == b || b == c || a == c) continue;
+                    double rate = convert(quotes, n, a, b, fee) * convert(quotes, n, b, c, fee) *
+                                  convert(quotes, n, c, a, fee);
+                    profitable += rate > 1.0;
+                }
+        ok = ok && profitable == graph.flagged_count * 3;
+        for (int f = 0; f < graph.flagged_count && ok; f++) {
+            const ArbCycle *cycle = &graph.cycles[graph.flagged[f]];
+            const char *a = graph.assets[cycle->assets[0]];
+            const char *b = graph.assets[cycle->assets[1]];
+            const char *c = graph.assets[cycle->assets[2]];
+            double rate = convert_named(quotes, n, a, b, fee) *
+                          convert_named(quotes, n, b, c, fee) *
+                          convert_named(quotes, n, c, a, fee);
+            ok = fabs(rate - cycle->rate) < 1e-12 * rate;
+        }
+        if (!ok) printf("  mismatch at step %d: %d flagged, brute force %d\n", step,
+                        graph.flagged_count, profitable / 3);
+    }
+
+    int top[4];
+    int shown = arb_graph_top(&graph, top, 4);
+    for (int i = 1; i < shown; i++) ok = ok && graph.cycles[top[i - 1]].rate >= graph.cycles[top[i]].rate;
+    printf("  2000 updates re-evaluated %ld cycles (full rescans: %ld), %d flagged at the end\n",
+           evaluated, 2000L * graph.cycle_count, graph.flagged_count);
+    ok = ok && evaluated < 2000L * graph.cycle_count;
+    arb_graph_free(&graph);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_arbitrage test_arbitrage.c arbitrage.c portfolio.c config.c -I. -lm -pthread
+if [ $? -eq 0 ] && ./test_arbitrage; then
+    echo "Test 13: PASSED"
+else
+    echo "Test 13: FAILED"
+    exit 1
+fi
+
+# Test 14: Trade-flow sketches flag block trades, bursts and one-sided flow
+echo ""
+echo "Test 14: Testing trade-flow anomaly detection..."
+cat > test_tradeflow.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "tradeflow.h"
+#include "test_bench.h"
+
+/* The monitor thread is not started here. */
+int fetch_agg_trades(const char *symbol, uint64_t from_id, TradeSample **trades, int *count) {
+    (void)symbol;
+    (void)from_id;
+    *trades = NULL;
+    *count = 0;
+    return -1;
+}
+void ui_set_status_alert(const char *text, int seconds) {
+    (void)text;
+    (void)seconds;
+}
+
+static TradeFlow flow;
+static uint64_t clock_ms = 1700000000000ull;
+static uint64_t next_id = 1;
+static int counts[TRADE_ALERT_KIND_COUNT];
+static TradeAlert last[TRADE_ALERT_KIND_COUNT];
+
+/* @p rate trades per second for @p seconds; @p buy_share of them taker buys. */
+static void play(double seconds, int rate, double buy_share, double size_scale) {
+    TradeSample batch[256];
+    int n = 0;
+    long total = (long)(seconds * rate);
+    for (long i = 0; i < total; i++) {
+        TradeSample *t = &batch[n++];
+        t->id = next_id++;
+        t->time_ms = clock_ms + (uint64_t)(i * 1000 / rate);
+        t->price = 100.0;
+        t->quantity = (0.5 + (double)rand() / RAND_MAX) * 10.0 * size_scale;
+        t->buyer_maker = (double)rand() / RAND_MAX >= buy_share;
+        if (n == 256 || i == total - 1) {
+            TradeAlert alerts[16];
+            int emitted = tradeflow_process(&flow, batch, n, alerts, 16);
+            for (int a = 0; a < emitted; a++) {
+                counts[alerts[a].kind]++;
+                last[alerts[a].kind] = alerts[a];
+            }
+            n = 0;
+        }
+    }
+    clock_ms += (uint64_t)(seconds * 1000);
+}
+
+int main(void) {
+    srand(5);
+    tradeflow_init(&flow, "BTCUSDT");
+    play(600, 50, 0.5, 1.0);
+    double median = tradeflow_size_quantile(&flow, 0.5);
+    int ok = counts[0] + counts[1] + counts[2] == 0 && fabs(median - 1000.0) < 40.0;
+    printf("  steady: median %.0f, p99.9 %.0f, %d/%d/%d alerts\n", median,
+           tradeflow_size_quantile(&flow, 0.999), counts[0], counts[1], counts[2]);
+
+    play(1, 1, 0.0, 100.0); /* one taker sell 100x the usual size */
+    ok = ok && counts[TRADE_ALERT_BLOCK] == 1 && !last[TRADE_ALERT_BLOCK].buy;
+    play(120, 50, 0.5, 1.0);
+    play(20, 400, 0.5, 1.0); /* 8x the usual rate */
+    ok = ok && counts[TRADE_ALERT_BURST] == 1 && counts[TRADE_ALERT_ONE_SIDED] == 0;
+    play(600, 50, 0.5, 1.0);
+    play(60, 50, 0.97, 1.0); /* taker buys only */
+    ok = ok && counts[TRADE_ALERT_ONE_SIDED] == 1 && last[TRADE_ALERT_ONE_SIDED].buy &&
+         counts[TRADE_ALERT_BLOCK] == 1 && counts[TRADE_ALERT_BURST] == 1;
+    for (int k = 0; k < TRADE_ALERT_KIND_COUNT; k++) {
+        char text[64];
+        tradeflow_describe(&last[k], text, sizeof(text));
+        printf("  %s\n", text);
+    }
+
+    /* Throughput: far beyond BTCUSDT's peak aggregated trade rate. */
+    double started = bench_now();
+    play(1000, 5000, 0.5, 1.0);
+    double elapsed = bench_now() - started;
+    printf("  5M trades in %.2f s (%.1f M trades/s on one core)\n", elapsed, 5.0 / elapsed);
+    ok = ok && bench_within(elapsed, 10.0);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_tradeflow test_tradeflow.c tradeflow.c -I. -lm -pthread
+if [ $? -eq 0 ] && ./test_tradeflow; then
+    echo "Test 14: PASSED"
+else
+    echo "Test 14: FAILED"
+    exit 1
+fi
+
+# Test 15: Volume profile follows a panning window incrementally
+echo ""
+echo "Test 15: Testing incremental volume profile..."
+cat > test_volprofile.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "volprofile.h"
+
+#define CANDLES 5000
+#define WINDOW 120
+#define BINS 40
+
+static PricePoint points[CANDLES];
+
+/* Compare with the same window binned from scratch. */
+static int matches_fresh(const VolumeProfile *incremental, int start, int end,
+                         double lo, double hi) {
+    VolumeProfile fresh;
+    volprofile_init(&fresh);
+    volprofile_update(&fresh, points, CANDLES, start, end, lo, hi, BINS);
+    double sum = 0.0, expect = 0.0;
+    int ok = 1;
+    for (int b = 0; b < BINS; b++) {
+        if (fabs(fresh.volume[b] - incremental->volume[b]) > 1e-6) {
+            ok = 0;
+        }
+        sum += fresh.volume[b];
+    }
+    for (int i = start; i < end; i++) {
+        expect += points[i].volume;
+    }
+    ok = ok && fabs(sum - expect) < 1e-6;
+
+    VolumeProfileLevels a, b;
+    volprofile_levels(incremental, &a);
+    volprofile_levels(&fresh, &b);
+    ok = ok && a.poc == b.poc && a.value_low == b.value_low && a.value_high == b.value_high;
+    /* The value area holds at least 70% of the volume around the POC. */
+    double covered = 0.0;
+    for (int k = b.value_low; k <= b.value_high; k++) {
+        covered += fresh.volume[k];
+    }
+    ok = ok && covered >= VOLPROFILE_VALUE_AREA * b.total - 1e-9 &&
+         b.value_low <= b.poc && b.poc <= b.value_high;
+    volprofile_free(&fresh);
+    return ok;
+}
+
+int main(void) {
+    srand(7);
+    double price = 100.0;
+    double lo = 1e9, hi = 0.0;
+    for (int i = 0; i < CANDLES; i++) {
+        double open = price;
+        price *= exp(((rand() % 2001) - 1000) / 1000.0 * 0.01);
+        points[i].timestamp = 1700000000ull + (uint64_t)i * 60;
+        points[i].open = open;
+        points[i].close = price;
+        points[i].high = fmax(open, price) * (1.0 + (rand() % 100) / 20000.0);
+        points[i].low = fmin(open, price) * (1.0 - (rand() % 100) / 20000.0);
+        points[i].volume = (i % 97 == 0) ? 0.0 : 1.0 + rand() % 1000;
+        if (points[i].low < lo) lo = points[i].low;
+        if (points[i].high > hi) hi = points[i].high;
+    }
+
+    VolumeProfile profile;
+    volprofile_init(&profile);
+    int ok = volprofile_update(&profile, points, CANDLES, 0, WINDOW, lo, hi, BINS) == WINDOW;
+
+    /* Pan right one candle at a time: two candles change per step. */
+    int start = 0, max_touched = 0, mismatches = 0;
+    for (int step = 0; step < 2000; step++) {
+        start++;
+        int touched = volprofile_update(&profile, points, CANDLES, start, start + WINDOW,
+                                        lo, hi, BINS);
+        if (touched > max_touched) max_touched = touched;
+        if (step % 97 == 0 && !matches_fresh(&profile, start, start + WINDOW, lo, hi)) {
+            mismatches++;
+        }
+    }
+    ok = ok && max_touched == 2;
+
+    /* Pan back, jump away, then update the live candle. */
+    int jumps[] = {1990, 1950, 3000, 4880, 4870};
+    for (int k = 0; k < 5; k++) {
+        volprofile_update(&profile, points, CANDLES, jumps[k], jumps[k] + WINDOW, lo, hi, BINS);
+        if (!matches_fresh(&profile, jumps[k], jumps[k] + WINDOW, lo, hi)) mismatches++;
+    }
+    points[4870 + WINDOW - 1].volume += 5000.0;
+    ok = ok && volprofile_update(&profile, points, CANDLES, 4870, 4870 + WINDOW, lo, hi, BINS) == 2;
+    if (!matches_fresh(&profile, 4870, 4870 + WINDOW, lo, hi)) mismatches++;
+
+    /* A replaced series (different timestamps) forces a rebuild. */
+    uint64_t rebuilds = profile.rebuilds;
+    points[4900].timestamp += 1;
+    volprofile_update(&profile, points, CANDLES, 4871, 4871 + WINDOW, lo, hi, BINS);
+    ok = ok && profile.rebuilds == rebuilds + 1 && mismatches == 0;
+
+    VolumeProfileLevels levels;
+    volprofile_levels(&profile, &levels);
+    printf("  %llu candle updates, %llu rebuilds; POC bin %d, value area %d..%d\n",
+           (unsigned long long)profile.candle_updates, (unsigned long long)profile.rebuilds,
+           levels.poc, levels.value_low, levels.value_high);
+    volprofile_free(&profile);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_volprofile test_volprofile.c volprofile.c -I. -lm
+if [ $? -eq 0 ] && ./test_volprofile; then
+    echo "Test 15: PASSED"
+else
+    echo "Test 15: FAILED"
+    exit 1
+fi
+
+# Test 16: Range statistics from prefix sums and a disjoint sparse table
+echo ""
+echo "Test 16: Testing chart range statistics..."
+cat > test_rangestats.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "rangestats.h"
+#include "test_bench.h"
+
+#define CANDLES 20000
+
+static PricePoint points[CANDLES];
+
+static void make_candle(int i, double *price) {
+    double open = *price;
+    *price *= exp(((rand() % 2001) - 1000) / 1000.0 * 0.02);
+    points[i].timestamp = 1700000000ull + (uint64_t)i * 60;
+    points[i].close_time = points[i].timestamp + 59;
+    points[i].open = open;
+    points[i].close = *price;
+    points[i].high = fmax(open, *price) * 1.001;
+    points[i].low = fmin(open, *price) * 0.999;
+    points[i].volume = rand() % 1000;
+    points[i].quote_volume = points[i].volume * *price;
+    points[i].taker_buy_base_volume = points[i].volume * (rand() % 100) / 100.0;
+    points[i].trade_count = rand() % 500;
+}
+
+static int check(const RangeIndex *index, int count, int from, int to) {
+    RangeStats fast;
+    range_index_query(index, points, count, from, to, &fast);
+    if (from > to) {
+        int tmp = from;
+        from = to;
+        to = tmp;
+    }
+    double high = points[from].high, low = points[from].low, peak = 0.0, drawdown = 0.0;
+    double volume = 0.0, taker = 0.0;
+    long long trades = 0;
+    for (int i = from; i <= to; i++) {
+        if (points[i].high > high) high = points[i].high;
+        if (points[i].low < low) low = points[i].low;
+        if (points[i].close > peak) peak = points[i].close;
+        if (1.0 - points[i].close / peak > drawdown) drawdown = 1.0 - points[i].close / peak;
+        volume += points[i].volume;
+        taker += points[i].taker_buy_base_volume;
+        trades += points[i].trade_count;
+    }
+    double change = points[to].close / points[from].open - 1.0;
+    return fast.from == from && fast.to == to && fast.candles == to - from + 1 &&
+           fast.high == high && fast.low == low && fabs(fast.max_drawdown - drawdown) < 1e-12 &&
+           fabs(fast.volume - volume) < 1e-6 * (1.0 + volume) &&
+           fabs(fast.taker_buy_volume - taker) < 1e-6 * (1.0 + taker) &&
+           fast.trades == trades && fabs(fast.change - change) < 1e-12;
+}
+
+int main(void) {
+    srand(11);
+    double price = 100.0;
+    for (int i = 0; i < CANDLES; i++) {
+        make_candle(i, &price);
+    }
+
+    RangeIndex index;
+    range_index_init(&index);
+    int count = 5000;
+    int ok = range_index_sync(&index, points, count) == 0 && index.closed == count - 1;
+    int failures = 0;
+    for (int q = 0; q < 2000; q++) {
+        if (!check(&index, count, rand() % count, rand() % count)) failures++;
+    }
+    /* Spans ending on the live candle, before and after a live tick. */
+    if (!check(&index, count, 10, count - 1) || !check(&index, count, count - 1, count - 1)) {
+        failures++;
+    }
+    points[count - 1].close *= 0.5;
+    points[count - 1].low = points[count - 1].close;
+    range_index_sync(&index, points, count);
+    if (!check(&index, count, 0, count - 1)) failures++;
+
+    /* Candles closing one by one are appended, never rebuilt. */
+    uint64_t rebuilds = index.rebuilds;
+    for (; count < CANDLES; count++) {
+        range_index_sync(&index, points, count + 1);
+        if (count % 251 == 0 && !check(&index, count + 1, rand() % (count + 1), count)) {
+            failures++;
+        }
+    }
+    printf("  appends to %d candles: %llu rebuilds (capacity growth)\n", count,
+           (unsigned long long)(index.rebuilds - rebuilds));
+    for (int q = 0; q < 2000; q++) {
+        if (!check(&index, count, rand() % count, rand() % count)) failures++;
+    }
+    ok = ok && failures == 0 && index.rebuilds - rebuilds <= 3;
+
+    /* Rewritten history is detected and rebuilt. */
+    points[0].timestamp -= 60;
+    rebuilds = index.rebuilds;
+    range_index_sync(&index, points, count);
+    ok = ok && index.rebuilds == rebuilds + 1 && check(&index, count, 0, count - 1);
+
+    RangeStats stats;
+    double sink = 0.0;
+    double started = bench_now();
+    for (int q = 0; q < 1000000; q++) {
+        range_index_query(&index, points, count, q % count, count - 1 - (q * 7) % count, &stats);
+        sink += stats.max_drawdown;
+    }
+    double elapsed = bench_now() - started;
+    printf("  1M span queries over %d candles in %.3f s (%s, %d failures)\n", count, elapsed,
+           sink > 0.0 ? "ok" : "?", failures);
+    range_index_free(&index);
+    return ok && bench_within(elapsed, 2.0) ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_rangestats test_rangestats.c rangestats.c -I. -lm
+if [ $? -eq 0 ] && ./test_rangestats; then
+    echo "Test 16: PASSED"
+else
+    echo "Test 16: FAILED"
+    exit 1
+fi
+
+# Test 17: Sub-minute candles aggregated from trades
+echo ""
+echo "Test 17: Testing sub-minute trade candles..."
+cat > test_tradecandles.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tradecandles.h"
+#include "test_bench.h"
+
+/* The poller thread is not started here. */
+int fetch_agg_trades(const char *symbol, uint64_t from_id, TradeSample **trades, int *count) {
+    (void)symbol;
+    (void)from_id;
+    *trades = NULL;
+    *count = 0;
+    return -1;
+}
+
+#define BARS 120
+#define TRADES 20000
+
+static TradeSample trades[TRADES];
+
+/* Rebuild bar @p open_time of length @p seconds from the raw trades. */
+static int check_bar(const PricePoint *bar, uint64_t seconds, double prev_close) {
+    double open = 0.0, high = 0.0, low = 0.0, close = 0.0, volume = 0.0, taker = 0.0;
+    int n = 0;
+    for (int i = 0; i < TRADES; i++) {
+        uint64_t second = trades[i].time_ms / 1000;
+        if (second - second % seconds != bar->timestamp) continue;
+        if (n == 0) open = high = low = trades[i].price;
+        high = fmax(high, trades[i].price);
+        low = fmin(low, trades[i].price);
+        close = trades[i].price;
+        volume += trades[i].quantity;
+        if (!trades[i].buyer_maker) taker += trades[i].quantity;
+        n++;
+    }
+    if (n == 0) {
+        /* Gap bars are flat at the previous close. */
+        return bar->trade_count == 0 && bar->volume == 0.0 && bar->open == prev_close &&
+               bar->close == prev_close && bar->high == prev_close && bar->low == prev_close;
+    }
+    return bar->trade_count == n && bar->open == open && bar->high == high &&
+           bar->low == low && bar->close == close && fabs(bar->volume - volume) < 1e-9 &&
+           fabs(bar->taker_buy_base_volume - taker) < 1e-9 &&
+           bar->close_time == bar->timestamp + seconds - 1;
+}
+
+int main(void) {
+    srand(5);
+    uint64_t ms = 1700000000000ull;
+    double price = 100.0;
+    for (int i = 0; i < TRADES; i++) {
+        /* Bursts of trades with occasional quiet spells of up to 20 s. */
+        ms += (rand() % 50 == 0) ? 2000 + rand() % 18000 : rand() % 200;
+        price *= 1.0 + ((rand() % 201) - 100) / 100000.0;
+        trades[i].id = (uint64_t)i + 1;
+        trades[i].time_ms = ms;
+        trades[i].price = price;
+        trades[i].quantity = 0.001 * (1 + rand() % 1000);
+        trades[i].buyer_maker = rand() % 2;
+    }
+
+    TradeCandleSeries series;
+    if (trade_candles_init(&series, "BTCUSDT", BARS) != 0) return 1;
+
+    /* Feed in pages while a chart buffer mirrors the 5 s ring. */
+    PricePoint *chart = NULL;
+    int chart_count = 0, copied_total = 0, syncs = 0, mismatches = 0;
+    for (int i = 0; i < TRADES; i += 37) {
+        int n = (TRADES - i < 37) ? TRADES - i : 37;
+        trade_candles_add(&series, trades + i, n);
+        int copied = trade_candles_sync(&series, PERIOD_5SEC, &chart, &chart_count);
+        copied_total += copied;
+        syncs++;
+        PricePoint *full = NULL;
+        int full_count = 0;
+        trade_candles_sync(&series, PERIOD_5SEC, &full, &full_count);
+        if (full_count != chart_count || memcmp(full, chart, sizeof(PricePoint) * chart_count) != 0) {
+            mismatches++;
+        }
+        free(full);
+    }
+    int ok = mismatches == 0 && series.trades == TRADES && chart_count == BARS;
+    /* Nothing changed: nothing copied. */
+    ok = ok && trade_candles_sync(&series, PERIOD_5SEC, &chart, &chart_count) == 0;
+
+    Period periods[4] = {PERIOD_1SEC, PERIOD_5SEC, PERIOD_15SEC, PERIOD_30SEC};
+    for (int p = 0; p < 4; p++) {
+        const TradeCandleRing *ring = &series.rings[periods[p] - PERIOD_1SEC];
+        ok = ok && ring->count == BARS && ring->seconds == period_seconds(periods[p]);
+        for (int b = 1; b < ring->count; b++) {
+            const PricePoint *bar = &ring->bars[(ring->head + b) % ring->capacity];
+            const PricePoint *prev = &ring->bars[(ring->head + b - 1) % ring->capacity];
+            if (bar->timestamp != prev->timestamp + ring->seconds ||
+                !check_bar(bar, ring->seconds, prev->close)) {
+                ok = 0;
+            }
+        }
+    }
+
+    /* A late trade lands in the bar it belongs to without moving its close. */
+    const TradeCandleRing *ring = &series.rings[PERIOD_30SEC - PERIOD_1SEC];
+    PricePoint before = ring->bars[(ring->head + ring->count - 2) % ring->capacity];
+    TradeSample late = {TRADES + 1, before.timestamp * 1000 + 500, before.high * 2.0, 1.0, false};
+    trade_candles_add(&series, &late, 1);
+    const PricePoint *after = &ring->bars[(ring->head + ring->count - 2) % ring->capacity];
+    ok = ok && after->high == late.price && after->close == before.close &&
+         after->trade_count == before.trade_count + 1;
+    ok = ok && period_is_local(PERIOD_30SEC) && !period_is_local(PERIOD_1MIN);
+    Period parsed;
+    ok = ok && period_from_interval_code("5s", &parsed) != 0;
+    /* Stored period numbers are unchanged; the chart still walks 30s -> 1m. */
+    ok = ok && PERIOD_1MIN == 0 && PERIOD_1MONTH == 6 &&
+         period_step(PERIOD_30SEC, 1) == PERIOD_1MIN && period_step(PERIOD_1MIN, -1) == PERIOD_30SEC &&
+         period_step(PERIOD_1MONTH, 1) == PERIOD_1SEC && period_step(PERIOD_1SEC, -1) == PERIOD_1MONTH;
+
+    printf("  %d syncs copied %d bars (%.1f per sync) into a %d-bar 5s chart\n", syncs,
+           copied_total, (double)copied_total / syncs, chart_count);
+    free(chart);
+    trade_candles_free(&series);
+
+    /* Throughput: every trade updates all four rings. */
+    TradeCandleSeries big;
+    trade_candles_init(&big, "BTCUSDT", 900);
+    double started = bench_now();
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < TRADES; i++) {
+            trades[i].time_ms += 10000000ull;
+        }
+        trade_candles_add(&big, trades, TRADES);
+    }
+    double elapsed = bench_now() - started;
+    printf("  2M trades in %.3f s\n", elapsed);
+    trade_candles_free(&big);
+    return ok && bench_within(elapsed, 5.0) ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_tradecandles test_tradecandles.c tradecandles.c period.c -I. -lm -pthread
+if [ $? -eq 0 ] && ./test_tradecandles; then
+    echo "Test 17: PASSED"
+else
+    echo "Test 17: FAILED"
+    exit 1
+fi
+
+# Test 18: Heikin-Ashi, Renko and range bars extended incrementally
+echo ""
+echo "Test 18: Testing derived bar types..."
+cat > test_bartransform.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bartransform.h"
+#include "test_bench.h"
+
+#define CANDLES 3000
+
+static PricePoint points[CANDLES];
+
+static int same_bars(const BarSeries *a, const BarSeries *b) {
+    if (a->count != b->count) return 0;
+    for (int i = 0; i < a->count; i++) {
+        const PricePoint *x = &a->bars[i], *y = &b->bars[i];
+        if (x->timestamp != y->timestamp || x->close_time != y->close_time ||
+            x->open != y->open || x->high != y->high || x->low != y->low ||
+            x->close != y->close || fabs(x->volume - y->volume) > 1e-6) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int check_shape(const BarSeries *s, int count) {
+    const PricePoint *b = s->bars;
+    double box = s->box;
+    for (int i = 1; i < s->count; i++) {
+        if (s->type == BAR_HEIKIN_ASHI) {
+            const PricePoint *c = &points[i];
+            if (fabs(b[i].close - (c->open + c->high + c->low + c->close) / 4.0) > 1e-9 ||
+                fabs(b[i].open - (b[i - 1].open + b[i - 1].close) / 2.0) > 1e-9 ||
+                b[i].high < fmax(b[i].open, b[i].close) || b[i].low > fmin(b[i].open, b[i].close)) {
+                return 0;
+            }
+        } else if (s->type == BAR_RENKO) {
+            bool up = b[i].close > b[i].open, prev_up = b[i - 1].close > b[i - 1].open;
+            double expect_open = (up == prev_up) ? b[i - 1].close : b[i - 1].open;
+            if (fabs(fabs(b[i].close - b[i].open) - box) > 1e-9 * box ||
+                fabs(b[i].open - expect_open) > 1e-9 * box) {
+                return 0;
+            }
+        } else if (i < s->count - 1 && fabs(b[i].high - b[i].low - box) > 1e-9 * box) {
+            return 0;
+        }
+    }
+    if (s->type == BAR_RANGE) {
+        /* Range bars keep every candle's volume, the live bar included. */
+        double bars = 0.0, candles = 0.0;
+        for (int i = 0; i < s->count; i++) bars += b[i].volume;
+        for (int i = 0; i < count; i++) candles += points[i].volume;
+        if (fabs(bars - candles) > 1e-6 * candles) return 0;
+    }
+    return s->count > 10;
+}
+
+int main(void) {
+    srand(3);
+    double price = 100.0;
+    for (int i = 0; i < CANDLES; i++) {
+        double open = price;
+        price *= exp(((rand() % 2001) - 1000) / 1000.0 * 0.01);
+        points[i].timestamp = 1700000000ull + (uint64_t)i * 60;
+        points[i].close_time = points[i].timestamp + 59;
+        points[i].open = open;
+        points[i].close = price;
+        points[i].high = fmax(open, price) * (1.0 + (rand() % 100) / 20000.0);
+        points[i].low = fmin(open, price) * (1.0 - (rand() % 100) / 20000.0);
+        points[i].volume = 1.0 + rand() % 1000;
+    }
+
+    BarCache cache, fresh;
+    bar_cache_init(&cache);
+    bar_cache_init(&fresh);
+    int ok = 1;
+    BarType types[3] = {BAR_HEIKIN_ASHI, BAR_RENKO, BAR_RANGE};
+    for (int t = 0; t < 3; t++) {
+        int mismatches = 0;
+        /* Candles close one by one; the live one ticks twice before it does. */
+        for (int n = 2; n <= CANDLES; n++) {
+            PricePoint full = points[n - 1];
+            points[n - 1].close = (full.open + full.close) / 2.0;
+            points[n - 1].high = fmax(full.open, points[n - 1].close);
+            points[n - 1].low = fmin(full.open, points[n - 1].close);
+            BarSeries *s = bar_cache_get(&cache, "BTCUSDT", PERIOD_1MIN, types[t], 0.5);
+            ok = ok && bar_series_sync(s, points, n) == 0;
+            points[n - 1] = full;
+            ok = ok && bar_series_sync(s, points, n) == 0;
+            if (n % 211 == 0 || n == CANDLES) {
+                bar_cache_free(&fresh);
+                BarSeries *f = bar_cache_get(&fresh, "BTCUSDT", PERIOD_1MIN, types[t], 0.5);
+                bar_series_sync(f, points, n);
+                if (!same_bars(s, f)) mismatches++;
+            }
+        }
+        BarSeries *s = bar_cache_get(&cache, "BTCUSDT", PERIOD_1MIN, types[t], 0.5);
+        ok = ok && mismatches == 0 && s->rebuilds == 1 && s->candles_folded == CANDLES - 1 &&
+             check_shape(s, CANDLES);
+        printf("  %s: %d bars, box %g, %llu candles folded, %d mismatches\n",
+               t == 0 ? "heikin-ashi" : t == 1 ? "renko" : "range", s->count, s->box,
+               (unsigned long long)s->candles_folded, mismatches);
+    }
+
+    /* A reload (new buffer, same candles) folds nothing; a scrolled window
+     * only drops bars from the front; more history rebuilds. */
+    PricePoint *copy = malloc(sizeof(points));
+    memcpy(copy, points, sizeof(points));
+    BarSeries *ha = bar_cache_get(&cache, "BTCUSDT", PERIOD_1MIN, BAR_HEIKIN_ASHI, 0.5);
+    uint64_t folded = ha->candles_folded;
+    ok = ok && bar_series_sync(ha, copy, CANDLES) == 0 && ha->candles_folded == folded &&
+         ha->rebuilds == 1;
+    ok = ok && bar_series_sync(ha, copy + 500, CANDLES - 500) == 0 && ha->rebuilds == 1 &&
+         ha->count == CANDLES - 500 && ha->bars[0].timestamp == copy[500].timestamp;
+    ok = ok && bar_series_find(ha, copy[700].timestamp) == 200;
+    ok = ok && bar_series_sync(ha, copy, CANDLES) == 0 && ha->rebuilds == 2 &&
+         ha->count == CANDLES;
+
+    BarSeries *renko = bar_cache_get(&cache, "BTCUSDT", PERIOD_1MIN, BAR_RENKO, 0.5);
+    int brick = bar_series_find(renko, copy[CANDLES / 2].timestamp);
+    ok = ok && brick > 0 && renko->bars[brick].close_time >= copy[CANDLES / 2].timestamp &&
+         renko->bars[brick - 1].close_time < copy[CANDLES / 2].timestamp;
+    free(copy);
+
+    /* Each frame re-folds only the live candle. */
+    BarSeries *range = bar_cache_get(&cache, "BTCUSDT", PERIOD_1MIN, BAR_RANGE, 0.5);
+    double started = bench_now();
+    for (int frame = 0; frame < 200000; frame++) {
+        points[CANDLES - 1].close = points[CANDLES - 1].open * (1.0 + (frame % 7) / 1000.0);
+        bar_series_sync(range, points, CANDLES);
+    }
+    double elapsed = bench_now() - started;
+    ok = ok && range->candles_folded == CANDLES - 1;
+    printf("  200k frame syncs in %.3f s\n", elapsed);
+
+    /* The least recently used series makes room for a new key. */
+    for (int k = 0; k < BAR_CACHE_SLOTS; k++) {
+        bar_cache_get(&cache, "ETHUSDT", PERIOD_1MIN, BAR_RENKO, 1.0 + k);
+    }
+    ok = ok && bar_cache_get(&cache, "BTCUSDT", PERIOD_1MIN, BAR_RANGE, 0.5)->rebuilds == 0;
+
+    bar_cache_free(&cache);
+    bar_cache_free(&fresh);
+    return ok && bench_within(elapsed, 2.0) ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_bartransform test_bartransform.c bartransform.c -I. -lm
+if [ $? -eq 0 ] && ./test_bartransform; then
+    echo "Test 18: PASSED"
+else
+    echo "Test 18: FAILED"
+    exit 1
+fi
+
+# Test 19: M4 columns draw the same line as every close
+echo ""
+echo "Test 19: Testing M4 line aggregation..."
+cat > test_m4.c << 'EOF'
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "m4.h"
+#include "test_bench.h"
+
+#define CANDLES 200000
+#define MAX_COLUMNS 256
+#define ROWS 40
+
+static PricePoint points[CANDLES];
+static unsigned char naive[ROWS][MAX_COLUMNS];
+static unsigned char fast[ROWS][MAX_COLUMNS];
+
+/* Every close as a cell, joined to the previous close by a vertical run. */
+static void plot_every_close(int from, int to, int columns, double lo, double hi) {
+    memset(naive, 0, sizeof(naive));
+    int prev_row = -1;
+    for (int i = from; i < to; i++) {
+        int col = m4_column_of(from, to, columns, i);
+        int row = m4_price_row(points[i].close, lo, hi, ROWS);
+        int a = (prev_row < 0) ? row : prev_row;
+        for (int r = (a < row ? a : row); r <= (a > row ? a : row); r++) {
+            naive[r][col] = 1;
+        }
+        prev_row = row;
+    }
+}
+
+int main(void) {
+    srand(13);
+    double price = 100.0;
+    for (int i = 0; i < CANDLES; i++) {
+        price *= exp(((rand() % 2001) - 1000) / 1000.0 * 0.01);
+        if (i % 5000 == 0) price *= 1.2;  /* occasional jumps */
+        points[i].timestamp = 1700000000ull + (uint64_t)i * 60;
+        points[i].close = price;
+    }
+
+    M4Column m4[MAX_COLUMNS];
+    int ok = 1, mismatches = 0;
+    int widths[] = {1, 7, 80, 200, 256};
+    int spans[][2] = {{0, 3}, {10, 250}, {1000, 6000}, {0, CANDLES}, {500, 500 + 256}};
+    for (int w = 0; w < 5; w++) {
+        for (int s = 0; s < 5; s++) {
+            int from = spans[s][0], to = spans[s][1];
+            int columns = m4_aggregate(points, from, to, widths[w], m4);
+            int expect = (to - from < widths[w]) ? to - from : widths[w];
+            if (columns != expect || m4[0].from != from || m4[columns - 1].to != to) ok = 0;
+            double lo = m4[0].min, hi = m4[0].max;
+            for (int c = 1; c < columns; c++) {
+                if (m4[c].from != m4[c - 1].to) ok = 0;
+                lo = fmin(lo, m4[c].min);
+                hi = fmax(hi, m4[c].max);
+            }
+            plot_every_close(from, to, columns, lo, hi);
+            memset(fast, 0, sizeof(fast));
+            for (int c = 0; c < columns; c++) {
+                int top, bottom;
+                m4_column_rows(m4, c, lo, hi, ROWS, &top, &bottom);
+                for (int r = top; r <= bottom; r++) fast[r][c] = 1;
+            }
+            if (memcmp(naive, fast, sizeof(naive)) != 0) mismatches++;
+        }
+    }
+    ok = ok && mismatches == 0;
+
+    /* Column lookup agrees with the buckets. */
+    int columns = m4_aggregate(points, 0, CANDLES, 200, m4);
+    for (int i = 0; i < CANDLES; i += 997) {
+        int c = m4_column_of(0, CANDLES, columns, i);
+        if (c < 0 || m4[c].from > i || m4[c].to <= i) ok = 0;
+    }
+
+    double started = bench_now();
+    double sink = 0.0;
+    for (int frame = 0; frame < 100; frame++) {
+        columns = m4_aggregate(points, 0, CANDLES, 200, m4);
+        sink += m4[frame % columns].max;
+    }
+    double elapsed = bench_now() - started;
+    printf("  25 rasters match the full line (%d mismatches); 100 frames of %d candles in %.3f s%s\n",
+           mismatches, CANDLES, elapsed, sink > 0.0 ? "" : "?");
+    return ok && bench_within(elapsed, 2.0) ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_m4 test_m4.c m4.c -I. -lm
+if [ $? -eq 0 ] && ./test_m4; then
+    echo "Test 19: PASSED"
+else
+    echo "Test 19: FAILED"
+    exit 1
+fi
+
+# Test 20: Per-thread trace rings exported as Chrome trace events
+echo ""
+echo "Test 20: Testing trace export..."
+cat > test_trace.c << 'EOF'
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+#define THREADS 4
+#define SPANS 1000
+
+static void *record(void *arg) {
+    int id = (int)(intptr_t)arg;
+    char name[16];
+    snprintf(name, sizeof(name), "worker %d", id);
+    trace_set_thread_name(name);
+    for (int i = 0; i < SPANS; i++) {
+        uint64_t span = trace_begin();
+        trace_end("work", span, "BTCUSDT");
+    }
+    return NULL;
+}
+
+int main(void) {
+    int ok = trace_begin() == 0;   /* off until opened */
+    trace_end("ignored", 0, NULL);
+    ok = ok && trace_open("test_trace.json") == 0 && trace_open("other.json") != 0;
+    trace_set_thread_name("main");
+
+    pthread_t threads[THREADS];
+    for (int t = 0; t < THREADS; t++) {
+        pthread_create(&threads[t], NULL, record, (void *)(intptr_t)t);
+    }
+    /* The main ring wraps: only the newest spans survive (less the slot
+     * the next span would overwrite). */
+    for (int i = 0; i < TRACE_EVENTS_PER_THREAD + 500; i++) {
+        uint64_t span = trace_begin();
+        trace_end(i < 500 ? "old" : "new", span, i == TRACE_EVENTS_PER_THREAD + 499 ? "a\"b\\c" : NULL);
+    }
+    for (int t = 0; t < THREADS; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    trace_close();
+
+    FILE *fp = fopen("test_trace.json", "r");
+    if (!fp) return 1;
+    char line[512];
+    int work = 0, old = 0, fresh = 0, names = 0, escaped = 0, lines = 0;
+    int per_tid[THREADS + 2] = {0};
+    while (fgets(line, sizeof(line), fp)) {
+        lines++;
+        int tid = 0;
+        const char *t = strstr(line, "\"tid\":");
+        if (t) tid = atoi(t + 6);
+        if (strstr(line, "\"thread_name\"")) names++;
+        if (strstr(line, "\"name\":\"work\"") && strstr(line, "\"args\":{\"detail\":\"BTCUSDT\"}")) {
+            work++;
+            if (tid > 0 && tid < THREADS + 2) per_tid[tid]++;
+        }
+        if (strstr(line, "\"name\":\"old\"")) old++;
+        if (strstr(line, "\"name\":\"new\"")) fresh++;
+        if (strstr(line, "\"detail\":\"a\\\"b\\\\c\"")) escaped++;
+    }
+    fclose(fp);
+    int busy = 0;
+    for (int t = 0; t < THREADS + 2; t++) {
+        if (per_tid[t] == SPANS) busy++;
+    }
+    ok = ok && names == THREADS + 1 && work == THREADS * SPANS && busy == THREADS &&
+         old == 0 && fresh == TRACE_EVENTS_PER_THREAD - 1 && escaped == 1;
+    printf("  %d lines: %d thread names, %d worker spans, %d kept of %d main spans\n", lines,
+           names, work, fresh, TRACE_EVENTS_PER_THREAD + 500);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -O2 -o test_trace test_trace.c trace.c -I. -pthread
+if [ $? -eq 0 ] && ./test_trace; then
+    echo "Test 20: PASSED"
+else
+    echo "Test 20: FAILED"
+    exit 1
+fi
+
+# Test 21: Backfill fills the leading range, interior holes and the tail
+echo ""
+echo "Test 21: Testing backfill ranges..."
+cat > test_backfill.c << 'EOF'
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "candle_store.h"
+#include "commands.h"
+
+#define MAX_REQUESTS 64
+
+static pthread_mutex_t request_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t requested[MAX_REQUESTS][2];
+static int request_count = 0;
+
+/* Exchange stub: one 1m candle per minute up to now, from the first open
+ * time at or after @p start_time. */
+int fetch_historical_range(const char *symbol, Period period,
+                           uint64_t start_time, uint64_t end_time, int limit,
+                           PricePoint **points, int *count) {
+    (void)symbol;
+    (void)period;
+    pthread_mutex_lock(&request_lock);
+    if (request_count < MAX_REQUESTS) {
+        requested[request_count][0] = start_time;
+        requested[request_count][1] = end_time;
+    }
+    request_count++;
+    pthread_mutex_unlock(&request_lock);
+
+    uint64_t now = (uint64_t)time(NULL);
+    *points = calloc((size_t)limit, sizeof(PricePoint));
+    *count = 0;
+    for (uint64_t t = (start_time + 59) / 60 * 60;
+         *count < limit && t <= now && (end_time == 0 || t <= end_time); t += 60) {
+        PricePoint *p = &(*points)[(*count)++];
+        p->timestamp = t;
+        p->close_time = t + 59;
+        p->open = p->high = p->low = p->close = 100.0 + (double)(t % 97);
+        p->volume = 1.0;
+    }
+    return 0;
+}
+
+static int was_requested(uint64_t start, uint64_t end) {
+    for (int i = 0; i < request_count && i < MAX_REQUESTS; i++) {
+        if (requested[i][0] == start && (end == 0 || requested[i][1] == end)) return 1;
+    }
+    return 0;
+}
+
+static void seed(CandleStore *store, uint64_t from, uint64_t to) {
+    for (uint64_t t = from; t < to; t += 60) {
+        PricePoint p = {0};
+        p.timestamp = t;
+        p.close_time = t + 59;
+        p.open = p.high = p.low = p.close = 100.0 + (double)(t % 97);
+        CandleRecord record;
+        candle_record_from_point(&record, &p);
+        candle_store_merge(store, &record, 1);
+    }
+}
+
+int main(void) {
+    /* Keep the run inside one minute so both sides agree on --days 1. */
+    if (time(NULL) % 60 >= 50) sleep(12);
+    uint64_t now = (uint64_t)time(NULL);
+    uint64_t from = (now - 86400) / 60 * 60;
+    uint64_t hour = 3600;
+
+    /* A shorter earlier run: 6h..8h and 9h..12h stored, 8h..9h missing. */
+    CandleStore store;
+    if (candle_store_open(&store, "BFTUSDT", PERIOD_1MIN, true) != 0) return 1;
+    seed(&store, from + 6 * hour, from + 8 * hour);
+    seed(&store, from + 9 * hour, from + 12 * hour);
+    candle_store_close(&store);
+
+    char *argv[] = {"backfill", "--interval", "1m", "--days", "1", "--jobs", "1", "BFTUSDT"};
+    int rc = command_backfill(8, argv);
+
+    if (candle_store_open(&store, "BFTUSDT", PERIOD_1MIN, false) != 0) return 1;
+    int ok = rc == 0 && store.count > 0 && store.records[0].timestamp == from &&
+             store.records[store.count - 1].timestamp >= now / 60 * 60 - 60;
+    for (uint64_t i = 1; ok && i < store.count; i++) {
+        ok = store.records[i].timestamp == store.records[i - 1].timestamp + 60;
+    }
+    ok = ok && was_requested(from, from + 6 * hour - 1) &&
+         was_requested(from + 8 * hour, from + 9 * hour - 1) &&
+         was_requested(from + 12 * hour - 60, 0);
+    printf("  %d requests, %llu contiguous candles from the requested start\n",
+           request_count, (unsigned long long)store.count);
+    candle_store_close(&store);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -o test_backfill test_backfill.c backfill.c candle_gaps.c candle_store.c config.c period.c \
+    cli_common.c -I. -pthread -lcurl -lz
+if [ $? -eq 0 ] && ./test_backfill 2>/dev/null; then
+    echo "Test 21: PASSED"
+else
+    echo "Test 21: FAILED"
+    exit 1
+fi
+
+# Test 22: Query aggregates the imported fixtures on bucket boundaries
+echo ""
+echo "Test 22: Testing candle queries..."
+cat > test_query.c << 'EOF'
+#include <stdlib.h>
+#include <string.h>
+#include "candle_store.h"
+#include "commands.h"
+
+/* SEEDUSDT 1m: 10000 candles from Monday 2024-01-01, one weekly bucket. */
+static int seed(void) {
+    const size_t n = 10000;
+    CandleRecord *records = calloc(n, sizeof(CandleRecord));
+    CandleStore store;
+    if (!records || candle_store_open(&store, "SEEDUSDT", PERIOD_1MIN, true) != 0) return 1;
+    for (size_t i = 0; i < n; i++) {
+        records[i].timestamp = 1704067200 + i * 60;
+        records[i].close_time = records[i].timestamp + 59;
+        records[i].open = (double)(i + 1);
+        records[i].high = (double)(i + 2);
+        records[i].low = i == 5000 ? 0.5 : (double)i + 1;
+        records[i].close = (double)(i + 1);
+        records[i].volume = 1.0;
+        records[i].trade_count = i;
+    }
+    long added = candle_store_merge(&store, records, n);
+    candle_store_close(&store);
+    free(records);
+    return added == (long)n ? 0 : 1;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc > 1 && strcmp(argv[1], "seed") == 0) return seed();
+    return command_query(argc - 1, argv + 1);  /* argv[1] is the sub-command */
+}
+EOF
+
+gcc -o test_query test_query.c query.c candle_store.c config.c period.c cli_common.c -I. -pthread
+if [ $? -ne 0 ] || ! ./test_query seed; then
+    echo "Test 22: FAILED"
+    exit 1
+fi
+# ETHUSDT 1h holds 00:00-02:00 and 04:00-05:00 (03:00 was rejected on import).
+agg_eth=$(./test_query query ETHUSDT --interval 1h --agg 4h --csv)
+# From 00:05, the 15m bucket still opens at 00:00 but holds 00:05-00:14 only.
+agg_btc=$(./test_query query BTCUSDT --interval 1m --from 1704067500 --agg 15m --csv)
+stats=$(./test_query query ETHUSDT --interval 1h --stats)
+# One bucket larger than the reduction block: extremes and sums span blocks.
+agg_seed=$(./test_query query SEEDUSDT --interval 1m --agg 1w --csv)
+echo "$agg_eth" | sed 's/^/  /'
+if [ "$(echo "$agg_eth" | wc -l)" -eq 3 ] &&
+   echo "$agg_eth" | grep -q '^1735689600,3332.5,3335.03,3326.05,3331.74,106.71033,[0-9.]*,689,' &&
+   echo "$agg_eth" | grep -q '^1735704000,3327.42,3328.77,3322.47,3327.05,65.01461,[0-9.]*,1026,' &&
+   [ "$(echo "$agg_btc" | wc -l)" -eq 2 ] &&
+   echo "$agg_btc" | grep -q '^1704067200,42273.11,42308.25,42126.61,42162.09,[0-9.]*,[0-9.]*,5877,' &&
+   echo "$stats" | grep -q '^ETHUSDT 1h: 5 rows' &&
+   echo "$stats" | grep -q 'open -> close : 3332.5 -> 3327.05 (-0.16%)' &&
+   echo "$stats" | grep -q 'highest high  : 3335.03 at 2025-01-01 02:00:00' &&
+   echo "$stats" | grep -q 'lowest low    : 3322.47 at 2025-01-01 05:00:00' &&
+   echo "$stats" | grep -q 'max range     : 8.31 (0.25%) at 2025-01-01 02:00:00' &&
+   echo "$stats" | grep -q '1715 trades' &&
+   [ "$(echo "$agg_seed" | wc -l)" -eq 2 ] &&
+   echo "$agg_seed" | grep -q '^1704067200,1,10001,0.5,10000,10000,0,49995000,'; then
+    echo "Test 22: PASSED"
+else
+    echo "$agg_btc"
+    echo "$stats"
+    echo "$agg_seed"
+    echo "Test 22: FAILED"
+    exit 1
+fi
+
+# Test 23: Tick history ring wraps and cuts at the since timestamp
+echo ""
+echo "Test 23: Testing the in-memory tick history..."
+cat > test_tickring.c << 'EOF'
+#include <stdio.h>
+#include <string.h>
+#include "tick_history.h"
+
+#define APPENDS 10000
+
+static TickSample out[2 * TICK_HISTORY_CAPACITY];
+
+/* Samples [first, first + n) in order, as appended below. */
+static int in_order(const TickSample *s, int n, uint64_t first) {
+    for (int i = 0; i < n; i++) {
+        if (s[i].timestamp != 1000 + first + (uint64_t)i ||
+            s[i].price != 100.0 + (double)(first + (uint64_t)i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int main(void) {
+    Config config;
+    memset(&config, 0, sizeof(config));
+    config.symbol_count = 2;
+    snprintf(config.symbols[0], MAX_SYMBOL_LEN, "AAAUSDT");
+    snprintf(config.symbols[1], MAX_SYMBOL_LEN, "BBBUSDT");
+
+    TickHistory history;
+    if (tick_history_init(&history, &config, NULL) != 0) return 1;
+    for (int i = 0; i < APPENDS; i++) {
+        TickerData row;
+        memset(&row, 0, sizeof(row));
+        row.timestamp = 1000 + (uint64_t)i;
+        row.price = 100.0 + i;
+        tick_history_append(&history, 0, &row);
+        if (i < 100) tick_history_append(&history, 1, &row);
+    }
+
+    const uint64_t oldest = APPENDS - TICK_HISTORY_CAPACITY;
+    int n = tick_history_copy_since(&history, 0, 0, out, 2 * TICK_HISTORY_CAPACITY);
+    int ok = n == TICK_HISTORY_CAPACITY && in_order(out, n, oldest);
+    /* Just before the oldest kept sample: still everything. */
+    ok = ok && tick_history_copy_since(&history, 0, 1000 + oldest - 1, out,
+                                       2 * TICK_HISTORY_CAPACITY) == TICK_HISTORY_CAPACITY;
+    /* Strictly newer than the cut, across the wrap point of the ring. */
+    n = tick_history_copy_since(&history, 0, 1000 + 8000, out, 2 * TICK_HISTORY_CAPACITY);
+    ok = ok && n == 1999 && in_order(out, n, 8001);
+    /* A short buffer keeps the newest samples. */
+    n = tick_history_copy_since(&history, 0, 0, out, 10);
+    ok = ok && n == 10 && in_order(out, n, APPENDS - 10);
+    ok = ok && tick_history_copy_since(&history, 0, 1000 + APPENDS - 1, out, 10) == 0;
+    /* The other symbol's ring has not wrapped. */
+    n = tick_history_copy_since(&history, 1, 0, out, 2 * TICK_HISTORY_CAPACITY);
+    ok = ok && n == 100 && in_order(out, n, 0);
+    ok = ok && tick_history_copy_since(&history, 2, 0, out, 10) == 0;
+    printf("  %d appends, %d kept, cut after 8000 keeps 1999\n", APPENDS, TICK_HISTORY_CAPACITY);
+    tick_history_destroy(&history);
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -o test_tickring test_tickring.c tick_history.c storage_io.c trace.c config.c -I. -pthread
+if [ $? -eq 0 ] && ./test_tickring; then
+    echo "Test 23: PASSED"
+else
+    echo "Test 23: FAILED"
+    exit 1
+fi
+
+echo "Test 24: Testing pointer-motion coalescing..."
+cat > test_ui_mouse.c << 'EOF'
+#include <stdio.h>
+#include <string.h>
+#include "ui_internal.h"
+
+void reset_chart_overlays(void) {}
+
+/* ungetch()/ungetmouse() are LIFO, so queue events newest first. */
+static void push_mouse(int x, int y, mmask_t bstate) {
+    MEVENT ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.x = x;
+    ev.y = y;
+    ev.bstate = bstate;
+    ungetmouse(&ev);
+}
+
+int main(void) {
+    FILE *out = fopen("/dev/null", "w");
+    FILE *in = fopen("/dev/null", "r");
+    if (!out || !in || !newterm("xterm", out, in)) return 1;
+    main_win = newwin(24, 80, 0, 0);
+    keypad(main_win, TRUE);
+    mousemask(ALL_MOUSE_EVENTS | REPORT_MOUSE_POSITION, NULL);
+
+    /* Two motions collapse to the last; the click and key stay queued. */
+    int x = -1, y = -1;
+    MEVENT ev;
+    ungetch('q');
+    push_mouse(7, 7, BUTTON1_PRESSED);
+    push_mouse(5, 6, REPORT_MOUSE_POSITION);
+    push_mouse(1, 1, REPORT_MOUSE_POSITION);
+    int dropped = ui_coalesce_pointer_motion(&x, &y);
+    int ok = dropped == 2 && x == 5 && y == 6;
+    wtimeout(main_win, 0);
+    ok = ok && wgetch(main_win) == KEY_MOUSE && getmouse(&ev) == OK &&
+         ev.bstate == BUTTON1_PRESSED && ev.x == 7 && ev.y == 7;
+    ok = ok && wgetch(main_win) == 'q' && wgetch(main_win) == ERR;
+    printf("  motion, motion, click, key: %d dropped, last at %d,%d\n", dropped, x, y);
+
+    /* A key after the motion is handed back untouched. */
+    ungetch('a');
+    push_mouse(3, 4, REPORT_MOUSE_POSITION);
+    ok = ok && ui_coalesce_pointer_motion(&x, &y) == 1 && x == 3 && y == 4;
+    wtimeout(main_win, 0);
+    ok = ok && wgetch(main_win) == 'a';
+
+    /* Nothing queued: nothing dropped, position untouched. */
+    ok = ok && ui_coalesce_pointer_motion(&x, &y) == 0 && x == 3 && y == 4;
+
+    delwin(main_win);
+    endwin();
+    return ok ? 0 : 1;
+}
+EOF
+
+gcc -o test_ui_mouse test_ui_mouse.c ui_core.c -I. -lncursesw -pthread
+if [ $? -eq 0 ] && TERM=xterm ./test_ui_mouse; then
+    echo "Test 24: PASSED"
+else
+    echo "Test 24: FAILED"
+    exit 1
+fi
+
 # Cleanup
-rm -f test_config test_config.c
+rm -f test_config test_config.c test_import test_import.c test_export test_export.c \
+    test_gaps test_gaps.c test_storage test_storage.c test_portfolio test_portfolio.c \
+    test_synthetic test_synthetic.c test_basket test_basket.c test_correlation test_correlation.c \
+    test_movestats test_movestats.c test_patterns test_patterns.c test_backtest test_backtest.c \
+    test_arbitrage test_arbitrage.c test_tradeflow test_tradeflow.c test_volprofile test_volprofile.c \
+    test_rangestats test_rangestats.c test_tradecandles test_tradecandles.c \
+    test_bartransform test_bartransform.c test_m4 test_m4.c \
+    test_trace test_trace.c test_trace.json test_backfill test_backfill.c test_bench.h \
+    test_query test_query.c test_tickring test_tickring.c test_ui_mouse test_ui_mouse.c
 rm -rf "$HOME"
 
 echo ""
@@ -0,0 +1,327 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file tick_history.c
+ * @brief Append-only per-symbol tick history (in-memory ring + on-disk log).
+ *
+ * Design notes:
+ * - Every published ticker row becomes one ::TickSample.
+ * - The ring keeps the most recent ::TICK_HISTORY_CAPACITY samples for
+ *   sparklines and intraday statistics.
+ * - With `tick_log on`, samples are also appended to
+ *   `$HOME/.cticker/ticks/<SYMBOL>.ticks`, a header plus fixed-size records.
+ *   Appends are queued on the shared ::StorageIO writer, so the fetch thread
+ *   never waits for the disk.
+ * - The header count is written only after the record (same fd, in order),
+ *   so a process crash never exposes a torn record to readers. Nothing
+ *   orders the two on disk between `storage_sync` points, so after a power
+ *   loss the count may run past the records that were written; opening the
+ *   log clamps it to the whole records present in the file.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "tick_history.h"
+
+#define TICK_LOG_MAGIC "CTTICK01"
+#define TICK_LOG_SUBDIR "ticks"
+
+// Build the log path for a symbol, creating the ticks directory.
+static int tick_log_path(const char *symbol, char *buf, size_t size) {
+    char dir[512];
+    if (config_data_path(dir, sizeof(dir), TICK_LOG_SUBDIR) != 0) {
+        return -1;
+    }
+    int written = snprintf(buf, size, "%s/%s.ticks", dir, symbol);
+    if (written < 0 || (size_t)written >= size) {
+        return -1;
+    }
+    return 0;
+}
+
+// Byte length of a log file holding @p capacity records.
+static size_t tick_log_bytes(uint64_t capacity) {
+    return sizeof(TickLogHeader) + (size_t)capacity * sizeof(TickSample);
+}
+
+// Check the header of a mapped or read log.
+static bool tick_log_header_valid(const TickLogHeader *header) {
+    if (memcmp(header->magic, TICK_LOG_MAGIC, sizeof(header->magic)) != 0) {
+        return false;
+    }
+    return header->record_size == sizeof(TickSample);
+}
+
+// Header count limited to the whole records a @p file_size byte log holds.
+static uint64_t tick_log_records(uint64_t count, size_t file_size) {
+    uint64_t present = (file_size - sizeof(TickLogHeader)) / sizeof(TickSample);
+    return count < present ? count : present;
+}
+
+// Release the descriptor of a series' log after pending writes land.
+static void tick_log_close(TickHistory *history, TickSeries *series) {
+    if (series->log_fd >= 0) {
+        if (history->storage) {
+            storage_close(history->storage, series->log_fd);
+        } else {
+            close(series->log_fd);
+        }
+        series->log_fd = -1;
+    }
+}
+
+// Open (or create) the log for a symbol and position it for appending.
+static int tick_log_open(TickHistory *history, TickSeries *series, const char *symbol) {
+    char path[768];
+    if (tick_log_path(symbol, path, sizeof(path)) != 0) {
+        return -1;
+    }
+
+    series->log_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (series->log_fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(series->log_fd, &st) != 0) {
+        tick_log_close(history, series);
+        return -1;
+    }
+
+    uint64_t count = 0;
+    if ((size_t)st.st_size >= sizeof(TickLogHeader)) {
+        TickLogHeader header;
+        if (pread(series->log_fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+            !tick_log_header_valid(&header)) {
+            /* Never clobber a file we do not understand. */
+            tick_log_close(history, series);
+            return -1;
+        }
+        count = tick_log_records(header.count, (size_t)st.st_size);
+    } else if (st.st_size != 0) {
+        tick_log_close(history, series);
+        return -1;
+    } else {
+        TickLogHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, TICK_LOG_MAGIC, sizeof(header.magic));
+        header.record_size = sizeof(TickSample);
+        if (pwrite(series->log_fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+            tick_log_close(history, series);
+            return -1;
+        }
+    }
+
+    series->log_count = count;
+    return 0;
+}
+
+/**
+ * @brief Queue one record plus the header count that publishes it.
+ *
+ * Both writes go to the same fd and therefore land in order. When the
+ * writer is saturated the sample is skipped on disk (the ring still has it)
+ * instead of stalling the fetch thread.
+ */
+static void tick_log_append(TickHistory *history, TickSeries *series, const TickSample *sample) {
+    if (series->log_fd < 0) {
+        return;
+    }
+
+    uint64_t offset = tick_log_bytes(series->log_count);
+    uint64_t count = series->log_count + 1;
+    uint64_t count_offset = offsetof(TickLogHeader, count);
+    if (!history->storage) {
+        if (pwrite(series->log_fd, sample, sizeof(*sample), (off_t)offset) ==
+                (ssize_t)sizeof(*sample) &&
+            pwrite(series->log_fd, &count, sizeof(count), (off_t)count_offset) ==
+                (ssize_t)sizeof(count)) {
+            series->log_count = count;
+        }
+        return;
+    }
+
+    if (storage_write(history->storage, series->log_fd, offset, (void *)sample, sizeof(*sample),
+                      STORAGE_WRITE_COPY | STORAGE_WRITE_NOWAIT) != 0) {
+        return;
+    }
+    series->log_count = count;
+    storage_write(history->storage, series->log_fd, count_offset, &count, sizeof(count),
+                  STORAGE_WRITE_COPY | STORAGE_WRITE_NOWAIT);
+}
+
+int tick_history_init(TickHistory *history, const Config *config, StorageIO *storage) {
+    if (!history || !config) {
+        return -1;
+    }
+
+    history->storage = storage;
+    history->series_count = config->symbol_count;
+    history->series = calloc((size_t)history->series_count, sizeof(TickSeries));
+    if (!history->series) {
+        history->series_count = 0;
+        return -1;
+    }
+
+    if (pthread_mutex_init(&history->mutex, NULL) != 0) {
+        free(history->series);
+        history->series = NULL;
+        history->series_count = 0;
+        return -1;
+    }
+
+    for (int i = 0; i < history->series_count; i++) {
+        TickSeries *series = &history->series[i];
+        series->log_fd = -1;
+        if (config->tick_log) {
+            tick_log_open(history, series, config->symbols[i]);
+        }
+    }
+    return 0;
+}
+
+void tick_history_destroy(TickHistory *history) {
+    if (!history || !history->series) {
+        return;
+    }
+
+    for (int i = 0; i < history->series_count; i++) {
+        tick_log_close(history, &history->series[i]);
+    }
+
+    pthread_mutex_destroy(&history->mutex);
+    free(history->series);
+    history->series = NULL;
+    history->series_count = 0;
+}
+
+void tick_history_append(TickHistory *history, int index, const TickerData *row) {
+    if (!history || !history->series || !row || index < 0 || index >= history->series_count) {
+        return;
+    }
+
+    TickSample sample = {
+        .timestamp = row->timestamp,
+        .price = row->price,
+        .volume_base = row->volume_base,
+        .volume_quote = row->volume_quote,
+    };
+
+    pthread_mutex_lock(&history->mutex);
+    TickSeries *series = &history->series[index];
+    series->ring[series->total % TICK_HISTORY_CAPACITY] = sample;
+    series->total++;
+    tick_log_append(history, series, &sample);
+    pthread_mutex_unlock(&history->mutex);
+}
+
+int tick_history_copy_since(TickHistory *history, int index, uint64_t since,
+                            TickSample *out, int max) {
+    if (!history || !history->series || !out || max <= 0 ||
+        index < 0 || index >= history->series_count) {
+        return 0;
+    }
+
+    pthread_mutex_lock(&history->mutex);
+    const TickSeries *series = &history->series[index];
+    uint64_t available = series->total < TICK_HISTORY_CAPACITY
+        ? series->total
+        : TICK_HISTORY_CAPACITY;
+
+    /* Walk backwards to find how many samples are newer than @p since. */
+    uint64_t wanted = 0;
+    while (wanted < available && wanted < (uint64_t)max) {
+        uint64_t pos = (series->total - 1 - wanted) % TICK_HISTORY_CAPACITY;
+        if (series->ring[pos].timestamp <= since) {
+            break;
+        }
+        wanted++;
+    }
+
+    for (uint64_t i = 0; i < wanted; i++) {
+        uint64_t pos = (series->total - wanted + i) % TICK_HISTORY_CAPACITY;
+        out[i] = series->ring[pos];
+    }
+    pthread_mutex_unlock(&history->mutex);
+    return (int)wanted;
+}
+
+int tick_log_open_view(const char *symbol, TickLogView *view) {
+    if (!symbol || !view) {
+        return -1;
+    }
+    memset(view, 0, sizeof(*view));
+
+    char path[768];
+    if (tick_log_path(symbol, path, sizeof(path)) != 0) {
+        return -1;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TickLogHeader)) {
+        close(fd);
+        return -1;
+    }
+
+    void *base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return -1;
+    }
+
+    const TickLogHeader *header = base;
+    if (!tick_log_header_valid(header)) {
+        munmap(base, (size_t)st.st_size);
+        return -1;
+    }
+    uint64_t count = __atomic_load_n(&header->count, __ATOMIC_ACQUIRE);
+    count = tick_log_records(count, (size_t)st.st_size);
+
+    view->base = base;
+    view->length = (size_t)st.st_size;
+    view->samples = (const TickSample *)(header + 1);
+    view->count = count;
+    return 0;
+}
+
+void tick_log_close_view(TickLogView *view) {
+    if (!view || !view->base) {
+        return;
+    }
+    munmap(view->base, view->length);
+    memset(view, 0, sizeof(*view));
+}
@@ -0,0 +1,134 @@
+#ifndef CTICKER_TICK_HISTORY_H
+#define CTICKER_TICK_HISTORY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "cticker.h"
+#include "storage_io.h"
+
+/** Samples retained in memory per symbol (~5.7 hours at the 5 s cadence). */
+#define TICK_HISTORY_CAPACITY 4096
+
+/**
+ * @brief One timestamped ticker sample.
+ *
+ * This is also the on-disk record layout of the tick log, so keep it
+ * fixed-size and free of pointers.
+ */
+typedef struct {
+    /** Sample timestamp in seconds since Unix epoch. */
+    uint64_t timestamp;
+    /** Last traded price at sample time. */
+    double price;
+    /** Rolling 24h base asset volume at sample time. */
+    double volume_base;
+    /** Rolling 24h quote asset volume at sample time. */
+    double volume_quote;
+} TickSample;
+
+/**
+ * @brief Header of a memory-mapped tick log file.
+ */
+typedef struct {
+    /** File magic ("CTTICK01"). */
+    char magic[8];
+    /** Size of one record in bytes (sizeof(TickSample)). */
+    uint32_t record_size;
+    /** Reserved for future use. */
+    uint32_t reserved;
+    /** Number of committed records following the header. */
+    uint64_t count;
+    /** Pad the header to 64 bytes so records stay cache-line aligned. */
+    uint8_t padding[40];
+} TickLogHeader;
+
+/**
+ * @brief Append-only sample history for one symbol.
+ */
+typedef struct {
+    /** In-memory ring of the most recent samples. */
+    TickSample ring[TICK_HISTORY_CAPACITY];
+    /** Total number of samples appended (ring index = total % capacity). */
+    uint64_t total;
+    /** Tick log file descriptor, or -1 when disk logging is disabled. */
+    int log_fd;
+    /** Records written (or queued) to the tick log. */
+    uint64_t log_count;
+} TickSeries;
+
+/**
+ * @brief Per-symbol tick histories for the whole watchlist.
+ *
+ * Writers (fetch thread) and readers (UI, exporters) synchronize on
+ * ::TickHistory::mutex, which is independent of the ticker data mutex.
+ */
+typedef struct {
+    /** Mutex guarding all series. */
+    pthread_mutex_t mutex;
+    /** One series per configured symbol (config order). */
+    TickSeries *series;
+    /** Number of entries in ::TickHistory::series. */
+    int series_count;
+    /** Background writer for tick logs (NULL writes synchronously). */
+    StorageIO *storage;
+} TickHistory;
+
+/**
+ * @brief Read-only view of a tick log on disk.
+ */
+typedef struct {
+    /** Mapped file base (NULL when not mapped). */
+    void *base;
+    /** Mapped length in bytes. */
+    size_t length;
+    /** First record. */
+    const TickSample *samples;
+    /** Number of committed records. */
+    uint64_t count;
+} TickLogView;
+
+/**
+ * @brief Allocate per-symbol rings and open tick logs when enabled.
+ *
+ * A tick log that cannot be opened only disables disk logging for that
+ * symbol; in-memory history keeps working.
+ *
+ * @param[in] storage Writer for log appends; must outlive the history.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int tick_history_init(TickHistory *history, const Config *config, StorageIO *storage);
+
+/**
+ * @brief Flush and close logs and release all memory.
+ */
+void tick_history_destroy(TickHistory *history);
+
+/**
+ * @brief Append a sample taken from a freshly published ticker row.
+ */
+void tick_history_append(TickHistory *history, int index, const TickerData *row);
+
+/**
+ * @brief Copy samples newer than @p since (oldest first).
+ *
+ * @param[out] out Destination buffer.
+ * @param[in] max Capacity of @p out; the newest samples win when it is short.
+ * @return Number of samples copied.
+ */
+int tick_history_copy_since(TickHistory *history, int index, uint64_t since,
+                            TickSample *out, int max);
+
+/**
+ * @brief Map the on-disk tick log of @p symbol read-only.
+ * @return 0 on success, -1 when the log does not exist or is invalid.
+ */
+int tick_log_open_view(const char *symbol, TickLogView *view);
+
+/**
+ * @brief Release a view obtained from tick_log_open_view().
+ */
+void tick_log_close_view(TickLogView *view);
+
+#endif
@@ -0,0 +1,260 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file trace.c
+ * @brief Opt-in span tracer writing Chrome trace-event JSON.
+ *
+ * Each thread records into its own ring buffer, registered once on a
+ * lock-free list, so recording takes no lock and never waits for the
+ * writer. The file is rewritten at exit and whenever SIGUSR1 arrives (the
+ * UI loop polls for the request) and opens in Perfetto or chrome://tracing.
+ */
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "trace.h"
+
+typedef struct {
+    const char *name;
+    uint64_t start_us;
+    uint64_t duration_us;
+    char detail[TRACE_DETAIL_LEN];
+} TraceEvent;
+
+// One thread's spans. Only the owner writes events and advances @ref head
+// (with release order), so the writer can copy a consistent window.
+typedef struct TraceBuffer {
+    struct TraceBuffer *next;
+    int tid;
+    char name[32];
+    _Atomic uint64_t head;
+    TraceEvent events[TRACE_EVENTS_PER_THREAD];
+} TraceBuffer;
+
+static atomic_bool trace_on = false;
+static char trace_path[4096];
+static uint64_t trace_origin_us = 0;
+static _Atomic(TraceBuffer *) trace_buffers = NULL;
+static atomic_int trace_next_tid = 0;
+static volatile sig_atomic_t trace_dump_requested = 0;
+static pthread_mutex_t trace_write_mutex = PTHREAD_MUTEX_INITIALIZER;
+static _Thread_local TraceBuffer *trace_local = NULL;
+
+// Monotonic microseconds (never 0, which marks "not tracing").
+static uint64_t trace_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u + 1u;
+}
+
+// SIGUSR1: only flag the request; trace_poll() does the writing.
+static void trace_signal_handler(int signo) {
+    (void)signo;
+    trace_dump_requested = 1;
+}
+
+// Enable tracing and hook SIGUSR1.
+int trace_open(const char *path) {
+    if (atomic_load(&trace_on) || !path || !path[0]) {
+        return -1;
+    }
+    snprintf(trace_path, sizeof(trace_path), "%s", path);
+    trace_origin_us = trace_now_us();
+    atomic_store(&trace_on, true);
+    signal(SIGUSR1, trace_signal_handler);
+    return 0;
+}
+
+bool trace_enabled(void) {
+    return atomic_load_explicit(&trace_on, memory_order_relaxed);
+}
+
+// Start time of a span, or 0 when tracing is off.
+uint64_t trace_begin(void) {
+    return trace_enabled() ? trace_now_us() : 0;
+}
+
+// The calling thread's buffer, created and pushed onto the list on first use.
+static TraceBuffer *trace_thread_buffer(void) {
+    if (trace_local) {
+        return trace_local;
+    }
+    TraceBuffer *buffer = calloc(1, sizeof(*buffer));
+    if (!buffer) {
+        return NULL;
+    }
+    buffer->tid = atomic_fetch_add(&trace_next_tid, 1) + 1;
+    snprintf(buffer->name, sizeof(buffer->name), "thread %d", buffer->tid);
+    TraceBuffer *head = atomic_load(&trace_buffers);
+    do {
+        buffer->next = head;
+    } while (!atomic_compare_exchange_weak(&trace_buffers, &head, buffer));
+    trace_local = buffer;
+    return buffer;
+}
+
+// Record a finished span in the calling thread's ring.
+void trace_end(const char *name, uint64_t start, const char *detail) {
+    if (start == 0) {
+        return;
+    }
+    uint64_t end = trace_now_us();
+    TraceBuffer *buffer = trace_thread_buffer();
+    if (!buffer) {
+        return;
+    }
+    uint64_t head = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    TraceEvent *event = &buffer->events[head % TRACE_EVENTS_PER_THREAD];
+    event->name = name;
+    event->start_us = start;
+    event->duration_us = end - start;
+    snprintf(event->detail, sizeof(event->detail), "%s", detail ? detail : "");
+    atomic_store_explicit(&buffer->head, head + 1, memory_order_release);
+}
+
+// Name the calling thread (call once, before its first spans).
+void trace_set_thread_name(const char *name) {
+    if (!trace_enabled()) {
+        return;
+    }
+    TraceBuffer *buffer = trace_thread_buffer();
+    if (buffer) {
+        snprintf(buffer->name, sizeof(buffer->name), "%s", name);
+    }
+}
+
+// Write @p text as a JSON string literal.
+static void trace_write_string(FILE *fp, const char *text) {
+    fputc('"', fp);
+    for (const unsigned char *p = (const unsigned char *)text; *p; ++p) {
+        if (*p == '"' || *p == '\\') {
+            fprintf(fp, "\\%c", *p);
+        } else if (*p < 0x20) {
+            fprintf(fp, "\\u%04x", *p);
+        } else {
+            fputc(*p, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+// Copy the spans of @p buffer that were not overwritten while copying and
+// write them as complete ("X") events.
+static void trace_write_buffer(FILE *fp, const TraceBuffer *buffer, TraceEvent *scratch,
+                               bool *first) {
+    uint64_t head = atomic_load_explicit(&buffer->head, memory_order_acquire);
+    uint64_t from = (head > TRACE_EVENTS_PER_THREAD) ? head - TRACE_EVENTS_PER_THREAD : 0;
+    for (uint64_t i = from; i < head; ++i) {
+        scratch[i - from] = buffer->events[i % TRACE_EVENTS_PER_THREAD];
+    }
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t now = atomic_load_explicit(&buffer->head, memory_order_relaxed);
+    // Slot i is reused by span i + capacity, which may be in progress once
+    // the head has reached it.
+    uint64_t valid = (now >= TRACE_EVENTS_PER_THREAD) ? now - TRACE_EVENTS_PER_THREAD + 1 : 0;
+
+    fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+                "\"args\":{\"name\":", *first ? "" : ",\n", buffer->tid);
+    trace_write_string(fp, buffer->name);
+    fputs("}}", fp);
+    *first = false;
+    for (uint64_t i = (from > valid) ? from : valid; i < head; ++i) {
+        const TraceEvent *event = &scratch[i - from];
+        fputs(",\n{\"name\":", fp);
+        trace_write_string(fp, event->name);
+        fprintf(fp, ",\"cat\":\"cticker\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,"
+                    "\"ts\":%llu,\"dur\":%llu",
+                buffer->tid, (unsigned long long)(event->start_us - trace_origin_us),
+                (unsigned long long)event->duration_us);
+        if (event->detail[0]) {
+            fputs(",\"args\":{\"detail\":", fp);
+            trace_write_string(fp, event->detail);
+            fputc('}', fp);
+        }
+        fputc('}', fp);
+    }
+}
+
+// Write all buffers to a temporary file and move it over the trace path.
+int trace_write(void) {
+    if (!trace_enabled()) {
+        return -1;
+    }
+    TraceEvent *scratch = malloc(sizeof(TraceEvent) * TRACE_EVENTS_PER_THREAD);
+    if (!scratch) {
+        return -1;
+    }
+    pthread_mutex_lock(&trace_write_mutex);
+    char tmp_path[sizeof(trace_path) + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", trace_path);
+    int rc = -1;
+    FILE *fp = fopen(tmp_path, "w");
+    if (fp) {
+        bool first = true;
+        fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", fp);
+        for (const TraceBuffer *buffer = atomic_load(&trace_buffers); buffer;
+             buffer = buffer->next) {
+            trace_write_buffer(fp, buffer, scratch, &first);
+        }
+        fputs("\n]}\n", fp);
+        rc = (fclose(fp) == 0 && rename(tmp_path, trace_path) == 0) ? 0 : -1;
+        if (rc != 0) {
+            remove(tmp_path);
+        }
+    }
+    pthread_mutex_unlock(&trace_write_mutex);
+    free(scratch);
+    return rc;
+}
+
+// Honour a SIGUSR1 dump request.
+void trace_poll(void) {
+    if (trace_dump_requested) {
+        trace_dump_requested = 0;
+        trace_write();
+    }
+}
+
+// Final write, then free the buffers of every (joined) thread.
+void trace_close(void) {
+    if (!trace_enabled()) {
+        return;
+    }
+    trace_write();
+    atomic_store(&trace_on, false);
+    signal(SIGUSR1, SIG_DFL);
+    TraceBuffer *buffer = atomic_exchange(&trace_buffers, NULL);
+    while (buffer) {
+        TraceBuffer *next = buffer->next;
+        free(buffer);
+        buffer = next;
+    }
+    trace_local = NULL;
+}
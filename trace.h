@@ -0,0 +1,60 @@
+#ifndef CTICKER_TRACE_H
+#define CTICKER_TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/** Spans kept per thread; older ones are overwritten. */
+#define TRACE_EVENTS_PER_THREAD 65536
+/** Bytes of span detail (symbol, endpoint) kept, including the terminator. */
+#define TRACE_DETAIL_LEN 32
+
+/**
+ * @brief Enable tracing into @p path and install the SIGUSR1 dump handler.
+ * @return 0 on success, -1 when already enabled or out of memory.
+ */
+int trace_open(const char *path);
+
+/**
+ * @brief Whether trace_open() has enabled tracing.
+ */
+bool trace_enabled(void);
+
+/**
+ * @brief Start a span.
+ * @return Opaque start time for trace_end(), 0 when tracing is off.
+ */
+uint64_t trace_begin(void);
+
+/**
+ * @brief Record the span started at @p start (no-op when it is 0).
+ *
+ * @param name Static string naming the span (kept by pointer).
+ * @param detail Optional text shown in the span's args (copied, truncated).
+ */
+void trace_end(const char *name, uint64_t start, const char *detail);
+
+/**
+ * @brief Name the calling thread in the trace (default "thread N").
+ */
+void trace_set_thread_name(const char *name);
+
+/**
+ * @brief Write the trace file now if a dump was requested by signal.
+ */
+void trace_poll(void);
+
+/**
+ * @brief Write every thread's recorded spans to the trace file.
+ * @return 0 on success, -1 when tracing is off or the file cannot be written.
+ */
+int trace_write(void);
+
+/**
+ * @brief Write the trace a last time and release the buffers.
+ *
+ * Call after the traced threads have been joined.
+ */
+void trace_close(void);
+
+#endif
@@ -0,0 +1,294 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file tradecandles.c
+ * @brief Sub-minute candles aggregated from the trade feed for chart mode.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "tradecandles.h"
+
+// Trades per page of the aggregated trade endpoint; a full page means we are behind.
+#define TRADE_CANDLE_PAGE_TRADES 1000
+
+// Allocate one empty ring per local period.
+int trade_candles_init(TradeCandleSeries *series, const char *symbol, int bars) {
+    memset(series, 0, sizeof(*series));
+    snprintf(series->symbol, sizeof(series->symbol), "%s", symbol);
+    for (int p = 0; p < TRADE_CANDLE_PERIODS; ++p) {
+        TradeCandleRing *ring = &series->rings[p];
+        ring->seconds = period_seconds((Period)(PERIOD_1SEC + p));
+        ring->bars = calloc((size_t)bars, sizeof(PricePoint));
+        if (!ring->bars) {
+            trade_candles_free(series);
+            return -1;
+        }
+        ring->capacity = bars;
+    }
+    return 0;
+}
+
+// Release the rings.
+void trade_candles_free(TradeCandleSeries *series) {
+    for (int p = 0; p < TRADE_CANDLE_PERIODS; ++p) {
+        free(series->rings[p].bars);
+    }
+    memset(series, 0, sizeof(*series));
+}
+
+// Bar @p index of @p ring counting from the oldest.
+static PricePoint *ring_bar(const TradeCandleRing *ring, int index) {
+    return &ring->bars[(ring->head + index) % ring->capacity];
+}
+
+// Open a flat bar at @p open_time, evicting the oldest bar when full.
+static PricePoint *ring_push(TradeCandleRing *ring, uint64_t open_time, double price) {
+    if (ring->count == ring->capacity) {
+        ring->head = (ring->head + 1) % ring->capacity;
+    } else {
+        ring->count++;
+    }
+    PricePoint *bar = ring_bar(ring, ring->count - 1);
+    memset(bar, 0, sizeof(*bar));
+    bar->timestamp = open_time;
+    bar->close_time = open_time + ring->seconds - 1;
+    bar->open = bar->high = bar->low = bar->close = price;
+    return bar;
+}
+
+// Add one trade's volume to @p bar and widen its range.
+static void bar_fold(PricePoint *bar, const TradeSample *trade) {
+    if (trade->price > bar->high) bar->high = trade->price;
+    if (trade->price < bar->low) bar->low = trade->price;
+    bar->volume += trade->quantity;
+    bar->quote_volume += trade->quantity * trade->price;
+    bar->trade_count++;
+    if (!trade->buyer_maker) {
+        bar->taker_buy_base_volume += trade->quantity;
+        bar->taker_buy_quote_volume += trade->quantity * trade->price;
+    }
+}
+
+// Fold one trade into @p ring, opening (and gap-filling) bars as time moves on.
+static void ring_add(TradeCandleRing *ring, const TradeSample *trade) {
+    uint64_t second = trade->time_ms / 1000;
+    uint64_t open_time = second - second % ring->seconds;
+    PricePoint *last = ring->count ? ring_bar(ring, ring->count - 1) : NULL;
+
+    if (last && open_time < last->timestamp) {
+        uint64_t back = (last->timestamp - open_time) / ring->seconds;
+        if (back < (uint64_t)ring->count) {
+            bar_fold(ring_bar(ring, ring->count - 1 - (int)back), trade);
+        }
+        return;
+    }
+    if (last && open_time == last->timestamp) {
+        bar_fold(last, trade);
+        last->close = trade->price;
+        return;
+    }
+
+    if (last) {
+        uint64_t gap = (open_time - last->timestamp) / ring->seconds - 1;
+        if (gap >= (uint64_t)ring->capacity) {
+            ring->head = 0;
+            ring->count = 0;
+        } else {
+            double close = last->close;
+            uint64_t next = last->timestamp;
+            for (uint64_t i = 0; i < gap; ++i) {
+                next += ring->seconds;
+                ring_push(ring, next, close);
+            }
+        }
+    }
+    PricePoint *bar = ring_push(ring, open_time, trade->price);
+    bar_fold(bar, trade);
+}
+
+// Fold a page of trades into every ring.
+void trade_candles_add(TradeCandleSeries *series, const TradeSample *trades, int count) {
+    for (int i = 0; i < count; ++i) {
+        if (!(trades[i].price > 0.0)) {
+            continue;
+        }
+        for (int p = 0; p < TRADE_CANDLE_PERIODS; ++p) {
+            ring_add(&series->rings[p], &trades[i]);
+        }
+        series->trades++;
+    }
+}
+
+// Copy the ring into the chart buffer, touching only the changed tail when
+// the buffer already mirrors it.
+int trade_candles_sync(const TradeCandleSeries *series, Period period, PricePoint **points,
+                       int *count) {
+    if (!period_is_local(period)) {
+        return -1;
+    }
+    const TradeCandleRing *ring = &series->rings[period - PERIOD_1SEC];
+    PricePoint *buf = *points;
+    int n = *count;
+
+    if (buf && n > 0 && ring->count > 0) {
+        uint64_t first = ring_bar(ring, 0)->timestamp;
+        uint64_t last = ring_bar(ring, ring->count - 1)->timestamp;
+        uint64_t buf_first = buf[0].timestamp;
+        uint64_t buf_last = buf[n - 1].timestamp;
+        bool mirrors = buf_first <= first && buf_last >= first && buf_last <= last &&
+                       buf_last - buf_first == (uint64_t)(n - 1) * ring->seconds;
+        if (mirrors) {
+            int drop = (int)((first - buf_first) / ring->seconds);
+            if (drop > 0) {
+                memmove(buf, buf + drop, (size_t)(n - drop) * sizeof(PricePoint));
+                n -= drop;
+            }
+            // buf[i] is now ring bar i; the last mirrored bar may still be open.
+            int from = n - 1;
+            const PricePoint *open_bar = ring_bar(ring, from);
+            if (drop == 0 && n == ring->count && buf[from].close == open_bar->close &&
+                buf[from].high == open_bar->high && buf[from].low == open_bar->low &&
+                buf[from].trade_count == open_bar->trade_count) {
+                return 0;
+            }
+            for (int i = from; i < ring->count; ++i) {
+                buf[i] = *ring_bar(ring, i);
+            }
+            *count = ring->count;
+            return ring->count - from;
+        }
+    }
+
+    free(buf);
+    *points = NULL;
+    *count = 0;
+    if (ring->count == 0) {
+        return 0;
+    }
+    buf = malloc((size_t)ring->capacity * sizeof(PricePoint));
+    if (!buf) {
+        return -1;
+    }
+    for (int i = 0; i < ring->count; ++i) {
+        buf[i] = *ring_bar(ring, i);
+    }
+    *points = buf;
+    *count = ring->count;
+    return ring->count;
+}
+
+// Poll the followed symbol's trades into its series.
+static void *trade_candle_worker(void *arg) {
+    TradeCandleFeed *feed = arg;
+    while (!atomic_load(&feed->stop)) {
+        char symbol[MAX_SYMBOL_LEN];
+        pthread_mutex_lock(&feed->mutex);
+        snprintf(symbol, sizeof(symbol), "%s", feed->series.symbol);
+        uint64_t from_id = feed->next_id;
+        uint64_t generation = feed->generation;
+        pthread_mutex_unlock(&feed->mutex);
+
+        bool behind = false;
+        if (symbol[0]) {
+            TradeSample *trades = NULL;
+            int count = 0;
+            if (fetch_agg_trades(symbol, from_id, &trades, &count) == 0 && count > 0) {
+                pthread_mutex_lock(&feed->mutex);
+                if (feed->generation == generation) {
+                    trade_candles_add(&feed->series, trades, count);
+                    feed->next_id = trades[count - 1].id + 1;
+                    behind = count >= TRADE_CANDLE_PAGE_TRADES;
+                }
+                pthread_mutex_unlock(&feed->mutex);
+            }
+            free(trades);
+        }
+        for (int i = 0; !behind && i < TRADE_CANDLE_POLL_SECONDS && !atomic_load(&feed->stop);
+             i++) {
+            sleep(1);
+        }
+    }
+    return NULL;
+}
+
+// Prepare an idle feed.
+void trade_candle_feed_init(TradeCandleFeed *feed, const Config *config) {
+    memset(feed, 0, sizeof(*feed));
+    atomic_init(&feed->stop, false);
+    feed->bars = config->trade_candle_bars > 0 ? config->trade_candle_bars
+                                               : TRADE_CANDLE_DEFAULT_BARS;
+    pthread_mutex_init(&feed->mutex, NULL);
+}
+
+// Switch the followed symbol and make sure the poller runs.
+int trade_candle_feed_follow(TradeCandleFeed *feed, const char *symbol) {
+    if (!symbol) {
+        symbol = "";
+    }
+    int rc = 0;
+    pthread_mutex_lock(&feed->mutex);
+    if (strncmp(feed->series.symbol, symbol, MAX_SYMBOL_LEN) != 0) {
+        trade_candles_free(&feed->series);
+        feed->next_id = 0;
+        feed->generation++;
+        if (symbol[0] && trade_candles_init(&feed->series, symbol, feed->bars) != 0) {
+            rc = -1;
+        }
+    }
+    pthread_mutex_unlock(&feed->mutex);
+    if (rc == 0 && symbol[0] && !feed->thread_started) {
+        if (pthread_create(&feed->thread, NULL, trade_candle_worker, feed) != 0) {
+            return -1;
+        }
+        feed->thread_started = true;
+    }
+    return rc;
+}
+
+// Sync a chart buffer from the followed series.
+int trade_candle_feed_sync(TradeCandleFeed *feed, const char *symbol, Period period,
+                           PricePoint **points, int *count) {
+    int rc = -1;
+    pthread_mutex_lock(&feed->mutex);
+    if (symbol[0] && strncmp(feed->series.symbol, symbol, MAX_SYMBOL_LEN) == 0) {
+        rc = trade_candles_sync(&feed->series, period, points, count);
+    }
+    pthread_mutex_unlock(&feed->mutex);
+    return rc;
+}
+
+// Join the poller and free the bars.
+void trade_candle_feed_stop(TradeCandleFeed *feed) {
+    if (feed->thread_started) {
+        atomic_store(&feed->stop, true);
+        pthread_join(feed->thread, NULL);
+        feed->thread_started = false;
+    }
+    trade_candles_free(&feed->series);
+    pthread_mutex_destroy(&feed->mutex);
+}
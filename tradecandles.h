@@ -0,0 +1,125 @@
+#ifndef CTICKER_TRADECANDLES_H
+#define CTICKER_TRADECANDLES_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/** Local periods (::PERIOD_1SEC .. ::PERIOD_30SEC) close the ::Period enum. */
+#define TRADE_CANDLE_PERIODS ((int)PERIOD_COUNT - (int)PERIOD_1SEC)
+
+/** Seconds between trade polls once caught up with the feed. */
+#define TRADE_CANDLE_POLL_SECONDS 1
+
+/**
+ * @brief Ring of the most recent bars of one interval.
+ *
+ * Bars are contiguous in time: intervals without trades are filled with
+ * flat bars at the previous close, as the exchange does for klines.
+ */
+typedef struct {
+    uint64_t seconds;
+    PricePoint *bars;
+    int capacity;
+    /** Slot of the oldest bar and number of bars kept. */
+    int head;
+    int count;
+} TradeCandleRing;
+
+/**
+ * @brief Sub-minute candles of one symbol, one ring per local period.
+ *
+ * Each trade is folded into the open bar of every ring in O(1).
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    /** Indexed by period - ::PERIOD_1SEC. */
+    TradeCandleRing rings[TRADE_CANDLE_PERIODS];
+    /** Trades folded in so far. */
+    uint64_t trades;
+} TradeCandleSeries;
+
+/**
+ * @brief Allocate empty rings of @p bars bars for @p symbol.
+ * @return 0 on success, -1 on allocation failure.
+ */
+int trade_candles_init(TradeCandleSeries *series, const char *symbol, int bars);
+
+/**
+ * @brief Release memory owned by @p series.
+ */
+void trade_candles_free(TradeCandleSeries *series);
+
+/**
+ * @brief Fold trades (oldest first) into every ring.
+ *
+ * Trades older than the open bar update the bar they fall in when it is
+ * still kept (its open and close are left alone); older ones are dropped.
+ */
+void trade_candles_add(TradeCandleSeries *series, const TradeSample *trades, int count);
+
+/**
+ * @brief Mirror the ring of local @p period into a chart buffer.
+ *
+ * When @p points already mirrors the ring, bars that scrolled out are
+ * dropped and only the bars from its last one onwards (the only ones that
+ * can have changed) are copied; otherwise the buffer is replaced.
+ *
+ * @param[in,out] points NULL or a buffer from an earlier call with the
+ *                       same ring capacity; caller frees it.
+ * @return Bars copied (0 when nothing changed), or -1 on allocation failure.
+ */
+int trade_candles_sync(const TradeCandleSeries *series, Period period, PricePoint **points,
+                       int *count);
+
+/**
+ * @brief Background trade poller feeding the series of the charted symbol.
+ *
+ * Polls run only while a symbol is followed; the first page seeds the bars
+ * with the most recent trades, later pages continue from the last trade id
+ * so none is skipped.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_t thread;
+    bool thread_started;
+    atomic_bool stop;
+    /** Ring length from the config. */
+    int bars;
+    /** Followed symbol's bars (empty symbol when idle), guarded by the mutex. */
+    TradeCandleSeries series;
+    /** Next trade id to request (0 = latest page). */
+    uint64_t next_id;
+    /** Bumped when the followed symbol changes, to discard in-flight pages. */
+    uint64_t generation;
+} TradeCandleFeed;
+
+/**
+ * @brief Prepare an idle feed keeping @p config's `trade_candle_bars`.
+ */
+void trade_candle_feed_init(TradeCandleFeed *feed, const Config *config);
+
+/**
+ * @brief Follow @p symbol (NULL or "" to go idle), starting the poller on first use.
+ *
+ * Following a new symbol discards the previous one's bars.
+ *
+ * @return 0 on success, -1 if the symbol's rings or the thread could not be set up.
+ */
+int trade_candle_feed_follow(TradeCandleFeed *feed, const char *symbol);
+
+/**
+ * @brief trade_candles_sync() on the followed series under the feed mutex.
+ * @return As trade_candles_sync(), or -1 when @p symbol is not followed.
+ */
+int trade_candle_feed_sync(TradeCandleFeed *feed, const char *symbol, Period period,
+                           PricePoint **points, int *count);
+
+/**
+ * @brief Stop and join the poller and release the bars.
+ */
+void trade_candle_feed_stop(TradeCandleFeed *feed);
+
+#endif
@@ -0,0 +1,304 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file tradeflow.c
+ * @brief Streaming trade-flow anomalies: block trades, volume bursts and
+ *        one-sided taker flow.
+ *
+ * All per-symbol state is fixed-size (see ::TradeFlow), so memory does not
+ * grow with the trade rate and each trade costs a logarithm plus, when the
+ * trade clock advances, three exponentials.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "tradeflow.h"
+
+// Trades per page of the aggregated trade endpoint; a full page means we are behind.
+#define TRADEFLOW_PAGE_TRADES 1000
+
+// Reset the sketches and rates.
+void tradeflow_init(TradeFlow *flow, const char *symbol) {
+    memset(flow, 0, sizeof(*flow));
+    snprintf(flow->symbol, sizeof(flow->symbol), "%s", symbol);
+    flow->block_threshold = INFINITY;
+}
+
+// Histogram bucket of a notional (values below 1 share bucket 0).
+static int size_bucket(double notional) {
+    if (!(notional > 1.0)) {
+        return 0;
+    }
+    /* log() of the constant gamma is folded at compile time. */
+    double index = log(notional) / log(TRADEFLOW_SIZE_GAMMA);
+    return index >= TRADEFLOW_SIZE_BUCKETS - 1 ? TRADEFLOW_SIZE_BUCKETS - 1 : (int)index;
+}
+
+// Upper edge of the bucket holding quantile @p q, scanning from the top.
+double tradeflow_size_quantile(const TradeFlow *flow, double q) {
+    if (flow->size_total <= 0.0) {
+        return INFINITY;
+    }
+    double above = (1.0 - q) * flow->size_total;
+    double seen = 0.0;
+    for (int i = TRADEFLOW_SIZE_BUCKETS - 1; i >= 0; i--) {
+        seen += flow->size_counts[i];
+        if (seen > above) {
+            return pow(TRADEFLOW_SIZE_GAMMA, i + 1);
+        }
+    }
+    return 1.0;
+}
+
+// Record a trade size; halve the histogram periodically so old regimes fade.
+static void add_size(TradeFlow *flow, double notional) {
+    flow->size_counts[size_bucket(notional)] += 1.0;
+    flow->size_total += 1.0;
+    if (flow->trades % TRADEFLOW_SIZE_DECAY_TRADES == 0) {
+        for (int i = 0; i < TRADEFLOW_SIZE_BUCKETS; i++) {
+            flow->size_counts[i] *= 0.5;
+        }
+        flow->size_total *= 0.5;
+    }
+    if (flow->trades % TRADEFLOW_QUANTILE_REFRESH == 0) {
+        flow->block_threshold = TRADEFLOW_BLOCK_MULTIPLE *
+                                tradeflow_size_quantile(flow, TRADEFLOW_BLOCK_QUANTILE);
+    }
+}
+
+// Decay the rate EWMAs up to @p time_ms.
+static void advance_clock(TradeFlow *flow, uint64_t time_ms) {
+    if (flow->last_ms == 0) {
+        flow->first_ms = time_ms;
+        flow->last_ms = time_ms;
+        return;
+    }
+    if (time_ms <= flow->last_ms) {
+        return;
+    }
+    double dt = (double)(time_ms - flow->last_ms) / 1000.0;
+    flow->fast_rate *= exp(-dt / TRADEFLOW_FAST_SECONDS);
+    flow->slow_rate *= exp(-dt / TRADEFLOW_SLOW_SECONDS);
+    double flow_decay = exp(-dt / TRADEFLOW_FLOW_SECONDS);
+    flow->buy_rate *= flow_decay;
+    flow->sell_rate *= flow_decay;
+    flow->last_ms = time_ms;
+}
+
+// Undo the start-up bias of an EWMA that began at zero @p elapsed seconds ago.
+static double debiased(double rate, double elapsed, double tau) {
+    double weight = 1.0 - exp(-elapsed / tau);
+    return weight > 0.0 ? rate / weight : 0.0;
+}
+
+// Append an alert unless the same kind fired within the cooldown.
+static void emit(TradeFlow *flow, TradeAlert *alerts, int max, int *count,
+                 TradeAlertKind kind, uint64_t time_ms, double value, double reference,
+                 bool buy) {
+    uint64_t last = flow->last_alert_ms[kind];
+    if ((last && time_ms - last < TRADEFLOW_COOLDOWN_SECONDS * 1000ull) || *count >= max) {
+        return;
+    }
+    flow->last_alert_ms[kind] = time_ms;
+    TradeAlert *alert = &alerts[(*count)++];
+    snprintf(alert->symbol, sizeof(alert->symbol), "%s", flow->symbol);
+    alert->kind = kind;
+    alert->time_ms = time_ms;
+    alert->value = value;
+    alert->reference = reference;
+    alert->buy = buy;
+}
+
+// Update sketches and rates trade by trade and test the three conditions.
+int tradeflow_process(TradeFlow *flow, const TradeSample *trades, int count,
+                      TradeAlert *alerts, int max) {
+    int emitted = 0;
+    for (int i = 0; i < count; i++) {
+        const TradeSample *trade = &trades[i];
+        double notional = trade->price * trade->quantity;
+        bool taker_buy = !trade->buyer_maker;
+        advance_clock(flow, trade->time_ms);
+
+        if (flow->trades >= TRADEFLOW_WARMUP_TRADES && notional > flow->block_threshold) {
+            emit(flow, alerts, max, &emitted, TRADE_ALERT_BLOCK, trade->time_ms, notional,
+                 flow->block_threshold, taker_buy);
+        }
+        flow->trades++;
+        add_size(flow, notional);
+
+        flow->fast_rate += notional / TRADEFLOW_FAST_SECONDS;
+        flow->slow_rate += notional / TRADEFLOW_SLOW_SECONDS;
+        if (taker_buy) {
+            flow->buy_rate += notional / TRADEFLOW_FLOW_SECONDS;
+        } else {
+            flow->sell_rate += notional / TRADEFLOW_FLOW_SECONDS;
+        }
+
+        double elapsed = (double)(flow->last_ms - flow->first_ms) / 1000.0;
+        if (elapsed < TRADEFLOW_WARMUP_SECONDS) {
+            continue;
+        }
+        double fast = debiased(flow->fast_rate, elapsed, TRADEFLOW_FAST_SECONDS);
+        double slow = debiased(flow->slow_rate, elapsed, TRADEFLOW_SLOW_SECONDS);
+        if (slow > 0.0 && fast > TRADEFLOW_BURST_RATIO * slow) {
+            emit(flow, alerts, max, &emitted, TRADE_ALERT_BURST, trade->time_ms, fast,
+                 fast / slow, taker_buy);
+        }
+        double buy = debiased(flow->buy_rate, elapsed, TRADEFLOW_FLOW_SECONDS);
+        double sell = debiased(flow->sell_rate, elapsed, TRADEFLOW_FLOW_SECONDS);
+        double total = buy + sell;
+        /* Only at near-normal activity: a quiet book is easily one-sided. */
+        if (total > 0.0 && total >= TRADEFLOW_FLOW_MIN_SHARE * slow) {
+            double imbalance = (buy - sell) / total;
+            if (fabs(imbalance) > TRADEFLOW_IMBALANCE) {
+                emit(flow, alerts, max, &emitted, TRADE_ALERT_ONE_SIDED, trade->time_ms,
+                     imbalance, total, imbalance > 0.0);
+            }
+        }
+    }
+    return emitted;
+}
+
+// Compact notional: 1.2K, 3.4M, 5.6B.
+static void format_notional(char *buf, size_t size, double value) {
+    if (value >= 1e9) {
+        snprintf(buf, size, "%.1fB", value / 1e9);
+    } else if (value >= 1e6) {
+        snprintf(buf, size, "%.1fM", value / 1e6);
+    } else if (value >= 1e3) {
+        snprintf(buf, size, "%.1fK", value / 1e3);
+    } else {
+        snprintf(buf, size, "%.0f", value);
+    }
+}
+
+// One-line alert text for the status panel.
+void tradeflow_describe(const TradeAlert *alert, char *buf, size_t size) {
+    char value[16];
+    char reference[16];
+    switch (alert->kind) {
+        case TRADE_ALERT_BLOCK:
+            format_notional(value, sizeof(value), alert->value);
+            format_notional(reference, sizeof(reference), alert->reference);
+            snprintf(buf, size, "%s BLOCK %s %s (>%s)", alert->symbol,
+                     alert->buy ? "BUY" : "SELL", value, reference);
+            break;
+        case TRADE_ALERT_BURST:
+            format_notional(value, sizeof(value), alert->value);
+            snprintf(buf, size, "%s VOLUME x%.1f (%s/S)", alert->symbol, alert->reference,
+                     value);
+            break;
+        case TRADE_ALERT_ONE_SIDED:
+        default:
+            snprintf(buf, size, "%s TAKER %s %.0f%%", alert->symbol,
+                     alert->buy ? "BUYS" : "SELLS", 50.0 + fabs(alert->value) * 50.0);
+            break;
+    }
+}
+
+/* ---- Background monitor ---- */
+
+// Store alerts in the history and show the newest in the status panel.
+static void publish_alerts(TradeFlowMonitor *monitor, const TradeAlert *alerts, int count) {
+    if (count == 0) {
+        return;
+    }
+    pthread_mutex_lock(&monitor->mutex);
+    for (int i = 0; i < count; i++) {
+        monitor->alerts[monitor->alert_head] = alerts[i];
+        monitor->alert_head = (monitor->alert_head + 1) % TRADEFLOW_ALERT_HISTORY;
+        if (monitor->alert_count < TRADEFLOW_ALERT_HISTORY) {
+            monitor->alert_count++;
+        }
+    }
+    pthread_mutex_unlock(&monitor->mutex);
+
+    char text[64];
+    tradeflow_describe(&alerts[count - 1], text, sizeof(text));
+    ui_set_status_alert(text, TRADEFLOW_ALERT_SECONDS);
+}
+
+// Worker loop: page every symbol's feed forward, sleep once caught up.
+static void *tradeflow_worker(void *arg) {
+    TradeFlowMonitor *monitor = arg;
+    while (!atomic_load(&monitor->stop)) {
+        bool behind = false;
+        for (int s = 0; s < monitor->symbol_count && !atomic_load(&monitor->stop); s++) {
+            TradeSample *trades = NULL;
+            int count = 0;
+            if (fetch_agg_trades(monitor->flows[s].symbol, monitor->next_id[s], &trades,
+                                 &count) == 0 && count > 0) {
+                TradeAlert alerts[TRADE_ALERT_KIND_COUNT * 4];
+                int emitted = tradeflow_process(&monitor->flows[s], trades, count, alerts,
+                                                (int)(sizeof(alerts) / sizeof(alerts[0])));
+                publish_alerts(monitor, alerts, emitted);
+                monitor->next_id[s] = trades[count - 1].id + 1;
+                atomic_fetch_add(&monitor->processed, (unsigned long long)count);
+                behind = behind || count >= TRADEFLOW_PAGE_TRADES;
+            }
+            free(trades);
+        }
+        for (int i = 0; !behind && i < TRADEFLOW_POLL_SECONDS && !atomic_load(&monitor->stop);
+             i++) {
+            sleep(1);
+        }
+    }
+    return NULL;
+}
+
+// Reset the flows and start the worker when symbols are configured.
+int tradeflow_monitor_start(TradeFlowMonitor *monitor, const Config *config) {
+    memset(monitor, 0, sizeof(*monitor));
+    atomic_init(&monitor->stop, false);
+    atomic_init(&monitor->processed, 0);
+    for (int i = 0; i < config->trade_flow_count && i < MAX_TRADE_FLOW_SYMBOLS; i++) {
+        tradeflow_init(&monitor->flows[i], config->trade_flow[i]);
+        monitor->symbol_count++;
+    }
+    if (monitor->symbol_count == 0) {
+        return 0;
+    }
+    pthread_mutex_init(&monitor->mutex, NULL);
+    if (pthread_create(&monitor->thread, NULL, tradeflow_worker, monitor) != 0) {
+        pthread_mutex_destroy(&monitor->mutex);
+        return -1;
+    }
+    monitor->thread_started = true;
+    return 0;
+}
+
+// Join the worker if it was started.
+void tradeflow_monitor_stop(TradeFlowMonitor *monitor) {
+    if (!monitor->thread_started) {
+        return;
+    }
+    atomic_store(&monitor->stop, true);
+    pthread_join(monitor->thread, NULL);
+    monitor->thread_started = false;
+    pthread_mutex_destroy(&monitor->mutex);
+}
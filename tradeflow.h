@@ -0,0 +1,161 @@
+#ifndef CTICKER_TRADEFLOW_H
+#define CTICKER_TRADEFLOW_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "cticker.h"
+
+/** Log-spaced trade-size buckets; bucket i covers notionals near GAMMA^i. */
+#define TRADEFLOW_SIZE_BUCKETS 1024
+/** Relative width of a size bucket (2%: 1024 buckets span 1 to ~6e8 quote units). */
+#define TRADEFLOW_SIZE_GAMMA 1.02
+/** Trades between halvings of the size histogram, so it tracks the current regime. */
+#define TRADEFLOW_SIZE_DECAY_TRADES 20000
+/** Trades between refreshes of the cached block-trade threshold. */
+#define TRADEFLOW_QUANTILE_REFRESH 1024
+/** Reference trade-size quantile for block trades. */
+#define TRADEFLOW_BLOCK_QUANTILE 0.999
+/** A block trade is at least this multiple of the reference quantile. */
+#define TRADEFLOW_BLOCK_MULTIPLE 2.0
+/** Trades seen before block trades are flagged. */
+#define TRADEFLOW_WARMUP_TRADES 2000
+
+/** EWMA time constants (seconds) of the fast and baseline volume rates and taker flow. */
+#define TRADEFLOW_FAST_SECONDS 10.0
+#define TRADEFLOW_SLOW_SECONDS 300.0
+#define TRADEFLOW_FLOW_SECONDS 30.0
+/** Fast volume rate over the baseline that counts as a burst. */
+#define TRADEFLOW_BURST_RATIO 4.0
+/** |buy - sell| / (buy + sell) of taker flow that counts as one-sided. */
+#define TRADEFLOW_IMBALANCE 0.8
+/** Taker flow must run at this share of the baseline volume rate to be judged. */
+#define TRADEFLOW_FLOW_MIN_SHARE 0.5
+/** Seconds of trades before bursts and one-sided flow are flagged. */
+#define TRADEFLOW_WARMUP_SECONDS 60.0
+/** Minimum seconds between two alerts of the same kind for one symbol. */
+#define TRADEFLOW_COOLDOWN_SECONDS 60
+
+/** Seconds between polls of a symbol once caught up with the feed. */
+#define TRADEFLOW_POLL_SECONDS 2
+/** Seconds an alert stays in the status panel. */
+#define TRADEFLOW_ALERT_SECONDS 15
+/** Alerts kept by the monitor. */
+#define TRADEFLOW_ALERT_HISTORY 32
+
+/**
+ * @brief What an alert flags.
+ */
+typedef enum {
+    /** A print ::TRADEFLOW_BLOCK_MULTIPLE times the ::TRADEFLOW_BLOCK_QUANTILE of recent sizes. */
+    TRADE_ALERT_BLOCK,
+    /** Fast volume rate ::TRADEFLOW_BURST_RATIO times the baseline. */
+    TRADE_ALERT_BURST,
+    /** Taker buys (or sells) dominating recent flow. */
+    TRADE_ALERT_ONE_SIDED,
+    TRADE_ALERT_KIND_COUNT
+} TradeAlertKind;
+
+/**
+ * @brief One anomaly.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    TradeAlertKind kind;
+    uint64_t time_ms;
+    /** Block: notional of the print. Burst: fast volume rate (quote/s). One-sided: imbalance. */
+    double value;
+    /** Block: threshold notional. Burst: ratio to baseline. One-sided: flow rate (quote/s). */
+    double reference;
+    /** Taker side: true when the taker bought. */
+    bool buy;
+} TradeAlert;
+
+/**
+ * @brief Constant-memory trade statistics of one symbol.
+ *
+ * Trade sizes (quote notional) go into a log-bucketed histogram whose
+ * counts are halved every ::TRADEFLOW_SIZE_DECAY_TRADES trades, so a
+ * quantile has ~1% relative error and follows the recent regime. Volume
+ * rates and taker flow are continuous-time EWMAs, decayed only when the
+ * trade clock advances. Processing a trade is O(1); the bucket scan for
+ * the block threshold is amortised over ::TRADEFLOW_QUANTILE_REFRESH trades.
+ */
+typedef struct {
+    char symbol[MAX_SYMBOL_LEN];
+    double size_counts[TRADEFLOW_SIZE_BUCKETS];
+    double size_total;
+    /** Cached block-trade notional (multiple of the reference quantile). */
+    double block_threshold;
+    uint64_t trades;
+    /** Quote volume per second, fast and baseline. */
+    double fast_rate;
+    double slow_rate;
+    /** Taker buy and sell quote volume per second. */
+    double buy_rate;
+    double sell_rate;
+    uint64_t first_ms;
+    uint64_t last_ms;
+    /** Time of the last alert per ::TradeAlertKind. */
+    uint64_t last_alert_ms[TRADE_ALERT_KIND_COUNT];
+} TradeFlow;
+
+/**
+ * @brief Reset @p flow for @p symbol.
+ */
+void tradeflow_init(TradeFlow *flow, const char *symbol);
+
+/**
+ * @brief Notional at quantile @p q (0..1) of the size histogram.
+ */
+double tradeflow_size_quantile(const TradeFlow *flow, double q);
+
+/**
+ * @brief Feed trades (oldest first) and collect alerts.
+ * @return Number of alerts written to @p alerts (at most @p max).
+ */
+int tradeflow_process(TradeFlow *flow, const TradeSample *trades, int count,
+                      TradeAlert *alerts, int max);
+
+/**
+ * @brief Human-readable one-line description of @p alert.
+ */
+void tradeflow_describe(const TradeAlert *alert, char *buf, size_t size);
+
+/**
+ * @brief Background monitor paging the trade feed of the `trade_flow` symbols.
+ *
+ * One thread polls every symbol in turn from the last seen trade id, so no
+ * trade is skipped; while a page comes back full it keeps paging instead of
+ * sleeping. Alerts go to the status panel and a short history.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_t thread;
+    bool thread_started;
+    atomic_bool stop;
+    TradeFlow flows[MAX_TRADE_FLOW_SYMBOLS];
+    uint64_t next_id[MAX_TRADE_FLOW_SYMBOLS];
+    int symbol_count;
+    /** Recent alerts (ring buffer, guarded by the mutex). */
+    TradeAlert alerts[TRADEFLOW_ALERT_HISTORY];
+    int alert_count;
+    int alert_head;
+    /** Trades processed so far (statistics). */
+    atomic_ullong processed;
+} TradeFlowMonitor;
+
+/**
+ * @brief Start monitoring @p config's `trade_flow` symbols.
+ * @return 0 on success (including when none are configured), -1 if the
+ *         thread could not be created.
+ */
+int tradeflow_monitor_start(TradeFlowMonitor *monitor, const Config *config);
+
+/**
+ * @brief Stop and join the monitor thread.
+ */
+void tradeflow_monitor_stop(TradeFlowMonitor *monitor);
+
+#endif
@@ -0,0 +1,156 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file ui_arbitrage.c
+ * @brief Triangular arbitrage opportunity list rendering.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "arbitrage.h"
+#include "ui_internal.h"
+
+// Column layout of the opportunity list.
+#define PATH_COL 2
+#define LEGS_COL 34
+#define NET_COL 90
+#define LIST_START_Y 6
+
+// First visible list row (kept across frames like the board offset).
+static int arbitrage_scroll_offset = 0;
+
+// Summary lines: graph size, last poll and fee/threshold settings.
+static void draw_arbitrage_summary(const ArbitrageSnapshot *snapshot) {
+    char updated[32] = "-";
+    if (snapshot->updated > 0) {
+        struct tm tm_buf;
+        time_t ts = (time_t)snapshot->updated;
+        strftime(updated, sizeof(updated), "%H:%M:%S", localtime_r(&ts, &tm_buf));
+    }
+    wattron(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+    mvwprintw(main_win, 2, 2, "%d PAIRS | %d ASSETS | %d CYCLES | FEE %.3g%%/LEG | THRESHOLD %+.3g%%",
+              snapshot->pair_count, snapshot->asset_count, snapshot->cycle_count,
+              snapshot->fee_pct, snapshot->threshold_pct);
+    wattroff(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+    mvwprintw(main_win, 3, 2, "UPDATED %s%s | %d PAIRS CHANGED, %d CYCLES RE-EVALUATED | %d FLAGGED",
+              updated, snapshot->stale ? " (STALE)" : "", snapshot->changed_pairs,
+              snapshot->evaluated_cycles, snapshot->flagged_count);
+}
+
+// One opportunity: asset path, the three legs and the net profit.
+static void draw_opportunity(const ArbOpportunity *opportunity, int y, bool selected) {
+    if (selected && colors_available) {
+        wattron(main_win, COLOR_PAIR(COLOR_PAIR_SELECTED));
+        mvwhline(main_win, y, 0, ' ', COLS);
+    }
+    char path[96];
+    snprintf(path, sizeof(path), "%s > %s > %s > %s", opportunity->assets[0],
+             opportunity->assets[1], opportunity->assets[2], opportunity->assets[0]);
+    mvwprintw(main_win, y, PATH_COL, "%-*.*s", LEGS_COL - PATH_COL - 1,
+              LEGS_COL - PATH_COL - 1, path);
+
+    char legs[128];
+    size_t len = 0;
+    legs[0] = '\0';
+    for (int k = 0; k < 3; k++) {
+        len += (size_t)snprintf(legs + len, sizeof(legs) - len, "%s%s %s", k ? ", " : "",
+                                opportunity->sells[k] ? "SELL" : "BUY",
+                                opportunity->symbols[k]);
+    }
+    mvwprintw(main_win, y, LEGS_COL, "%-*.*s", NET_COL - LEGS_COL - 1, NET_COL - LEGS_COL - 1,
+              legs);
+    if (selected && colors_available) {
+        wattroff(main_win, COLOR_PAIR(COLOR_PAIR_SELECTED));
+    }
+
+    int pair = selected ? COLOR_PAIR_GREEN_SELECTED : COLOR_PAIR_GREEN;
+    if (colors_available) {
+        wattron(main_win, COLOR_PAIR(pair) | A_BOLD);
+    }
+    mvwprintw(main_win, y, NET_COL, "%+9.3f%%", opportunity->profit * 100.0);
+    if (colors_available) {
+        wattroff(main_win, COLOR_PAIR(pair) | A_BOLD);
+    }
+}
+
+// Draw the flagged cycles, most profitable first.
+void draw_arbitrage_screen(const ArbitrageSnapshot *snapshot, int selected) {
+    werase(main_win);
+    draw_title_bar("[A][R][B][I][T][R][A][G][E]");
+
+    if (snapshot->status == ARBITRAGE_LOADING) {
+        mvwprintw(main_win, 2, 2, "Loading the book ticker...");
+    } else if (snapshot->status == ARBITRAGE_FAILED) {
+        mvwprintw(main_win, 2, 2, "Book ticker request failed; retrying every %d s.",
+                  ARBITRAGE_REFRESH_SECONDS);
+    } else {
+        draw_arbitrage_summary(snapshot);
+
+        wattron(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+        mvwprintw(main_win, 4, PATH_COL, "%-*s", LEGS_COL - PATH_COL, "CYCLE");
+        mvwprintw(main_win, 4, LEGS_COL, "%-*s", NET_COL - LEGS_COL, "LEGS");
+        mvwprintw(main_win, 4, NET_COL, "%10s", "NET");
+        wattroff(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+        mvwhline(main_win, 5, 2, ACS_HLINE, COLS - 4);
+
+        int count = snapshot->shown_count;
+        int visible_rows = LINES - 1 - LIST_START_Y;
+        if (visible_rows < 1) {
+            visible_rows = 1;
+        }
+        if (selected < arbitrage_scroll_offset) {
+            arbitrage_scroll_offset = selected;
+        } else if (selected >= arbitrage_scroll_offset + visible_rows) {
+            arbitrage_scroll_offset = selected - visible_rows + 1;
+        }
+        if (arbitrage_scroll_offset > count - visible_rows) {
+            arbitrage_scroll_offset = count - visible_rows;
+        }
+        if (arbitrage_scroll_offset < 0) {
+            arbitrage_scroll_offset = 0;
+        }
+
+        if (count == 0) {
+            mvwprintw(main_win, LIST_START_Y, 2,
+                      "No cycle beats the threshold after fees.");
+        }
+        int end = arbitrage_scroll_offset + visible_rows;
+        end = end > count ? count : end;
+        for (int i = arbitrage_scroll_offset; i < end; i++) {
+            draw_opportunity(&snapshot->shown[i], LIST_START_Y + i - arbitrage_scroll_offset,
+                             i == selected);
+        }
+        if (arbitrage_scroll_offset > 0) {
+            mvwaddch(main_win, LIST_START_Y, 0, ACS_UARROW);
+        }
+        if (end < count) {
+            mvwaddch(main_win, LIST_START_Y + visible_rows - 1, 0, ACS_DARROW);
+        }
+    }
+
+    draw_footer_bar("KEYS: ↑/↓ SCROLL | A/ESC: PRICE BOARD | Q: QUIT");
+    wrefresh(main_win);
+}
@@ -28,23 +28,88 @@ SOFTWARE.
  */
 
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include "ui_internal.h"
+#include "bartransform.h"
+#include "m4.h"
+#include "rangestats.h"
+#include "volprofile.h"
+
+// Volume profile overlay state (toggled from the chart with V).
+static bool chart_profile_enabled = false;
+static VolumeProfile chart_profile;
+
+// Range selection: anchored at a candle timestamp (S), the cursor is the
+// other end. The index over the loaded candles is kept across frames.
+static bool chart_range_active = false;
+static uint64_t chart_range_anchor = 0;
+static RangeIndex chart_range_index;
+
+// Bar type (B) and box size ([ / ]) of the derived bars. Derived series
+// are cached per symbol, interval, type and box, so switching back to one
+// only folds in the candles that closed meanwhile.
+static const double chart_box_percents[] = {0.1, 0.2, 0.5, 1.0, 2.0, 5.0};
+static const char *const chart_bar_labels[BAR_TYPE_COUNT] = {
+    "CANDLESTICK", "HEIKIN-ASHI", "RENKO", "RANGE BAR",
+};
+static BarType chart_bar_type = BAR_CANDLES;
+static int chart_box_index = 2;
+static BarCache chart_bars;
+// Bars drawn in the last frame (NULL when drawing the candles themselves).
+static const BarSeries *chart_view_bars = NULL;
+
+// Line/area mode (L) fits the whole series into the chart width; each
+// screen column is drawn from the M4 aggregate of the candles it covers.
+typedef enum {
+    CHART_LINE_OFF,
+    CHART_LINE_LINE,
+    CHART_LINE_AREA,
+    CHART_LINE_MODE_COUNT
+} ChartLineMode;
+
+static ChartLineMode chart_line_mode = CHART_LINE_OFF;
+static M4Column *chart_m4 = NULL;
+static int chart_m4_capacity = 0;
+// Columns drawn in line mode by the last frame (0 when drawing candles).
+static int chart_view_line_columns = 0;
+
+// Hover crosshair. Pointer motion only restores the cells the previous
+// crosshair covered and paints the new one; the geometry and visible
+// timestamps are kept from the last full draw.
+typedef struct {
+    short y;
+    short x;
+    chtype ch;
+} ChartCrossCell;
+
+static bool chart_pointer_valid = false;
+static int chart_pointer_x = 0;
+static int chart_pointer_y = 0;
+static ChartCrossCell *chart_cross_cells = NULL;
+static int chart_cross_count = 0;
+static int chart_cross_capacity = 0;
+static struct {
+    int chart_x;
+    int chart_y;
+    int chart_width;
+    int chart_height;
+    int label_row;
+    int label_max_x;
+    double min_price;
+    double max_price;
+    Period period;
+    int visible;
+    uint64_t *times;
+    int times_capacity;
+} chart_cross_view;
 
 // Convert a price into a y-coordinate on the chart grid.
 static int price_to_row(double price, double min_price, double max_price,
                         int chart_height, int chart_y) {
-    double range = max_price - min_price;
-    if (range <= 0.0000001) {
-        range = 1.0;
-    }
-    double normalized = (price - min_price) / range;
-    if (normalized < 0.0) normalized = 0.0;
-    if (normalized > 1.0) normalized = 1.0;
-    int usable_height = chart_height - 1;
-    if (usable_height < 1) usable_height = 1;
-    return chart_y + chart_height - 1 - (int)(normalized * usable_height);
+    return chart_y + m4_price_row(price, min_price, max_price, chart_height);
 }
 
 // Draw the floating info box in the top-right corner that mirrors the
@@ -168,6 +233,120 @@ static void draw_info_box(int x, int y, int width, int height,
     wattroff(main_win, A_REVERSE);
 }
 
+// Draw the range statistics box in place of the candle info box.
+static void draw_range_box(int x, int y, int width, int height, const PricePoint *points,
+                           const RangeStats *stats) {
+    if (width < 10 || height < 6) {
+        return;
+    }
+
+    int right = x + width - 1;
+    int bottom = y + height - 1;
+
+    wattron(main_win, A_REVERSE);
+    for (int row = y; row <= bottom; ++row) {
+        mvwhline(main_win, row, x, ' ', width);
+    }
+
+    mvwaddch(main_win, y, x, ACS_ULCORNER);
+    mvwaddch(main_win, y, right, ACS_URCORNER);
+    mvwaddch(main_win, bottom, x, ACS_LLCORNER);
+    mvwaddch(main_win, bottom, right, ACS_LRCORNER);
+    mvwhline(main_win, y, x + 1, ACS_HLINE, width - 2);
+    mvwhline(main_win, bottom, x + 1, ACS_HLINE, width - 2);
+    mvwvline(main_win, y + 1, x, ACS_VLINE, height - 2);
+    mvwvline(main_win, y + 1, right, ACS_VLINE, height - 2);
+
+    char from_str[32], to_str[32];
+    struct tm tm_buf;
+    time_t from_ts = (time_t)points[stats->from].timestamp;
+    time_t to_ts = (time_t)points[stats->to].close_time;
+    strftime(from_str, sizeof(from_str), "%Y-%m-%d %H:%M", localtime_r(&from_ts, &tm_buf));
+    strftime(to_str, sizeof(to_str), "%Y-%m-%d %H:%M", localtime_r(&to_ts, &tm_buf));
+
+    char high_str[32], low_str[32], volume_str[16], quote_volume_str[16];
+    char taker_buy_str[16], trades_str[32];
+    ui_format_number(high_str, sizeof(high_str), stats->high);
+    ui_trim_trailing_zeros(high_str);
+    ui_format_number(low_str, sizeof(low_str), stats->low);
+    ui_trim_trailing_zeros(low_str);
+    ui_format_number(volume_str, sizeof(volume_str), stats->volume);
+    ui_format_number(quote_volume_str, sizeof(quote_volume_str), stats->quote_volume);
+    ui_format_number(taker_buy_str, sizeof(taker_buy_str), stats->taker_buy_volume);
+    ui_format_integer_with_commas(trades_str, sizeof(trades_str), stats->trades);
+    double taker_share = (stats->volume > 0.0)
+        ? stats->taker_buy_volume / stats->volume * 100.0
+        : 0.0;
+
+    int content_x = x + 2;
+    int line = y + 1;
+    mvwprintw(main_win, line++, content_x, "From : %s", from_str);
+    mvwprintw(main_win, line++, content_x, "To   : %s", to_str);
+    mvwprintw(main_win, line++, content_x, "Candles  : %d", stats->candles);
+    int change_color = (stats->change >= 0.0)
+        ? COLOR_PAIR(COLOR_PAIR_GREEN)
+        : COLOR_PAIR(COLOR_PAIR_RED);
+    if (colors_available) {
+        wattron(main_win, change_color | A_BOLD);
+    }
+    mvwprintw(main_win, line++, content_x, "Return   : %+.2f%%", stats->change * 100.0);
+    if (colors_available) {
+        wattroff(main_win, change_color | A_BOLD);
+        wattron(main_win, COLOR_PAIR(COLOR_PAIR_INFO_HIGH) | A_BOLD);
+    }
+    mvwprintw(main_win, line++, content_x, "High : %s", high_str);
+    if (colors_available) {
+        wattroff(main_win, COLOR_PAIR(COLOR_PAIR_INFO_HIGH) | A_BOLD);
+        wattron(main_win, COLOR_PAIR(COLOR_PAIR_INFO_LOW) | A_BOLD);
+    }
+    mvwprintw(main_win, line++, content_x, "Low  : %s", low_str);
+    if (colors_available) {
+        wattroff(main_win, COLOR_PAIR(COLOR_PAIR_INFO_LOW) | A_BOLD);
+    }
+    mvwprintw(main_win, line++, content_x, "Max Drawdown: %.2f%%", stats->max_drawdown * 100.0);
+    mvwprintw(main_win, line++, content_x, "Vol  : %s", volume_str);
+    mvwprintw(main_win, line++, content_x, "Quote Vol: %s", quote_volume_str);
+    mvwprintw(main_win, line++, content_x, "Trades   : %s", trades_str);
+    mvwprintw(main_win, line++, content_x, "Taker Buy (B): %s", taker_buy_str);
+    mvwprintw(main_win, line, content_x, "Taker Buy %%: %.1f%%", taker_share);
+
+    wattroff(main_win, A_REVERSE);
+}
+
+// Index of the candle opening at @p timestamp, or -1 when none does.
+static int find_candle(const PricePoint *points, int count, uint64_t timestamp) {
+    int lo = 0;
+    int hi = count - 1;
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (points[mid].timestamp == timestamp) {
+            return mid;
+        }
+        if (points[mid].timestamp < timestamp) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+// Overlay value of chart candle @p i, or NAN where the comparison has no
+// candle: its close rebased onto the chart's close at @p base (percent
+// mode), or the chart close over the comparison close (ratio mode).
+static double compare_value(const ChartComparison *compare, const PricePoint *points,
+                            int base, int i) {
+    int pos = compare->positions[i];
+    if (pos < 0 || compare->points[pos].close <= 0.0) {
+        return NAN;
+    }
+    double other = compare->points[pos].close;
+    if (compare->mode == CHART_COMPARE_RATIO) {
+        return points[i].close / other;
+    }
+    return points[base].close * other / compare->points[compare->positions[base]].close;
+}
+
 // Draw the current price box below the info box.
 static void draw_current_price_box(int x, int y, int width, int height,
                                    const PricePoint *point) {
@@ -216,11 +395,203 @@ static void draw_current_price_box(int x, int y, int width, int height,
     wattroff(main_win, A_REVERSE);
 }
 
+// Draw the volume-at-price strip for candles [start, end) beside the chart.
+// One bin per chart row: the bins span one extra row's worth of price above
+// max_price so bin b lands exactly on the row price_to_row() gives it.
+static void draw_volume_profile(int x, int chart_y, int width, int chart_height,
+                                const PricePoint *points, int count, int start, int end,
+                                double min_price, double max_price) {
+    if (width < 4 || chart_height < 2) {
+        return;
+    }
+    double row_span = (max_price - min_price) / (chart_height - 1);
+    if (volprofile_update(&chart_profile, points, count, start, end, min_price,
+                          max_price + row_span, chart_height) < 0) {
+        return;
+    }
+    VolumeProfileLevels levels;
+    volprofile_levels(&chart_profile, &levels);
+    if (levels.poc < 0) {
+        return;
+    }
+
+    // Leave room for the POC/VAH/VAL labels when the strip is wide enough.
+    int label_width = (width >= 10) ? 4 : 0;
+    int bar_width = width - label_width;
+    for (int b = 0; b < chart_profile.bins; ++b) {
+        int y = chart_y + chart_height - 1 - b;
+        double volume = chart_profile.volume[b];
+        int len = (volume > 0.0)
+            ? (int)lround(volume / levels.poc_volume * bar_width)
+            : 0;
+        if (len == 0 && volume > 0.0) {
+            len = 1;
+        }
+        bool in_value_area = b >= levels.value_low && b <= levels.value_high;
+        attr_t attr = in_value_area ? A_NORMAL : A_DIM;
+        int pair = (b == levels.poc) ? COLOR_PAIR_SYMBOL : COLOR_PAIR_HEADER;
+        if (b == levels.poc) {
+            attr |= A_BOLD;
+        }
+        if (colors_available) {
+            attr |= COLOR_PAIR(pair);
+        }
+        wattron(main_win, attr);
+        if (len > 0) {
+            mvwhline(main_win, y, x, in_value_area ? ACS_CKBOARD : ACS_BOARD, len);
+        }
+        if (label_width > 0) {
+            const char *label = NULL;
+            if (b == levels.poc) {
+                label = "POC";
+            } else if (b == levels.value_high) {
+                label = "VAH";
+            } else if (b == levels.value_low) {
+                label = "VAL";
+            }
+            if (label) {
+                mvwprintw(main_win, y, x + bar_width + 1, "%s", label);
+            }
+        }
+        wattroff(main_win, attr);
+    }
+}
+
+// Remember the cell at (@p y, @p x) and paint @p ch over it.
+static void cross_put(int y, int x, chtype ch) {
+    if (chart_cross_count == chart_cross_capacity) {
+        int capacity = chart_cross_capacity ? chart_cross_capacity * 2 : 256;
+        ChartCrossCell *cells = realloc(chart_cross_cells, sizeof(*cells) * (size_t)capacity);
+        if (!cells) {
+            return;
+        }
+        chart_cross_cells = cells;
+        chart_cross_capacity = capacity;
+    }
+    ChartCrossCell *cell = &chart_cross_cells[chart_cross_count++];
+    cell->y = (short)y;
+    cell->x = (short)x;
+    cell->ch = mvwinch(main_win, y, x);
+    mvwaddch(main_win, y, x, ch);
+}
+
+// Paint a readout string through cross_put() so it can be taken off again.
+static void cross_puts(int y, int x, const char *text, int max_x, chtype attr) {
+    for (int i = 0; text[i] && x + i <= max_x; ++i) {
+        cross_put(y, x + i, (chtype)(unsigned char)text[i] | attr);
+    }
+}
+
+// Put back the cells under the crosshair, newest first.
+static void erase_crosshair(void) {
+    while (chart_cross_count > 0) {
+        const ChartCrossCell *cell = &chart_cross_cells[--chart_cross_count];
+        mvwaddch(main_win, cell->y, cell->x, cell->ch);
+    }
+}
+
+// Paint the crosshair at the pointer with the price of its row on the
+// y-axis and the open time of its candle below the x-axis. Lines pass
+// behind candles and overlays (any coloured cell).
+static void draw_crosshair(void) {
+    const int left = chart_cross_view.chart_x;
+    const int top = chart_cross_view.chart_y;
+    const int right = left + chart_cross_view.chart_width - 1;
+    const int bottom = top + chart_cross_view.chart_height - 1;
+    int px = chart_pointer_x;
+    int py = chart_pointer_y;
+    if (!chart_pointer_valid || px < left || px > right || py < top || py > bottom) {
+        return;
+    }
+
+    chtype line_attr = A_BOLD;
+    for (int x = left; x <= right; ++x) {
+        if (x != px && PAIR_NUMBER(mvwinch(main_win, py, x) & A_COLOR) == 0) {
+            cross_put(py, x, ACS_HLINE | line_attr);
+        }
+    }
+    for (int y = top; y <= bottom; ++y) {
+        if (y != py && PAIR_NUMBER(mvwinch(main_win, y, px) & A_COLOR) == 0) {
+            cross_put(y, px, ACS_VLINE | line_attr);
+        }
+    }
+    cross_put(py, px, ACS_PLUS | line_attr);
+
+    double range = chart_cross_view.max_price - chart_cross_view.min_price;
+    int usable_height = chart_cross_view.chart_height - 1;
+    if (usable_height < 1) usable_height = 1;
+    double price = chart_cross_view.min_price + range * (bottom - py) / usable_height;
+    char price_str[24];
+    char label[24];
+    ui_format_axis_price(price_str, sizeof(price_str), price, range);
+    snprintf(label, sizeof(label), "%10s", price_str);
+    cross_puts(py, 1, label, left - 3, A_REVERSE);
+
+    int column = (px - left) / (chart_view_stride > 0 ? chart_view_stride : 1);
+    if (column < chart_cross_view.visible && chart_cross_view.label_row < LINES - 1) {
+        time_t ts = (time_t)chart_cross_view.times[column];
+        struct tm tm_buf;
+        char time_str[32];
+        const char *fmt = "%Y-%m-%d";
+        if (period_is_local(chart_cross_view.period)) {
+            fmt = "%H:%M:%S";
+        } else if (chart_cross_view.period < PERIOD_1DAY) {
+            fmt = "%m-%d %H:%M";
+        }
+        strftime(time_str, sizeof(time_str), fmt, localtime_r(&ts, &tm_buf));
+        int x = px - (int)strlen(time_str) / 2;
+        if (x < left) x = left;
+        cross_puts(chart_cross_view.label_row, x, time_str, chart_cross_view.label_max_x,
+                   A_REVERSE);
+    }
+}
+
+// Series index shown in screen column @p col (the first candle of an M4 column).
+static int view_index(int col, int start_idx, int line_columns) {
+    return (line_columns > 0) ? chart_m4[col].from : start_idx + col;
+}
+
+// Screen column of series index @p idx.
+static int view_column(int idx, int start_idx, int count, int line_columns) {
+    return (line_columns > 0) ? m4_column_of(0, count, line_columns, idx) : idx - start_idx;
+}
+
+// Draw the closes as a line (optionally filled below) from the M4 columns:
+// each column spans its min/max and the join from the previous column.
+static void draw_line_columns(int chart_x, int chart_y, int chart_height, int columns,
+                              double min_price, double max_price, bool area) {
+    for (int c = 0; c < columns; ++c) {
+        int top, bottom;
+        m4_column_rows(chart_m4, c, min_price, max_price, chart_height, &top, &bottom);
+        double prev = (c > 0) ? chart_m4[c - 1].last : chart_m4[c].first;
+        int color = (chart_m4[c].last >= prev) ? COLOR_PAIR_GREEN : COLOR_PAIR_RED;
+        int x = chart_x + c;
+        if (colors_available) {
+            wattron(main_win, COLOR_PAIR(color));
+        }
+        if (top == bottom) {
+            mvwaddch(main_win, chart_y + top, x, ACS_HLINE);
+        } else {
+            mvwvline(main_win, chart_y + top, x, ACS_VLINE, bottom - top + 1);
+        }
+        if (area && bottom < chart_height - 1) {
+            wattron(main_win, A_DIM);
+            mvwvline(main_win, chart_y + bottom + 1, x, ACS_CKBOARD, chart_height - 1 - bottom);
+            wattroff(main_win, A_DIM);
+        }
+        if (colors_available) {
+            wattroff(main_win, COLOR_PAIR(color));
+        }
+    }
+}
+
 // Draw the interactive candlestick chart along with axis labels, cursor, and
 // metadata for the currently selected candle.
 void draw_chart(const char *restrict symbol, int count, PricePoint points[count],
-                Period period, int selected_index) {
+                Period period, int selected_index, const ChartComparison *compare) {
     werase(main_win);
+    chart_cross_count = 0;
+    chart_cross_view.visible = 0;
 
     if (count == 0) {
         mvwprintw(main_win, LINES / 2, COLS / 2 - 10, "No data available");
@@ -228,9 +599,47 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
         return;
     }
 
+    // Derived bars stand in for the candles: the cursor moves to the bar
+    // covering its candle, and the price box keeps quoting the live candle.
+    const PricePoint *live_candle = &points[count - 1];
+    chart_view_bars = NULL;
+    if (chart_bar_type != BAR_CANDLES) {
+        BarSeries *bars = bar_cache_get(&chart_bars, symbol, period, chart_bar_type,
+                                        chart_box_percents[chart_box_index]);
+        if (bar_series_sync(bars, points, count) == 0 && bars->count > 0) {
+            if (selected_index >= 0 && selected_index < count) {
+                selected_index = bar_series_find(bars, points[selected_index].timestamp);
+            }
+            points = bars->bars;
+            count = bars->count;
+            compare = NULL;
+            chart_view_bars = bars;
+        }
+    }
+    if (chart_line_mode != CHART_LINE_OFF) {
+        compare = NULL;
+    }
+
     const char *period_str = ui_period_label(period);
+    char kind[48];
+    const char *bar_label = chart_bar_labels[chart_view_bars ? chart_bar_type : BAR_CANDLES];
+    if (chart_line_mode == CHART_LINE_OFF) {
+        snprintf(kind, sizeof(kind), "%s", bar_label);
+    } else {
+        snprintf(kind, sizeof(kind), "%s%s%s", chart_view_bars ? bar_label : "",
+                 chart_view_bars ? " " : "", chart_line_mode == CHART_LINE_AREA ? "AREA" : "LINE");
+    }
     char header_text[128];
-    snprintf(header_text, sizeof(header_text), "%s - %s CANDLESTICK CHART", symbol, period_str);
+    if (chart_view_bars && chart_bar_type != BAR_HEIKIN_ASHI) {
+        char box_str[32];
+        ui_format_number(box_str, sizeof(box_str), chart_view_bars->box);
+        ui_trim_trailing_zeros(box_str);
+        snprintf(header_text, sizeof(header_text), "%s - %s %s CHART (BOX %s = %g%%)", symbol,
+                 period_str, kind, box_str, chart_box_percents[chart_box_index]);
+    } else {
+        snprintf(header_text, sizeof(header_text), "%s - %s %s CHART", symbol, period_str,
+                 kind);
+    }
     int header_len = (int)strlen(header_text);
     int header_x = (COLS - header_len) / 2;
     if (header_x < 0) {
@@ -249,6 +658,43 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
         if (points[i].low < min_price) min_price = points[i].low;
         if (points[i].high > max_price) max_price = points[i].high;
     }
+
+    // The comparison is rebased onto the first candle both series share.
+    // Percent mode shares the price axis; the ratio gets its own scale.
+    int compare_base = -1;
+    double ratio_min = 0.0;
+    double ratio_max = 0.0;
+    if (compare && compare->mode != CHART_COMPARE_OFF && compare->points &&
+        compare->positions && compare->positions_capacity >= count) {
+        for (int i = 0; i < count && compare_base < 0; ++i) {
+            int pos = compare->positions[i];
+            if (pos >= 0 && compare->points[pos].close > 0.0) {
+                compare_base = i;
+            }
+        }
+    }
+    if (compare_base >= 0) {
+        bool ratio = compare->mode == CHART_COMPARE_RATIO;
+        bool first = true;
+        for (int i = compare_base; i < count; ++i) {
+            double value = compare_value(compare, points, compare_base, i);
+            if (isnan(value)) {
+                continue;
+            }
+            if (ratio) {
+                if (first || value < ratio_min) ratio_min = value;
+                if (first || value > ratio_max) ratio_max = value;
+                first = false;
+            } else {
+                if (value < min_price) min_price = value;
+                if (value > max_price) max_price = value;
+            }
+        }
+        if (ratio_max - ratio_min < 1e-12) {
+            ratio_min -= ratio_min * 0.01 + 1e-12;
+            ratio_max += ratio_max * 0.01 + 1e-12;
+        }
+    }
     if (max_price - min_price < 0.000001) {
         min_price -= 1.0;
         max_price += 1.0;
@@ -293,6 +739,44 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
     int info_y = 2;
     int info_height = 14;
 
+    // Carve the volume profile strip off the right edge of the candle area.
+    int profile_width = 0;
+    if (chart_profile_enabled && chart_width >= 40) {
+        profile_width = chart_width / 5;
+        if (profile_width > 20) profile_width = 20;
+        chart_width -= profile_width + 1;
+    }
+    int profile_x = chart_x + chart_width + 1;
+
+    // Line/area mode: one M4 column per screen column over the whole
+    // series, scaled to the closes.
+    int line_columns = 0;
+    if (chart_line_mode != CHART_LINE_OFF) {
+        if (chart_width > chart_m4_capacity) {
+            M4Column *m4 = realloc(chart_m4, sizeof(M4Column) * (size_t)chart_width);
+            if (m4) {
+                chart_m4 = m4;
+                chart_m4_capacity = chart_width;
+            }
+        }
+        if (chart_width <= chart_m4_capacity) {
+            line_columns = m4_aggregate(points, 0, count, chart_width, chart_m4);
+        }
+        if (line_columns > 0) {
+            min_price = chart_m4[0].min;
+            max_price = chart_m4[0].max;
+            for (int c = 1; c < line_columns; ++c) {
+                if (chart_m4[c].min < min_price) min_price = chart_m4[c].min;
+                if (chart_m4[c].max > max_price) max_price = chart_m4[c].max;
+            }
+            if (max_price - min_price < 0.000001) {
+                min_price -= 1.0;
+                max_price += 1.0;
+            }
+        }
+    }
+    chart_view_line_columns = line_columns;
+
     double price_range = max_price - min_price;
 
     // Draw faint grid lines inside the chart area for better price context.
@@ -324,8 +808,8 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
 
     // Compute how many candles can fit (respecting spacing between candles).
     // Use stride=2 so each candle is 1 column wide with a 1-column gap.
-    int candle_stride = 2;
-    int visible_points = chart_width / candle_stride;
+    int candle_stride = (line_columns > 0) ? 1 : 2;
+    int visible_points = (line_columns > 0) ? line_columns : chart_width / candle_stride;
     if (visible_points < 1) {
         visible_points = 1;
     }
@@ -358,14 +842,36 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
     if (start_idx + visible_points > count) {
         start_idx = count - visible_points;
     }
-    if (start_idx < 0) {
+    if (start_idx < 0 || line_columns > 0) {
         start_idx = 0;
     }
 
     chart_view_start_idx = start_idx;
+    int view_end = (line_columns > 0) ? count : start_idx + visible_points;
+
+    // Resolve the range selection; it lapses when its anchor candle is gone
+    // (e.g. after an interval change). Derived bars hide it.
+    RangeStats range_stats;
+    bool range_shown = false;
+    if (chart_range_active && !chart_view_bars && selected_index >= 0 &&
+        selected_index < count) {
+        int anchor_idx = find_candle(points, count, chart_range_anchor);
+        if (anchor_idx < 0) {
+            chart_range_active = false;
+        } else if (range_index_sync(&chart_range_index, points, count) == 0) {
+            range_index_query(&chart_range_index, points, count, anchor_idx, selected_index,
+                              &range_stats);
+            range_shown = true;
+        }
+    }
+
+    if (line_columns > 0) {
+        draw_line_columns(chart_x, chart_y, chart_height, line_columns, min_price, max_price,
+                          chart_line_mode == CHART_LINE_AREA);
+    }
 
     // Draw candlesticks within the visible window.
-    for (int i = 0; i < visible_points; ++i) {
+    for (int i = 0; line_columns == 0 && i < visible_points; ++i) {
         int idx = start_idx + i;
         if (idx < 0 || idx >= count) {
             continue;
@@ -396,6 +902,64 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
         }
     }
 
+    if (compare_base >= 0) {
+        // Comparison dots sit in the gap column right of each candle.
+        bool ratio = compare->mode == CHART_COMPARE_RATIO;
+        double lo = ratio ? ratio_min : min_price;
+        double hi = ratio ? ratio_max : max_price;
+        attr_t attr = A_BOLD | (colors_available ? COLOR_PAIR(COLOR_PAIR_INFO_CLOSE) : 0);
+        wattron(main_win, attr);
+        for (int i = 0; i < visible_points; ++i) {
+            int idx = start_idx + i;
+            int x = chart_x + i * candle_stride + 1;
+            if (idx < compare_base || idx >= count || x >= chart_x + chart_width) {
+                continue;
+            }
+            double value = compare_value(compare, points, compare_base, idx);
+            if (!isnan(value)) {
+                mvwaddch(main_win, price_to_row(value, lo, hi, chart_height, chart_y), x,
+                         ACS_BULLET);
+            }
+        }
+
+        // Legend for the selected candle on the row under the title.
+        char legend[128];
+        int sel = (selected_index >= compare_base && selected_index < count)
+            ? selected_index
+            : count - 1;
+        double value = compare_value(compare, points, compare_base, sel);
+        if (ratio) {
+            char ratio_str[32], lo_str[32], hi_str[32];
+            ui_format_number(ratio_str, sizeof(ratio_str), value);
+            ui_format_number(lo_str, sizeof(lo_str), ratio_min);
+            ui_format_number(hi_str, sizeof(hi_str), ratio_max);
+            ui_trim_trailing_zeros(ratio_str);
+            ui_trim_trailing_zeros(lo_str);
+            ui_trim_trailing_zeros(hi_str);
+            snprintf(legend, sizeof(legend), "%s/%s: %s (range %s - %s)", symbol,
+                     compare->symbol, isnan(value) ? "n/a" : ratio_str, lo_str, hi_str);
+        } else {
+            double base = points[compare_base].close;
+            double own = (base > 0.0) ? points[sel].close / base - 1.0 : 0.0;
+            double other = (base > 0.0) ? value / base - 1.0 : 0.0;
+            if (isnan(value)) {
+                snprintf(legend, sizeof(legend), "vs %s: %s %+.2f%% | %s n/a",
+                         compare->symbol, symbol, own * 100.0, compare->symbol);
+            } else {
+                snprintf(legend, sizeof(legend), "vs %s: %s %+.2f%% | %s %+.2f%%",
+                         compare->symbol, symbol, own * 100.0, compare->symbol,
+                         other * 100.0);
+            }
+        }
+        mvwaddnstr(main_win, 1, chart_x, legend, COLS - chart_x - 1);
+        wattroff(main_win, attr);
+    }
+
+    if (profile_width > 0) {
+        draw_volume_profile(profile_x, chart_y, profile_width, chart_height, points, count,
+                            start_idx, view_end, min_price, max_price);
+    }
+
     // Draw X-axis line and time labels below the chart area.
     int axis_y = chart_y + chart_height;
     if (axis_y < LINES - 2) {
@@ -405,6 +969,20 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
         }
         mvwhline(main_win, axis_y, axis_width, ACS_HLINE, axis_len);
         mvwaddch(main_win, axis_y, axis_width, ACS_LLCORNER);
+        if (range_shown) {
+            // Underline the selected span on the axis.
+            int first = view_column(range_stats.from, start_idx, count, line_columns);
+            int last = view_column(range_stats.to, start_idx, count, line_columns);
+            if (first < 0) first = 0;
+            if (last > visible_points - 1) last = visible_points - 1;
+            if (first <= last) {
+                attr_t attr = A_BOLD | (colors_available ? COLOR_PAIR(COLOR_PAIR_SYMBOL) : 0);
+                wattron(main_win, attr);
+                mvwhline(main_win, axis_y, chart_x + first * candle_stride, ACS_HLINE,
+                         (last - first) * candle_stride + 1);
+                wattroff(main_win, attr);
+            }
+        }
         int arrow_row = axis_y;
         int label_row = axis_y + 1;
         if (label_row < LINES - 1) {
@@ -425,7 +1003,7 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
             }
             for (int t = 0; t < ticks; ++t) {
                 int col_idx = (t == ticks - 1) ? (visible_points - 1) : t * step;
-                int idx = start_idx + col_idx;
+                int idx = view_index(col_idx, start_idx, line_columns);
                 if (idx < 0 || idx >= count) {
                     continue;
                 }
@@ -433,7 +1011,9 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
                 struct tm tm_buf;
                 char time_str[32];
                 const char *fmt = "%m-%d";
-                if (period <= PERIOD_1HOUR) {
+                if (period_is_local(period)) {
+                    fmt = (label_width >= 8) ? "%H:%M:%S" : "%M:%S";
+                } else if (period <= PERIOD_1HOUR) {
                     fmt = (label_width >= 8) ? "%H:%M" : "%H";
                 } else if (period <= PERIOD_4HOUR) {
                     fmt = (label_width >= 10) ? "%m-%d %H:%M" : "%m-%d";
@@ -475,11 +1055,11 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
         selected_point = &points[selected_index];
     }
     if (count > 0) {
-        latest_point = &points[count - 1];
+        latest_point = live_candle;
     }
 
     if (selected_point) {
-        int highlight_idx = selected_index - start_idx;
+        int highlight_idx = view_column(selected_index, start_idx, count, line_columns);
         if (highlight_idx >= 0 && highlight_idx < visible_points) {
             int highlight_x = chart_x + highlight_idx * candle_stride;
             int line_bottom = axis_y - 2;
@@ -527,7 +1107,12 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
             if (info_x + info_width > COLS) {
                 info_x = COLS - info_width;
             }
-            draw_info_box(info_x, info_y, info_width, info_height, selected_point);
+            if (range_shown) {
+                draw_range_box(info_x, info_y, info_width, info_height, points,
+                               &range_stats);
+            } else {
+                draw_info_box(info_x, info_y, info_width, info_height, selected_point);
+            }
         }
     }
 
@@ -547,13 +1132,55 @@ void draw_chart(const char *restrict symbol, int count, PricePoint points[count]
         }
     }
 
-    draw_footer_bar("KEYS: ←/→ CURSOR | ↑/↓: CHANGE INTERVAL | F: FOLLOW LATEST | R: REFRESH | LEFT CLICK: PICK CANDLE | RIGHT CLICK/ESC/Q: BACK");
+    // Keep what crosshair-only updates need, then put the crosshair back.
+    chart_cross_view.chart_x = chart_x;
+    chart_cross_view.chart_y = chart_y;
+    chart_cross_view.chart_width = chart_width;
+    chart_cross_view.chart_height = chart_height;
+    chart_cross_view.label_row = chart_y + chart_height + 1;
+    chart_cross_view.label_max_x = (info_x - 2 > chart_x + chart_width - 1)
+        ? info_x - 2
+        : chart_x + chart_width - 1;
+    chart_cross_view.min_price = min_price;
+    chart_cross_view.max_price = max_price;
+    chart_cross_view.period = period;
+    int shown = (count - start_idx < visible_points) ? count - start_idx : visible_points;
+    if (shown > chart_cross_view.times_capacity) {
+        uint64_t *times = realloc(chart_cross_view.times, sizeof(uint64_t) * (size_t)shown);
+        if (times) {
+            chart_cross_view.times = times;
+            chart_cross_view.times_capacity = shown;
+        }
+    }
+    if (shown <= chart_cross_view.times_capacity) {
+        for (int i = 0; i < shown; ++i) {
+            chart_cross_view.times[i] = points[view_index(i, start_idx, line_columns)].timestamp;
+        }
+        chart_cross_view.visible = shown;
+    }
+    draw_crosshair();
+
+    draw_footer_bar("KEYS: ←/→ CURSOR | ↑/↓: CHANGE INTERVAL | F: FOLLOW LATEST | S: MARK RANGE | V: VOLUME PROFILE | B: BAR TYPE | [/]: BOX SIZE | L: LINE/AREA | O: COMPARE | C: COMPARE NEXT | R: REFRESH | LEFT CLICK: PICK CANDLE | RIGHT CLICK/ESC/Q: BACK");
+
+    wrefresh(main_win);
+}
 
+// Move the hover crosshair to the pointer at (@p x, @p y), touching only
+// the cells it leaves and enters.
+int ui_chart_move_crosshair(int x, int y) {
+    int erased = chart_cross_count;
+    erase_crosshair();
+    chart_pointer_valid = true;
+    chart_pointer_x = x;
+    chart_pointer_y = y;
+    draw_crosshair();
     wrefresh(main_win);
+    return erased + chart_cross_count;
 }
 
 // Convert mouse X position to a candle index in the current chart viewport.
-int ui_chart_hit_test_index(int mouse_x, int total_points) {
+// A derived bar maps to the candle that completed it.
+int ui_chart_hit_test_index(int mouse_x, const PricePoint *points, int total_points) {
     if (total_points <= 0) {
         return -1;
     }
@@ -566,8 +1193,67 @@ int ui_chart_hit_test_index(int mouse_x, int total_points) {
     }
     int col = (mouse_x - chart_view_start_x) / chart_view_stride;
     int idx = chart_view_start_idx + col;
-    if (idx < 0 || idx >= total_points) {
+    if (chart_view_line_columns > 0) {
+        // The last candle of the M4 column, whose close ends the line there.
+        idx = (col < chart_view_line_columns) ? chart_m4[col].to - 1 : -1;
+    }
+    if (!chart_view_bars) {
+        return (idx >= 0 && idx < total_points) ? idx : -1;
+    }
+    if (idx < 0 || idx >= chart_view_bars->count) {
         return -1;
     }
-    return idx;
+    // Last candle opening at or before the bar's close.
+    uint64_t close_time = chart_view_bars->bars[idx].close_time;
+    int lo = 0;
+    int hi = total_points - 1;
+    while (lo < hi) {
+        int mid = lo + (hi - lo + 1) / 2;
+        if (points[mid].timestamp <= close_time) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+// Show or hide the volume profile strip.
+void ui_chart_toggle_volume_profile(void) {
+    chart_profile_enabled = !chart_profile_enabled;
+}
+
+// Anchor a range selection at @p timestamp, or clear the current one.
+void ui_chart_toggle_range(uint64_t timestamp) {
+    chart_range_active = !chart_range_active;
+    chart_range_anchor = timestamp;
+}
+
+// Step through candles, Heikin-Ashi, Renko and range bars.
+void ui_chart_cycle_bar_type(void) {
+    chart_bar_type = (BarType)((chart_bar_type + 1) % BAR_TYPE_COUNT);
+}
+
+// Step through candles, line and area drawing.
+void ui_chart_cycle_line_mode(void) {
+    chart_line_mode = (ChartLineMode)((chart_line_mode + 1) % CHART_LINE_MODE_COUNT);
+}
+
+// Pick the next smaller (@p step < 0) or larger box size for Renko and range bars.
+void ui_chart_step_box_size(int step) {
+    int last = (int)(sizeof(chart_box_percents) / sizeof(chart_box_percents[0])) - 1;
+    chart_box_index += (step < 0) ? -1 : 1;
+    if (chart_box_index < 0) chart_box_index = 0;
+    if (chart_box_index > last) chart_box_index = last;
+}
+
+// Drop the cached profile, range index and selection (called when the chart closes).
+void reset_chart_overlays(void) {
+    volprofile_free(&chart_profile);
+    range_index_free(&chart_range_index);
+    chart_range_active = false;
+    chart_view_bars = NULL;
+    chart_pointer_valid = false;
+    chart_cross_count = 0;
+    chart_view_line_columns = 0;
 }
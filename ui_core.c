@@ -29,11 +29,21 @@ SOFTWARE.
 
 #include <locale.h>
 #include <math.h>
+#include <pthread.h>
+#include <signal.h>
 #include <stdatomic.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include "ui_internal.h"
 
+// xterm any-event mouse tracking, the only mode that reports bare pointer
+// motion (for the chart crosshair).
+#define ANY_MOTION_ON "\033[?1003h"
+#define ANY_MOTION_OFF "\033[?1003l"
+
 // ncurses window for all rendering in this module.
 WINDOW *main_win = NULL;
 // Whether terminal supports colors (set during init_ui()).
@@ -56,6 +66,16 @@ int chart_view_total_points = 0;
 // Atomic status shown in the footer bar.
 static _Atomic StatusPanelState status_panel_state = STATUS_PANEL_NORMAL;
 
+// Transient alert shown in the status panel instead of the state label.
+static pthread_mutex_t status_alert_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char status_alert_text[64];
+static time_t status_alert_until = 0;
+
+// Whether init_ui() switched any-event tracking on.
+static volatile sig_atomic_t any_motion_enabled = 0;
+// Signals that end the process without reaching cleanup_ui().
+static const int fatal_signals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
 // Reset chart viewport to a neutral state (used on init and chart exit).
 void reset_chart_view_state(void) {
     chart_view_start_x = 0;
@@ -111,6 +131,61 @@ void ui_set_status_panel_state(StatusPanelState state) {
     atomic_store_explicit(&status_panel_state, state, memory_order_relaxed);
 }
 
+// Set the footer alert text and its expiry (used by background monitors).
+void ui_set_status_alert(const char *text, int seconds) {
+    pthread_mutex_lock(&status_alert_mutex);
+    snprintf(status_alert_text, sizeof(status_alert_text), "%s", text);
+    status_alert_until = time(NULL) + seconds;
+    pthread_mutex_unlock(&status_alert_mutex);
+}
+
+// Copy the active alert into @p buf; false when none is showing.
+static bool current_status_alert(char *buf, size_t size) {
+    pthread_mutex_lock(&status_alert_mutex);
+    bool active = status_alert_until > time(NULL);
+    if (active) {
+        snprintf(buf, size, "%s", status_alert_text);
+    }
+    pthread_mutex_unlock(&status_alert_mutex);
+    return active;
+}
+
+// Unified title bar: left label, centered view name, and right clock.
+void draw_title_bar(const char *title_text) {
+    time_t now = time(NULL);
+    char time_str[64];
+    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    const char *left_text = "CTICKER";
+    int left_x = 2;
+    int left_len = (int)strlen(left_text);
+    int title_len = (int)strlen(title_text);
+    int time_x = COLS - (int)strlen(time_str) - 2;
+    if (time_x < 2) {
+        time_x = 2;
+    }
+    int title_x = (COLS - title_len) / 2;
+    if (title_x < 2) {
+        title_x = 2;
+    }
+    int min_title_x = left_x + left_len + 2;
+    if (title_x < min_title_x) {
+        title_x = min_title_x;
+    }
+    if (title_x + title_len >= time_x) {
+        title_x = time_x - title_len - 1;
+        if (title_x < 2) {
+            title_x = 2;
+        }
+    }
+
+    wattron(main_win, COLOR_PAIR(COLOR_PAIR_TITLE_BAR));
+    mvwhline(main_win, 0, 0, ' ', COLS);
+    mvwprintw(main_win, 0, left_x, "%s", left_text);
+    mvwprintw(main_win, 0, title_x, "%s", title_text);
+    mvwprintw(main_win, 0, time_x, "%s", time_str);
+    wattroff(main_win, COLOR_PAIR(COLOR_PAIR_TITLE_BAR));
+}
+
 // Render a bottom footer bar with a contrasting background for interaction hints.
 void draw_footer_bar(const char *text) {
     if (!main_win || LINES <= 0) {
@@ -123,10 +198,19 @@ void draw_footer_bar(const char *text) {
     }
 
     int start_x = (COLS >= 4) ? 2 : 0;
+    char alert[sizeof(status_alert_text)];
+    bool alerting = current_status_alert(alert, sizeof(alert));
     int panel_width = COLS / 10;
     if (panel_width < 12) {
         panel_width = 12;
     }
+    // Alerts widen the panel up to a third of the screen.
+    if (alerting && panel_width < (int)strlen(alert) + 2) {
+        panel_width = (int)strlen(alert) + 2;
+        if (panel_width > COLS / 3) {
+            panel_width = COLS / 3;
+        }
+    }
     if (panel_width > COLS) {
         panel_width = COLS;
     }
@@ -156,7 +240,7 @@ void draw_footer_bar(const char *text) {
     }
 
     StatusPanelState state = atomic_load_explicit(&status_panel_state, memory_order_relaxed);
-    const char *label = status_panel_label(state);
+    const char *label = alerting ? alert : status_panel_label(state);
     int label_len = (int)strlen(label);
     int label_max = panel_width - 2;
     if (label_max < 1) {
@@ -171,7 +255,8 @@ void draw_footer_bar(const char *text) {
     }
 
     if (panel_width > 0) {
-        int pair = status_panel_pair(state);
+        int pair = alerting && colors_available ? COLOR_PAIR_STATUS_PANEL_ALERT
+                                                : status_panel_pair(state);
         if (colors_available && pair > 0) {
             wattron(main_win, COLOR_PAIR(pair) | A_BOLD);
         } else if (colors_available) {
@@ -189,6 +274,46 @@ void draw_footer_bar(const char *text) {
     }
 }
 
+// Fatal signal: take the terminal out of any-event tracking (with write(),
+// as ncurses output is not async-signal-safe), then die as before.
+static void restore_mouse_mode(int signo) {
+    if (any_motion_enabled) {
+        ssize_t written = write(STDOUT_FILENO, ANY_MOTION_OFF, sizeof(ANY_MOTION_OFF) - 1);
+        (void)written;
+    }
+    signal(signo, SIG_DFL);
+    raise(signo);
+}
+
+// Switch any-event tracking on when terminfo describes an xterm-style mouse
+// (XM, or failing that the kmous key) and make sure it is undone on exit.
+static void enable_pointer_motion(void) {
+    const char *xm = tigetstr("XM");
+    const char *kmous = tigetstr("kmous");
+    bool xterm_mouse = (xm && xm != (char *)-1) ||
+                       (kmous && kmous != (char *)-1 && strncmp(kmous, "\033[", 2) == 0);
+    if (!xterm_mouse) {
+        return;
+    }
+    putp(ANY_MOTION_ON);
+    any_motion_enabled = 1;
+    for (size_t i = 0; i < sizeof(fatal_signals) / sizeof(fatal_signals[0]); i++) {
+        signal(fatal_signals[i], restore_mouse_mode);
+    }
+}
+
+// Undo enable_pointer_motion(); the escape goes out with endwin()'s flush.
+static void disable_pointer_motion(void) {
+    if (!any_motion_enabled) {
+        return;
+    }
+    putp(ANY_MOTION_OFF);
+    any_motion_enabled = 0;
+    for (size_t i = 0; i < sizeof(fatal_signals) / sizeof(fatal_signals[0]); i++) {
+        signal(fatal_signals[i], SIG_DFL);
+    }
+}
+
 // Initialize ncurses and prepare the root window plus color palette.
 void init_ui(void) {
     setlocale(LC_ALL, "");
@@ -202,8 +327,9 @@ void init_ui(void) {
     timeout(1000);
     mousemask(BUTTON1_PRESSED | BUTTON1_RELEASED | BUTTON1_CLICKED |
               BUTTON3_PRESSED | BUTTON3_RELEASED | BUTTON3_CLICKED |
-              BUTTON4_PRESSED | BUTTON5_PRESSED, NULL);
+              BUTTON4_PRESSED | BUTTON5_PRESSED | REPORT_MOUSE_POSITION, NULL);
     mouseinterval(0);
+    enable_pointer_motion();
 
     // Initialize colors
     colors_available = has_colors();
@@ -263,11 +389,13 @@ void cleanup_ui(void) {
     if (main_win) {
         delwin(main_win);
     }
+    disable_pointer_motion();
     endwin();
 }
 
 void ui_chart_reset_viewport(void) {
     reset_chart_view_state();
+    reset_chart_overlays();
 }
 
 /**
@@ -347,3 +475,33 @@ void draw_splash_screen(void) {
 int handle_input(void) {
     return wgetch(main_win);
 }
+
+// Drain pointer motion already queued, keeping the newest position; the
+// first other input is pushed back for the next handle_input().
+int ui_coalesce_pointer_motion(int *x, int *y) {
+    int dropped = 0;
+    wtimeout(main_win, 0);
+    for (;;) {
+        int ch = wgetch(main_win);
+        if (ch == ERR) {
+            break;
+        }
+        if (ch != KEY_MOUSE) {
+            ungetch(ch);
+            break;
+        }
+        MEVENT ev;
+        if (getmouse(&ev) != OK) {
+            continue;
+        }
+        if (ev.bstate != REPORT_MOUSE_POSITION) {
+            ungetmouse(&ev);
+            break;
+        }
+        *x = ev.x;
+        *y = ev.y;
+        dropped++;
+    }
+    wtimeout(main_win, 1000);
+    return dropped;
+}
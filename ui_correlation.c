@@ -0,0 +1,190 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file ui_correlation.c
+ * @brief Correlation heat grid rendering.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <time.h>
+#include "correlation.h"
+#include "portfolio.h"
+#include "ui_internal.h"
+
+// Grid geometry: row label width and cell width (" +0.87").
+#define LABEL_WIDTH 11
+#define CELL_WIDTH 6
+#define GRID_START_Y 5
+
+// First visible grid row/column (kept across frames like the board offset).
+static int correlation_row_offset = 0;
+static int correlation_col_offset = 0;
+
+// Column label: the base asset when the quote is known, else the symbol head.
+static void column_label(const char *symbol, char *label, size_t size) {
+    char quote[MAX_SYMBOL_LEN];
+    if (portfolio_split_symbol(symbol, label, size, quote, sizeof(quote)) != 0) {
+        snprintf(label, size, "%s", symbol);
+    }
+    if (strlen(label) > CELL_WIDTH - 1) {
+        label[CELL_WIDTH - 1] = '\0';
+    }
+}
+
+// Heat colour for a coefficient: solid beyond ±0.7, tinted beyond ±0.3.
+static int cell_pair(double value, attr_t *attrs) {
+    *attrs = 0;
+    if (!colors_available || isnan(value)) {
+        return 0;
+    }
+    double magnitude = fabs(value);
+    if (magnitude >= 0.7) {
+        return value > 0.0 ? COLOR_PAIR_GREEN_BG : COLOR_PAIR_RED_BG;
+    }
+    if (magnitude >= 0.3) {
+        *attrs = A_BOLD;
+        return value > 0.0 ? COLOR_PAIR_GREEN : COLOR_PAIR_RED;
+    }
+    return 0;
+}
+
+// Keep @p cursor inside [offset, offset + visible) by moving the offset.
+static int scroll_to(int offset, int cursor, int visible, int count) {
+    if (cursor < offset) {
+        offset = cursor;
+    } else if (cursor >= offset + visible) {
+        offset = cursor - visible + 1;
+    }
+    if (offset > count - visible) {
+        offset = count - visible;
+    }
+    return offset < 0 ? 0 : offset;
+}
+
+// Summary line: interval, window and the pair under the cursor.
+static void draw_correlation_summary(const CorrelationSnapshot *snapshot, int row, int col) {
+    char updated[32] = "-";
+    if (snapshot->last_close > 0) {
+        struct tm tm_buf;
+        time_t ts = (time_t)snapshot->last_close;
+        strftime(updated, sizeof(updated), "%Y-%m-%d %H:%M", localtime_r(&ts, &tm_buf));
+    }
+    wattron(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+    mvwprintw(main_win, 2, 2, "INTERVAL %s | WINDOW %d RETURNS | %d SYMBOLS | LAST CLOSE %s",
+              period_interval_code(snapshot->period), snapshot->window,
+              snapshot->symbol_count, updated);
+    wattroff(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+
+    double value = snapshot->matrix[(size_t)row * snapshot->symbol_count + col];
+    if (isnan(value)) {
+        mvwprintw(main_win, 3, 2, "%s ~ %s: -", snapshot->symbols[row], snapshot->symbols[col]);
+    } else {
+        mvwprintw(main_win, 3, 2, "%s ~ %s: %+.3f", snapshot->symbols[row],
+                  snapshot->symbols[col], value);
+    }
+}
+
+// Draw the correlation matrix as a coloured grid with a cell cursor.
+void draw_correlation_screen(const CorrelationSnapshot *snapshot, int row, int col) {
+    werase(main_win);
+    draw_title_bar("[C][O][R][R][E][L][A][T][I][O][N]");
+
+    int n = snapshot->symbol_count;
+    if (snapshot->status != CORRELATION_READY || n < 2) {
+        const char *message = snapshot->status == CORRELATION_LOADING
+            ? "Loading candles for %s..."
+            : "No aligned candles on %s (needs two or more symbols with history).";
+        mvwprintw(main_win, 2, 2, message, period_interval_code(snapshot->period));
+    } else {
+        draw_correlation_summary(snapshot, row, col);
+
+        int visible_rows = LINES - 1 - (GRID_START_Y + 1);
+        int visible_cols = (COLS - 2 - LABEL_WIDTH) / CELL_WIDTH;
+        if (visible_rows < 1) {
+            visible_rows = 1;
+        }
+        if (visible_cols < 1) {
+            visible_cols = 1;
+        }
+        correlation_row_offset = scroll_to(correlation_row_offset, row, visible_rows, n);
+        correlation_col_offset = scroll_to(correlation_col_offset, col, visible_cols, n);
+        int row_end = correlation_row_offset + visible_rows;
+        int col_end = correlation_col_offset + visible_cols;
+        row_end = row_end > n ? n : row_end;
+        col_end = col_end > n ? n : col_end;
+
+        wattron(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+        for (int j = correlation_col_offset; j < col_end; j++) {
+            char label[MAX_SYMBOL_LEN];
+            column_label(snapshot->symbols[j], label, sizeof(label));
+            int x = 2 + LABEL_WIDTH + (j - correlation_col_offset) * CELL_WIDTH;
+            mvwprintw(main_win, GRID_START_Y, x, "%*s", CELL_WIDTH, label);
+        }
+        wattroff(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+
+        for (int i = correlation_row_offset; i < row_end; i++) {
+            int y = GRID_START_Y + 1 + (i - correlation_row_offset);
+            int sym_pair = i == row ? COLOR_PAIR_SYMBOL_SELECTED : COLOR_PAIR_SYMBOL;
+            if (colors_available) {
+                wattron(main_win, COLOR_PAIR(sym_pair) | A_BOLD);
+            }
+            mvwprintw(main_win, y, 2, "%-*.*s", LABEL_WIDTH, LABEL_WIDTH - 1,
+                      snapshot->symbols[i]);
+            if (colors_available) {
+                wattroff(main_win, COLOR_PAIR(sym_pair) | A_BOLD);
+            }
+            for (int j = correlation_col_offset; j < col_end; j++) {
+                double value = snapshot->matrix[(size_t)i * n + j];
+                int x = 2 + LABEL_WIDTH + (j - correlation_col_offset) * CELL_WIDTH;
+                attr_t attrs = 0;
+                int pair = cell_pair(value, &attrs);
+                if (i == row && j == col) {
+                    attrs |= A_REVERSE;
+                }
+                if (pair) {
+                    attrs |= COLOR_PAIR(pair);
+                }
+                wattron(main_win, attrs);
+                if (isnan(value)) {
+                    mvwprintw(main_win, y, x, "%*s", CELL_WIDTH, "- ");
+                } else {
+                    mvwprintw(main_win, y, x, " %+.2f", value);
+                }
+                wattroff(main_win, attrs);
+            }
+        }
+
+        if (correlation_row_offset > 0) {
+            mvwaddch(main_win, GRID_START_Y + 1, 0, ACS_UARROW);
+        }
+        if (row_end < n) {
+            mvwaddch(main_win, GRID_START_Y + visible_rows, 0, ACS_DARROW);
+        }
+    }
+
+    draw_footer_bar("KEYS: ARROWS MOVE | TAB: INTERVAL | C/ESC: PRICE BOARD | Q: QUIT");
+    wrefresh(main_win);
+}
@@ -128,6 +128,10 @@ void ui_format_integer_with_commas(char *buf, size_t size, long long value) {
 // Translate an enum period into a user-facing label.
 const char *ui_period_label(Period period) {
     switch (period) {
+        case PERIOD_1SEC: return "1 SECOND";
+        case PERIOD_5SEC: return "5 SECONDS";
+        case PERIOD_15SEC: return "15 SECONDS";
+        case PERIOD_30SEC: return "30 SECONDS";
         case PERIOD_1MIN: return "1 MINUTE";
         case PERIOD_15MIN: return "15 MINUTES";
         case PERIOD_1HOUR: return "1 HOUR";
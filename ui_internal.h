@@ -70,6 +70,8 @@ extern int chart_view_total_points;
 // Shared helper functions across UI modules.
 void reset_price_history(void);
 void reset_chart_view_state(void);
+void reset_chart_overlays(void);
+void draw_title_bar(const char *title);
 void draw_footer_bar(const char *text);
 
 void ui_format_number(char *buf, size_t size, double num);
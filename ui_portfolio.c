@@ -0,0 +1,219 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file ui_portfolio.c
+ * @brief Portfolio panel rendering.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "portfolio.h"
+#include "ui_internal.h"
+
+// Column anchors for the portfolio layout.
+#define QTY_COL 18
+#define ENTRY_COL 34
+#define PRICE_COL 50
+#define VALUE_COL 66
+#define PNL_COL 84
+#define PNL_PCT_COL 102
+
+// First visible lot (kept across frames like the price board offset).
+static int portfolio_scroll_offset = 0;
+
+// Print a signed amount in green/red, honoring the selection background.
+static void draw_signed_cell(int y, int x, int width, const char *text, bool up,
+                             bool row_selected) {
+    int pair = 0;
+    if (colors_available) {
+        if (row_selected) {
+            pair = up ? COLOR_PAIR_GREEN_SELECTED : COLOR_PAIR_RED_SELECTED;
+        } else {
+            pair = up ? COLOR_PAIR_GREEN : COLOR_PAIR_RED;
+        }
+        wattron(main_win, COLOR_PAIR(pair) | A_BOLD);
+    }
+    mvwprintw(main_win, y, x, "%*s", width, text);
+    if (colors_available) {
+        wattroff(main_win, COLOR_PAIR(pair) | A_BOLD);
+    }
+}
+
+// Summary line with the running totals.
+static void draw_portfolio_totals(const Portfolio *portfolio, const PortfolioView *view) {
+    const PortfolioTotals *totals = &view->totals;
+    char value_buf[48];
+    char pnl_buf[48];
+    ui_format_number_with_commas(value_buf, sizeof(value_buf), totals->value);
+    ui_format_number_with_commas(pnl_buf, sizeof(pnl_buf), totals->pnl);
+    double pct = totals->cost != 0.0 ? totals->pnl / fabs(totals->cost) * 100.0 : 0.0;
+
+    wattron(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+    mvwprintw(main_win, 2, 2, "VALUE %s %s", value_buf, portfolio->currency);
+    wattroff(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+
+    char text[96];
+    snprintf(text, sizeof(text), "P&L %s%s (%+.2f%%)", totals->pnl >= 0.0 ? "+" : "",
+             pnl_buf, pct);
+    int x = 2 + (int)strlen(value_buf) + (int)strlen(portfolio->currency) + 10;
+    if (x + (int)strlen(text) < COLS) {
+        draw_signed_cell(2, x, 0, text, totals->pnl >= 0.0, false);
+    }
+
+    char priced[48];
+    snprintf(priced, sizeof(priced), "PRICED %d/%d", totals->priced_rows, totals->held_rows);
+    int priced_x = COLS - (int)strlen(priced) - 2;
+    if (priced_x > x + (int)strlen(text) + 2) {
+        mvwprintw(main_win, 2, priced_x, "%s", priced);
+    }
+}
+
+// Draw the portfolio lots with per-lot P&L derived from the row snapshot.
+void draw_portfolio_screen(const Portfolio *portfolio, const PortfolioView *view,
+                           int selected) {
+    werase(main_win);
+    draw_title_bar("[P][O][R][T][F][O][L][I][O]");
+    draw_portfolio_totals(portfolio, view);
+
+    const int board_start_y = 6;
+    int visible_rows = LINES - 1 - board_start_y;
+    if (visible_rows < 1) {
+        visible_rows = 1;
+    }
+    int count = portfolio->lot_count;
+    int max_scroll = count - visible_rows;
+    if (max_scroll < 0) {
+        max_scroll = 0;
+    }
+    if (selected < portfolio_scroll_offset) {
+        portfolio_scroll_offset = selected;
+    } else if (selected >= portfolio_scroll_offset + visible_rows) {
+        portfolio_scroll_offset = selected - visible_rows + 1;
+    }
+    if (portfolio_scroll_offset > max_scroll) {
+        portfolio_scroll_offset = max_scroll;
+    }
+    if (portfolio_scroll_offset < 0) {
+        portfolio_scroll_offset = 0;
+    }
+
+    bool show_pct = (COLS > PNL_PCT_COL + 10);
+    wattron(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+    mvwprintw(main_win, 4, 2, "%-15s", "SYMBOL");
+    mvwprintw(main_win, 4, QTY_COL, "%14s", "QTY");
+    mvwprintw(main_win, 4, ENTRY_COL, "%14s", "ENTRY");
+    mvwprintw(main_win, 4, PRICE_COL, "%14s", "PRICE");
+    mvwprintw(main_win, 4, VALUE_COL, "%16s", "VALUE");
+    mvwprintw(main_win, 4, PNL_COL, "%16s", "P&L");
+    if (show_pct) {
+        mvwprintw(main_win, 4, PNL_PCT_COL, "%10s", "P&L %");
+    }
+    wattroff(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
+    mvwhline(main_win, 5, 2, ACS_HLINE, COLS - 4);
+
+    if (count == 0) {
+        mvwprintw(main_win, board_start_y, 2,
+                  "No holdings. Add lines like `hold BTCUSDT 0.5 42000` to ~/%s",
+                  CONFIG_FILE);
+    }
+
+    int end = portfolio_scroll_offset + visible_rows;
+    if (end > count) {
+        end = count;
+    }
+    for (int i = portfolio_scroll_offset; i < end; i++) {
+        const Holding *lot = &portfolio->lots[i];
+        int row = portfolio->lot_rows[i];
+        const PortfolioRow *state = row >= 0 ? &view->rows[row] : NULL;
+        int y = board_start_y + (i - portfolio_scroll_offset);
+        bool row_selected = (i == selected);
+
+        if (row_selected && colors_available) {
+            wattron(main_win, COLOR_PAIR(COLOR_PAIR_SELECTED));
+            mvwhline(main_win, y, 0, ' ', COLS);
+        }
+        if (colors_available) {
+            int sym_pair = row_selected ? COLOR_PAIR_SYMBOL_SELECTED : COLOR_PAIR_SYMBOL;
+            wattron(main_win, COLOR_PAIR(sym_pair) | A_BOLD);
+            mvwprintw(main_win, y, 2, "%-15s", lot->symbol);
+            wattroff(main_win, COLOR_PAIR(sym_pair) | A_BOLD);
+            if (row_selected) {
+                wattron(main_win, COLOR_PAIR(COLOR_PAIR_SELECTED));
+            }
+        } else {
+            mvwprintw(main_win, y, 2, "%-15s", lot->symbol);
+        }
+
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%.8f", lot->quantity);
+        ui_trim_trailing_zeros(buf);
+        mvwprintw(main_win, y, QTY_COL, "%14s", buf);
+        ui_format_number(buf, sizeof(buf), lot->entry_price);
+        ui_trim_trailing_zeros(buf);
+        mvwprintw(main_win, y, ENTRY_COL, "%14s", buf);
+
+        if (!state || !state->priced) {
+            const char *reason = !state ? "not watched"
+                : (portfolio->rate_hops[row] < 0 ? "no rate" : "-");
+            mvwprintw(main_win, y, PRICE_COL, "%14s", reason);
+        } else {
+            ui_format_number(buf, sizeof(buf), state->price);
+            ui_trim_trailing_zeros(buf);
+            mvwprintw(main_win, y, PRICE_COL, "%14s", buf);
+
+            double value = lot->quantity * state->price * state->rate;
+            double pnl = lot->quantity * (state->price - lot->entry_price) * state->rate;
+            ui_format_number_with_commas(buf, sizeof(buf), value);
+            mvwprintw(main_win, y, VALUE_COL, "%16s", buf);
+
+            char pnl_buf[64];
+            ui_format_number_with_commas(buf, sizeof(buf), pnl);
+            snprintf(pnl_buf, sizeof(pnl_buf), "%s%s", pnl >= 0.0 ? "+" : "", buf);
+            draw_signed_cell(y, PNL_COL, 16, pnl_buf, pnl >= 0.0, row_selected);
+            if (show_pct && lot->entry_price > 0.0) {
+                double cost = fabs(lot->quantity) * lot->entry_price * state->rate;
+                snprintf(pnl_buf, sizeof(pnl_buf), "%+.2f%%", pnl / cost * 100.0);
+                draw_signed_cell(y, PNL_PCT_COL, 10, pnl_buf, pnl >= 0.0, row_selected);
+            }
+        }
+        if (row_selected && colors_available) {
+            wattroff(main_win, COLOR_PAIR(COLOR_PAIR_SELECTED));
+        }
+    }
+
+    if (portfolio_scroll_offset > 0) {
+        mvwaddch(main_win, board_start_y, 0, ACS_UARROW);
+    }
+    if (portfolio_scroll_offset + visible_rows < count) {
+        mvwaddch(main_win, board_start_y + visible_rows - 1, 0, ACS_DARROW);
+    }
+
+    char footer_text[256];
+    snprintf(footer_text, sizeof(footer_text),
+             "KEYS: ↑/↓ NAVIGATE | P/ESC: PRICE BOARD | VALUES IN %s | Q: QUIT",
+             portfolio->currency);
+    draw_footer_bar(footer_text);
+    wrefresh(main_win);
+}
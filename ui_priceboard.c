@@ -29,7 +29,7 @@ SOFTWARE.
 
 #include <math.h>
 #include <string.h>
-#include <time.h>
+#include "patterns.h"
 #include "ui_internal.h"
 
 // Timing and formatting constants.
@@ -90,10 +90,101 @@ static void draw_change_cell(int y, const char *change_str, bool change_up,
     }
 }
 
+// Volatility, ATR and move z-score cells; moves beyond two standard
+// deviations are highlighted in the direction of the move.
+static void draw_move_stats(int y, const TickerData *ticker, bool show_vol, bool show_atr,
+                            bool show_z, bool row_selected) {
+    char buf[32];
+    if (!ticker->stats_ready) {
+        if (show_vol) {
+            mvwprintw(main_win, y, VOLUME_COL, "%14s", "-");
+        }
+        if (show_atr) {
+            mvwprintw(main_win, y, TRADES_COL, "%10s", "-");
+        }
+        if (show_z) {
+            mvwprintw(main_win, y, QUOTE_COL, "%14s", "-");
+        }
+        return;
+    }
+    if (show_vol) {
+        snprintf(buf, sizeof(buf), "%.2f%%", ticker->volatility);
+        mvwprintw(main_win, y, VOLUME_COL, "%14s", buf);
+    }
+    if (show_atr) {
+        snprintf(buf, sizeof(buf), "%.3f%%", ticker->atr_pct);
+        mvwprintw(main_win, y, TRADES_COL, "%10s", buf);
+    }
+    if (show_z) {
+        snprintf(buf, sizeof(buf), "%+.2f", ticker->move_z);
+        if (colors_available && fabs(ticker->move_z) >= 2.0) {
+            bool up = ticker->move_z > 0.0;
+            int pair = row_selected ? (up ? COLOR_PAIR_GREEN_SELECTED : COLOR_PAIR_RED_SELECTED)
+                                    : (up ? COLOR_PAIR_GREEN : COLOR_PAIR_RED);
+            wattron(main_win, COLOR_PAIR(pair) | A_BOLD);
+            mvwprintw(main_win, y, QUOTE_COL, "%14s", buf);
+            wattroff(main_win, COLOR_PAIR(pair) | A_BOLD);
+            if (row_selected) {
+                wattron(main_win, COLOR_PAIR(COLOR_PAIR_SELECTED));
+            }
+        } else {
+            mvwprintw(main_win, y, QUOTE_COL, "%14s", buf);
+        }
+    }
+}
+
+// Pattern tags shown after the symbol: bullish in green, bearish in red.
+static const struct {
+    unsigned flag;
+    const char *tag;
+    int direction;
+} pattern_tags[] = {
+    {PATTERN_BULL_ENGULFING, "E+", 1},
+    {PATTERN_BEAR_ENGULFING, "E-", -1},
+    {PATTERN_HAMMER, "H", 1},
+    {PATTERN_INSIDE_BAR, "IB", 0},
+    {PATTERN_BREAKOUT_HIGH, "B+", 1},
+    {PATTERN_BREAKOUT_LOW, "B-", -1},
+};
+
+// Print the tags of @p flags between the symbol and the price column.
+static void draw_pattern_tags(int y, const char *symbol, unsigned flags, bool row_selected) {
+    int x = 2 + (int)strlen(symbol) + 1;
+    for (size_t i = 0; i < sizeof(pattern_tags) / sizeof(pattern_tags[0]); i++) {
+        if (!(flags & pattern_tags[i].flag)) {
+            continue;
+        }
+        int width = (int)strlen(pattern_tags[i].tag);
+        if (x + width >= PRICE_COL) {
+            break;
+        }
+        int pair = 0;
+        if (colors_available) {
+            if (pattern_tags[i].direction > 0) {
+                pair = row_selected ? COLOR_PAIR_GREEN_SELECTED : COLOR_PAIR_GREEN;
+            } else if (pattern_tags[i].direction < 0) {
+                pair = row_selected ? COLOR_PAIR_RED_SELECTED : COLOR_PAIR_RED;
+            } else {
+                pair = row_selected ? COLOR_PAIR_SYMBOL_SELECTED : COLOR_PAIR_HEADER;
+            }
+            wattron(main_win, COLOR_PAIR(pair) | A_BOLD);
+        }
+        mvwprintw(main_win, y, x, "%s", pattern_tags[i].tag);
+        if (colors_available) {
+            wattroff(main_win, COLOR_PAIR(pair) | A_BOLD);
+        }
+        x += width + 1;
+    }
+    if (row_selected && colors_available) {
+        wattron(main_win, COLOR_PAIR(COLOR_PAIR_SELECTED));
+    }
+}
+
 // Draw the ticker board listing all configured symbols along with their latest
 // price, change, and a transient flicker for updated rows.
 void draw_main_screen(TickerData *tickers, int count, int selected,
-                      const char *sort_hint_price, const char *sort_hint_change) {
+                      const char *sort_hint_price, const char *sort_hint_change,
+                      bool move_stats) {
     // Full-frame redraw to keep layout consistent after terminal resize.
     werase(main_win);
     // Layout (screen coordinates):
@@ -163,40 +254,7 @@ void draw_main_screen(TickerData *tickers, int count, int selected,
     }
     last_visible_count = count;
 
-    // Unified title bar header keeps left label, centered board name, and right clock visually cohesive.
-    time_t now = time(NULL);
-    char time_str[64];
-    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", localtime(&now));
-    const char *left_text = "CTICKER";
-    const char *title_text = "[P][R][I][C][E] [B][O][A][R][D]";
-    int left_x = 2;
-    int left_len = (int)strlen(left_text);
-    int title_len = (int)strlen(title_text);
-    int time_x = COLS - (int)strlen(time_str) - 2;
-    if (time_x < 2) {
-        time_x = 2;
-    }
-    int title_x = (COLS - title_len) / 2;
-    if (title_x < 2) {
-        title_x = 2;
-    }
-    int min_title_x = left_x + left_len + 2;
-    if (title_x < min_title_x) {
-        title_x = min_title_x;
-    }
-    if (title_x + title_len >= time_x) {
-        title_x = time_x - title_len - 1;
-        if (title_x < 2) {
-            title_x = 2;
-        }
-    }
-
-    wattron(main_win, COLOR_PAIR(COLOR_PAIR_TITLE_BAR));
-    mvwhline(main_win, 0, 0, ' ', COLS);
-    mvwprintw(main_win, 0, left_x, "%s", left_text);
-    mvwprintw(main_win, 0, title_x, "%s", title_text);
-    mvwprintw(main_win, 0, time_x, "%s", time_str);
-    wattroff(main_win, COLOR_PAIR(COLOR_PAIR_TITLE_BAR));
+    draw_title_bar("[P][R][I][C][E] [B][O][A][R][D]");
 
     // Column headers and a horizontal rule to separate the board.
     wattron(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
@@ -210,13 +268,13 @@ void draw_main_screen(TickerData *tickers, int count, int selected,
         mvwprintw(main_win, 2, LOW_COL, "%12s", "LOW");
     }
     if (show_volume) {
-        mvwprintw(main_win, 2, VOLUME_COL, "%14s", "VOLUME");
+        mvwprintw(main_win, 2, VOLUME_COL, "%14s", move_stats ? "VOL 24H" : "VOLUME");
     }
     if (show_trades) {
-        mvwprintw(main_win, 2, TRADES_COL, "%10s", "TRADES");
+        mvwprintw(main_win, 2, TRADES_COL, "%10s", move_stats ? "ATR 1M" : "TRADES");
     }
     if (show_quote) {
-        mvwprintw(main_win, 2, QUOTE_COL, "%14s", "QUOTE VOL");
+        mvwprintw(main_win, 2, QUOTE_COL, "%14s", move_stats ? "MOVE Z" : "QUOTE VOL");
     }
     wattroff(main_win, COLOR_PAIR(COLOR_PAIR_HEADER));
     mvwhline(main_win, 3, 2, ACS_HLINE, COLS - 4);
@@ -255,6 +313,9 @@ void draw_main_screen(TickerData *tickers, int count, int selected,
         } else {
             mvwprintw(main_win, y, 2, "%-15s", tickers[i].symbol);
         }
+        if (tickers[i].patterns) {
+            draw_pattern_tags(y, tickers[i].symbol, tickers[i].patterns, row_selected);
+        }
 
         char price_str[32];
         if (tickers[i].price_text[0]) {
@@ -294,35 +355,62 @@ void draw_main_screen(TickerData *tickers, int count, int selected,
         }
 
         char number_buf[32];
-        if (show_high) {
-            if (tickers[i].high_text[0]) {
-                snprintf(number_buf, sizeof(number_buf), "%s", tickers[i].high_text);
-            } else {
-                ui_format_number(number_buf, sizeof(number_buf), tickers[i].high_price);
+        if (tickers[i].synthetic) {
+            // Derived rows have no 24h range of their own.
+            if (show_high) {
+                mvwprintw(main_win, y, HIGH_COL, "%12s", "-");
             }
-            ui_trim_trailing_zeros(number_buf);
-            mvwprintw(main_win, y, HIGH_COL, "%12s", number_buf);
-        }
-        if (show_low) {
-            if (tickers[i].low_text[0]) {
-                snprintf(number_buf, sizeof(number_buf), "%s", tickers[i].low_text);
-            } else {
-                ui_format_number(number_buf, sizeof(number_buf), tickers[i].low_price);
+            if (show_low) {
+                mvwprintw(main_win, y, LOW_COL, "%12s", "-");
+            }
+        } else {
+            if (show_high) {
+                if (tickers[i].high_text[0]) {
+                    snprintf(number_buf, sizeof(number_buf), "%s", tickers[i].high_text);
+                } else {
+                    ui_format_number(number_buf, sizeof(number_buf), tickers[i].high_price);
+                }
+                ui_trim_trailing_zeros(number_buf);
+                mvwprintw(main_win, y, HIGH_COL, "%12s", number_buf);
+            }
+            if (show_low) {
+                if (tickers[i].low_text[0]) {
+                    snprintf(number_buf, sizeof(number_buf), "%s", tickers[i].low_text);
+                } else {
+                    ui_format_number(number_buf, sizeof(number_buf), tickers[i].low_price);
+                }
+                ui_trim_trailing_zeros(number_buf);
+                mvwprintw(main_win, y, LOW_COL, "%12s", number_buf);
             }
-            ui_trim_trailing_zeros(number_buf);
-            mvwprintw(main_win, y, LOW_COL, "%12s", number_buf);
-        }
-        if (show_volume) {
-            ui_format_number_with_commas(number_buf, sizeof(number_buf), tickers[i].volume_base);
-            mvwprintw(main_win, y, VOLUME_COL, "%14s", number_buf);
-        }
-        if (show_trades) {
-            ui_format_integer_with_commas(number_buf, sizeof(number_buf), tickers[i].trade_count);
-            mvwprintw(main_win, y, TRADES_COL, "%10s", number_buf);
         }
-        if (show_quote) {
-            ui_format_number_with_commas(number_buf, sizeof(number_buf), tickers[i].volume_quote);
-            mvwprintw(main_win, y, QUOTE_COL, "%14s", number_buf);
+
+        if (move_stats) {
+            draw_move_stats(y, &tickers[i], show_volume, show_trades, show_quote,
+                            row_selected);
+        } else if (tickers[i].synthetic) {
+            // ... nor any trading activity.
+            if (show_volume) {
+                mvwprintw(main_win, y, VOLUME_COL, "%14s", "-");
+            }
+            if (show_trades) {
+                mvwprintw(main_win, y, TRADES_COL, "%10s", "-");
+            }
+            if (show_quote) {
+                mvwprintw(main_win, y, QUOTE_COL, "%14s", "-");
+            }
+        } else {
+            if (show_volume) {
+                ui_format_number_with_commas(number_buf, sizeof(number_buf), tickers[i].volume_base);
+                mvwprintw(main_win, y, VOLUME_COL, "%14s", number_buf);
+            }
+            if (show_trades) {
+                ui_format_integer_with_commas(number_buf, sizeof(number_buf), tickers[i].trade_count);
+                mvwprintw(main_win, y, TRADES_COL, "%10s", number_buf);
+            }
+            if (show_quote) {
+                ui_format_number_with_commas(number_buf, sizeof(number_buf), tickers[i].volume_quote);
+                mvwprintw(main_win, y, QUOTE_COL, "%14s", number_buf);
+            }
         }
 
         if (row_selected && colors_available) {
@@ -343,8 +431,8 @@ void draw_main_screen(TickerData *tickers, int count, int selected,
     const char *change_hint = (sort_hint_change && sort_hint_change[0]) ? sort_hint_change : "=";
     char footer_text[256];
     snprintf(footer_text, sizeof(footer_text),
-             "KEYS: ↑/↓ NAVIGATE | ENTER/CLICK: VIEW CHART | F5: SORT BY PRICE %s | F6: SORT BY CHANGE %s | Q: QUIT",
-             price_hint, change_hint);
+             "KEYS: ↑/↓ NAVIGATE | ENTER/CLICK: VIEW CHART | F5: SORT BY PRICE %s | F6: SORT BY CHANGE %s | V: %s | P: PORTFOLIO | C: CORRELATION | A: ARBITRAGE | Q: QUIT",
+             price_hint, change_hint, move_stats ? "24H ACTIVITY" : "VOLATILITY");
     draw_footer_bar(footer_text);
 
     wrefresh(main_win);
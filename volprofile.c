@@ -0,0 +1,235 @@
+/*
+MIT License
+
+Copyright (c) 2026 xtaci
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+/**
+ * @file volprofile.c
+ * @brief Incremental volume-at-price histogram for the chart viewport.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "volprofile.h"
+
+// Start with an empty profile.
+void volprofile_init(VolumeProfile *profile) {
+    memset(profile, 0, sizeof(*profile));
+}
+
+// Release the contribution ring and empty the profile.
+void volprofile_free(VolumeProfile *profile) {
+    free(profile->candles);
+    volprofile_init(profile);
+}
+
+// Add (sign 1) or remove (sign -1) one candle's volume, spread evenly over
+// the bins its low-high range covers.
+static void volprofile_apply(VolumeProfile *profile, const VolumeProfileCandle *candle,
+                             double sign) {
+    if (!(candle->volume > 0.0)) {
+        return;
+    }
+    int bins = profile->bins;
+    double width = (profile->max_price - profile->min_price) / bins;
+    double lo = (candle->low - profile->min_price) / width;
+    double hi = (candle->high - profile->min_price) / width;
+    if (lo > hi) {
+        double tmp = lo;
+        lo = hi;
+        hi = tmp;
+    }
+    if (lo < 0.0) lo = 0.0;
+    if (hi < 0.0) hi = 0.0;
+    if (lo > bins) lo = bins;
+    if (hi > bins) hi = bins;
+
+    int first = (int)lo;
+    if (first >= bins) {
+        first = bins - 1;
+    }
+    double span = hi - lo;
+    if (span < 1e-9) {
+        profile->volume[first] += sign * candle->volume;
+        return;
+    }
+    double density = sign * candle->volume / span;
+    for (int b = first; b < bins && b < hi; ++b) {
+        double from = (b > lo) ? b : lo;
+        double to = (b + 1 < hi) ? b + 1 : hi;
+        profile->volume[b] += density * (to - from);
+    }
+}
+
+// Record candle @p index's values in its ring slot.
+static VolumeProfileCandle *volprofile_record(VolumeProfile *profile, const PricePoint *points,
+                                              int index) {
+    VolumeProfileCandle *slot = &profile->candles[index % profile->capacity];
+    slot->timestamp = points[index].timestamp;
+    slot->low = points[index].low;
+    slot->high = points[index].high;
+    slot->volume = points[index].volume;
+    return slot;
+}
+
+// Re-bin the whole window from scratch.
+static int volprofile_rebuild(VolumeProfile *profile, const PricePoint *points,
+                              int start, int end) {
+    memset(profile->volume, 0, sizeof(profile->volume));
+    for (int i = start; i < end; ++i) {
+        volprofile_apply(profile, volprofile_record(profile, points, i), 1.0);
+    }
+    profile->start = start;
+    profile->end = end;
+    profile->updates_since_resync = 0;
+    profile->candle_updates += (uint64_t)(end - start);
+    profile->rebuilds++;
+    return end - start;
+}
+
+// Move the histogram to points[start .. end), touching only the edges.
+int volprofile_update(VolumeProfile *profile, const PricePoint *points, int count,
+                      int start, int end, double min_price, double max_price, int bins) {
+    if (start < 0) start = 0;
+    if (end > count) end = count;
+    if (end < start) end = start;
+    if (bins < 1) bins = 1;
+    if (bins > VOLPROFILE_MAX_BINS) bins = VOLPROFILE_MAX_BINS;
+    if (!(max_price > min_price)) {
+        max_price = min_price + 1.0;
+    }
+
+    bool rebuild = bins != profile->bins || min_price != profile->min_price ||
+                   max_price != profile->max_price ||
+                   profile->updates_since_resync >= VOLPROFILE_RESYNC_UPDATES;
+    if (end - start > profile->capacity) {
+        int capacity = profile->capacity ? profile->capacity : 64;
+        while (capacity < end - start) {
+            capacity *= 2;
+        }
+        VolumeProfileCandle *candles = realloc(profile->candles,
+                                               (size_t)capacity * sizeof(*candles));
+        if (!candles) {
+            return -1;
+        }
+        profile->candles = candles;
+        profile->capacity = capacity;
+        rebuild = true;  // Slots are indexed modulo the capacity.
+    }
+    profile->min_price = min_price;
+    profile->max_price = max_price;
+    profile->bins = bins;
+
+    int overlap_start = (start > profile->start) ? start : profile->start;
+    int overlap_end = (end < profile->end) ? end : profile->end;
+    if (rebuild || overlap_start >= overlap_end) {
+        return volprofile_rebuild(profile, points, start, end);
+    }
+
+    // Candles kept in the window must still be the same candles; a changed
+    // one (typically the live candle) is swapped for its new values.
+    int touched = 0;
+    for (int i = overlap_start; i < overlap_end; ++i) {
+        VolumeProfileCandle *slot = &profile->candles[i % profile->capacity];
+        const PricePoint *point = &points[i];
+        if (slot->timestamp != point->timestamp) {
+            return volprofile_rebuild(profile, points, start, end);
+        }
+        if (slot->low != point->low || slot->high != point->high ||
+            slot->volume != point->volume) {
+            volprofile_apply(profile, slot, -1.0);
+            volprofile_apply(profile, volprofile_record(profile, points, i), 1.0);
+            touched += 2;
+        }
+    }
+
+    // Take out the candles that left before recording the ones that entered,
+    // since both may share ring slots.
+    for (int i = profile->start; i < overlap_start; ++i) {
+        volprofile_apply(profile, &profile->candles[i % profile->capacity], -1.0);
+        touched++;
+    }
+    for (int i = overlap_end; i < profile->end; ++i) {
+        volprofile_apply(profile, &profile->candles[i % profile->capacity], -1.0);
+        touched++;
+    }
+    for (int i = start; i < overlap_start; ++i) {
+        volprofile_apply(profile, volprofile_record(profile, points, i), 1.0);
+        touched++;
+    }
+    for (int i = overlap_end; i < end; ++i) {
+        volprofile_apply(profile, volprofile_record(profile, points, i), 1.0);
+        touched++;
+    }
+
+    profile->start = start;
+    profile->end = end;
+    profile->updates_since_resync += touched;
+    profile->candle_updates += (uint64_t)touched;
+    return touched;
+}
+
+// Find the point of control and expand the value area around it.
+void volprofile_levels(const VolumeProfile *profile, VolumeProfileLevels *levels) {
+    levels->poc = -1;
+    levels->value_low = -1;
+    levels->value_high = -1;
+    levels->poc_volume = 0.0;
+    levels->total = 0.0;
+
+    // Removals can leave tiny negative residues; treat them as empty.
+    double total = 0.0;
+    for (int b = 0; b < profile->bins; ++b) {
+        double volume = profile->volume[b];
+        if (volume > 0.0) {
+            total += volume;
+            if (volume > levels->poc_volume) {
+                levels->poc_volume = volume;
+                levels->poc = b;
+            }
+        }
+    }
+    levels->total = total;
+    if (levels->poc < 0) {
+        return;
+    }
+
+    int low = levels->poc;
+    int high = levels->poc;
+    double covered = levels->poc_volume;
+    double target = total * VOLPROFILE_VALUE_AREA;
+    while (covered < target && (low > 0 || high + 1 < profile->bins)) {
+        double below = (low > 0) ? profile->volume[low - 1] : 0.0;
+        double above = (high + 1 < profile->bins) ? profile->volume[high + 1] : 0.0;
+        if (below < 0.0) below = 0.0;
+        if (above < 0.0) above = 0.0;
+        if (low == 0 || (high + 1 < profile->bins && above >= below)) {
+            high++;
+            covered += above;
+        } else {
+            low--;
+            covered += below;
+        }
+    }
+    levels->value_low = low;
+    levels->value_high = high;
+}
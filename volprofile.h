@@ -0,0 +1,92 @@
+#ifndef CTICKER_VOLPROFILE_H
+#define CTICKER_VOLPROFILE_H
+
+#include <stdint.h>
+#include "cticker.h"
+
+/** Upper bound on price bins (one per chart row). */
+#define VOLPROFILE_MAX_BINS 512
+/** Share of the binned volume covered by the value area. */
+#define VOLPROFILE_VALUE_AREA 0.70
+/** Candle additions/removals between exact rebuilds (bounds float drift). */
+#define VOLPROFILE_RESYNC_UPDATES 4096
+
+/**
+ * @brief What one binned candle contributed, kept so it can be taken out again.
+ */
+typedef struct {
+    uint64_t timestamp;
+    double low;
+    double high;
+    double volume;
+} VolumeProfileCandle;
+
+/**
+ * @brief Volume-at-price histogram of a window of candles.
+ *
+ * A candle's base volume is spread evenly over its low-high range. When
+ * the window moves, only the candles that left or entered it are removed
+ * or added (plus any candle whose values changed, such as the live one);
+ * the histogram is rebuilt only when the price bins change, the candle
+ * series is replaced, or every ::VOLPROFILE_RESYNC_UPDATES updates.
+ */
+typedef struct {
+    /** Price range and bin count of the histogram (bins == 0 before the first update). */
+    double min_price;
+    double max_price;
+    int bins;
+    double volume[VOLPROFILE_MAX_BINS];
+    /** Binned candles: points[start .. end). */
+    int start;
+    int end;
+    /** Contribution of candle i at candles[i % capacity]. */
+    VolumeProfileCandle *candles;
+    int capacity;
+    int updates_since_resync;
+    /** Statistics: candles binned or unbinned, and full rebuilds. */
+    uint64_t candle_updates;
+    uint64_t rebuilds;
+} VolumeProfile;
+
+/**
+ * @brief Point of control and value area, as bin indices.
+ */
+typedef struct {
+    /** Bin with the most volume (-1 when the profile is empty). */
+    int poc;
+    /** Lowest and highest bin of the value area (inclusive). */
+    int value_low;
+    int value_high;
+    /** Volume of the point of control and of the whole profile. */
+    double poc_volume;
+    double total;
+} VolumeProfileLevels;
+
+/**
+ * @brief Start with an empty profile.
+ */
+void volprofile_init(VolumeProfile *profile);
+
+/**
+ * @brief Release memory owned by @p profile and empty it.
+ */
+void volprofile_free(VolumeProfile *profile);
+
+/**
+ * @brief Bring the histogram to points[start .. end) over @p bins equal
+ *        bins spanning [@p min_price, @p max_price).
+ *
+ * Volume outside the price range is clamped into the end bins.
+ *
+ * @return Candles binned or unbinned by this call, or -1 on allocation failure.
+ */
+int volprofile_update(VolumeProfile *profile, const PricePoint *points, int count,
+                      int start, int end, double min_price, double max_price, int bins);
+
+/**
+ * @brief Locate the point of control and grow the value area from it,
+ *        one bin at a time towards the heavier neighbour.
+ */
+void volprofile_levels(const VolumeProfile *profile, VolumeProfileLevels *levels);
+
+#endif